@@ -208,12 +208,14 @@ void FEBiphasicFSIDomain3D::UnpackLM(FEElement& el, vector<int>& lm)
 void FEBiphasicFSIDomain3D::InternalForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -662,14 +664,17 @@ void FEBiphasicFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementMatrix& ke = buf.ke;
+            ke.SetNodes(el.m_node);
             
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
@@ -680,7 +685,7 @@ void FEBiphasicFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
             ElementStiffness(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = buf.lm;
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -696,14 +701,17 @@ void FEBiphasicFSIDomain3D::MassMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
             
-            FEElementMatrix ke(el);
+            FEElementMatrix& ke = buf.ke;
+            ke.SetNodes(el.m_node);
             
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
@@ -714,7 +722,7 @@ void FEBiphasicFSIDomain3D::MassMatrix(FELinearSystem& LS)
             ElementMassMatrix(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = buf.lm;
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1032,16 +1040,18 @@ void FEBiphasicFSIDomain3D::UpdateElementStress(int iel, const FETimeInfo& tp)
 void FEBiphasicFSIDomain3D::InertialForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // get the element
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
             // element force vector
-            vector<double> fe;
-            vector<int> lm;
+            vector<double>& fe = buf.fe;
+            vector<int>& lm = buf.lm;
             
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
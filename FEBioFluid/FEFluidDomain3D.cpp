@@ -138,12 +138,14 @@ void FEFluidDomain3D::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEFluidDomain3D::InternalForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -453,13 +455,16 @@ void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
@@ -470,7 +475,7 @@ void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -485,13 +490,16 @@ void FEFluidDomain3D::MassMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
 
+    PrepareElementBuffers();
 #pragma omp parallel for shared(NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
@@ -502,7 +510,7 @@ void FEFluidDomain3D::MassMatrix(FELinearSystem& LS)
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -712,12 +720,14 @@ void FEFluidDomain3D::UpdateElementStress(int iel, const FETimeInfo& tp)
 void FEFluidDomain3D::InertialForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared(NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
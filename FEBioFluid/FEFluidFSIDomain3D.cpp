@@ -194,12 +194,14 @@ void FEFluidFSIDomain3D::UnpackLM(FEElement& el, vector<int>& lm)
 void FEFluidFSIDomain3D::InternalForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -567,14 +569,17 @@ void FEFluidFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementMatrix& ke = buf.ke;
+            ke.SetNodes(el.m_node);
             
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
@@ -585,7 +590,7 @@ void FEFluidFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
             ElementStiffness(el, ke);
             
             // get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = buf.lm;
 			UnpackLM(el, lm);
 			ke.SetIndices(lm);
             
@@ -601,14 +606,17 @@ void FEFluidFSIDomain3D::MassMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
 
-			FEElementMatrix ke(el);
+			FEElementMatrix& ke = buf.ke;
+			ke.SetNodes(el.m_node);
 
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
@@ -619,7 +627,7 @@ void FEFluidFSIDomain3D::MassMatrix(FELinearSystem& LS)
             ElementMassMatrix(el, ke);
             
             // get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = buf.lm;
 			UnpackLM(el, lm);
 			ke.SetIndices(lm);
             
@@ -636,15 +644,18 @@ void FEFluidFSIDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
     
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
 
 			// element stiffness matrix
-			FEElementMatrix ke(el);
+			FEElementMatrix& ke = buf.ke;
+			ke.SetNodes(el.m_node);
 
             // create the element's stiffness matrix
             int ndof = 7*el.Nodes();
@@ -655,7 +666,7 @@ void FEFluidFSIDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
             ElementBodyForceStiffness(bf, el, ke);
             
             // get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = buf.lm;
 			UnpackLM(el, lm);
 			ke.SetIndices(lm);
             
@@ -880,16 +891,18 @@ void FEFluidFSIDomain3D::UpdateElementStress(int iel, const FETimeInfo& tp)
 void FEFluidFSIDomain3D::InertialForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // get the element
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
             // element force vector
-            vector<double> fe;
-            vector<int> lm;
+            vector<double>& fe = buf.fe;
+            vector<int>& lm = buf.lm;
             
             // get the element force vector and initialize it to zero
             int ndof = 7*el.Nodes();
@@ -293,12 +293,14 @@ void FEFluidSolutesDomain3D::InternalForces(FEGlobalVector& R)
     int nsol = m_pMat->Solutes();
     int ndpn = 4+nsol;
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -882,13 +884,16 @@ void FEFluidSolutesDomain3D::StiffnessMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int nsol = m_pMat->Solutes();
@@ -901,7 +906,7 @@ void FEFluidSolutesDomain3D::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -916,13 +921,16 @@ void FEFluidSolutesDomain3D::MassMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         const int nsol = m_pMat->Solutes();
@@ -935,7 +943,7 @@ void FEFluidSolutesDomain3D::MassMatrix(FELinearSystem& LS)
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -1189,12 +1197,14 @@ void FEFluidSolutesDomain3D::UpdateElementStress(int iel, const FETimeInfo& tp)
 void FEFluidSolutesDomain3D::InertialForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -382,12 +382,14 @@ void FEMultiphasicFSIDomain3D::InternalForces(FEGlobalVector& R)
     int nsol = m_pMat->Solutes();
     int ndpn = 7+nsol;
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -1246,14 +1248,17 @@ void FEMultiphasicFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
     int nsol = m_pMat->Solutes();
     int ndpn = 7 + nsol;
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementMatrix& ke = buf.ke;
+            ke.SetNodes(el.m_node);
             
             // create the element's stiffness matrix
             int ndof = ndpn*el.Nodes();
@@ -1264,7 +1269,7 @@ void FEMultiphasicFSIDomain3D::StiffnessMatrix(FELinearSystem& LS)
             ElementStiffness(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = buf.lm;
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1283,14 +1288,17 @@ void FEMultiphasicFSIDomain3D::MassMatrix(FELinearSystem& LS)
     const int nsol = m_pMat->Solutes();
     const int ndpn = 7 + nsol;
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
             
-            FEElementMatrix ke(el);
+            FEElementMatrix& ke = buf.ke;
+            ke.SetNodes(el.m_node);
             
             // create the element's stiffness matrix
             int ndof = ndpn*el.Nodes();
@@ -1301,7 +1309,7 @@ void FEMultiphasicFSIDomain3D::MassMatrix(FELinearSystem& LS)
             ElementMassMatrix(el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = buf.lm;
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1322,15 +1330,18 @@ void FEMultiphasicFSIDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForc
     const int nsol = m_pMat->Solutes();
     const int ndpn = 7 + nsol;
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         if (el.isActive()) {
             
             // element stiffness matrix
-            FEElementMatrix ke(el);
+            FEElementMatrix& ke = buf.ke;
+            ke.SetNodes(el.m_node);
             
             // create the element's stiffness matrix
             int ndof = ndpn*el.Nodes();
@@ -1341,7 +1352,7 @@ void FEMultiphasicFSIDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForc
             ElementBodyForceStiffness(bf, el, ke);
             
             // get the element's LM vector
-            vector<int> lm;
+            vector<int>& lm = buf.lm;
             UnpackLM(el, lm);
             ke.SetIndices(lm);
             
@@ -1673,16 +1684,18 @@ void FEMultiphasicFSIDomain3D::InertialForces(FEGlobalVector& R)
     
     const int nsol = m_pMat->Solutes();
     const int ndpn = 7+nsol;
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // get the element
         FESolidElement& el = m_Elem[i];
         
         if (el.isActive()) {
             // element force vector
-            vector<double> fe;
-            vector<int> lm;
+            vector<double>& fe = buf.fe;
+            vector<int>& lm = buf.lm;
             
             // get the element force vector and initialize it to zero
             int ndof = ndpn*el.Nodes();
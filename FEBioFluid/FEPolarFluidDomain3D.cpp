@@ -144,12 +144,14 @@ void FEPolarFluidDomain3D::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEPolarFluidDomain3D::InternalForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -631,13 +633,16 @@ void FEPolarFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 7*el.Nodes();
@@ -648,7 +653,7 @@ void FEPolarFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -663,13 +668,16 @@ void FEPolarFluidDomain3D::MassMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 7*el.Nodes();
@@ -680,7 +688,7 @@ void FEPolarFluidDomain3D::MassMatrix(FELinearSystem& LS)
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -695,13 +703,16 @@ void FEPolarFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
         
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 7*el.Nodes();
@@ -712,7 +723,7 @@ void FEPolarFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -965,12 +976,14 @@ void FEPolarFluidDomain3D::UpdateElementStress(int iel, const FETimeInfo& tp)
 void FEPolarFluidDomain3D::InertialForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -238,12 +238,14 @@ void FESolutesDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FESolutesDomain::InternalForces(FEGlobalVector& R)
 {
 	int NE = (int)m_Elem.size();
+	PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
 	for (int i = 0; i<NE; ++i)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		vector<double>& fe = buf.fe;
+		vector<int>& lm = buf.lm;
 
 		// get the element
 		FESolidElement& el = m_Elem[i];
@@ -448,13 +450,16 @@ void FESolutesDomain::StiffnessMatrix(FELinearSystem& LS)
 	// repeat over all solid elements
 	int NE = (int)m_Elem.size();
 
+	PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
 	for (int iel = 0; iel<NE; ++iel)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 
 		// create the element's stiffness matrix
 		int nsol = m_pMat->Solutes();
@@ -466,7 +471,7 @@ void FESolutesDomain::StiffnessMatrix(FELinearSystem& LS)
 		ElementStiffness(el, ke);
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -163,12 +163,14 @@ void FEThermoFluidDomain3D::InternalForces(FEGlobalVector& R)
     int NE = (int)m_Elem.size();
     int ndpn = 5;
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -650,13 +652,16 @@ void FEThermoFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 5*el.Nodes();
@@ -667,7 +672,7 @@ void FEThermoFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
 
@@ -682,13 +687,16 @@ void FEThermoFluidDomain3D::MassMatrix(FELinearSystem& LS)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 5*el.Nodes();
@@ -699,7 +707,7 @@ void FEThermoFluidDomain3D::MassMatrix(FELinearSystem& LS)
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -714,13 +722,16 @@ void FEThermoFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+        FEElementBuffer& buf = ElementBuffer();
         FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 5*el.Nodes();
@@ -731,7 +742,7 @@ void FEThermoFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-        vector<int> lm;
+        vector<int>& lm = buf.lm;
         UnpackLM(el, lm);
         ke.SetIndices(lm);
         
@@ -960,12 +971,14 @@ void FEThermoFluidDomain3D::UpdateElementStress(int iel, const FETimeInfo& tp)
 void FEThermoFluidDomain3D::InertialForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "febio.h"
 #include <XML/XMLReader.h>
 #include <FEBioXML/xmltool.h>
+#include <FEBioXML/FEBModelCache.h>
 #include <FECore/FEModel.h>
 #include <FECore/FECoreTask.h>
 #include <FECore/FEMaterial.h>
@@ -61,6 +62,7 @@ namespace febio {
 	bool parse_import_folder(XMLTag& tag);
 	bool parse_set(XMLTag& tag);
 	bool parse_output_negative_jacobians(XMLTag& tag);
+	bool parse_model_cache(XMLTag& tag);
 
 	// create a map for the variables (defined with set)
 	static std::map<string, string> vars;
@@ -186,6 +188,10 @@ namespace febio {
 		{
 			if (parse_output_negative_jacobians(tag) == false) return false;
 		}
+		else if (tag == "model_cache")
+		{
+			if (parse_model_cache(tag) == false) return false;
+		}
 		else throw XMLReader::InvalidTag(tag);
 
 		return true;
@@ -307,6 +313,19 @@ namespace febio {
 		return bok;
 	}
 
+	//-----------------------------------------------------------------------------
+	// Sets the folder where the binary mesh cache files are stored.
+	bool parse_model_cache(XMLTag& tag)
+	{
+		// process any aliases
+		char szbuf[1024] = { 0 };
+		bool bok = process_aliases(szbuf, tag.szvalue());
+
+		if (bok) FEBModelCache::SetFolder(szbuf);
+
+		return bok;
+	}
+
 	//-----------------------------------------------------------------------------
 	const char* GetFileTitle(const char* szfile)
 	{
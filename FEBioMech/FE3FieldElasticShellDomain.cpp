@@ -119,13 +119,16 @@ void FE3FieldElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
     
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 6*el.Nodes();
@@ -139,7 +142,7 @@ void FE3FieldElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
         ElementDilatationalStiffness(fem, iel, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
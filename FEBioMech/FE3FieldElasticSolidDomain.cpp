@@ -136,13 +136,16 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 
 	// repeat over all solid elements
 	int NE = (int)m_Elem.size();
+	PrepareElementBuffers();
 	#pragma omp parallel for
 	for (int iel=0; iel<NE; ++iel)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 
 		// create the element's stiffness matrix
 		int ndof = 3*el.Nodes();
@@ -166,7 +169,7 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 				ke[j][i] = ke[i][j];
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
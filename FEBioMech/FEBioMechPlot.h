@@ -41,7 +41,7 @@ SOFTWARE.*/
 class FEPlotNodeDisplacement : public FEPlotNodeData
 {
 public:
-	FEPlotNodeDisplacement(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE) { SetUnits(UNIT_LENGTH); }
+	FEPlotNodeDisplacement(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE) { SetUnits(UNIT_LENGTH); SetThreadSafe(true); }
 	bool Save(FEMesh& m, FEDataStream& a);
 };
 
@@ -51,7 +51,7 @@ public:
 class FEPlotNodeVelocity : public FEPlotNodeData
 {
 public:
-	FEPlotNodeVelocity(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE) { SetUnits(UNIT_VELOCITY); }
+	FEPlotNodeVelocity(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE) { SetUnits(UNIT_VELOCITY); SetThreadSafe(true); }
 	bool Save(FEMesh& m, FEDataStream& a);
 };
 
@@ -61,7 +61,7 @@ public:
 class FEPlotNodeAcceleration : public FEPlotNodeData
 {
 public:
-	FEPlotNodeAcceleration(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE) { SetUnits(UNIT_ACCELERATION); }
+	FEPlotNodeAcceleration(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE) { SetUnits(UNIT_ACCELERATION); SetThreadSafe(true); }
 	bool Save(FEMesh& m, FEDataStream& a);
 };
 
@@ -338,7 +338,7 @@ public:
 class FEPlotElementStress : public FEPlotDomainData
 {
 public:
-	FEPlotElementStress(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM) { SetUnits(UNIT_PRESSURE); }
+	FEPlotElementStress(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM) { SetUnits(UNIT_PRESSURE); SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -347,7 +347,7 @@ public:
 class FEPlotElementPK2Stress : public FEPlotDomainData
 {
 public:
-	FEPlotElementPK2Stress(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM) { SetUnits(UNIT_PRESSURE); }
+	FEPlotElementPK2Stress(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM) { SetUnits(UNIT_PRESSURE); SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -386,7 +386,7 @@ public:
 class FEPlotElementsnorm : public FEPlotDomainData
 {
 public:
-	FEPlotElementsnorm(FEModel* pfem) : FEPlotDomainData(pfem, PLT_FLOAT, FMT_ITEM){ SetUnits(UNIT_PRESSURE); }
+	FEPlotElementsnorm(FEModel* pfem) : FEPlotDomainData(pfem, PLT_FLOAT, FMT_ITEM){ SetUnits(UNIT_PRESSURE); SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -539,7 +539,7 @@ public:
 class FEPlotRelativeVolume : public FEPlotDomainData
 {
 public:
-	FEPlotRelativeVolume(FEModel* pfem) : FEPlotDomainData(pfem, PLT_FLOAT, FMT_ITEM){}
+	FEPlotRelativeVolume(FEModel* pfem) : FEPlotDomainData(pfem, PLT_FLOAT, FMT_ITEM){ SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -878,7 +878,7 @@ public:
 class FEPlotLagrangeStrain : public FEPlotDomainData
 {
 public:
-	FEPlotLagrangeStrain(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM){}
+	FEPlotLagrangeStrain(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM){ SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -153,12 +153,14 @@ void FEElasticANSShellDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEElasticANSShellDomain::InternalForces(FEGlobalVector& R)
 {
     int NS = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NS)
     for (int i=0; i<NS; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
 		FEShellElementNew& el = m_Elem[i];
@@ -257,12 +259,14 @@ void FEElasticANSShellDomain::ElementInternalForce(FEShellElementNew& el, vector
 void FEElasticANSShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 {
     int NS = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int i=0; i<NS; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
 		FEShellElementNew& el = m_Elem[i];
@@ -331,12 +335,14 @@ void FEElasticANSShellDomain::ElementBodyForce(FEBodyForce& BF, FEShellElementNe
 void FEElasticANSShellDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElementNew& el = m_Elem[i];
@@ -464,13 +470,16 @@ void FEElasticANSShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
     // repeat over all shell elements
     int NS = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NS)
     for (int iel=0; iel<NS; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         
@@ -478,7 +487,7 @@ void FEElasticANSShellDomain::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(iel, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -492,13 +501,16 @@ void FEElasticANSShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 {
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElementNew& el = m_Elem[iel];
 
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         ke.zero();
@@ -507,7 +519,7 @@ void FEElasticANSShellDomain::MassMatrix(FELinearSystem& LS, double scale)
         ElementMassMatrix(el, ke, scale);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -521,13 +533,16 @@ void FEElasticANSShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce
 {
     // repeat over all shell elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElementNew& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         ke.zero();
@@ -536,7 +551,7 @@ void FEElasticANSShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -179,12 +179,14 @@ void FEElasticEASShellDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEElasticEASShellDomain::InternalForces(FEGlobalVector& R)
 {
     int NS = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NS)
     for (int i=0; i<NS; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
 		FEShellElementNew& el = m_Elem[i];
@@ -306,12 +308,14 @@ void FEElasticEASShellDomain::ElementInternalForce(FEShellElementNew& el, vector
 void FEElasticEASShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 {
     int NS = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int i=0; i<NS; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
 		FEShellElementNew& el = m_Elem[i];
@@ -380,12 +384,14 @@ void FEElasticEASShellDomain::ElementBodyForce(FEBodyForce& BF, FEShellElementNe
 void FEElasticEASShellDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElementNew& el = m_Elem[i];
@@ -512,13 +518,16 @@ void FEElasticEASShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
     // repeat over all shell elements
     int NS = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NS)
     for (int iel=0; iel<NS; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         
@@ -526,7 +535,7 @@ void FEElasticEASShellDomain::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(iel, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -540,13 +549,16 @@ void FEElasticEASShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 {
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElementNew& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         ke.zero();
@@ -555,7 +567,7 @@ void FEElasticEASShellDomain::MassMatrix(FELinearSystem& LS, double scale)
         ElementMassMatrix(el, ke, scale);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -569,13 +581,16 @@ void FEElasticEASShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce
 {
     // repeat over all shell elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElementNew& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         ke.zero();
@@ -584,7 +599,7 @@ void FEElasticEASShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEElasticMaterialPoint.h"
+#include <typeinfo>
 
 //-----------------------------------------------------------------------------
 FEElasticMaterialPoint::FEElasticMaterialPoint(FEMaterialPointData* mp) : FEMaterialPointData(mp)
@@ -77,6 +78,30 @@ void FEElasticMaterialPoint::Serialize(DumpStream& ar)
 	ar & m_buncoupled;
 }
 
+//-----------------------------------------------------------------------------
+// Fast state snapshot. This must store the same data as Serialize.
+int FEElasticMaterialPoint::StateSize() const
+{
+	// derived classes have additional state, so they need to opt in themselves
+	if (typeid(*this) != typeid(FEElasticMaterialPoint)) return -1;
+
+	return (int)(2*sizeof(mat3d) + sizeof(mat3ds) + 3*sizeof(vec3d) + 4*sizeof(double) + sizeof(bool));
+}
+
+void FEElasticMaterialPoint::SaveState(char* pb) const
+{
+	SaveValue(pb, m_F); SaveValue(pb, m_J); SaveValue(pb, m_s); SaveValue(pb, m_v); SaveValue(pb, m_a);
+	SaveValue(pb, m_gradJ); SaveValue(pb, m_L); SaveValue(pb, m_Wt); SaveValue(pb, m_Wp); SaveValue(pb, m_p);
+	SaveValue(pb, m_buncoupled);
+}
+
+void FEElasticMaterialPoint::RestoreState(const char* pb)
+{
+	RestoreValue(pb, m_F); RestoreValue(pb, m_J); RestoreValue(pb, m_s); RestoreValue(pb, m_v); RestoreValue(pb, m_a);
+	RestoreValue(pb, m_gradJ); RestoreValue(pb, m_L); RestoreValue(pb, m_Wt); RestoreValue(pb, m_Wp); RestoreValue(pb, m_p);
+	RestoreValue(pb, m_buncoupled);
+}
+
 //-----------------------------------------------------------------------------
 //! Calculates the right Cauchy-Green tensor at the current material point
 
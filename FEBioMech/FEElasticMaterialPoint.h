@@ -49,6 +49,10 @@ public:
 	//! serialize material point data
 	void Serialize(DumpStream& ar) override;
 
+	int StateSize() const override;
+	void SaveState(char* pb) const override;
+	void RestoreState(const char* pb) override;
+
 public:
 	mat3ds Strain() const;
 	mat3ds SmallStrain() const;
@@ -156,13 +156,16 @@ void FEElasticShellDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 // Calculates the forces due to the stress
 void FEElasticShellDomain::InternalForces(FEGlobalVector& R)
 {
-    int NS = (int)m_Elem.size();
-#pragma omp parallel for shared (NS)
-    for (int i=0; i<NS; ++i)
-    {
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) R.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int i) {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -179,7 +182,9 @@ void FEElasticShellDomain::InternalForces(FEGlobalVector& R)
         
         // assemble the residual
         R.Assemble(el.m_node, lm, fe, true);
-    }
+    });
+
+    if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -243,12 +248,14 @@ void FEElasticShellDomain::ElementInternalForce(FEShellElement& el, vector<doubl
 void FEElasticShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 {
     int NS = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int i=0; i<NS; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -316,13 +323,16 @@ void FEElasticShellDomain::ElementBodyForce(FEBodyForce& BF, FEShellElement& el,
 // Calculate inertial forces \todo Why is F no longer needed?
 void FEElasticShellDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int i=0; i<NE; ++i)
-    {
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) R.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int i) {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -339,7 +349,9 @@ void FEElasticShellDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
         
         // assemble element 'fe'-vector into global R vector
         R.Assemble(el.m_node, lm, fe, true);
-    }
+    });
+
+    if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -443,15 +455,18 @@ void FEElasticShellDomain::ElementBodyForceStiffness(FEBodyForce& BF, FEShellEle
 
 void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
-    // repeat over all shell elements
-    int NS = (int)m_Elem.size();
-#pragma omp parallel for shared (NS)
-    for (int iel=0; iel<NS; ++iel)
-    {
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) LS.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int iel) {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         
@@ -459,13 +474,15 @@ void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(iel, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
+
+    if (bcolored) LS.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -473,13 +490,16 @@ void FEElasticShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 {
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         ke.zero();
@@ -488,7 +508,7 @@ void FEElasticShellDomain::MassMatrix(FELinearSystem& LS, double scale)
         ElementMassMatrix(el, ke, scale);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -502,13 +522,16 @@ void FEElasticShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
 {
     // repeat over all shell elements
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
         
         // create the element's stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 6*el.Nodes();
         ke.resize(ndof, ndof);
         ke.zero();
@@ -517,7 +540,7 @@ void FEElasticShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
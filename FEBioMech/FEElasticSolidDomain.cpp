@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioMech.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEElementTraits.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -162,17 +163,21 @@ void FEElasticSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 {
-	int NE = Elements();
-	#pragma omp parallel for shared (NE)
-	for (int i=0; i<NE; ++i)
-	{
+	// elements of the same color can be assembled without atomics
+	bool bcolored = UseColoredAssembly();
+	if (bcolored) R.SetAtomicAssembly(false);
+
+	PrepareElementBuffers();
+	ForEachElementParallel(bcolored, [&](int i) {
+		FEElementBuffer& buf = ElementBuffer();
+
 		// get the element
 		FESolidElement& el = m_Elem[i];
 
 		if (el.isActive()) {
 			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+			vector<double>& fe = buf.fe;
+			vector<int>& lm = buf.lm;
 
 			// get the element force vector and initialize it to zero
 			int ndof = 3 * el.Nodes();
@@ -187,7 +192,9 @@ void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 			// assemble element 'fe'-vector into global R vector
 			R.Assemble(el.m_node, lm, fe);
 		}
-	}
+	});
+
+	if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -278,10 +285,192 @@ void FEElasticSolidDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 	});
 }
 
+//-----------------------------------------------------------------------------
+//! Geometrical stiffness kernel for element types with a fixed number of nodes
+//! and integration points. Since the Cauchy stress is symmetric, the nodal
+//! blocks are symmetric as well, so only the upper blocks are evaluated.
+template <class T> void FEElasticSolidDomain::GeometricalStiffnessKernel(FESolidElement& el, matrix& ke)
+{
+	const int NELN = T::NELN;
+	const int NINT = T::NINT;
+	assert((el.Nodes() == NELN) && (el.GaussPoints() == NINT));
+
+	// spatial derivatives of shape functions
+	vec3d G[NELN];
+
+	// weights at gauss points
+	const double *gw = el.GaussWeights();
+
+	for (int n = 0; n<NINT; ++n)
+	{
+		// calculate shape function gradients and jacobian
+		double w = ShapeGradient(el, n, G, m_alphaf)*gw[n]*m_alphaf;
+
+		// element's Cauchy-stress tensor at gauss point n
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		mat3ds& s = mp.ExtractData<FEElasticMaterialPoint>()->m_s;
+
+		for (int i = 0; i<NELN; ++i)
+		{
+			vec3d sGi = (s*G[i])*w;
+			for (int j = i; j<NELN; ++j)
+			{
+				double kab = G[j]*sGi;
+
+				ke[3*i  ][3*j  ] += kab;
+				ke[3*i+1][3*j+1] += kab;
+				ke[3*i+2][3*j+2] += kab;
+
+				if (j != i)
+				{
+					ke[3*j  ][3*i  ] += kab;
+					ke[3*j+1][3*i+1] += kab;
+					ke[3*j+2][3*i+2] += kab;
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Material stiffness kernel for element types with a fixed number of nodes
+//! and integration points. As long as the tangent has major symmetry, only the
+//! upper nodal blocks are evaluated and the lower blocks are copied at the end.
+//! If a non-symmetric tangent is encountered, the blocks accumulated so far are
+//! mirrored and the remaining integration points are evaluated in full.
+template <class T> void FEElasticSolidDomain::MaterialStiffnessKernel(FESolidElement& el, matrix& ke)
+{
+	const int NELN = T::NELN;
+	const int NINT = T::NINT;
+	const int NDOF = 3*NELN;
+	assert((el.Nodes() == NELN) && (el.GaussPoints() == NINT));
+
+	// global derivatives of shape functions
+	vec3d G[NELN];
+
+	// The 'D' matrix
+	double D[6][6];
+
+	// The 'D*BL' matrices for all nodes (scaled by the integration weight)
+	double DBL[NELN][6][3];
+
+	// element matrix accumulator
+	double K[NDOF][NDOF];
+	for (int i=0; i<NDOF; ++i)
+		for (int j=0; j<NDOF; ++j) K[i][j] = 0.0;
+
+	// weights at gauss points
+	const double *gw = el.GaussWeights();
+
+	// set when the full matrix (instead of the upper blocks) is evaluated
+	bool bfull = false;
+
+	// evaluate the tangents at all integration points at once
+	FEMaterialPoint* mp[NINT];
+	tens4dmm C[NINT];
+	for (int n=0; n<NINT; ++n) mp[n] = el.GetMaterialPoint(n);
+	if (m_secant_tangent)
+	{
+		for (int n=0; n<NINT; ++n) C[n] = m_pMat->SecantTangent(*mp[n]);
+	}
+	else m_pMat->SolidTangents(mp, NINT, C);
+
+	for (int n=0; n<NINT; ++n)
+	{
+		// calculate jacobian and shape function gradients
+		double detJt = ShapeGradient(el, n, G, m_alphaf)*gw[n]*m_alphaf;
+
+		// get the 'D' matrix
+		C[n].extract(D);
+
+		// check the symmetry of the tangent
+		if (bfull == false)
+		{
+			bool bsymm = true;
+			for (int a=1; a<6 && bsymm; ++a)
+				for (int b=0; b<a; ++b)
+					if (D[a][b] != D[b][a]) { bsymm = false; break; }
+
+			if (bsymm == false)
+			{
+				// copy the upper blocks we have so far to the lower blocks
+				for (int i=0; i<NELN; ++i)
+					for (int j=i+1; j<NELN; ++j)
+						for (int k=0; k<3; ++k)
+							for (int l=0; l<3; ++l) K[3*j+l][3*i+k] = K[3*i+k][3*j+l];
+				bfull = true;
+			}
+		}
+
+		// calculate D*BL matrices
+		for (int j=0; j<NELN; ++j)
+		{
+			const double Gxj = G[j].x*detJt;
+			const double Gyj = G[j].y*detJt;
+			const double Gzj = G[j].z*detJt;
+			for (int k=0; k<6; ++k)
+			{
+				DBL[j][k][0] = (D[k][0]*Gxj+D[k][3]*Gyj+D[k][5]*Gzj);
+				DBL[j][k][1] = (D[k][1]*Gyj+D[k][3]*Gxj+D[k][4]*Gzj);
+				DBL[j][k][2] = (D[k][2]*Gzj+D[k][4]*Gyj+D[k][5]*Gxj);
+			}
+		}
+
+		for (int i=0, i3=0; i<NELN; ++i, i3 += 3)
+		{
+			const double Gxi = G[i].x;
+			const double Gyi = G[i].y;
+			const double Gzi = G[i].z;
+
+			for (int j=(bfull ? 0 : i), j3 = 3*j; j<NELN; ++j, j3 += 3)
+			{
+				double (&Dj)[6][3] = DBL[j];
+				for (int l=0; l<3; ++l)
+				{
+					K[i3  ][j3+l] += Gxi*Dj[0][l] + Gyi*Dj[3][l] + Gzi*Dj[5][l];
+					K[i3+1][j3+l] += Gyi*Dj[1][l] + Gxi*Dj[3][l] + Gzi*Dj[4][l];
+					K[i3+2][j3+l] += Gzi*Dj[2][l] + Gyi*Dj[4][l] + Gxi*Dj[5][l];
+				}
+			}
+		}
+	}
+
+	// add it to the element matrix
+	for (int i=0; i<NELN; ++i)
+	{
+		for (int j=(bfull ? 0 : i); j<NELN; ++j)
+		{
+			for (int k=0; k<3; ++k)
+				for (int l=0; l<3; ++l)
+				{
+					ke[3*i+k][3*j+l] += K[3*i+k][3*j+l];
+					if ((bfull == false) && (j != i)) ke[3*j+l][3*i+k] += K[3*i+k][3*j+l];
+				}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! calculates element's geometrical stiffness component for integration point n
 void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matrix &ke)
 {
+	// use a specialized kernel for the common element types
+	switch (el.Type())
+	{
+	case FE_HEX8G8    : GeometricalStiffnessKernel<FEHex8G8   >(el, ke); return;
+	case FE_HEX8G1    : GeometricalStiffnessKernel<FEHex8G1   >(el, ke); return;
+	case FE_TET4G1    : GeometricalStiffnessKernel<FETet4G1   >(el, ke); return;
+	case FE_TET4G4    : GeometricalStiffnessKernel<FETet4G4   >(el, ke); return;
+	case FE_PENTA6G6  : GeometricalStiffnessKernel<FEPenta6G6 >(el, ke); return;
+	case FE_TET10G4   : GeometricalStiffnessKernel<FETet10G4  >(el, ke); return;
+	case FE_TET10G8   : GeometricalStiffnessKernel<FETet10G8  >(el, ke); return;
+	case FE_TET10GL11 : GeometricalStiffnessKernel<FETet10GL11>(el, ke); return;
+	case FE_HEX20G8   : GeometricalStiffnessKernel<FEHex20G8  >(el, ke); return;
+	case FE_HEX20G27  : GeometricalStiffnessKernel<FEHex20G27 >(el, ke); return;
+	default:
+		break;
+	}
+
 	// spatial derivatives of shape functions
 	vec3d G[FEElement::MAX_NODES];
 
@@ -320,6 +509,23 @@ void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matri
 
 void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &ke)
 {
+	// use a specialized kernel for the common element types
+	switch (el.Type())
+	{
+	case FE_HEX8G8    : MaterialStiffnessKernel<FEHex8G8   >(el, ke); return;
+	case FE_HEX8G1    : MaterialStiffnessKernel<FEHex8G1   >(el, ke); return;
+	case FE_TET4G1    : MaterialStiffnessKernel<FETet4G1   >(el, ke); return;
+	case FE_TET4G4    : MaterialStiffnessKernel<FETet4G4   >(el, ke); return;
+	case FE_PENTA6G6  : MaterialStiffnessKernel<FEPenta6G6 >(el, ke); return;
+	case FE_TET10G4   : MaterialStiffnessKernel<FETet10G4  >(el, ke); return;
+	case FE_TET10G8   : MaterialStiffnessKernel<FETet10G8  >(el, ke); return;
+	case FE_TET10GL11 : MaterialStiffnessKernel<FETet10GL11>(el, ke); return;
+	case FE_HEX20G8   : MaterialStiffnessKernel<FEHex20G8  >(el, ke); return;
+	case FE_HEX20G27  : MaterialStiffnessKernel<FEHex20G27 >(el, ke); return;
+	default:
+		break;
+	}
+
 	// Get the current element's data
 	const int nint = el.GaussPoints();
 	const int neln = el.Nodes();
@@ -416,22 +622,26 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 {
+	// elements of the same color can be assembled without atomics
+	bool bcolored = UseColoredAssembly();
+	if (bcolored) LS.SetAtomicAssembly(false);
+
 	// repeat over all solid elements
-	int NE = Elements();
-	
-	#pragma omp parallel for shared (NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
+	PrepareElementBuffers();
+	ForEachElementParallel(bcolored, [&](int iel) {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		if (el.isActive()) {
 
 			// get the element's LM vector
-			vector<int> lm;
+			vector<int>& lm = buf.lm;
 			UnpackLM(el, lm);
 
 			// element stiffness matrix
-			FEElementMatrix ke(el, lm);
+			FEElementMatrix& ke = buf.ke;
+			ke.SetNodes(el.m_node);
+			ke.SetIndices(lm);
 
 			// create the element's stiffness matrix
 			int ndof = 3 * el.Nodes();
@@ -454,7 +664,9 @@ void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 			// assemble element matrix in global stiffness matrix
 			LS.Assemble(ke);
 		}
-	}
+	});
+
+	if (bcolored) LS.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -709,17 +921,21 @@ void FEElasticSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
 // Calculate inertial forces \todo Why is F no longer needed?
 void FEElasticSolidDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
-    int NE = Elements();
-#pragma omp parallel for shared(R, F)
-	for (int i=0; i<NE; ++i)
-    {
+	// elements of the same color can be assembled without atomics
+	bool bcolored = UseColoredAssembly();
+	if (bcolored) R.SetAtomicAssembly(false);
+
+	PrepareElementBuffers();
+	ForEachElementParallel(bcolored, [&](int i) {
+		FEElementBuffer& buf = ElementBuffer();
+
 		// get the element
 		FESolidElement& el = m_Elem[i];
 
 		if (el.isActive()) {
 			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+			vector<double>& fe = buf.fe;
+			vector<int>& lm = buf.lm;
 
 			// get the element force vector and initialize it to zero
 			int ndof = 3 * el.Nodes();
@@ -734,7 +950,9 @@ void FEElasticSolidDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 			// assemble element 'fe'-vector into global R vector
 			R.Assemble(el.m_node, lm, fe);
 		}
-    }
+	});
+
+	if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
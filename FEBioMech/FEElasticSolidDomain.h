@@ -108,6 +108,15 @@ public:
 	//! material stiffness component
 	virtual void ElementMaterialStiffness(FESolidElement& el, matrix& ke);
 
+protected:
+	//! geometrical stiffness kernel, specialized for the element traits class T
+	template <class T> void GeometricalStiffnessKernel(FESolidElement& el, matrix& ke);
+
+	//! material stiffness kernel, specialized for the element traits class T
+	template <class T> void MaterialStiffnessKernel(FESolidElement& el, matrix& ke);
+
+public:
+
 	// --- R E S I D U A L ---
 
 	//! Calculates the internal stress vector for solid elements
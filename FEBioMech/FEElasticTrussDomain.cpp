@@ -269,15 +269,17 @@ void FEElasticTrussDomain::InternalForces(FEGlobalVector& R)
 {
 	// element force vector
 	int NT = (int)m_Elem.size();
+	PrepareElementBuffers();
 #pragma omp parallel for
 	for (int i=0; i<NT; ++i)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		FETrussElement& el = m_Elem[i];
 
-		vector<double> fe;
+		vector<double>& fe = buf.fe;
 		ElementInternalForces(el, fe);
 
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		R.Assemble(el.m_node, lm, fe);
 	}
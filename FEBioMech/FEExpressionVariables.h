@@ -0,0 +1,65 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <initializer_list>
+
+//-----------------------------------------------------------------------------
+//! Variable array for the math expressions of the generic materials. The fixed
+//! variables (e.g. invariants) come first, followed by the values of the user 
+//! parameters. Small arrays use a buffer on the stack, so that evaluating the
+//! expressions at a material point does not allocate memory.
+class FEExpressionVariables
+{
+	enum { MAX_VARS = 16 };
+
+public:
+	FEExpressionVariables(const std::vector<double*>& param, std::initializer_list<double> vars)
+	{
+		int nfix = (int)vars.size();
+		int nvar = nfix + (int)param.size();
+		m_v = m_buf;
+		if (nvar > MAX_VARS) { m_tmp.resize(nvar); m_v = m_tmp.data(); }
+
+		int n = 0;
+		for (double vi : vars) m_v[n++] = vi;
+		for (double* p : param) m_v[n++] = *p;
+	}
+
+	operator const double* () const { return m_v; }
+
+private:
+	FEExpressionVariables(const FEExpressionVariables&) = delete;
+	void operator = (const FEExpressionVariables&) = delete;
+
+private:
+	double*				m_v;
+	double				m_buf[MAX_VARS];
+	std::vector<double>	m_tmp;
+};
@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #include "stdafx.h"
 #include "FEGenericHyperelastic.h"
+#include "FEExpressionVariables.h"
 #include <FECore/MMath.h>
 #include <FECore/MObj2String.h>
 #include <FECore/log.h>
@@ -83,6 +84,15 @@ bool FEGenericHyperelastic::BuildMathExpressions()
     MITEM WJJ = MDerive(m_WJ.GetExpression(), *m_WJ.Variable(2), 1);
 	m_WJJ.AddVariables(vars); m_WJJ.SetExpression(WJJ);
 
+	// Compile the derivatives into single programs, so that the sub-expressions
+	// they have in common are evaluated only once. If this fails, we'll just
+	// evaluate the derivatives separately.
+	int nvar = (int)vars.size();
+	m_dW.Compile({ m_W1.GetExpression().ItemPtr(), m_W2.GetExpression().ItemPtr(), m_WJ.GetExpression().ItemPtr() }, nvar);
+	m_d2W.Compile({ m_W1.GetExpression().ItemPtr(), m_W2.GetExpression().ItemPtr(), m_WJ.GetExpression().ItemPtr(),
+		m_W11.GetExpression().ItemPtr(), m_W12.GetExpression().ItemPtr(), m_W22.GetExpression().ItemPtr(),
+		m_WJJ.GetExpression().ItemPtr() }, nvar);
+
 #ifdef _DEBUG
 	MObj2String o2s;
 	string sW1 = o2s.Convert(m_W1); feLog("W1  = %s\n", sW1.c_str());
@@ -97,7 +107,6 @@ bool FEGenericHyperelastic::BuildMathExpressions()
 	return true;
 }
 
-
 // serialization
 void FEGenericHyperelastic::Serialize(DumpStream& ar)
 {
@@ -122,12 +131,19 @@ mat3ds FEGenericHyperelastic::Stress(FEMaterialPoint& mp)
 	double I1 = B.tr();
 	double I2 = 0.5*(I1*I1 - B2.tr());
 
-	vector<double> v = { I1, I2, J, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
+	FEExpressionVariables v(m_param, { I1, I2, J, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z });
 
-	double W1 = m_W1.value_s(v);
-	double W2 = m_W2.value_s(v);
-	double WJ = m_WJ.value_s(v);
+	double dW[3];
+	if (m_dW.IsValid()) m_dW.value(v, dW);
+	else
+	{
+		dW[0] = m_W1.value_s(v);
+		dW[1] = m_W2.value_s(v);
+		dW[2] = m_WJ.value_s(v);
+	}
+	double W1 = dW[0];
+	double W2 = dW[1];
+	double WJ = dW[2];
 
 	mat3dd I(1.0);
 
@@ -149,18 +165,29 @@ tens4ds FEGenericHyperelastic::Tangent(FEMaterialPoint& mp)
 	double I1 = B.tr();
 	double I2 = 0.5*(I1*I1 - B2.tr());
 
-	vector<double> v = { I1, I2, J, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
+	FEExpressionVariables v(m_param, { I1, I2, J, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z });
 
-	double W1 = m_W1.value_s(v);
-	double W2 = m_W2.value_s(v);
-	double WJ = m_WJ.value_s(v);
+	double dW[7];
+	if (m_d2W.IsValid()) m_d2W.value(v, dW);
+	else
+	{
+		dW[0] = m_W1.value_s(v);
+		dW[1] = m_W2.value_s(v);
+		dW[2] = m_WJ.value_s(v);
+		dW[3] = m_W11.value_s(v);
+		dW[4] = m_W12.value_s(v);
+		dW[5] = m_W22.value_s(v);
+		dW[6] = m_WJJ.value_s(v);
+	}
+	double W1 = dW[0];
+	double W2 = dW[1];
+	double WJ = dW[2];
 
-	double W11 = m_W11.value_s(v);
-	double W22 = m_W22.value_s(v);
-	double W12 = m_W12.value_s(v);
+	double W11 = dW[3];
+	double W12 = dW[4];
+	double W22 = dW[5];
 
-	double WJJ = m_WJJ.value_s(v);
+	double WJJ = dW[6];
 
 	mat3dd I(1.0);
 	tens4ds IxI = dyad1s(I);
@@ -195,8 +222,7 @@ double FEGenericHyperelastic::StrainEnergyDensity(FEMaterialPoint& mp)
 	double I1 = B.tr();
 	double I2 = 0.5*(I1*I1 - B2.tr());
 
-	vector<double> v = { I1, I2, J, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
+	FEExpressionVariables v(m_param, { I1, I2, J, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z });
 
 	double W = m_W.value_s(v);
 
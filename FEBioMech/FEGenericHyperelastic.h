@@ -26,6 +26,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEElasticMaterial.h"
 #include <FECore/MathObject.h>
+#include <FECore/MFusedExpression.h>
 
 //! Hyperelastic material, defined by strain energy function. 
 //! This case only considers the strain energy function to be a function of
@@ -68,5 +69,9 @@ private:
 	MSimpleExpression	m_W22;
 	MSimpleExpression	m_WJJ;
 
+	// the derivatives compiled into single programs
+	MFusedExpression	m_dW;	// W1, W2, WJ
+	MFusedExpression	m_d2W;	// W1, W2, WJ, W11, W12, W22, WJJ
+
 	DECLARE_FECORE_CLASS();
 };
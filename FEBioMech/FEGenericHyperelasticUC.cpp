@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #include "stdafx.h"
 #include "FEGenericHyperelasticUC.h"
+#include "FEExpressionVariables.h"
 #include <FECore/MMath.h>
 #include <FECore/MObj2String.h>
 #include <FECore/log.h>
@@ -79,6 +80,14 @@ bool FEGenericHyperelasticUC::BuildMathExpressions()
 	m_W12.AddVariables(vars); m_W12.SetExpression(W12);
 	m_W22.AddVariables(vars); m_W22.SetExpression(W22);
 
+	// Compile the derivatives into single programs, so that the sub-expressions
+	// they have in common are evaluated only once. If this fails, we'll just
+	// evaluate the derivatives separately.
+	int nvar = (int)vars.size();
+	m_dW.Compile({ m_W1.GetExpression().ItemPtr(), m_W2.GetExpression().ItemPtr() }, nvar);
+	m_d2W.Compile({ m_W1.GetExpression().ItemPtr(), m_W2.GetExpression().ItemPtr(),
+		m_W11.GetExpression().ItemPtr(), m_W12.GetExpression().ItemPtr(), m_W22.GetExpression().ItemPtr() }, nvar);
+
 	if (m_printDerivs)
 	{
 		feLog("\nStrain energy and derivatives for material %d (%s):\n", GetID(), GetName().c_str());
@@ -125,10 +134,17 @@ mat3ds FEGenericHyperelasticUC::DevStress(FEMaterialPoint& mp)
 	double I2 = 0.5*(I1*I1 - B2.tr());
 
 	// get strain energy derivatives
-	vector<double> v = { I1, I2, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
-	double W1 = m_W1.value_s(v);
-	double W2 = m_W2.value_s(v);
+	FEExpressionVariables v(m_param, { I1, I2, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z });
+
+	double dW[2];
+	if (m_dW.IsValid()) m_dW.value(v, dW);
+	else
+	{
+		dW[0] = m_W1.value_s(v);
+		dW[1] = m_W2.value_s(v);
+	}
+	double W1 = dW[0];
+	double W2 = dW[1];
 
 	// calculate T = F*dW/dC*Ft
 	mat3ds T = B*(W1 + W2*I1) - B2*W2;
@@ -158,14 +174,24 @@ tens4ds FEGenericHyperelasticUC::DevTangent(FEMaterialPoint& mp)
 	double I2 = 0.5*(I1*I1 - B2.tr());
 
 	// get strain energy derivatives
-	vector<double> v = { I1, I2, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
-	double W1 = m_W1.value_s(v);
-	double W2 = m_W2.value_s(v);
+	FEExpressionVariables v(m_param, { I1, I2, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z });
+
+	double dW[5];
+	if (m_d2W.IsValid()) m_d2W.value(v, dW);
+	else
+	{
+		dW[0] = m_W1.value_s(v);
+		dW[1] = m_W2.value_s(v);
+		dW[2] = m_W11.value_s(v);
+		dW[3] = m_W12.value_s(v);
+		dW[4] = m_W22.value_s(v);
+	}
+	double W1 = dW[0];
+	double W2 = dW[1];
 
-	double W11 = m_W11.value_s(v);
-	double W22 = m_W22.value_s(v);
-	double W12 = m_W12.value_s(v);
+	double W11 = dW[2];
+	double W12 = dW[3];
+	double W22 = dW[4];
 
 	// define fourth-order tensors
 	mat3dd I(1.0);
@@ -213,8 +239,7 @@ double FEGenericHyperelasticUC::DevStrainEnergyDensity(FEMaterialPoint& mp)
 	double I2 = 0.5*(I1*I1 - B2.tr());
 
 	// evaluate (deviatoric) strain energy
-	vector<double> v = { I1, I2, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
+	FEExpressionVariables v(m_param, { I1, I2, mp.m_r0.x, mp.m_r0.y, mp.m_r0.z });
 	double W = m_W.value_s(v);
 
 	return W;
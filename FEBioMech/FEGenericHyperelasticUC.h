@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #pragma once
 #include "FEUncoupledMaterial.h"
+#include <FECore/MFusedExpression.h>
 
 class FEGenericHyperelasticUC : public FEUncoupledMaterial
 {
@@ -64,5 +65,9 @@ private:
 	MSimpleExpression	m_W12;
 	MSimpleExpression	m_W22;
 
+	// the derivatives compiled into single programs
+	MFusedExpression	m_dW;	// W1, W2
+	MFusedExpression	m_d2W;	// W1, W2, W11, W12, W22
+
 	DECLARE_FECORE_CLASS();
 };
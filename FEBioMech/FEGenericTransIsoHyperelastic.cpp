@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #include "stdafx.h"
 #include "FEGenericTransIsoHyperelastic.h"
+#include "FEExpressionVariables.h"
 #include <FECore/MMath.h>
 #include <FECore/MObj2String.h>
 #include <FECore/log.h>
@@ -98,6 +99,17 @@ bool FEGenericTransIsoHyperelastic::Init()
 	MITEM WJJ = MDerive(m_WJ.GetExpression(), *m_WJ.Variable(4), 1);
 	m_WJJ.AddVariables(vars); m_WJJ.SetExpression(WJJ);
 
+	// Compile the derivatives into single programs, so that the sub-expressions
+	// they have in common are evaluated only once. If this fails, we'll just
+	// evaluate the derivatives separately.
+	int nvar = (int)vars.size();
+	m_dW.Compile({ m_W1.GetExpression().ItemPtr(), m_W2.GetExpression().ItemPtr(), m_W4.GetExpression().ItemPtr(), m_W5.GetExpression().ItemPtr(),
+		m_WJ.GetExpression().ItemPtr() }, nvar);
+	m_d2W.Compile({ m_W1.GetExpression().ItemPtr(), m_W2.GetExpression().ItemPtr(), m_W4.GetExpression().ItemPtr(), m_W5.GetExpression().ItemPtr(),
+		m_WJ.GetExpression().ItemPtr(), m_W11.GetExpression().ItemPtr(), m_W12.GetExpression().ItemPtr(), m_W14.GetExpression().ItemPtr(),
+		m_W15.GetExpression().ItemPtr(), m_W22.GetExpression().ItemPtr(), m_W24.GetExpression().ItemPtr(), m_W25.GetExpression().ItemPtr(),
+		m_W44.GetExpression().ItemPtr(), m_W45.GetExpression().ItemPtr(), m_W55.GetExpression().ItemPtr(), m_WJJ.GetExpression().ItemPtr() }, nvar);
+
 #ifdef _DEBUG
 	MObj2String o2s;
 	string sW1 = o2s.Convert(m_W1); feLog("W1  = %s\n", sW1.c_str());
@@ -145,15 +157,24 @@ mat3ds FEGenericTransIsoHyperelastic::Stress(FEMaterialPoint& mp)
 	double I5 = I4*(a*(B*a));
 
 	// create the parameter list
-	vector<double> v = { I1, I2, I4, I5, J };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
+	FEExpressionVariables v(m_param, { I1, I2, I4, I5, J });
 
 	// evaluate the strain energy derivatives
-	double W1 = m_W1.value_s(v);
-	double W2 = m_W2.value_s(v);
-	double W4 = m_W4.value_s(v);
-	double W5 = m_W5.value_s(v);
-	double WJ = m_WJ.value_s(v);
+	double dW[5];
+	if (m_dW.IsValid()) m_dW.value(v, dW);
+	else
+	{
+		dW[0] = m_W1.value_s(v);
+		dW[1] = m_W2.value_s(v);
+		dW[2] = m_W4.value_s(v);
+		dW[3] = m_W5.value_s(v);
+		dW[4] = m_WJ.value_s(v);
+	}
+	double W1 = dW[0];
+	double W2 = dW[1];
+	double W4 = dW[2];
+	double W5 = dW[3];
+	double WJ = dW[4];
 
 	mat3dd I(1.0);
 	mat3ds AxA = dyad(a);
@@ -189,28 +210,48 @@ tens4ds FEGenericTransIsoHyperelastic::Tangent(FEMaterialPoint& mp)
 	double I5 = I4*(a*(B*a));
 
 	// evaluate parameters
-	vector<double> v = { I1, I2, I4, I5, J };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
+	FEExpressionVariables v(m_param, { I1, I2, I4, I5, J });
 
 	// evaluate strain energy derivatives
-	double W1 = m_W1.value_s(v);
-	double W2 = m_W2.value_s(v);
-	double W4 = m_W4.value_s(v);
-	double W5 = m_W5.value_s(v);
-	double WJ = m_WJ.value_s(v);
-
-	double W11 = m_W11.value_s(v);
-	double W12 = m_W12.value_s(v);
-	double W14 = m_W14.value_s(v);
-	double W15 = m_W15.value_s(v);
-	double W22 = m_W22.value_s(v);
-	double W24 = m_W24.value_s(v);
-	double W25 = m_W25.value_s(v);
-	double W44 = m_W44.value_s(v);
-	double W45 = m_W45.value_s(v);
-	double W55 = m_W55.value_s(v);
-
-	double WJJ = m_WJJ.value_s(v);
+	double dW[16];
+	if (m_d2W.IsValid()) m_d2W.value(v, dW);
+	else
+	{
+		dW[0] = m_W1.value_s(v);
+		dW[1] = m_W2.value_s(v);
+		dW[2] = m_W4.value_s(v);
+		dW[3] = m_W5.value_s(v);
+		dW[4] = m_WJ.value_s(v);
+		dW[5] = m_W11.value_s(v);
+		dW[6] = m_W12.value_s(v);
+		dW[7] = m_W14.value_s(v);
+		dW[8] = m_W15.value_s(v);
+		dW[9] = m_W22.value_s(v);
+		dW[10] = m_W24.value_s(v);
+		dW[11] = m_W25.value_s(v);
+		dW[12] = m_W44.value_s(v);
+		dW[13] = m_W45.value_s(v);
+		dW[14] = m_W55.value_s(v);
+		dW[15] = m_WJJ.value_s(v);
+	}
+	double W1 = dW[0];
+	double W2 = dW[1];
+	double W4 = dW[2];
+	double W5 = dW[3];
+	double WJ = dW[4];
+
+	double W11 = dW[5];
+	double W12 = dW[6];
+	double W14 = dW[7];
+	double W15 = dW[8];
+	double W22 = dW[9];
+	double W24 = dW[10];
+	double W25 = dW[11];
+	double W44 = dW[12];
+	double W45 = dW[13];
+	double W55 = dW[14];
+
+	double WJJ = dW[15];
 
 	mat3dd I(1.0);
 	tens4ds IxI = dyad1s(I);
@@ -285,8 +326,7 @@ double FEGenericTransIsoHyperelastic::StrainEnergyDensity(FEMaterialPoint& mp)
 	double I5 = I4*(a*(B*a));
 
 	// evaluate parameters
-	vector<double> v = { I1, I2, I4, I5, J };
-	for (int i = 0; i < m_param.size(); ++i) v.push_back(*m_param[i]);
+	FEExpressionVariables v(m_param, { I1, I2, I4, I5, J });
 
 	double W = m_W.value_s(v);
 
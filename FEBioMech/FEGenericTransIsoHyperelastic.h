@@ -26,6 +26,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEElasticMaterial.h"
 #include <FECore/MathObject.h>
+#include <FECore/MFusedExpression.h>
 
 //! Transversely isotropic Hyperelastic material, defined by strain energy function. 
 //! This case assumes the strain energy function to be a function of
@@ -45,6 +46,7 @@ public:
 
 	double StrainEnergyDensity(FEMaterialPoint& mp) override;
 
+private:
 private:
 	std::string			m_exp;
 	FEVec3dValuator*	m_fiber;
@@ -72,5 +74,9 @@ private:
 	MSimpleExpression	m_W55;
 	MSimpleExpression	m_WJJ;
 
+	// the derivatives compiled into single programs
+	MFusedExpression	m_dW;	// first derivatives
+	MFusedExpression	m_d2W;	// first and second derivatives
+
 	DECLARE_FECORE_CLASS();
 };
@@ -26,6 +26,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEUncoupledMaterial.h"
 #include <FECore/MathObject.h>
+#include <FECore/MFusedExpression.h>
 
 //! Uncoupled transversely isotropic Hyperelastic material, defined by strain energy function. 
 //! This case assumes the strain energy function to be a function of
@@ -46,6 +47,7 @@ public:
 
 	double DevStrainEnergyDensity(FEMaterialPoint& mp) override;
 
+private:
 private:
 	std::string			m_exp;		// the string with the strain energy expression
 	FEVec3dValuator*	m_fiber;	// fiber direction
@@ -72,5 +74,9 @@ private:
 	MSimpleExpression	m_W45;
 	MSimpleExpression	m_W55;
 
+	// the derivatives compiled into single programs
+	MFusedExpression	m_dW;	// first derivatives
+	MFusedExpression	m_d2W;	// first and second derivatives
+
 	DECLARE_FECORE_CLASS();
 };
@@ -31,26 +31,72 @@ SOFTWARE.*/
 #include "FECore/mortar.h"
 #include "FECore/log.h"
 #include <FECore/FEMesh.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+void FEMortarWeights::Clear(int rows)
+{
+	m_row.assign(rows + 1, 0);
+	m_data.clear();
+	m_tmp.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMortarWeights::Finalize()
+{
+	// Sort the contributions by row and column. The sort is stable, so the
+	// contributions to a weight are summed in the order they were added.
+	std::stable_sort(m_tmp.begin(), m_tmp.end(), [](const TRIPLET& a, const TRIPLET& b) {
+		return (a.row < b.row) || ((a.row == b.row) && (a.col < b.col));
+	});
+
+	int rows = Rows();
+	m_data.clear();
+	m_row.assign(rows + 1, 0);
+	size_t n = 0;
+	while (n < m_tmp.size())
+	{
+		const TRIPLET& t = m_tmp[n];
+		double w = 0.0;
+		for (; (n < m_tmp.size()) && (m_tmp[n].row == t.row) && (m_tmp[n].col == t.col); ++n) w += m_tmp[n].w;
+
+		// only store nonzero weights
+		if (w != 0.0)
+		{
+			m_data.push_back({ t.col, w });
+			m_row[t.row + 1]++;
+		}
+	}
+	for (int i = 0; i < rows; ++i) m_row[i + 1] += m_row[i];
+
+	// release the temporary storage
+	std::vector<TRIPLET>().swap(m_tmp);
+}
+
+//-----------------------------------------------------------------------------
+double FEMortarWeights::Sum() const
+{
+	double sum = 0.0;
+	for (const ENTRY& e : m_data) sum += e.w;
+	return sum;
+}
 
 //-----------------------------------------------------------------------------
 FEMortarInterface::FEMortarInterface(FEModel* pfem) : FEContactInterface(pfem)
 {
 	// set the integration rule
 	m_pT = dynamic_cast<FESurfaceElementTraits*>(FEElementLibrary::GetElementTraits(FE_TRI3G7));
+
+	m_srad = 0.0;
 }
 
 //-----------------------------------------------------------------------------
 void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 {
-	// allocate sturcture for the integration weights
+	// clear the integration weights
 	int NS = ss.Nodes();
-	int NM = ms.Nodes();
-	m_n1.resize(NS,NS);
-	m_n2.resize(NS,NM);
-
-	// clear weights
-	m_n1.zero();
-	m_n2.zero();
+	m_n1.Clear(NS);
+	m_n2.Clear(NS);
 
 	// number of integration points
 	const int MAX_INT = 11;
@@ -61,7 +107,7 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 
 	// calculate the mortar surface
 	MortarSurface mortar;
-	CalculateMortarSurface(ss, ms, mortar);
+	CalculateMortarSurface(ss, ms, mortar, m_srad);
 
 	// These arrays will store the shape function values of the projection points 
 	// on the primary and secondary side when evaluating the integral over a pallet
@@ -134,7 +180,7 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 						n1 *= Area;
 
 						int b = se.m_lnode[B];
-						m_n1[a][b] += n1;
+						m_n1.Add(a, b, n1);
 					}
 
 					// loop over all the nodes on the secondary facet
@@ -148,23 +194,22 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 						n2 *= Area;
 
 						int c = me.m_lnode[C];
-						m_n2[a][c] += n2;
+						m_n2.Add(a, c, n2);
 					}
 				}
 			}		
 		}
 	}
 
+	// sum the contributions
+	m_n1.Finalize();
+	m_n2.Finalize();
+
 #ifdef _DEBUG
 	// Sanity check: sum should add up to contact area
 	// This is for a hardcoded problem. Remove or generalize this!
-	double sum1 = 0.0;
-	for (int A=0; A<NS; ++A)
-		for (int B=0; B<NS; ++B) sum1 += m_n1[A][B];
-
-	double sum2 = 0.0;
-	for (int A=0; A<NS; ++A)
-		for (int C=0; C<NM; ++C) sum2 += m_n2[A][C];
+	double sum1 = m_n1.Sum();
+	double sum2 = m_n2.Sum();
 
 	if (fabs(sum1 - 1.0) > 1e-5) feLog("WARNING: Mortar weights are not correct (%lg).\n", sum1);
 	if (fabs(sum2 - 1.0) > 1e-5) feLog("WARNING: Mortar weights are not correct (%lg).\n", sum2);
@@ -180,26 +225,25 @@ void FEMortarInterface::UpdateNodalGaps(FEMortarContactSurface& ss, FEMortarCont
 	zero(ss.m_gap);
 
 	int NS = ss.Nodes();
-	int NM = ms.Nodes();
 
 	// loop over all primary nodes
 	for (int A=0; A<NS; ++A)
 	{
 		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		for (const FEMortarWeights::ENTRY* e = m_n1.begin(A); e != m_n1.end(A); ++e)
 		{
-			FENode& nodeB = ss.Node(B);
+			FENode& nodeB = ss.Node(e->node);
 			vec3d& xB = nodeB.m_rt;
-			double nAB = m_n1[A][B];
+			double nAB = e->w;
 			gap[A] += xB*nAB;
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		for (const FEMortarWeights::ENTRY* e = m_n2.begin(A); e != m_n2.end(A); ++e)
 		{
-			FENode& nodeC = ms.Node(C);
+			FENode& nodeC = ms.Node(e->node);
 			vec3d& xC = nodeC.m_rt;
-			double nAC = m_n2[A][C];
+			double nAC = e->w;
 			gap[A] -= xC*nAC;
 		}
 	}
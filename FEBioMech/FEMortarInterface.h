@@ -29,6 +29,54 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEMortarContactSurface.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Sparse storage of the mortar integration weights. The weights are first
+// added as (row, column, value) triplets and then compressed by Finalize.
+// Each row stores its nonzero weights in ascending column order.
+class FEMortarWeights
+{
+public:
+	struct ENTRY
+	{
+		int		node;	//!< column (node) index
+		double	w;		//!< weight
+	};
+
+public:
+	FEMortarWeights() {}
+
+	//! clear all weights and set the number of rows
+	void Clear(int rows);
+
+	//! add a contribution to a weight
+	void Add(int row, int col, double w) { m_tmp.push_back({ row, col, w }); }
+
+	//! sum the contributions and build the row structure
+	void Finalize();
+
+	//! number of rows
+	int Rows() const { return (m_row.empty() ? 0 : (int)m_row.size() - 1); }
+
+	//! row access
+	const ENTRY* begin(int row) const { return m_data.data() + m_row[row]; }
+	const ENTRY* end(int row) const { return m_data.data() + m_row[row + 1]; }
+
+	//! sum of all weights
+	double Sum() const;
+
+private:
+	struct TRIPLET
+	{
+		int		row, col;
+		double	w;
+	};
+
+	std::vector<int>		m_row;	//!< offset of each row into m_data
+	std::vector<ENTRY>		m_data;	//!< nonzero weights
+	std::vector<TRIPLET>	m_tmp;	//!< contributions that are not finalized yet
+};
 
 //-----------------------------------------------------------------------------
 // Base class for mortar-type contact formulations
@@ -45,8 +93,9 @@ public:
 	void UpdateNodalGaps(FEMortarContactSurface& ss, FEMortarContactSurface& ms);
 
 protected:
-	matrix	m_n1;	//!< integration weights n1_AB
-	matrix	m_n2;	//!< integration weights n2_AB
+	FEMortarWeights	m_n1;	//!< integration weights n1_AB
+	FEMortarWeights	m_n2;	//!< integration weights n2_AB
+	double			m_srad;	//!< search radius for finding facet pairs (0 = automatic)
 
 private:
 	// integration rule
@@ -115,6 +115,7 @@ BEGIN_FECORE_CLASS(FEMortarSlidingContact, FEMortarInterface)
 	ADD_PARAMETER(m_eps    , "penalty"      );
 	ADD_PARAMETER(m_naugmin, "minaug"       );
 	ADD_PARAMETER(m_naugmax, "maxaug"       );
+	ADD_PARAMETER(m_srad   , "search_radius")->setUnits(UNIT_LENGTH);
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -191,7 +192,6 @@ void FEMortarSlidingContact::BuildMatrixProfile(FEGlobalMatrix& K)
 void FEMortarSlidingContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
 	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
 
 	// loop over all primary nodes
 	for (int A=0; A<NS; ++A)
@@ -209,15 +209,16 @@ void FEMortarSlidingContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<int> en(1);
 		vector<int> lm(3);
 		vector<double> fe(3);
-		for (int B=0; B<NS; ++B)
+		for (const FEMortarWeights::ENTRY* e = m_n1.begin(A); e != m_n1.end(A); ++e)
 		{
+			int B = e->node;
 			FENode& nodeB = m_ss.Node(B);
 			en[0] = m_ss.NodeIndex(B);
 			lm[0] = nodeB.m_ID[m_dofX];
 			lm[1] = nodeB.m_ID[m_dofY];
 			lm[2] = nodeB.m_ID[m_dofZ];
 
-			double nAB = -m_n1[A][B];
+			double nAB = -e->w;
 			if (nAB != 0.0)
 			{
 				fe[0] = tA.x*nAB;
@@ -229,15 +230,16 @@ void FEMortarSlidingContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		for (const FEMortarWeights::ENTRY* e = m_n2.begin(A); e != m_n2.end(A); ++e)
 		{
+			int C = e->node;
 			FENode& nodeC = m_ms.Node(C);
 			en[0] = m_ms.NodeIndex(C);
 			lm[0] = nodeC.m_ID[m_dofX];
 			lm[1] = nodeC.m_ID[m_dofY];
 			lm[2] = nodeC.m_ID[m_dofZ];
 
-			double nAC = m_n2[A][C];
+			double nAC = e->w;
 			if (nAC != 0.0)
 			{
 				fe[0] = tA.x*nAC;
@@ -263,7 +265,6 @@ void FEMortarSlidingContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInf
 void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 {
 	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
 
 	// A. Linearization of the gap function
 	vector<int> lmi(3), lmj(3);
@@ -276,14 +277,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 		double eps = m_eps*m_ss.m_A[A];
 
 		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		for (const FEMortarWeights::ENTRY* eB = m_n1.begin(A); eB != m_n1.end(A); ++eB)
 		{
+			int B = eB->node;
 			FENode& nodeB = m_ss.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = m_n1[A][B];
+			double nAB = eB->w;
 			if (nAB != 0.0)
 			{
 				kA[0][0] = eps*nAB*(nuA.x*nuA.x); kA[0][1] = eps*nAB*(nuA.x*nuA.y); kA[0][2] = eps*nAB*(nuA.x*nuA.z);
@@ -291,14 +293,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				kA[2][0] = eps*nAB*(nuA.z*nuA.x); kA[2][1] = eps*nAB*(nuA.z*nuA.y); kA[2][2] = eps*nAB*(nuA.z*nuA.z);
 
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n1.begin(A); eC != m_n1.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C];
+					double nAC = eC->w;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -313,14 +316,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n2.begin(A); eC != m_n2.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C];
+					double nAC = -eC->w;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -337,14 +341,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 		}
 
 		// loop over all secondary nodes
-		for (int B=0; B<NM; ++B)
+		for (const FEMortarWeights::ENTRY* eB = m_n2.begin(A); eB != m_n2.end(A); ++eB)
 		{
+			int B = eB->node;
 			FENode& nodeB = m_ms.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = -m_n2[A][B];
+			double nAB = -eB->w;
 			if (nAB != 0.0)
 			{
 				kA[0][0] = eps*nAB*(nuA.x*nuA.x); kA[0][1] = eps*nAB*(nuA.x*nuA.y); kA[0][2] = eps*nAB*(nuA.x*nuA.z);
@@ -352,14 +357,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				kA[2][0] = eps*nAB*(nuA.z*nuA.x); kA[2][1] = eps*nAB*(nuA.z*nuA.y); kA[2][2] = eps*nAB*(nuA.z*nuA.z);
 
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n1.begin(A); eC != m_n1.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C];
+					double nAC = eC->w;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -374,14 +380,15 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n2.begin(A); eC != m_n2.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C];
+					double nAC = -eC->w;
 					if (nAC != 0.0)
 					{
 						kG[0][0] = nAC; kG[0][1] = 0.0; kG[0][2] = 0.0;
@@ -403,9 +410,6 @@ void FEMortarSlidingContact::ContactGapStiffness(FELinearSystem& LS)
 //! calculate contact stiffness
 void FEMortarSlidingContact::ContactNormalStiffness(FELinearSystem& LS)
 {
-	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
-
 	vector<int> lm1(3);
 	vector<int> lm2(3);
 	FEElementMatrix ke;
@@ -444,11 +448,12 @@ void FEMortarSlidingContact::ContactNormalStiffness(FELinearSystem& LS)
 			lm2[2] = nodej2.m_ID[2];
 
 			// loop over primary nodes
-			for (int B=0; B<NS; ++B)
+			for (const FEMortarWeights::ENTRY* eB = m_n1.begin(A); eB != m_n1.end(A); ++eB)
 			{
+				int B = eB->node;
 				FENode& nodeB = m_ss.Node(B);
 				
-				double nAB = m_n1[A][B];
+				double nAB = eB->w;
 				if (nAB != 0.0)
 				{
 					vector<int> lmi(3);
@@ -475,11 +480,12 @@ void FEMortarSlidingContact::ContactNormalStiffness(FELinearSystem& LS)
 			}
 
 			// loop over secondary nodes
-			for (int B=0; B<NM; ++B)
+			for (const FEMortarWeights::ENTRY* eB = m_n2.begin(A); eB != m_n2.end(A); ++eB)
 			{
+				int B = eB->node;
 				FENode& nodeB = m_ms.Node(B);
 				
-				double nAB = m_n2[A][B];
+				double nAB = eB->w;
 				if (nAB != 0.0)
 				{
 					vector<int> lmi(3);
@@ -66,6 +66,7 @@ BEGIN_FECORE_CLASS(FEMortarTiedContact, FEMortarInterface)
 	ADD_PARAMETER(m_eps    , "penalty"      );
 	ADD_PARAMETER(m_naugmin, "minaug"       );
 	ADD_PARAMETER(m_naugmax, "maxaug"       );
+	ADD_PARAMETER(m_srad   , "search_radius")->setUnits(UNIT_LENGTH);
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -134,7 +135,6 @@ void FEMortarTiedContact::BuildMatrixProfile(FEGlobalMatrix& K)
 void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
 	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
 
 	// loop over all primary nodes
 	for (int A=0; A<NS; ++A)
@@ -147,15 +147,16 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<int> en(1);
 		vector<int> lm(3);
 		vector<double> fe(3);
-		for (int B=0; B<NS; ++B)
+		for (const FEMortarWeights::ENTRY* e = m_n1.begin(A); e != m_n1.end(A); ++e)
 		{
+			int B = e->node;
 			FENode& nodeB = m_ss.Node(B);
 			en[0] = m_ss.NodeIndex(B);
 			lm[0] = nodeB.m_ID[m_dofX];
 			lm[1] = nodeB.m_ID[m_dofY];
 			lm[2] = nodeB.m_ID[m_dofZ];
 
-			double nAB = -m_n1[A][B];
+			double nAB = -e->w;
 			if (nAB != 0.0)
 			{
 				fe[0] = tA.x*nAB;
@@ -167,15 +168,16 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		}
 
 		// loop over secondary side
-		for (int C=0; C<NM; ++C)
+		for (const FEMortarWeights::ENTRY* e = m_n2.begin(A); e != m_n2.end(A); ++e)
 		{
+			int C = e->node;
 			FENode& nodeC = m_ms.Node(C);
 			en[0] = m_ms.NodeIndex(C);
 			lm[0] = nodeC.m_ID[m_dofX];
 			lm[1] = nodeC.m_ID[m_dofY];
 			lm[2] = nodeC.m_ID[m_dofZ];
 
-			double nAC = m_n2[A][C];
+			double nAC = e->w;
 			if (nAC != 0.0)
 			{
 				fe[0] = tA.x*nAC;
@@ -193,7 +195,6 @@ void FEMortarTiedContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
 	int NS = m_ss.Nodes();
-	int NM = m_ms.Nodes();
 
 	// A. Linearization of the gap function
 	vector<int> lmi(3), lmj(3);
@@ -204,25 +205,27 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		double eps = m_eps*m_ss.m_A[A];
 
 		// loop over all primary nodes
-		for (int B=0; B<NS; ++B)
+		for (const FEMortarWeights::ENTRY* eB = m_n1.begin(A); eB != m_n1.end(A); ++eB)
 		{
+			int B = eB->node;
 			FENode& nodeB = m_ss.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = m_n1[A][B]*eps;
+			double nAB = eB->w*eps;
 			if (nAB != 0.0)
 			{
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n1.begin(A); eC != m_n1.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C]*nAB;
+					double nAC = eC->w*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -235,14 +238,15 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n2.begin(A); eC != m_n2.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C]*nAB;
+					double nAC = -eC->w*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -257,25 +261,27 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		}
 
 		// loop over all secondary nodes
-		for (int B=0; B<NM; ++B)
+		for (const FEMortarWeights::ENTRY* eB = m_n2.begin(A); eB != m_n2.end(A); ++eB)
 		{
+			int B = eB->node;
 			FENode& nodeB = m_ms.Node(B);
 			lmi[0] = nodeB.m_ID[0];
 			lmi[1] = nodeB.m_ID[1];
 			lmi[2] = nodeB.m_ID[2];
 
-			double nAB = -m_n2[A][B]*eps;
+			double nAB = -eB->w*eps;
 			if (nAB != 0.0)
 			{
 				// loop over primary nodes
-				for (int C=0; C<NS; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n1.begin(A); eC != m_n1.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ss.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = m_n1[A][C]*nAB;
+					double nAC = eC->w*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -288,14 +294,15 @@ void FEMortarTiedContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 
 				// loop over secondary nodes
-				for (int C=0; C<NM; ++C)
+				for (const FEMortarWeights::ENTRY* eC = m_n2.begin(A); eC != m_n2.end(A); ++eC)
 				{
+					int C = eC->node;
 					FENode& nodeC = m_ms.Node(C);
 					lmj[0] = nodeC.m_ID[0];
 					lmj[1] = nodeC.m_ID[1];
 					lmj[2] = nodeC.m_ID[2];
 
-					double nAC = -m_n2[A][C]*nAB;
+					double nAC = -eC->w*nAB;
 					if (nAC != 0.0)
 					{
 						ke[0][0] = nAC; ke[0][1] = 0.0; ke[0][2] = 0.0;
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FENeoHookean.h"
+#include <FECore/FEElement.h>
 
 //-----------------------------------------------------------------------------
 // define the material parameters
@@ -70,16 +71,39 @@ mat3ds FENeoHookean::Stress(FEMaterialPoint& mp)
 
 //-----------------------------------------------------------------------------
 tens4ds FENeoHookean::Tangent(FEMaterialPoint& mp)
+{
+	// get the material parameters
+	double E = m_E(mp);
+	double v = m_v(mp);
+
+	return Tangent(mp, E, v);
+}
+
+//-----------------------------------------------------------------------------
+void FENeoHookean::SolidTangents(FEMaterialPoint* const* mp, int n, tens4dmm* C)
+{
+	if (UseSecantTangent() || (n > FEElement::MAX_INTPOINTS))
+	{
+		FEElasticMaterial::SolidTangents(mp, n, C);
+		return;
+	}
+
+	// get the material parameters at all points
+	double E[FEElement::MAX_INTPOINTS], v[FEElement::MAX_INTPOINTS];
+	m_E(mp, n, E);
+	m_v(mp, n, v);
+
+	for (int i = 0; i < n; ++i) C[i] = Tangent(*mp[i], E[i], v[i]);
+}
+
+//-----------------------------------------------------------------------------
+tens4ds FENeoHookean::Tangent(FEMaterialPoint& mp, double E, double v)
 {
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 
 	// deformation gradient
 	double detF = pt.m_J;
 
-	// get the material parameters
-	double E = m_E(mp);
-	double v = m_v(mp);
-
 	// lame parameters
 	double lam = v*E/((1+v)*(1-2*v));
 	double mu  = 0.5*E/(1+v);
@@ -50,6 +50,9 @@ public:
 	//! calculate tangent stiffness at material point
 	virtual tens4ds Tangent(FEMaterialPoint& pt) override;
 
+	//! calculate the tangents at several material points, evaluating E and v for all points at once
+	void SolidTangents(FEMaterialPoint* const* mp, int n, tens4dmm* C) override;
+
 	//! calculate strain energy density at material point
 	virtual double StrainEnergyDensity(FEMaterialPoint& pt) override;
     
@@ -58,7 +61,12 @@ public:
     
     //! calculate material tangent stiffness at material point
     tens4dmm MaterialTangent(FEMaterialPoint& pt, const mat3ds E) override;
-    
+
+private:
+	//! tangent for given material parameters
+	tens4ds Tangent(FEMaterialPoint& pt, double E, double v);
+
+public:
 	// declare the parameter list
 	DECLARE_FECORE_CLASS();
 };
@@ -87,13 +87,16 @@ void FERemodelingElasticDomain::StiffnessMatrix(FELinearSystem& LS)
 	// I only need this for the element density stiffness
 	double dt = GetFEModel()->GetTime().timeIncrement;
 
+	PrepareElementBuffers();
 	#pragma omp parallel for
 	for (int iel=0; iel<NE; ++iel)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = 3*el.Nodes();
 		ke.resize(ndof, ndof);
 		ke.zero();
@@ -115,7 +118,7 @@ void FERemodelingElasticDomain::StiffnessMatrix(FELinearSystem& LS)
 				ke[j][i] = ke[i][j];
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
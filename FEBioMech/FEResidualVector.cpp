@@ -62,14 +62,22 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
             I = elm[i];
             
             if ( I >= 0){
+                if (m_batomic)
+                {
 #pragma omp atomic
-                R[I] += fe[i];
+                    R[I] += fe[i];
+                }
+                else R[I] += fe[i];
             }
             // TODO: Find another way to store reaction forces
             
             else if (-I-2 >= 0){
+                if (m_batomic)
+                {
 #pragma omp atomic
-                m_Fr[-I-2] -= fe[i];
+                    m_Fr[-I-2] -= fe[i];
+                }
+                else m_Fr[-I-2] -= fe[i];
             }
         }
         
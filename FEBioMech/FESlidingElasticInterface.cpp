@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include "FECore/FEModel.h"
 #include "FECore/FEAnalysis.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/sys.h>
 #include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
@@ -941,11 +942,6 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
 {
     const int MN = FEElement::MAX_NODES;
     
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    
     m_ss.m_Ft = vec3d(0,0,0);
     m_ms.m_Ft = vec3d(0,0,0);
     
@@ -958,129 +954,149 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary elements
-        //#pragma omp parallel for private(sLM, mLM, LM, en, fe, detJ, w, Hm, N)
-        for (int i=0; i<ss.Elements(); ++i)
+        // (each thread uses its own element buffers and contact force sums)
+        int NE = ss.Elements();
+        m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
         {
-            // get the surface element
-            FESurfaceElement& se = ss.Element(i);
+            FEElementBuffer& buf = m_work.ThreadBuffer();
+            vector<int>& LM = buf.lm;
+            vector<double>& fe = buf.fe;
+            vector<int> sLM, mLM, en;
+            double detJ[MN], w[MN], Hm[MN];
+            double N[MN*6];
+            vec3d Fs(0,0,0), Fm(0,0,0);
+
+#pragma omp for schedule(dynamic)
+            for (int i=0; i<NE; ++i)
+            {
+                // get the surface element
+                FESurfaceElement& se = ss.Element(i);
             
-            // get the nr of nodes and integration points
-            int nseln = se.Nodes();
-            int nint = se.GaussPoints();
+                // get the nr of nodes and integration points
+                int nseln = se.Nodes();
+                int nint = se.GaussPoints();
             
-            // copy the LM vector; we'll need it later
-            ss.UnpackLM(se, sLM);
+                // copy the LM vector; we'll need it later
+                ss.UnpackLM(se, sLM);
             
-            // we calculate all the metrics we need before we
-            // calculate the nodal forces
-            for (int j=0; j<nint; ++j)
-            {
-                // get the base vectors
-                vec3d g[2];
-                ss.CoBaseVectors(se, j, g);
+                // we calculate all the metrics we need before we
+                // calculate the nodal forces
+                for (int j=0; j<nint; ++j)
+                {
+                    // get the base vectors
+                    vec3d g[2];
+                    ss.CoBaseVectors(se, j, g);
                 
-                // jacobians: J = |g0xg1|
-                detJ[j] = (g[0] ^ g[1]).norm();
+                    // jacobians: J = |g0xg1|
+                    detJ[j] = (g[0] ^ g[1]).norm();
                 
-                // integration weights
-                w[j] = se.GaussWeights()[j];
-            }
+                    // integration weights
+                    w[j] = se.GaussWeights()[j];
+                }
             
-            // loop over all integration points
-            // note that we are integrating over the current surface
-            for (int j=0; j<nint; ++j)
-            {
-                // get integration point data
-				FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(j));
+                // loop over all integration points
+                // note that we are integrating over the current surface
+                for (int j=0; j<nint; ++j)
+                {
+                    // get integration point data
+					FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(j));
 
-                // calculate contact pressure and account for stick
-                double pn;
-                vec3d t = ContactTraction(ss, i, j, ms, pn);
-                
-                // get the secondary element
-                FESurfaceElement* pme = data.m_pme;
+                    // calculate contact pressure and account for stick
+                    double pn;
+                    vec3d t = ContactTraction(ss, i, j, ms, pn);
                 
-                if (pme)
-                {
                     // get the secondary element
-                    FESurfaceElement& me = *pme;
+                    FESurfaceElement* pme = data.m_pme;
+                
+                    if (pme)
+                    {
+                        // get the secondary element
+                        FESurfaceElement& me = *pme;
                     
-                    // get the nr of secondary element nodes
-                    int nmeln = me.Nodes();
+                        // get the nr of secondary element nodes
+                        int nmeln = me.Nodes();
                     
-                    // copy LM vector
-                    ms.UnpackLM(me, mLM);
+                        // copy LM vector
+                        ms.UnpackLM(me, mLM);
                     
-                    // calculate degrees of freedom
-                    int ndof = 3*(nseln + nmeln);
+                        // calculate degrees of freedom
+                        int ndof = 3*(nseln + nmeln);
                     
-                    // build the LM vector
-                    LM.resize(ndof);
-                    for (int k=0; k<nseln; ++k)
-                    {
-                        LM[3*k  ] = sLM[3*k  ];
-                        LM[3*k+1] = sLM[3*k+1];
-                        LM[3*k+2] = sLM[3*k+2];
-                    }
+                        // build the LM vector
+                        LM.resize(ndof);
+                        for (int k=0; k<nseln; ++k)
+                        {
+                            LM[3*k  ] = sLM[3*k  ];
+                            LM[3*k+1] = sLM[3*k+1];
+                            LM[3*k+2] = sLM[3*k+2];
+                        }
                     
-                    for (int k=0; k<nmeln; ++k)
-                    {
-                        LM[3*(k+nseln)  ] = mLM[3*k  ];
-                        LM[3*(k+nseln)+1] = mLM[3*k+1];
-                        LM[3*(k+nseln)+2] = mLM[3*k+2];
-                    }
+                        for (int k=0; k<nmeln; ++k)
+                        {
+                            LM[3*(k+nseln)  ] = mLM[3*k  ];
+                            LM[3*(k+nseln)+1] = mLM[3*k+1];
+                            LM[3*(k+nseln)+2] = mLM[3*k+2];
+                        }
                     
-                    // build the en vector
-                    en.resize(nseln+nmeln);
-                    for (int k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
-                    for (int k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
+                        // build the en vector
+                        en.resize(nseln+nmeln);
+                        for (int k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
+                        for (int k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
                     
-                    // get primary element shape functions
-                    double *Hs = se.H(j);
+                        // get primary element shape functions
+                        double *Hs = se.H(j);
                     
-                    // get secondary element shape functions
-                    double r = data.m_rs[0];
-                    double s = data.m_rs[1];
-                    me.shape_fnc(Hm, r, s);
+                        // get secondary element shape functions
+                        double r = data.m_rs[0];
+                        double s = data.m_rs[1];
+                        me.shape_fnc(Hm, r, s);
                     
-                    if (pn != 0) {
+                        if (pn != 0) {
                         
-                        // calculate the force vector
-                        fe.resize(ndof);
-                        zero(fe);
+                            // calculate the force vector
+                            fe.resize(ndof);
+                            zero(fe);
                         
-                        for (int k=0; k<nseln; ++k)
-                        {
-                            N[3*k  ] = Hs[k]*t.x;
-                            N[3*k+1] = Hs[k]*t.y;
-                            N[3*k+2] = Hs[k]*t.z;
-                        }
+                            for (int k=0; k<nseln; ++k)
+                            {
+                                N[3*k  ] = Hs[k]*t.x;
+                                N[3*k+1] = Hs[k]*t.y;
+                                N[3*k+2] = Hs[k]*t.z;
+                            }
                         
-                        for (int k=0; k<nmeln; ++k)
-                        {
-                            N[3*(k+nseln)  ] = -Hm[k]*t.x;
-                            N[3*(k+nseln)+1] = -Hm[k]*t.y;
-                            N[3*(k+nseln)+2] = -Hm[k]*t.z;
-                        }
+                            for (int k=0; k<nmeln; ++k)
+                            {
+                                N[3*(k+nseln)  ] = -Hm[k]*t.x;
+                                N[3*(k+nseln)+1] = -Hm[k]*t.y;
+                                N[3*(k+nseln)+2] = -Hm[k]*t.z;
+                            }
                         
-                        for (int k=0; k<ndof; ++k) fe[k] += N[k]*detJ[j]*w[j];
+                            for (int k=0; k<ndof; ++k) fe[k] += N[k]*detJ[j]*w[j];
                         
-                        // calculate contact forces
-                        for (int k=0; k<nseln; ++k)
-                        {
-                            ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
-                        }
+                            // calculate contact forces
+                            for (int k=0; k<nseln; ++k)
+                            {
+                                Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                            }
                         
-                        for (int k = 0; k<nmeln; ++k)
-                        {
-                            ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
-                        }
+                            for (int k = 0; k<nmeln; ++k)
+                            {
+                                Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                            }
                         
-                        // assemble the global residual
-                        R.Assemble(en, LM, fe);
+                            // assemble the global residual
+                            R.Assemble(en, LM, fe);
+                        }
                     }
                 }
             }
+
+#pragma omp critical
+            {
+                ss.m_Ft += Fs;
+                ms.m_Ft += Fm;
+            }
         }
     }
 }
@@ -1093,11 +1109,6 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
     
     const int MN = FEElement::MAX_NODES;
     
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    vector<int> sLM, mLM, LM, en;
-    FEElementMatrix ke;
-    
     double psf = GetPenaltyScaleFactor();
     
     // do single- or two-pass
@@ -1109,420 +1120,433 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary elements
-        //#pragma omp parallel for private(detJ, w, Hm, N, sLM, mLM, LM, en, ke)
-        for (int i=0; i<ss.Elements(); ++i)
+        // (each thread uses its own element buffers)
+        int NE = ss.Elements();
+        m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
         {
-            // get ths primary element
-            FESurfaceElement& se = ss.Element(i);
+            FEElementBuffer& buf = m_work.ThreadBuffer();
+            vector<int>& LM = buf.lm;
+            FEElementMatrix& ke = buf.ke;
+            vector<int> sLM, mLM, en;
+            double detJ[MN], w[MN], Hm[MN];
+            double N[MN*6];
+
+#pragma omp for schedule(dynamic)
+            for (int i=0; i<NE; ++i)
+            {
+                // get ths primary element
+                FESurfaceElement& se = ss.Element(i);
             
-            // get nr of nodes and integration points
-            int nseln = se.Nodes();
-            int nint = se.GaussPoints();
+                // get nr of nodes and integration points
+                int nseln = se.Nodes();
+                int nint = se.GaussPoints();
             
-            // copy the LM vector
-            ss.UnpackLM(se, sLM);
+                // copy the LM vector
+                ss.UnpackLM(se, sLM);
             
-            // we calculate all the metrics we need before we
-            // calculate the nodal forces
-            for (int j=0; j<nint; ++j)
-            {
-                // get the base vectors
-                vec3d g[2];
-                ss.CoBaseVectors(se, j, g);
+                // we calculate all the metrics we need before we
+                // calculate the nodal forces
+                for (int j=0; j<nint; ++j)
+                {
+                    // get the base vectors
+                    vec3d g[2];
+                    ss.CoBaseVectors(se, j, g);
                 
-                // jacobians: J = |g0xg1|
-                detJ[j] = (g[0] ^ g[1]).norm();
+                    // jacobians: J = |g0xg1|
+                    detJ[j] = (g[0] ^ g[1]).norm();
                 
-                // integration weights
-                w[j] = se.GaussWeights()[j];
+                    // integration weights
+                    w[j] = se.GaussWeights()[j];
                 
-            }
+                }
             
-            // loop over all integration points
-            for (int j=0; j<nint; ++j)
-            {
-                // get integration point data
-				FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(j));
+                // loop over all integration points
+                for (int j=0; j<nint; ++j)
+                {
+                    // get integration point data
+					FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(j));
 
-                // calculate contact pressure and account for stick
-                double pn;
-                vec3d t = ContactTraction(ss, i, j, ms, pn);
+                    // calculate contact pressure and account for stick
+                    double pn;
+                    vec3d t = ContactTraction(ss, i, j, ms, pn);
                 
-                // get the secondary element
-                FESurfaceElement* pme = data.m_pme;
+                    // get the secondary element
+                    FESurfaceElement* pme = data.m_pme;
                 
-                if (pme)
-                {
-                    FESurfaceElement& me = *pme;
+                    if (pme)
+                    {
+                        FESurfaceElement& me = *pme;
                     
-                    // get the nr of secondary nodes
-                    int nmeln = me.Nodes();
+                        // get the nr of secondary nodes
+                        int nmeln = me.Nodes();
                     
-                    // copy the LM vector
-                    ms.UnpackLM(me, mLM);
+                        // copy the LM vector
+                        ms.UnpackLM(me, mLM);
                     
-                    // calculate degrees of freedom
-                    int ndpn = 3;
-                    int ndof = ndpn*(nseln + nmeln);
+                        // calculate degrees of freedom
+                        int ndpn = 3;
+                        int ndof = ndpn*(nseln + nmeln);
                     
-                    // build the LM vector
-                    LM.resize(ndof);
+                        // build the LM vector
+                        LM.resize(ndof);
                     
-                    for (int k=0; k<nseln; ++k)
-                    {
-                        LM[3*k  ] = sLM[3*k  ];
-                        LM[3*k+1] = sLM[3*k+1];
-                        LM[3*k+2] = sLM[3*k+2];
-                    }
+                        for (int k=0; k<nseln; ++k)
+                        {
+                            LM[3*k  ] = sLM[3*k  ];
+                            LM[3*k+1] = sLM[3*k+1];
+                            LM[3*k+2] = sLM[3*k+2];
+                        }
                     
-                    for (int k=0; k<nmeln; ++k)
-                    {
-                        LM[3*(k+nseln)  ] = mLM[3*k  ];
-                        LM[3*(k+nseln)+1] = mLM[3*k+1];
-                        LM[3*(k+nseln)+2] = mLM[3*k+2];
-                    }
+                        for (int k=0; k<nmeln; ++k)
+                        {
+                            LM[3*(k+nseln)  ] = mLM[3*k  ];
+                            LM[3*(k+nseln)+1] = mLM[3*k+1];
+                            LM[3*(k+nseln)+2] = mLM[3*k+2];
+                        }
                     
-                    // build the en vector
-                    en.resize(nseln+nmeln);
-                    for (int k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
-                    for (int k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
+                        // build the en vector
+                        en.resize(nseln+nmeln);
+                        for (int k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
+                        for (int k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
                     
-                    // primary shape functions
-                    double* Hs = se.H(j);
+                        // primary shape functions
+                        double* Hs = se.H(j);
                     
-                    // secondary shape functions
-                    double r = data.m_rs[0];
-                    double s = data.m_rs[1];
-                    me.shape_fnc(Hm, r, s);
+                        // secondary shape functions
+                        double r = data.m_rs[0];
+                        double s = data.m_rs[1];
+                        me.shape_fnc(Hm, r, s);
                     
-                    // get primary normal vector
-                    vec3d nu = data.m_nu;
+                        // get primary normal vector
+                        vec3d nu = data.m_nu;
                     
-                    // gap function
-                    double g = data.m_gap;
+                        // gap function
+                        double g = data.m_gap;
                     
-                    // penalty
-                    double eps = m_epsn*data.m_epsn*psf;
+                        // penalty
+                        double eps = m_epsn*data.m_epsn*psf;
                     
-                    // only evaluate stiffness matrix if contact traction is non-zero
-                    if (pn != 0)
-                    {
-                        // if stick
-                        if (data.m_bstick)
+                        // only evaluate stiffness matrix if contact traction is non-zero
+                        if (pn != 0)
                         {
-                            double dtn = eps;
+                            // if stick
+                            if (data.m_bstick)
+                            {
+                                double dtn = eps;
                             
-                            // create the stiffness matrix
-                            ke.resize(ndof, ndof); ke.zero();
+                                // create the stiffness matrix
+                                ke.resize(ndof, ndof); ke.zero();
                             
-                            // evaluate basis vectors on primary surface
-                            vec3d gscov[2];
-                            ss.CoBaseVectors(se, j, gscov);
+                                // evaluate basis vectors on primary surface
+                                vec3d gscov[2];
+                                ss.CoBaseVectors(se, j, gscov);
                             
-                            // identity tensor
-                            mat3d I = mat3dd(1);
+                                // identity tensor
+                                mat3d I = mat3dd(1);
                             
-                            // evaluate Mc and Ac and combine them into As
-                            double* Gsr = se.Gr(j);
-                            double* Gss = se.Gs(j);
-                            mat3d As[MN];
-                            mat3d gscovh[2];
-                            gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
-                            for (int k=0; k<nseln; ++k) {
-                                mat3d Ac = (gscovh[1]*Gsr[k] - gscovh[0]*Gss[k])/detJ[j];
-                                As[k] = t & (Ac*nu);
-                            }
+                                // evaluate Mc and Ac and combine them into As
+                                double* Gsr = se.Gr(j);
+                                double* Gss = se.Gs(j);
+                                mat3d As[MN];
+                                mat3d gscovh[2];
+                                gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
+                                for (int k=0; k<nseln; ++k) {
+                                    mat3d Ac = (gscovh[1]*Gsr[k] - gscovh[0]*Gss[k])/detJ[j];
+                                    As[k] = t & (Ac*nu);
+                                }
                             
-                            // --- S O L I D - S O L I D   C O N T A C T ---
+                                // --- S O L I D - S O L I D   C O N T A C T ---
                             
-                            // a. I-term
-                            //------------------------------------
+                                // a. I-term
+                                //------------------------------------
                             
-                            for (int k=0; k<nseln; ++k) N[k      ] =  Hs[k];
-                            for (int k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+                                for (int k=0; k<nseln; ++k) N[k      ] =  Hs[k];
+                                for (int k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
                             
-                            double tmp = dtn*detJ[j]*w[j];
-                            for (int l=0; l<nseln+nmeln; ++l)
-                            {
-                                for (int k=0; k<nseln+nmeln; ++k)
+                                double tmp = dtn*detJ[j]*w[j];
+                                for (int l=0; l<nseln+nmeln; ++l)
                                 {
-                                    ke[k*ndpn  ][l*ndpn  ] -= -tmp*N[k]*N[l]*I[0][0];
-                                    ke[k*ndpn  ][l*ndpn+1] -= -tmp*N[k]*N[l]*I[0][1];
-                                    ke[k*ndpn  ][l*ndpn+2] -= -tmp*N[k]*N[l]*I[0][2];
+                                    for (int k=0; k<nseln+nmeln; ++k)
+                                    {
+                                        ke[k*ndpn  ][l*ndpn  ] -= -tmp*N[k]*N[l]*I[0][0];
+                                        ke[k*ndpn  ][l*ndpn+1] -= -tmp*N[k]*N[l]*I[0][1];
+                                        ke[k*ndpn  ][l*ndpn+2] -= -tmp*N[k]*N[l]*I[0][2];
                                     
-                                    ke[k*ndpn+1][l*ndpn  ] -= -tmp*N[k]*N[l]*I[1][0];
-                                    ke[k*ndpn+1][l*ndpn+1] -= -tmp*N[k]*N[l]*I[1][1];
-                                    ke[k*ndpn+1][l*ndpn+2] -= -tmp*N[k]*N[l]*I[1][2];
+                                        ke[k*ndpn+1][l*ndpn  ] -= -tmp*N[k]*N[l]*I[1][0];
+                                        ke[k*ndpn+1][l*ndpn+1] -= -tmp*N[k]*N[l]*I[1][1];
+                                        ke[k*ndpn+1][l*ndpn+2] -= -tmp*N[k]*N[l]*I[1][2];
                                     
-                                    ke[k*ndpn+2][l*ndpn  ] -= -tmp*N[k]*N[l]*I[2][0];
-                                    ke[k*ndpn+2][l*ndpn+1] -= -tmp*N[k]*N[l]*I[2][1];
-                                    ke[k*ndpn+2][l*ndpn+2] -= -tmp*N[k]*N[l]*I[2][2];
+                                        ke[k*ndpn+2][l*ndpn  ] -= -tmp*N[k]*N[l]*I[2][0];
+                                        ke[k*ndpn+2][l*ndpn+1] -= -tmp*N[k]*N[l]*I[2][1];
+                                        ke[k*ndpn+2][l*ndpn+2] -= -tmp*N[k]*N[l]*I[2][2];
+                                    }
                                 }
-                            }
                             
-                            // b. A-term
-                            //-------------------------------------
+                                // b. A-term
+                                //-------------------------------------
                             
-                            tmp = detJ[j]*w[j];
-                            // non-symmetric
-                            for (int l=0; l<nseln; ++l)
-                            {
-                                for (int k=0; k<nseln+nmeln; ++k)
+                                tmp = detJ[j]*w[j];
+                                // non-symmetric
+                                for (int l=0; l<nseln; ++l)
                                 {
-                                    ke[k*ndpn  ][l*ndpn  ] -= tmp*N[k]*As[l][0][0];
-                                    ke[k*ndpn  ][l*ndpn+1] -= tmp*N[k]*As[l][0][1];
-                                    ke[k*ndpn  ][l*ndpn+2] -= tmp*N[k]*As[l][0][2];
+                                    for (int k=0; k<nseln+nmeln; ++k)
+                                    {
+                                        ke[k*ndpn  ][l*ndpn  ] -= tmp*N[k]*As[l][0][0];
+                                        ke[k*ndpn  ][l*ndpn+1] -= tmp*N[k]*As[l][0][1];
+                                        ke[k*ndpn  ][l*ndpn+2] -= tmp*N[k]*As[l][0][2];
                                     
-                                    ke[k*ndpn+1][l*ndpn  ] -= tmp*N[k]*As[l][1][0];
-                                    ke[k*ndpn+1][l*ndpn+1] -= tmp*N[k]*As[l][1][1];
-                                    ke[k*ndpn+1][l*ndpn+2] -= tmp*N[k]*As[l][1][2];
+                                        ke[k*ndpn+1][l*ndpn  ] -= tmp*N[k]*As[l][1][0];
+                                        ke[k*ndpn+1][l*ndpn+1] -= tmp*N[k]*As[l][1][1];
+                                        ke[k*ndpn+1][l*ndpn+2] -= tmp*N[k]*As[l][1][2];
                                     
-                                    ke[k*ndpn+2][l*ndpn  ] -= tmp*N[k]*As[l][2][0];
-                                    ke[k*ndpn+2][l*ndpn+1] -= tmp*N[k]*As[l][2][1];
-                                    ke[k*ndpn+2][l*ndpn+2] -= tmp*N[k]*As[l][2][2];
+                                        ke[k*ndpn+2][l*ndpn  ] -= tmp*N[k]*As[l][2][0];
+                                        ke[k*ndpn+2][l*ndpn+1] -= tmp*N[k]*As[l][2][1];
+                                        ke[k*ndpn+2][l*ndpn+2] -= tmp*N[k]*As[l][2][2];
+                                    }
                                 }
-                            }
                             
-                            // assemble the global stiffness
-                            {
-								ke.SetNodes(en);
-								ke.SetIndices(LM);
-								LS.Assemble(ke);
+                                // assemble the global stiffness
+                                {
+									ke.SetNodes(en);
+									ke.SetIndices(LM);
+									LS.Assemble(ke);
+                                }
                             }
-                        }
-                        // if slip
-                        else
-                        {
-                            double tn = -pn;
-                            
-                            // create the stiffness matrix
-                            ke.resize(ndof, ndof); ke.zero();
-                            
-                            // obtain the slip direction s1 and inverse of spatial increment dh
-                            double dh = 0, hd = 0;
-                            vec3d dr(0,0,0);
-                            vec3d s1 = FESlidingElasticInterface::SlipTangent(ss, i, j, ms, dh, dr);
-                            
-                            if (dh != 0)
+                            // if slip
+                            else
                             {
-                                hd = 1.0 / dh;
-                            }
-                            
-                            // evaluate basis vectors on both surfaces
-                            vec3d gscov[2], gmcov[2];
-                            ss.CoBaseVectors(se, j, gscov);
-                            ms.CoBaseVectors(me, r, s, gmcov);
-                            mat2d A;
-                            A[0][0] = gscov[0]*gmcov[0]; A[0][1] = gscov[0]*gmcov[1];
-                            A[1][0] = gscov[1]*gmcov[0]; A[1][1] = gscov[1]*gmcov[1];
-                            mat2d a = A.inverse();
+                                double tn = -pn;
                             
-                            // evaluate covariant basis vectors on primary surface at previous time step
-                            vec3d gscovp[2];
-                            ss.CoBaseVectorsP(se, j, gscovp);
+                                // create the stiffness matrix
+                                ke.resize(ndof, ndof); ke.zero();
                             
-                            // calculate delta gscov
-                            vec3d dgscov[2];
-                            dgscov[0] = gscov[0] - gscovp[0];
-                            dgscov[1] = gscov[1] - gscovp[1];
+                                // obtain the slip direction s1 and inverse of spatial increment dh
+                                double dh = 0, hd = 0;
+                                vec3d dr(0,0,0);
+                                vec3d s1 = FESlidingElasticInterface::SlipTangent(ss, i, j, ms, dh, dr);
                             
-                            // evaluate contravariant basis vectors
-                            vec3d gscnt[2], gmcnt[2];
-                            if (m_knmult == 0)
-                            {
-                                // evaluate true contravariant basis vectors when gap = 0
-                                ss.ContraBaseVectors(se, j, gscnt);
-                                ms.ContraBaseVectors(me, r, s, gmcnt);
-                            }
-                            else
-                            {
-                                // evaluate approximate contravariant basis vectors when gap != 0
-                                gmcnt[0] = gscov[0]*a[0][0] + gscov[1]*a[0][1];
-                                gmcnt[1] = gscov[0]*a[1][0] + gscov[1]*a[1][1];
-                                gscnt[0] = gmcov[0]*a[0][0] + gmcov[1]*a[1][0];
-                                gscnt[1] = gmcov[0]*a[0][1] + gmcov[1]*a[1][1];
-                            }
+                                if (dh != 0)
+                                {
+                                    hd = 1.0 / dh;
+                                }
                             
-                            // evaluate N and S tensors and approximations when gap != 0
-                            mat3ds N1 = dyad(nu);
-                            mat3d Nh1 = mat3dd(1) - (nu & nu);
-                            mat3d Nb1 = mat3dd(1) - (gscov[0] & gscnt[0])*m_knmult - (gscov[1] & gscnt[1])*m_knmult;
-                            mat3d Nt1 = nu & (Nb1*nu);
-                            mat3d S1 = s1 & nu;
-                            mat3d Sh1 = (mat3dd(1) - (s1 & s1))*hd;
-                            mat3d Sb1 = s1 & (Nb1*nu);
+                                // evaluate basis vectors on both surfaces
+                                vec3d gscov[2], gmcov[2];
+                                ss.CoBaseVectors(se, j, gscov);
+                                ms.CoBaseVectors(me, r, s, gmcov);
+                                mat2d A;
+                                A[0][0] = gscov[0]*gmcov[0]; A[0][1] = gscov[0]*gmcov[1];
+                                A[1][0] = gscov[1]*gmcov[0]; A[1][1] = gscov[1]*gmcov[1];
+                                mat2d a = A.inverse();
                             
-                            // evaluate m, c, B, and R
-                            // evaluate L1 from Mg and R
-                            vec3d m = ((dgscov[0] ^ gscov[1]) + (gscov[0] ^ dgscov[1]));
-                            vec3d c = Sh1*Nh1*m*(1/detJ[j]);
-                            mat3d Mg = (mat3dd(1)*(nu * m) + (nu & m))*(1/detJ[j]);
-                            mat3d B = (c & (Nb1*nu))*m_knmult - Sh1*Nh1;
-                            mat3d R = mat3dd(1)*(nu * dr) + (nu & dr);
-                            mat3d L1 = Sh1*((Nh1*Mg - mat3dd(1))*(-g)*m_knmult + R)*Nh1;
+                                // evaluate covariant basis vectors on primary surface at previous time step
+                                vec3d gscovp[2];
+                                ss.CoBaseVectorsP(se, j, gscovp);
                             
-                            // evaluate Mc and Ac and combine them into As
-                            // evaluate s1 dyad (N1*mc - Ac*nu) + c dyad (N1*mc + Ac*nu)*g*hd as Pc
-                            // evaluate Fc from Ac_bar (Ab)
-                            double* Gsr = se.Gr(j);
-                            double* Gss = se.Gs(j);
-                            mat3d As[MN];
-                            mat3d gscovh[2];
-                            mat3d dgscovh[2];
-                            mat3d Pc[MN];
-                            mat3d Jc[MN];
-                            gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
-                            dgscovh[0].skew(dgscov[0]); dgscovh[1].skew(dgscov[1]);
-                            for (int k=0; k<nseln; ++k) {
-                                vec3d mc = gscnt[0]*Gsr[k] + gscnt[1]*Gss[k];
-                                mat3d Mc = nu & mc;
-                                mat3d Ac = (gscovh[1]*Gsr[k] - gscovh[0]*Gss[k])/detJ[j];
-                                mat3d Ab = (dgscovh[1]*Gsr[k] - dgscovh[0]*Gss[k])/detJ[j];
-                                Pc[k] = (s1 & (N1*mc*m_knmult - Ac*nu)) + ((c & (N1*mc + Ac*nu))*(-g)*m_knmult);
-                                As[k] = Ac + Mc*N1*m_knmult;
-                                Jc[k] = (L1*Ac - (Sh1*Nh1*Ab*(-g)*m_knmult));
-                            }
+                                // calculate delta gscov
+                                vec3d dgscov[2];
+                                dgscov[0] = gscov[0] - gscovp[0];
+                                dgscov[1] = gscov[1] - gscovp[1];
                             
-                            // evaluate Mb
-                            // evaluate s1 dyad mb and combine as Psb
-                            double Gmr[MN], Gms[MN];
-                            me.shape_deriv(Gmr, Gms, r, s);
-                            mat3d Pb[MN];
-                            for (int k=0; k<nmeln; ++k) {
-                                vec3d n(0,0,0);
+                                // evaluate contravariant basis vectors
+                                vec3d gscnt[2], gmcnt[2];
                                 if (m_knmult == 0)
                                 {
-                                    n = gmcnt[0] ^ gmcnt[1];
-                                    n.unit();
-                                } else
+                                    // evaluate true contravariant basis vectors when gap = 0
+                                    ss.ContraBaseVectors(se, j, gscnt);
+                                    ms.ContraBaseVectors(me, r, s, gmcnt);
+                                }
+                                else
                                 {
-                                    n = -nu;
+                                    // evaluate approximate contravariant basis vectors when gap != 0
+                                    gmcnt[0] = gscov[0]*a[0][0] + gscov[1]*a[0][1];
+                                    gmcnt[1] = gscov[0]*a[1][0] + gscov[1]*a[1][1];
+                                    gscnt[0] = gmcov[0]*a[0][0] + gmcov[1]*a[1][0];
+                                    gscnt[1] = gmcov[0]*a[0][1] + gmcov[1]*a[1][1];
                                 }
-                                vec3d mb = gmcnt[0]*Gmr[k] + gmcnt[1]*Gms[k];
-                                mat3d Mb = n & mb;
-                                Pb[k] = Mb - ((s1 & mb)*m_mu);
-                            }
                             
-                            // evaluate Gbc
-                            matrix Gbc(nmeln,nseln);
-                            for (int b=0; b<nmeln; ++b) {
-                                for (int c=0; c<nseln; ++c) {
-                                    Gbc(b,c)
-                                    = (a[0][0]*Gmr[b]*Gsr[c]
-                                       + a[0][1]*Gmr[b]*Gss[c]
-                                       + a[1][0]*Gms[b]*Gsr[c]
-                                       + a[1][1]*Gms[b]*Gss[c])*(-g)*m_knmult;
+                                // evaluate N and S tensors and approximations when gap != 0
+                                mat3ds N1 = dyad(nu);
+                                mat3d Nh1 = mat3dd(1) - (nu & nu);
+                                mat3d Nb1 = mat3dd(1) - (gscov[0] & gscnt[0])*m_knmult - (gscov[1] & gscnt[1])*m_knmult;
+                                mat3d Nt1 = nu & (Nb1*nu);
+                                mat3d S1 = s1 & nu;
+                                mat3d Sh1 = (mat3dd(1) - (s1 & s1))*hd;
+                                mat3d Sb1 = s1 & (Nb1*nu);
+                            
+                                // evaluate m, c, B, and R
+                                // evaluate L1 from Mg and R
+                                vec3d m = ((dgscov[0] ^ gscov[1]) + (gscov[0] ^ dgscov[1]));
+                                vec3d c = Sh1*Nh1*m*(1/detJ[j]);
+                                mat3d Mg = (mat3dd(1)*(nu * m) + (nu & m))*(1/detJ[j]);
+                                mat3d B = (c & (Nb1*nu))*m_knmult - Sh1*Nh1;
+                                mat3d R = mat3dd(1)*(nu * dr) + (nu & dr);
+                                mat3d L1 = Sh1*((Nh1*Mg - mat3dd(1))*(-g)*m_knmult + R)*Nh1;
+                            
+                                // evaluate Mc and Ac and combine them into As
+                                // evaluate s1 dyad (N1*mc - Ac*nu) + c dyad (N1*mc + Ac*nu)*g*hd as Pc
+                                // evaluate Fc from Ac_bar (Ab)
+                                double* Gsr = se.Gr(j);
+                                double* Gss = se.Gs(j);
+                                mat3d As[MN];
+                                mat3d gscovh[2];
+                                mat3d dgscovh[2];
+                                mat3d Pc[MN];
+                                mat3d Jc[MN];
+                                gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
+                                dgscovh[0].skew(dgscov[0]); dgscovh[1].skew(dgscov[1]);
+                                for (int k=0; k<nseln; ++k) {
+                                    vec3d mc = gscnt[0]*Gsr[k] + gscnt[1]*Gss[k];
+                                    mat3d Mc = nu & mc;
+                                    mat3d Ac = (gscovh[1]*Gsr[k] - gscovh[0]*Gss[k])/detJ[j];
+                                    mat3d Ab = (dgscovh[1]*Gsr[k] - dgscovh[0]*Gss[k])/detJ[j];
+                                    Pc[k] = (s1 & (N1*mc*m_knmult - Ac*nu)) + ((c & (N1*mc + Ac*nu))*(-g)*m_knmult);
+                                    As[k] = Ac + Mc*N1*m_knmult;
+                                    Jc[k] = (L1*Ac - (Sh1*Nh1*Ab*(-g)*m_knmult));
+                                }
+                            
+                                // evaluate Mb
+                                // evaluate s1 dyad mb and combine as Psb
+                                double Gmr[MN], Gms[MN];
+                                me.shape_deriv(Gmr, Gms, r, s);
+                                mat3d Pb[MN];
+                                for (int k=0; k<nmeln; ++k) {
+                                    vec3d n(0,0,0);
+                                    if (m_knmult == 0)
+                                    {
+                                        n = gmcnt[0] ^ gmcnt[1];
+                                        n.unit();
+                                    } else
+                                    {
+                                        n = -nu;
+                                    }
+                                    vec3d mb = gmcnt[0]*Gmr[k] + gmcnt[1]*Gms[k];
+                                    mat3d Mb = n & mb;
+                                    Pb[k] = Mb - ((s1 & mb)*m_mu);
                                 }
-                            }
                             
-                            // define T, Ttb
-                            mat3d T = N1 + (S1*m_mu);
-                            mat3d Ttb = Nt1 + (Sb1*m_mu);
+                                // evaluate Gbc
+                                matrix Gbc(nmeln,nseln);
+                                for (int b=0; b<nmeln; ++b) {
+                                    for (int c=0; c<nseln; ++c) {
+                                        Gbc(b,c)
+                                        = (a[0][0]*Gmr[b]*Gsr[c]
+                                           + a[0][1]*Gmr[b]*Gss[c]
+                                           + a[1][0]*Gms[b]*Gsr[c]
+                                           + a[1][1]*Gms[b]*Gss[c])*(-g)*m_knmult;
+                                    }
+                                }
                             
-                            // --- S O L I D - S O L I D   C O N T A C T ---
+                                // define T, Ttb
+                                mat3d T = N1 + (S1*m_mu);
+                                mat3d Ttb = Nt1 + (Sb1*m_mu);
                             
-                            // a. NxN-term
-                            //------------------------------------
+                                // --- S O L I D - S O L I D   C O N T A C T ---
                             
-                            for (int k=0; k<nseln; ++k) N[k      ] =  Hs[k];
-                            for (int k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+                                // a. NxN-term
+                                //------------------------------------
                             
-                            double tmp = detJ[j]*w[j];
-                            for (int l=0; l<nseln+nmeln; ++l)
-                            {
-                                for (int k=0; k<nseln+nmeln; ++k)
+                                for (int k=0; k<nseln; ++k) N[k      ] =  Hs[k];
+                                for (int k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+                            
+                                double tmp = detJ[j]*w[j];
+                                for (int l=0; l<nseln+nmeln; ++l)
                                 {
-                                    ke[k*ndpn  ][l*ndpn  ] -= -tmp*N[k]*N[l]*(eps*Ttb[0][0] + m_mu*tn*B[0][0]);
-                                    ke[k*ndpn  ][l*ndpn+1] -= -tmp*N[k]*N[l]*(eps*Ttb[0][1] + m_mu*tn*B[0][1]);
-                                    ke[k*ndpn  ][l*ndpn+2] -= -tmp*N[k]*N[l]*(eps*Ttb[0][2] + m_mu*tn*B[0][2]);
+                                    for (int k=0; k<nseln+nmeln; ++k)
+                                    {
+                                        ke[k*ndpn  ][l*ndpn  ] -= -tmp*N[k]*N[l]*(eps*Ttb[0][0] + m_mu*tn*B[0][0]);
+                                        ke[k*ndpn  ][l*ndpn+1] -= -tmp*N[k]*N[l]*(eps*Ttb[0][1] + m_mu*tn*B[0][1]);
+                                        ke[k*ndpn  ][l*ndpn+2] -= -tmp*N[k]*N[l]*(eps*Ttb[0][2] + m_mu*tn*B[0][2]);
                                     
-                                    ke[k*ndpn+1][l*ndpn  ] -= -tmp*N[k]*N[l]*(eps*Ttb[1][0] + m_mu*tn*B[1][0]);
-                                    ke[k*ndpn+1][l*ndpn+1] -= -tmp*N[k]*N[l]*(eps*Ttb[1][1] + m_mu*tn*B[1][1]);
-                                    ke[k*ndpn+1][l*ndpn+2] -= -tmp*N[k]*N[l]*(eps*Ttb[1][2] + m_mu*tn*B[1][2]);
+                                        ke[k*ndpn+1][l*ndpn  ] -= -tmp*N[k]*N[l]*(eps*Ttb[1][0] + m_mu*tn*B[1][0]);
+                                        ke[k*ndpn+1][l*ndpn+1] -= -tmp*N[k]*N[l]*(eps*Ttb[1][1] + m_mu*tn*B[1][1]);
+                                        ke[k*ndpn+1][l*ndpn+2] -= -tmp*N[k]*N[l]*(eps*Ttb[1][2] + m_mu*tn*B[1][2]);
                                     
-                                    ke[k*ndpn+2][l*ndpn  ] -= -tmp*N[k]*N[l]*(eps*Ttb[2][0] + m_mu*tn*B[2][0]);
-                                    ke[k*ndpn+2][l*ndpn+1] -= -tmp*N[k]*N[l]*(eps*Ttb[2][1] + m_mu*tn*B[2][1]);
-                                    ke[k*ndpn+2][l*ndpn+2] -= -tmp*N[k]*N[l]*(eps*Ttb[2][2] + m_mu*tn*B[2][2]);
+                                        ke[k*ndpn+2][l*ndpn  ] -= -tmp*N[k]*N[l]*(eps*Ttb[2][0] + m_mu*tn*B[2][0]);
+                                        ke[k*ndpn+2][l*ndpn+1] -= -tmp*N[k]*N[l]*(eps*Ttb[2][1] + m_mu*tn*B[2][1]);
+                                        ke[k*ndpn+2][l*ndpn+2] -= -tmp*N[k]*N[l]*(eps*Ttb[2][2] + m_mu*tn*B[2][2]);
+                                    }
                                 }
-                            }
                             
-                            // b. Na,Nb-term
-                            //-------------------------------------
+                                // b. Na,Nb-term
+                                //-------------------------------------
                             
-                            tmp = tn*detJ[j]*w[j];
-                            // non-symmetric
-                            for (int l=0; l<nseln; ++l)
-                            {
-                                for (int k=0; k<nseln+nmeln; ++k)
+                                tmp = tn*detJ[j]*w[j];
+                                // non-symmetric
+                                for (int l=0; l<nseln; ++l)
                                 {
-                                    ke[k*ndpn  ][l*ndpn  ] -= -tmp*N[k]*(As[l][0][0] + m_mu*(Pc[l][0][0] - Jc[l][0][0]));
-                                    ke[k*ndpn  ][l*ndpn+1] -= -tmp*N[k]*(As[l][0][1] + m_mu*(Pc[l][0][1] - Jc[l][0][1]));
-                                    ke[k*ndpn  ][l*ndpn+2] -= -tmp*N[k]*(As[l][0][2] + m_mu*(Pc[l][0][2] - Jc[l][0][2]));
+                                    for (int k=0; k<nseln+nmeln; ++k)
+                                    {
+                                        ke[k*ndpn  ][l*ndpn  ] -= -tmp*N[k]*(As[l][0][0] + m_mu*(Pc[l][0][0] - Jc[l][0][0]));
+                                        ke[k*ndpn  ][l*ndpn+1] -= -tmp*N[k]*(As[l][0][1] + m_mu*(Pc[l][0][1] - Jc[l][0][1]));
+                                        ke[k*ndpn  ][l*ndpn+2] -= -tmp*N[k]*(As[l][0][2] + m_mu*(Pc[l][0][2] - Jc[l][0][2]));
                                     
-                                    ke[k*ndpn+1][l*ndpn  ] -= -tmp*N[k]*(As[l][1][0] + m_mu*(Pc[l][1][0] - Jc[l][1][0]));
-                                    ke[k*ndpn+1][l*ndpn+1] -= -tmp*N[k]*(As[l][1][1] + m_mu*(Pc[l][1][1] - Jc[l][1][1]));
-                                    ke[k*ndpn+1][l*ndpn+2] -= -tmp*N[k]*(As[l][1][2] + m_mu*(Pc[l][1][2] - Jc[l][1][2]));
+                                        ke[k*ndpn+1][l*ndpn  ] -= -tmp*N[k]*(As[l][1][0] + m_mu*(Pc[l][1][0] - Jc[l][1][0]));
+                                        ke[k*ndpn+1][l*ndpn+1] -= -tmp*N[k]*(As[l][1][1] + m_mu*(Pc[l][1][1] - Jc[l][1][1]));
+                                        ke[k*ndpn+1][l*ndpn+2] -= -tmp*N[k]*(As[l][1][2] + m_mu*(Pc[l][1][2] - Jc[l][1][2]));
                                     
-                                    ke[k*ndpn+2][l*ndpn  ] -= -tmp*N[k]*(As[l][2][0] + m_mu*(Pc[l][2][0] - Jc[l][2][0]));
-                                    ke[k*ndpn+2][l*ndpn+1] -= -tmp*N[k]*(As[l][2][1] + m_mu*(Pc[l][2][1] - Jc[l][2][1]));
-                                    ke[k*ndpn+2][l*ndpn+2] -= -tmp*N[k]*(As[l][2][2] + m_mu*(Pc[l][2][2] - Jc[l][2][2]));
+                                        ke[k*ndpn+2][l*ndpn  ] -= -tmp*N[k]*(As[l][2][0] + m_mu*(Pc[l][2][0] - Jc[l][2][0]));
+                                        ke[k*ndpn+2][l*ndpn+1] -= -tmp*N[k]*(As[l][2][1] + m_mu*(Pc[l][2][1] - Jc[l][2][1]));
+                                        ke[k*ndpn+2][l*ndpn+2] -= -tmp*N[k]*(As[l][2][2] + m_mu*(Pc[l][2][2] - Jc[l][2][2]));
+                                    }
                                 }
-                            }
                             
-                            // c. Nc,Nd-term
-                            //---------------------------------------
+                                // c. Nc,Nd-term
+                                //---------------------------------------
                             
-                            tmp = tn*detJ[j]*w[j];
-                            // non-symmetric
-                            for (int k=0; k<nmeln; ++k)
-                            {
-                                for (int l=0; l<nseln+nmeln; ++l)
+                                tmp = tn*detJ[j]*w[j];
+                                // non-symmetric
+                                for (int k=0; k<nmeln; ++k)
                                 {
-                                    ke[(k+nseln)*ndpn  ][l*ndpn  ] -= tmp*N[l]*Pb[k][0][0];
-                                    ke[(k+nseln)*ndpn  ][l*ndpn+1] -= tmp*N[l]*Pb[k][0][1];
-                                    ke[(k+nseln)*ndpn  ][l*ndpn+2] -= tmp*N[l]*Pb[k][0][2];
+                                    for (int l=0; l<nseln+nmeln; ++l)
+                                    {
+                                        ke[(k+nseln)*ndpn  ][l*ndpn  ] -= tmp*N[l]*Pb[k][0][0];
+                                        ke[(k+nseln)*ndpn  ][l*ndpn+1] -= tmp*N[l]*Pb[k][0][1];
+                                        ke[(k+nseln)*ndpn  ][l*ndpn+2] -= tmp*N[l]*Pb[k][0][2];
                                     
-                                    ke[(k+nseln)*ndpn+1][l*ndpn  ] -= tmp*N[l]*Pb[k][1][0];
-                                    ke[(k+nseln)*ndpn+1][l*ndpn+1] -= tmp*N[l]*Pb[k][1][1];
-                                    ke[(k+nseln)*ndpn+1][l*ndpn+2] -= tmp*N[l]*Pb[k][1][2];
+                                        ke[(k+nseln)*ndpn+1][l*ndpn  ] -= tmp*N[l]*Pb[k][1][0];
+                                        ke[(k+nseln)*ndpn+1][l*ndpn+1] -= tmp*N[l]*Pb[k][1][1];
+                                        ke[(k+nseln)*ndpn+1][l*ndpn+2] -= tmp*N[l]*Pb[k][1][2];
                                     
-                                    ke[(k+nseln)*ndpn+2][l*ndpn  ] -= tmp*N[l]*Pb[k][2][0];
-                                    ke[(k+nseln)*ndpn+2][l*ndpn+1] -= tmp*N[l]*Pb[k][2][1];
-                                    ke[(k+nseln)*ndpn+2][l*ndpn+2] -= tmp*N[l]*Pb[k][2][2];
+                                        ke[(k+nseln)*ndpn+2][l*ndpn  ] -= tmp*N[l]*Pb[k][2][0];
+                                        ke[(k+nseln)*ndpn+2][l*ndpn+1] -= tmp*N[l]*Pb[k][2][1];
+                                        ke[(k+nseln)*ndpn+2][l*ndpn+2] -= tmp*N[l]*Pb[k][2][2];
+                                    }
                                 }
-                            }
                             
-                            // c. Gbc-term
-                            //---------------------------------------
+                                // c. Gbc-term
+                                //---------------------------------------
                             
-                            tmp = tn*detJ[j]*w[j];
-                            for (int k=0; k<nmeln; ++k)
-                            {
-                                for (int l=0; l<nseln; ++l)
+                                tmp = tn*detJ[j]*w[j];
+                                for (int k=0; k<nmeln; ++k)
                                 {
-                                    mat3d gT = T*(Gbc[k][l]*tmp);
-                                    ke[(k+nseln)*ndpn  ][l*ndpn  ] -= gT[0][0];
-                                    ke[(k+nseln)*ndpn  ][l*ndpn+1] -= gT[0][1];
-                                    ke[(k+nseln)*ndpn  ][l*ndpn+2] -= gT[0][2];
+                                    for (int l=0; l<nseln; ++l)
+                                    {
+                                        mat3d gT = T*(Gbc[k][l]*tmp);
+                                        ke[(k+nseln)*ndpn  ][l*ndpn  ] -= gT[0][0];
+                                        ke[(k+nseln)*ndpn  ][l*ndpn+1] -= gT[0][1];
+                                        ke[(k+nseln)*ndpn  ][l*ndpn+2] -= gT[0][2];
                                     
-                                    ke[(k+nseln)*ndpn+1][l*ndpn  ] -= gT[1][0];
-                                    ke[(k+nseln)*ndpn+1][l*ndpn+1] -= gT[1][1];
-                                    ke[(k+nseln)*ndpn+1][l*ndpn+2] -= gT[1][2];
+                                        ke[(k+nseln)*ndpn+1][l*ndpn  ] -= gT[1][0];
+                                        ke[(k+nseln)*ndpn+1][l*ndpn+1] -= gT[1][1];
+                                        ke[(k+nseln)*ndpn+1][l*ndpn+2] -= gT[1][2];
                                     
-                                    ke[(k+nseln)*ndpn+2][l*ndpn  ] -= gT[2][0];
-                                    ke[(k+nseln)*ndpn+2][l*ndpn+1] -= gT[2][1];
-                                    ke[(k+nseln)*ndpn+2][l*ndpn+2] -= gT[2][2];
+                                        ke[(k+nseln)*ndpn+2][l*ndpn  ] -= gT[2][0];
+                                        ke[(k+nseln)*ndpn+2][l*ndpn+1] -= gT[2][1];
+                                        ke[(k+nseln)*ndpn+2][l*ndpn+2] -= gT[2][2];
+                                    }
                                 }
-                            }
                             
-                            // assemble the global stiffness
-                            {
-								ke.SetNodes(en);
-								ke.SetIndices(LM);
-								LS.Assemble(ke);
+                                // assemble the global stiffness
+                                {
+									ke.SetNodes(en);
+									ke.SetIndices(LM);
+									LS.Assemble(ke);
+                                }
                             }
-                        }
                         
+                        }
                     }
                 }
             }
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEContactSurface.h"
+#include <FECore/FEElementWorkspace.h>
 
 // Elastic sliding contact, reducing the algorithm of biphasic sliding contact
 // (FESlidingInterface2) to elastic case.  The algorithm derives from Bonet
@@ -154,6 +155,9 @@ protected:
     
     void CalcAutoPenalty(FESlidingElasticSurface& s);
 
+protected:
+    FEElementWorkspace	m_work;	//!< per-thread element buffers for the assembly loops
+
 public:
     FESlidingElasticSurface	m_ss;	//!< primary surface
 	FESlidingElasticSurface	m_ms;	//!< secondary surface
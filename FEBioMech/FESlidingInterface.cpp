@@ -523,10 +523,6 @@ void FESlidingInterface::Activate()
 
 void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface& ms, bool bupseg, bool bmove)
 {
-	// node projection data
-	double r, s;
-	vec3d q;
-
 	FEClosestPointProjection cpp(ms);
 	cpp.SetTolerance(m_stol);
 	cpp.SetSearchRadius(m_sradius);
@@ -534,8 +530,16 @@ void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface&
 	cpp.Init();
 
 	// loop over all primary surface nodes
-	for (int i=0; i<ss.Nodes(); ++i)
+	// (each node only touches its own contact data, and the projection
+	// queries are read-only, so the nodes can be processed in parallel)
+	int NN = ss.Nodes();
+#pragma omp parallel for shared(cpp) schedule(dynamic)
+	for (int i=0; i<NN; ++i)
 	{
+		// node projection data
+		double r, s;
+		vec3d q;
+
 		// get the node
 		FENode& node = ss.Node(i);
 
@@ -77,7 +77,6 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 		if (LCM.LinearConstraints() > 0)
 		{
-			#pragma omp critical 
 			LCM.AssembleStiffness(m_K, m_F, m_u, ke.Nodes(), ke.RowIndices(), ke.ColumnsIndices(), ke);
 		}
 
@@ -109,8 +108,12 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 						if (I >= 0)
 						{
 							// dof i is not a prescribed degree of freedom
-							#pragma omp atomic
-							m_F[I] -= ke[i][j] * ui[J];
+							if (m_batomic)
+							{
+								#pragma omp atomic
+								m_F[I] -= ke[i][j] * ui[J];
+							}
+							else m_F[I] -= ke[i][j] * ui[J];
 						}
 					}
 
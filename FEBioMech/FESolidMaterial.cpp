@@ -57,6 +57,12 @@ tens4dmm FESolidMaterial::SolidTangent(FEMaterialPoint& mp)
 	return (UseSecantTangent() ? SecantTangent(mp) : Tangent(mp));
 }
 
+//-----------------------------------------------------------------------------
+void FESolidMaterial::SolidTangents(FEMaterialPoint* const* mp, int n, tens4dmm* C)
+{
+	for (int i = 0; i < n; ++i) C[i] = SolidTangent(*mp[i]);
+}
+
 //-----------------------------------------------------------------------------
 mat3ds FESolidMaterial::SecantStress(FEMaterialPoint& pt, bool PK2)
 {
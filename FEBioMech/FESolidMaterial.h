@@ -67,6 +67,10 @@ public:
 
 	tens4dmm SolidTangent(FEMaterialPoint& pt);
 
+	//! Evaluate SolidTangent at n material points (e.g. the integration points of an element).
+	//! Materials can override this to evaluate their parameters for all points at once.
+	virtual void SolidTangents(FEMaterialPoint* const* mp, int n, tens4dmm* C);
+
 	virtual mat3ds SecantStress(FEMaterialPoint& pt, bool PK2 = false);
 	virtual bool UseSecantTangent() { return false; }
 
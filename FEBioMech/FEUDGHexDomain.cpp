@@ -71,9 +71,11 @@ bool FEUDGHexDomain::Create(int nelems, FE_Element_Spec spec)
 void FEUDGHexDomain::InternalForces(FEGlobalVector& R)
 {
 	int NE = (int)m_Elem.size();
+	PrepareElementBuffers();
 #pragma omp parallel for
 	for (int i=0; i<NE; ++i)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		// get the element
 		FESolidElement& el = m_Elem[i];
 
@@ -81,14 +83,14 @@ void FEUDGHexDomain::InternalForces(FEGlobalVector& R)
 		int ndof = 3*el.Nodes();
 
 		// element force vector
-		vector<double> fe;
+		vector<double>& fe = buf.fe;
 		fe.assign(ndof, 0);
 
 		// calculate internal force vector
 		UDGInternalForces(el, fe);
 
 		// get the element's LM vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 
 		// assemble element 'fe'-vector into global R vector
@@ -200,12 +200,14 @@ void FEBiphasicShellDomain::Reset()
 void FEBiphasicShellDomain::InternalForces(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -318,12 +320,14 @@ void FEBiphasicShellDomain::ElementInternalForce(FEShellElement& el, vector<doub
 void FEBiphasicShellDomain::InternalForcesSS(FEGlobalVector& R)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -432,13 +436,16 @@ void FEBiphasicShellDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared(NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         int neln = el.Nodes();
         int ndof = neln*8;
         ke.resize(ndof, ndof);
@@ -446,7 +453,7 @@ void FEBiphasicShellDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
         // calculate the element stiffness matrix
         ElementBiphasicStiffness(el, ke, bsymm);
         
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -461,13 +468,16 @@ void FEBiphasicShellDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for shared(NE)
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         int neln = el.Nodes();
         int ndof = neln*8;
         ke.resize(ndof, ndof);
@@ -475,7 +485,7 @@ void FEBiphasicShellDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
         // calculate the element stiffness matrix
         ElementBiphasicStiffnessSS(el, ke, bsymm);
         
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -953,11 +963,13 @@ void FEBiphasicShellDomain::UpdateElementStress(int iel)
 void FEBiphasicShellDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 {
     int NE = (int)m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEElementBuffer& buf = ElementBuffer();
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
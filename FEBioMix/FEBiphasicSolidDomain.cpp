@@ -262,13 +262,16 @@ void FEBiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 	int degree_d = dofs.GetVariableInterpolationOrder(m_varU);
 	int degree_p = dofs.GetVariableInterpolationOrder(m_varP);
 
-	int NE = (int)m_Elem.size();
-	#pragma omp parallel for shared (NE)
-	for (int i=0; i<NE; ++i)
-	{
+	// elements of the same color can be assembled without atomics
+	bool bcolored = UseColoredAssembly();
+	if (bcolored) R.SetAtomicAssembly(false);
+
+	PrepareElementBuffers();
+	ForEachElementParallel(bcolored, [&](int i) {
+		FEElementBuffer& buf = ElementBuffer();
 		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		vector<double>& fe = buf.fe;
+		vector<int>& lm = buf.lm;
 		
 		// get the element
 		FESolidElement& el = m_Elem[i];
@@ -288,7 +291,9 @@ void FEBiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 
 		// assemble element 'fe'-vector into global R vector
 		R.Assemble(el.m_node, lm, fe);
-	}
+	});
+
+	if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -388,13 +393,16 @@ void FEBiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<doub
 //-----------------------------------------------------------------------------
 void FEBiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
 {
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int i=0; i<NE; ++i)
-    {
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) R.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int i) {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -411,7 +419,9 @@ void FEBiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
         
         // assemble element 'fe'-vector into global R vector
         R.Assemble(el.m_node, lm, fe);
-    }
+    });
+
+    if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -505,16 +515,18 @@ void FEBiphasicSolidDomain::ElementInternalForceSS(FESolidElement& el, vector<do
 //-----------------------------------------------------------------------------
 void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 {
-	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
-    
-    #pragma omp parallel for shared(NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) LS.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int iel) {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = el.Nodes()*4;
 		ke.resize(ndof, ndof);
 		
@@ -526,28 +538,32 @@ void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+    });
+
+    if (bcolored) LS.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
 void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 {
-	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
+	// elements of the same color can be assembled without atomics
+	bool bcolored = UseColoredAssembly();
+	if (bcolored) LS.SetAtomicAssembly(false);
 
-	#pragma omp parallel for shared(NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
+	PrepareElementBuffers();
+	ForEachElementParallel(bcolored, [&](int iel) {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int ndof = el.Nodes()*4;
 		ke.resize(ndof, ndof);
 		
@@ -559,13 +575,15 @@ void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
+
+	if (bcolored) LS.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
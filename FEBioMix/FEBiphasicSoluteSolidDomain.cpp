@@ -334,12 +334,14 @@ void FEBiphasicSoluteSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FEBiphasicSoluteSolidDomain::InternalForces(FEGlobalVector& R)
 {
     size_t NE = m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -449,12 +451,14 @@ void FEBiphasicSoluteSolidDomain::ElementInternalForce(FESolidElement& el, vecto
 void FEBiphasicSoluteSolidDomain::InternalForcesSS(FEGlobalVector& R)
 {
     size_t NE = m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -559,13 +563,16 @@ void FEBiphasicSoluteSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm
     // repeat over all solid elements
     const int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         int neln = el.Nodes();
         int ndof = neln*5;
         ke.resize(ndof, ndof);
@@ -574,7 +581,7 @@ void FEBiphasicSoluteSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm
         ElementBiphasicSoluteStiffness(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -591,13 +598,16 @@ void FEBiphasicSoluteSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsy
     // repeat over all solid elements
     const int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
         int neln = el.Nodes();
         int ndof = neln*5;
         ke.resize(ndof, ndof);
@@ -606,7 +616,7 @@ void FEBiphasicSoluteSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsy
         ElementBiphasicSoluteStiffnessSS(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -576,12 +576,14 @@ void FEMultiphasicShellDomain::InternalForces(FEGlobalVector& R)
     int nsol = m_pMat->Solutes();
     int ndpn = 2*(4+nsol);
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -749,12 +751,14 @@ void FEMultiphasicShellDomain::InternalForcesSS(FEGlobalVector& R)
     int nsol = m_pMat->Solutes();
     int ndpn = 2*(4+nsol);
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -913,13 +917,16 @@ void FEMultiphasicShellDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 		int neln = el.Nodes();
         int ndof = neln*ndpn;
         ke.resize(ndof, ndof);
@@ -928,7 +935,7 @@ void FEMultiphasicShellDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
         ElementMultiphasicStiffness(el, ke, bsymm);
 
 		// get lm vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -948,13 +955,16 @@ void FEMultiphasicShellDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
         int neln = el.Nodes();
         int ndof = neln*ndpn;
         ke.resize(ndof, ndof);
@@ -962,7 +972,7 @@ void FEMultiphasicShellDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
         // calculate the element stiffness matrix
         ElementMultiphasicStiffnessSS(el, ke, bsymm);
 
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -1960,12 +1970,14 @@ void FEMultiphasicShellDomain::MembraneReactionFluxes(FEGlobalVector& R)
     
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FEShellElement& el = m_Elem[i];
@@ -2084,15 +2096,18 @@ void FEMultiphasicShellDomain::MembraneReactionStiffnessMatrix(FELinearSystem& L
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
+    PrepareElementBuffers();
 #pragma omp parallel for
     for (int iel=0; iel<NE; ++iel)
     {
+		FEElementBuffer& buf = ElementBuffer();
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
 
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
         UnpackMembraneLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -524,18 +524,20 @@ void FEMultiphasicSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 //-----------------------------------------------------------------------------
 void FEMultiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 {
-    size_t NE = m_Elem.size();
-    
     // get nodal DOFS
     int nsol = m_pMat->Solutes();
     int ndpn = 4+nsol;
     
-#pragma omp parallel for
-    for (int i=0; i<NE; ++i)
-    {
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) R.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int i) {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -552,7 +554,9 @@ void FEMultiphasicSolidDomain::InternalForces(FEGlobalVector& R)
         
         // assemble element 'fe'-vector into global R vector
         R.Assemble(el.m_node, lm, fe);
-    }
+    });
+
+    if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -670,18 +674,20 @@ void FEMultiphasicSolidDomain::ElementInternalForce(FESolidElement& el, vector<d
 //-----------------------------------------------------------------------------
 void FEMultiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
 {
-    size_t NE = m_Elem.size();
-    
     // get nodal DOFS
     int nsol = m_pMat->Solutes();
     int ndpn = 4+nsol;
     
-#pragma omp parallel for
-    for (int i=0; i<NE; ++i)
-    {
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) R.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int i) {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -698,7 +704,9 @@ void FEMultiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
         
         // assemble element 'fe'-vector into global R vector
         R.Assemble(el.m_node, lm, fe);
-    }
+    });
+
+    if (bcolored) R.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -811,17 +819,19 @@ void FEMultiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 {
     const int nsol = m_pMat->Solutes();
     int ndpn = 4+nsol;
-    
-    // repeat over all solid elements
-    int NE = (int)m_Elem.size();
-    
-#pragma omp parallel for
-    for (int iel=0; iel<NE; ++iel)
-    {
+
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) LS.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int iel) {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
 
         // allocate stiffness matrix
         int neln = el.Nodes();
@@ -832,13 +842,15 @@ void FEMultiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
         ElementMultiphasicStiffness(el, ke, bsymm);
 
 		// get the lm vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
+
+    if (bcolored) LS.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -846,17 +858,19 @@ void FEMultiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 {
     const int nsol = m_pMat->Solutes();
     int ndpn = 4+nsol;
-    
-    // repeat over all solid elements
-    int NE = (int)m_Elem.size();
-    
-#pragma omp parallel for
-    for (int iel=0; iel<NE; ++iel)
-    {
+
+    // elements of the same color can be assembled without atomics
+    bool bcolored = UseColoredAssembly();
+    if (bcolored) LS.SetAtomicAssembly(false);
+
+    PrepareElementBuffers();
+    ForEachElementParallel(bcolored, [&](int iel) {
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEElementMatrix& ke = buf.ke;
+        ke.SetNodes(el.m_node);
 
         // allocate stiffness matrix
         int neln = el.Nodes();
@@ -867,13 +881,15 @@ void FEMultiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
         ElementMultiphasicStiffnessSS(el, ke, bsymm);
 
 		// get the lm vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
+
+    if (bcolored) LS.SetAtomicAssembly(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FECore/FEAnalysis.h"
 #include "FECore/FENormalProjection.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/sys.h>
 #include "FECore/log.h"
 
 //-----------------------------------------------------------------------------
@@ -714,12 +715,6 @@ double FESlidingInterface2::AutoPressurePenalty(FESurfaceElement& el, FESlidingS
 void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface2& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
-
-	double ps[FEElement::MAX_NODES], p1;
 
     double psf = GetPenaltyScaleFactor();
     
@@ -781,8 +776,11 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 	}
 
 	// loop over all integration points
- //   #pragma omp parallel for shared(R, bupseg)
-	for (int i=0; i<ss.Elements(); ++i)
+	// (the ray queries are read-only and each element only updates its own
+	// integration point data, so the elements can be processed in parallel)
+	int NE = ss.Elements();
+#pragma omp parallel for shared(np) schedule(dynamic)
+	for (int i=0; i<NE; ++i)
 	{
 		FESurfaceElement& el = ss.Element(i);
 		bool sporo = ss.m_poro[i];
@@ -790,6 +788,8 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 		int ne = el.Nodes();
 		int nint = el.GaussPoints();
 
+		double ps[FEElement::MAX_NODES], p1 = 0;
+
 		// get the nodal pressures
 		if (sporo)
 		{
@@ -802,16 +802,17 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 			FESlidingSurface2::Data& pt = static_cast<FESlidingSurface2::Data&>(*el.GetMaterialPoint(j));
 
 			// calculate the global position of the integration point
-			r = ss.Local2Global(el, j);
+			vec3d r = ss.Local2Global(el, j);
 
 			// get the pressure at the integration point
             if (sporo) p1 = el.eval(ps, j);
 
 			// calculate the normal at this integration point
-			nu = ss.SurfaceNormal(el, j);
+			vec3d nu = ss.SurfaceNormal(el, j);
 
 			// first see if the old intersected face is still good enough
-			pme = pt.m_pme;
+			FESurfaceElement* pme = pt.m_pme;
+			double rs[2] = {0,0};
 			if (pme)
 			{
 				double g;
@@ -848,7 +849,7 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 
 				double eps = m_epsn*pt.m_epsn*psf;
 
-				Ln = pt.m_Lmd + eps*g;
+				double Ln = pt.m_Lmd + eps*g;
 
 				pt.m_gap = (g <= m_srad? g : 0);
 
@@ -1025,12 +1026,7 @@ void FESlidingInterface2::Update()
 //-----------------------------------------------------------------------------
 void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	int i, j, k;
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double N[4*MN*2]; // TODO: is the size correct?
 
 	FEModel& fem = *GetFEModel();
 
@@ -1052,167 +1048,189 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		// (each thread uses its own element buffers and contact force sums)
+		int NE = ss.Elements();
+		m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
 		{
-			// get the surface element
-			FESurfaceElement& se = ss.Element(i);
-
-			bool sporo = ss.m_poro[i];
+			FEElementBuffer& buf = m_work.ThreadBuffer();
+			int j, k;
+			vector<int>& LM = buf.lm;
+			vector<int> sLM, mLM, en;
+			vector<double>& fe = buf.fe;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			double N[4*MN*2]; // TODO: is the size correct?
+			vec3d Fs(0,0,0), Fm(0,0,0);
+
+#pragma omp for schedule(dynamic)
+			for (int i=0; i<NE; ++i)
+			{
+				// get the surface element
+				FESurfaceElement& se = ss.Element(i);
 
-			// get the nr of nodes and integration points
-			int nseln = se.Nodes();
-			int nint = se.GaussPoints();
+				bool sporo = ss.m_poro[i];
 
-			// copy the LM vector; we'll need it later
-			ss.UnpackLM(se, sLM);
+				// get the nr of nodes and integration points
+				int nseln = se.Nodes();
+				int nint = se.GaussPoints();
 
-			// we calculate all the metrics we need before we
-			// calculate the nodal forces
-			for (j=0; j<nint; ++j)
-			{
-				// get the base vectors
-				vec3d g[2];
-				ss.CoBaseVectors(se, j, g);
+				// copy the LM vector; we'll need it later
+				ss.UnpackLM(se, sLM);
 
-				// jacobians: J = |g0xg1|
-				detJ[j] = (g[0] ^ g[1]).norm();
+				// we calculate all the metrics we need before we
+				// calculate the nodal forces
+				for (j=0; j<nint; ++j)
+				{
+					// get the base vectors
+					vec3d g[2];
+					ss.CoBaseVectors(se, j, g);
 
-				// integration weights
-				w[j] = se.GaussWeights()[j];
-			}
+					// jacobians: J = |g0xg1|
+					detJ[j] = (g[0] ^ g[1]).norm();
 
-			// loop over all integration points
-			// note that we are integrating over the current surface
-			for (j=0; j<nint; ++j)
-			{
-				// get the integration point data
-				FESlidingSurface2::Data& pt = static_cast<FESlidingSurface2::Data&>(*se.GetMaterialPoint(j));
+					// integration weights
+					w[j] = se.GaussWeights()[j];
+				}
 
-				// get the secondary surface element
-				FESurfaceElement* pme = pt.m_pme;
-				if (pme)
+				// loop over all integration points
+				// note that we are integrating over the current surface
+				for (j=0; j<nint; ++j)
 				{
+					// get the integration point data
+					FESlidingSurface2::Data& pt = static_cast<FESlidingSurface2::Data&>(*se.GetMaterialPoint(j));
+
 					// get the secondary surface element
-					FESurfaceElement& me = *pme;
+					FESurfaceElement* pme = pt.m_pme;
+					if (pme)
+					{
+						// get the secondary surface element
+						FESurfaceElement& me = *pme;
 
-					bool mporo = ms.m_poro[pme->m_lid];
+						bool mporo = ms.m_poro[pme->m_lid];
 
-					// get the nr of element nodes
-					int nmeln = me.Nodes();
+						// get the nr of element nodes
+						int nmeln = me.Nodes();
 
-					// copy LM vector
-					ms.UnpackLM(me, mLM);
+						// copy LM vector
+						ms.UnpackLM(me, mLM);
 
-					// calculate degrees of freedom
-					int ndof = 3*(nseln + nmeln);
+						// calculate degrees of freedom
+						int ndof = 3*(nseln + nmeln);
 
-					// build the LM vector
-					LM.resize(ndof);
-					for (k=0; k<nseln; ++k)
-					{
-						LM[3*k  ] = sLM[3*k  ];
-						LM[3*k+1] = sLM[3*k+1];
-						LM[3*k+2] = sLM[3*k+2];
-					}
+						// build the LM vector
+						LM.resize(ndof);
+						for (k=0; k<nseln; ++k)
+						{
+							LM[3*k  ] = sLM[3*k  ];
+							LM[3*k+1] = sLM[3*k+1];
+							LM[3*k+2] = sLM[3*k+2];
+						}
 
-					for (k=0; k<nmeln; ++k)
-					{
-						LM[3*(k+nseln)  ] = mLM[3*k  ];
-						LM[3*(k+nseln)+1] = mLM[3*k+1];
-						LM[3*(k+nseln)+2] = mLM[3*k+2];
-					}
+						for (k=0; k<nmeln; ++k)
+						{
+							LM[3*(k+nseln)  ] = mLM[3*k  ];
+							LM[3*(k+nseln)+1] = mLM[3*k+1];
+							LM[3*(k+nseln)+2] = mLM[3*k+2];
+						}
 
-					// build the en vector
-					en.resize(nseln+nmeln);
-					for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
-					for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
+						// build the en vector
+						en.resize(nseln+nmeln);
+						for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
+						for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
 
-					// get element shape functions
-					Hs = se.H(j);
+						// get element shape functions
+						Hs = se.H(j);
 
-					// get secondary surface element shape functions
-					double r = pt.m_rs[0];
-					double s = pt.m_rs[1];
-					me.shape_fnc(Hm, r, s);
+						// get secondary surface element shape functions
+						double r = pt.m_rs[0];
+						double s = pt.m_rs[1];
+						me.shape_fnc(Hm, r, s);
 
-					// get normal vector
-					vec3d nu = pt.m_nu;
+						// get normal vector
+						vec3d nu = pt.m_nu;
 
-					// gap function
-					double g = pt.m_gap;
+						// gap function
+						double g = pt.m_gap;
 					
-					// lagrange multiplier
-					double Lm = pt.m_Lmd;
+						// lagrange multiplier
+						double Lm = pt.m_Lmd;
 
-					// penalty 
-					double eps = m_epsn*pt.m_epsn*psf;
+						// penalty 
+						double eps = m_epsn*pt.m_epsn*psf;
 
-					// contact traction
-					double tn = Lm + eps*g;
-					tn = MBRACKET(tn);
+						// contact traction
+						double tn = Lm + eps*g;
+						tn = MBRACKET(tn);
 
-					// calculate the force vector
-					fe.resize(ndof);
-					zero(fe);
+						// calculate the force vector
+						fe.resize(ndof);
+						zero(fe);
 
-					for (k=0; k<nseln; ++k)
-					{
-						N[3*k  ] = -Hs[k]*nu.x;
-						N[3*k+1] = -Hs[k]*nu.y;
-						N[3*k+2] = -Hs[k]*nu.z;
-					}
+						for (k=0; k<nseln; ++k)
+						{
+							N[3*k  ] = -Hs[k]*nu.x;
+							N[3*k+1] = -Hs[k]*nu.y;
+							N[3*k+2] = -Hs[k]*nu.z;
+						}
 
-					for (k=0; k<nmeln; ++k)
-					{
-						N[3*(k+nseln)  ] = Hm[k]*nu.x;
-						N[3*(k+nseln)+1] = Hm[k]*nu.y;
-						N[3*(k+nseln)+2] = Hm[k]*nu.z;
-					}
+						for (k=0; k<nmeln; ++k)
+						{
+							N[3*(k+nseln)  ] = Hm[k]*nu.x;
+							N[3*(k+nseln)+1] = Hm[k]*nu.y;
+							N[3*(k+nseln)+2] = Hm[k]*nu.z;
+						}
 
-					for (k=0; k<ndof; ++k) fe[k] += tn*N[k]*detJ[j]*w[j];
+						for (k=0; k<ndof; ++k) fe[k] += tn*N[k]*detJ[j]*w[j];
 
-					for (k=0; k<nseln; ++k)
-					{
-						ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
-					}
+						for (k=0; k<nseln; ++k)
+						{
+							Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+						}
 
-					for (k = 0; k<nmeln; ++k)
-					{
-						ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
-					}
+						for (k = 0; k<nmeln; ++k)
+						{
+							Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+						}
 
-					// assemble the global residual
-					R.Assemble(en, LM, fe);
+						// assemble the global residual
+						R.Assemble(en, LM, fe);
 
-					// do the biphasic stuff
-					if (sporo && mporo && (tn > 0))
-					{
-						// calculate nr of pressure dofs
-						int ndof = nseln + nmeln;
+						// do the biphasic stuff
+						if (sporo && mporo && (tn > 0))
+						{
+							// calculate nr of pressure dofs
+							int ndof = nseln + nmeln;
 
-						// calculate the flow rate
-						double epsp = m_epsp*pt.m_epsp*psf;
+							// calculate the flow rate
+							double epsp = m_epsp*pt.m_epsp*psf;
 
-						double wn = pt.m_Lmp + epsp*pt.m_pg;
+							double wn = pt.m_Lmp + epsp*pt.m_pg;
 
-						// fill the LM
-						LM.resize(ndof);
-						for (k=0; k<nseln; ++k) LM[k        ] = sLM[3*nseln+k];
-						for (k=0; k<nmeln; ++k) LM[k + nseln] = mLM[3*nmeln+k];
+							// fill the LM
+							LM.resize(ndof);
+							for (k=0; k<nseln; ++k) LM[k        ] = sLM[3*nseln+k];
+							for (k=0; k<nmeln; ++k) LM[k + nseln] = mLM[3*nmeln+k];
 
-						// fill the force array
-						fe.resize(ndof);
-						zero(fe);
-						for (k=0; k<nseln; ++k) N[k      ] =  Hs[k];
-						for (k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+							// fill the force array
+							fe.resize(ndof);
+							zero(fe);
+							for (k=0; k<nseln; ++k) N[k      ] =  Hs[k];
+							for (k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
 
-						for (k=0; k<ndof; ++k) fe[k] += dt*wn*N[k]*detJ[j]*w[j];
+							for (k=0; k<ndof; ++k) fe[k] += dt*wn*N[k]*detJ[j]*w[j];
 
-						// assemble residual
-						R.Assemble(en, LM, fe);
+							// assemble residual
+							R.Assemble(en, LM, fe);
+						}
 					}
 				}
 			}
+
+#pragma omp critical
+			{
+				ss.m_Ft += Fs;
+				ms.m_Ft += Fm;
+			}
 		}
 	}
 }
@@ -1220,12 +1238,7 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 //-----------------------------------------------------------------------------
 void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	int i, j, k, l;
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN], pt[MN], dpr[MN], dps[MN];
-	double N[4*MN*2];
-	FEElementMatrix ke;
 
 	FEModel& fem = *GetFEModel();
 
@@ -1259,416 +1272,431 @@ void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		// (each thread uses its own element buffers)
+		int NE = ss.Elements();
+		m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
 		{
-			// get the next element
-			FESurfaceElement& se = ss.Element(i);
-
-			bool sporo = ss.m_poro[i];
-
-			// get nr of nodes and integration points
-			int nseln = se.Nodes();
-			int nint = se.GaussPoints();
-
-			// nodal pressures
-			double pn[MN] = {0};
-			if (sporo)
-			{
-				for (j=0; j<nseln; ++j) pn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofP);
-			}
-
-			// copy the LM vector
-			ss.UnpackLM(se, sLM);
-
-			// we calculate all the metrics we need before we
-			// calculate the nodal forces
-			for (j=0; j<nint; ++j)
+			FEElementBuffer& buf = m_work.ThreadBuffer();
+			int j, k, l;
+			vector<int>& LM = buf.lm;
+			vector<int> sLM, mLM, en;
+			double detJ[MN], w[MN], *Hs, Hm[MN], pt[MN], dpr[MN], dps[MN];
+			double N[4*MN*2];
+			FEElementMatrix& ke = buf.ke;
+
+#pragma omp for schedule(dynamic)
+			for (int i=0; i<NE; ++i)
 			{
-				// get the base vectors
-				vec3d g[2];
-				ss.CoBaseVectors(se, j, g);
+				// get the next element
+				FESurfaceElement& se = ss.Element(i);
 
-				// jacobians: J = |g0xg1|
-				detJ[j] = (g[0] ^ g[1]).norm();
+				bool sporo = ss.m_poro[i];
 
-				// integration weights
-				w[j] = se.GaussWeights()[j];
+				// get nr of nodes and integration points
+				int nseln = se.Nodes();
+				int nint = se.GaussPoints();
 
-				// pressure
+				// nodal pressures
+				double pn[MN] = {0};
 				if (sporo)
 				{
-					pt[j] = se.eval(pn, j);
-					dpr[j] = se.eval_deriv1(pn, j);
-					dps[j] = se.eval_deriv2(pn, j);
+					for (j=0; j<nseln; ++j) pn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofP);
 				}
-			}
 
-			// loop over all integration points
-			for (j=0; j<nint; ++j)
-			{
-				// get integration point data
-				FESlidingSurface2::Data& pt = static_cast<FESlidingSurface2::Data&>(*se.GetMaterialPoint(j));
+				// copy the LM vector
+				ss.UnpackLM(se, sLM);
 
-				// get the secondary surface element
-				FESurfaceElement* pme = pt.m_pme;
-				if (pme)
+				// we calculate all the metrics we need before we
+				// calculate the nodal forces
+				for (j=0; j<nint; ++j)
 				{
-					FESurfaceElement& me = *pme;
+					// get the base vectors
+					vec3d g[2];
+					ss.CoBaseVectors(se, j, g);
 
-					bool mporo = ms.m_poro[pme->m_lid];
+					// jacobians: J = |g0xg1|
+					detJ[j] = (g[0] ^ g[1]).norm();
 
-					// get the nr of nodes
-					int nmeln = me.Nodes();
+					// integration weights
+					w[j] = se.GaussWeights()[j];
 
-					// nodal pressure
-					double pm[MN] = {0};
-					if (sporo && mporo)
+					// pressure
+					if (sporo)
 					{
-						for (k=0; k<nmeln; ++k) pm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofP);
+						pt[j] = se.eval(pn, j);
+						dpr[j] = se.eval_deriv1(pn, j);
+						dps[j] = se.eval_deriv2(pn, j);
 					}
+				}
+
+				// loop over all integration points
+				for (j=0; j<nint; ++j)
+				{
+					// get integration point data
+					FESlidingSurface2::Data& pt = static_cast<FESlidingSurface2::Data&>(*se.GetMaterialPoint(j));
+
+					// get the secondary surface element
+					FESurfaceElement* pme = pt.m_pme;
+					if (pme)
+					{
+						FESurfaceElement& me = *pme;
 
-					// copy the LM vector
-					ms.UnpackLM(me, mLM);
+						bool mporo = ms.m_poro[pme->m_lid];
+
+						// get the nr of nodes
+						int nmeln = me.Nodes();
+
+						// nodal pressure
+						double pm[MN] = {0};
+						if (sporo && mporo)
+						{
+							for (k=0; k<nmeln; ++k) pm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofP);
+						}
+
+						// copy the LM vector
+						ms.UnpackLM(me, mLM);
 					
-					int ndpn;	// number of dofs per node
-					int ndof;	// number of dofs in stiffness matrix
+						int ndpn;	// number of dofs per node
+						int ndof;	// number of dofs in stiffness matrix
 
-					if (sporo && mporo) {
-						// calculate degrees of freedom for biphasic-on-biphasic contact
-						ndpn = 4;
-						ndof = ndpn*(nseln+nmeln);
+						if (sporo && mporo) {
+							// calculate degrees of freedom for biphasic-on-biphasic contact
+							ndpn = 4;
+							ndof = ndpn*(nseln+nmeln);
 						
-						// build the LM vector
-						LM.resize(ndof);
+							// build the LM vector
+							LM.resize(ndof);
 						
-						for (k=0; k<nseln; ++k)
-						{
-							LM[4*k  ] = sLM[3*k  ];			// x-dof
-							LM[4*k+1] = sLM[3*k+1];			// y-dof
-							LM[4*k+2] = sLM[3*k+2];			// z-dof
-							LM[4*k+3] = sLM[3*nseln+k];		// p-dof
-						}
-						for (k=0; k<nmeln; ++k)
-						{
-							LM[4*(k+nseln)  ] = mLM[3*k  ];			// x-dof
-							LM[4*(k+nseln)+1] = mLM[3*k+1];			// y-dof
-							LM[4*(k+nseln)+2] = mLM[3*k+2];			// z-dof
-							LM[4*(k+nseln)+3] = mLM[3*nmeln+k];		// p-dof
+							for (k=0; k<nseln; ++k)
+							{
+								LM[4*k  ] = sLM[3*k  ];			// x-dof
+								LM[4*k+1] = sLM[3*k+1];			// y-dof
+								LM[4*k+2] = sLM[3*k+2];			// z-dof
+								LM[4*k+3] = sLM[3*nseln+k];		// p-dof
+							}
+							for (k=0; k<nmeln; ++k)
+							{
+								LM[4*(k+nseln)  ] = mLM[3*k  ];			// x-dof
+								LM[4*(k+nseln)+1] = mLM[3*k+1];			// y-dof
+								LM[4*(k+nseln)+2] = mLM[3*k+2];			// z-dof
+								LM[4*(k+nseln)+3] = mLM[3*nmeln+k];		// p-dof
+							}
 						}
-					}
 					
-					else {
-						// calculate degrees of freedom for biphasic-on-elastic or elastic-on-elastic contact
-						ndpn = 3;
-						ndof = ndpn*(nseln + nmeln);
+						else {
+							// calculate degrees of freedom for biphasic-on-elastic or elastic-on-elastic contact
+							ndpn = 3;
+							ndof = ndpn*(nseln + nmeln);
 						
-						// build the LM vector
-						LM.resize(ndof);
+							// build the LM vector
+							LM.resize(ndof);
 						
-						for (k=0; k<nseln; ++k)
-						{
-							LM[3*k  ] = sLM[3*k  ];
-							LM[3*k+1] = sLM[3*k+1];
-							LM[3*k+2] = sLM[3*k+2];
-						}
+							for (k=0; k<nseln; ++k)
+							{
+								LM[3*k  ] = sLM[3*k  ];
+								LM[3*k+1] = sLM[3*k+1];
+								LM[3*k+2] = sLM[3*k+2];
+							}
 						
-						for (k=0; k<nmeln; ++k)
-						{
-							LM[3*(k+nseln)  ] = mLM[3*k  ];
-							LM[3*(k+nseln)+1] = mLM[3*k+1];
-							LM[3*(k+nseln)+2] = mLM[3*k+2];
+							for (k=0; k<nmeln; ++k)
+							{
+								LM[3*(k+nseln)  ] = mLM[3*k  ];
+								LM[3*(k+nseln)+1] = mLM[3*k+1];
+								LM[3*(k+nseln)+2] = mLM[3*k+2];
+							}
 						}
-					}
 					
-					// build the en vector
-					en.resize(nseln+nmeln);
-					for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
-					for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
+						// build the en vector
+						en.resize(nseln+nmeln);
+						for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
+						for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
 
-					// shape functions
-					Hs = se.H(j);
+						// shape functions
+						Hs = se.H(j);
 
-					// secondary surface shape functions
-					double r = pt.m_rs[0];
-					double s = pt.m_rs[1];
-					me.shape_fnc(Hm, r, s);
+						// secondary surface shape functions
+						double r = pt.m_rs[0];
+						double s = pt.m_rs[1];
+						me.shape_fnc(Hm, r, s);
 
-					// get normal vector
-					vec3d nu = pt.m_nu;
+						// get normal vector
+						vec3d nu = pt.m_nu;
 
-					// gap function
-					double g = pt.m_gap;
+						// gap function
+						double g = pt.m_gap;
 					
-					// lagrange multiplier
-					double Lm = pt.m_Lmd;
+						// lagrange multiplier
+						double Lm = pt.m_Lmd;
 
-					// penalty 
-					double eps = m_epsn*pt.m_epsn*psf;
+						// penalty 
+						double eps = m_epsn*pt.m_epsn*psf;
 
-					// contact traction
-					double tn = Lm + eps*g;
-					tn = MBRACKET(tn);
+						// contact traction
+						double tn = Lm + eps*g;
+						tn = MBRACKET(tn);
 
-//					double dtn = m_eps*HEAVYSIDE(Lm + eps*g);
-					double dtn = (tn > 0.? eps :0.);
+	//					double dtn = m_eps*HEAVYSIDE(Lm + eps*g);
+						double dtn = (tn > 0.? eps :0.);
 					
-					// create the stiffness matrix
-					ke.resize(ndof, ndof); ke.zero();
+						// create the stiffness matrix
+						ke.resize(ndof, ndof); ke.zero();
 					
-					// --- S O L I D - S O L I D   C O N T A C T ---
-					
-					// a. NxN-term
-					//------------------------------------
-					
-					// calculate the N-vector
-					for (k=0; k<nseln; ++k)
-					{
-						N[ndpn*k  ] = Hs[k]*nu.x;
-						N[ndpn*k+1] = Hs[k]*nu.y;
-						N[ndpn*k+2] = Hs[k]*nu.z;
-					}
+						// --- S O L I D - S O L I D   C O N T A C T ---
 					
-					for (k=0; k<nmeln; ++k)
-					{
-						N[ndpn*(k+nseln)  ] = -Hm[k]*nu.x;
-						N[ndpn*(k+nseln)+1] = -Hm[k]*nu.y;
-						N[ndpn*(k+nseln)+2] = -Hm[k]*nu.z;
-					}
+						// a. NxN-term
+						//------------------------------------
 					
-					if (ndpn == 4) {
+						// calculate the N-vector
 						for (k=0; k<nseln; ++k)
-							N[ndpn*k+3] = 0;
+						{
+							N[ndpn*k  ] = Hs[k]*nu.x;
+							N[ndpn*k+1] = Hs[k]*nu.y;
+							N[ndpn*k+2] = Hs[k]*nu.z;
+						}
+					
 						for (k=0; k<nmeln; ++k)
-							N[ndpn*(k+nseln)+3] = 0;
-					}
+						{
+							N[ndpn*(k+nseln)  ] = -Hm[k]*nu.x;
+							N[ndpn*(k+nseln)+1] = -Hm[k]*nu.y;
+							N[ndpn*(k+nseln)+2] = -Hm[k]*nu.z;
+						}
 					
-					for (k=0; k<ndof; ++k)
-						for (l=0; l<ndof; ++l) ke[k][l] += dtn*N[k]*N[l]*detJ[j]*w[j];
+						if (ndpn == 4) {
+							for (k=0; k<nseln; ++k)
+								N[ndpn*k+3] = 0;
+							for (k=0; k<nmeln; ++k)
+								N[ndpn*(k+nseln)+3] = 0;
+						}
 					
-					// b. A-term
-					//-------------------------------------
+						for (k=0; k<ndof; ++k)
+							for (l=0; l<ndof; ++l) ke[k][l] += dtn*N[k]*N[l]*detJ[j]*w[j];
 					
-					for (k=0; k<nseln; ++k) N[k      ] =  Hs[k];
-					for (k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+						// b. A-term
+						//-------------------------------------
 					
-					double* Gr = se.Gr(j);
-					double* Gs = se.Gs(j);
-					vec3d gs[2];
-					ss.CoBaseVectors(se, j, gs);
+						for (k=0; k<nseln; ++k) N[k      ] =  Hs[k];
+						for (k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
 					
-					mat3d S1, S2;
-					S1.skew(gs[0]);
-					S2.skew(gs[1]);
-					mat3d As[FEElement::MAX_NODES];
-					for (l=0; l<nseln; ++l)
-						As[l] = S2*Gr[l] - S1*Gs[l];
+						double* Gr = se.Gr(j);
+						double* Gs = se.Gs(j);
+						vec3d gs[2];
+						ss.CoBaseVectors(se, j, gs);
 					
-					if (!m_bsymm)
-					{	// non-symmetric
+						mat3d S1, S2;
+						S1.skew(gs[0]);
+						S2.skew(gs[1]);
+						mat3d As[FEElement::MAX_NODES];
 						for (l=0; l<nseln; ++l)
-						{
-							for (k=0; k<nseln+nmeln; ++k)
+							As[l] = S2*Gr[l] - S1*Gs[l];
+					
+						if (!m_bsymm)
+						{	// non-symmetric
+							for (l=0; l<nseln; ++l)
 							{
-								ke[k*ndpn  ][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][0][0];
-								ke[k*ndpn  ][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][0][1];
-								ke[k*ndpn  ][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][0][2];
+								for (k=0; k<nseln+nmeln; ++k)
+								{
+									ke[k*ndpn  ][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][0][0];
+									ke[k*ndpn  ][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][0][1];
+									ke[k*ndpn  ][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][0][2];
 								
-								ke[k*ndpn+1][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][1][0];
-								ke[k*ndpn+1][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][1][1];
-								ke[k*ndpn+1][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][1][2];
+									ke[k*ndpn+1][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][1][0];
+									ke[k*ndpn+1][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][1][1];
+									ke[k*ndpn+1][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][1][2];
 								
-								ke[k*ndpn+2][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][2][0];
-								ke[k*ndpn+2][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][2][1];
-								ke[k*ndpn+2][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][2][2];
+									ke[k*ndpn+2][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][2][0];
+									ke[k*ndpn+2][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][2][1];
+									ke[k*ndpn+2][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][2][2];
+								}
 							}
-						}
-					} 
-					else 
-					{	// symmetric
-						for (l=0; l<nseln; ++l)
-						{
-							for (k=0; k<nseln+nmeln; ++k)
+						} 
+						else 
+						{	// symmetric
+							for (l=0; l<nseln; ++l)
 							{
-								ke[k*ndpn  ][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
-								ke[k*ndpn  ][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
-								ke[k*ndpn  ][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
+								for (k=0; k<nseln+nmeln; ++k)
+								{
+									ke[k*ndpn  ][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
+									ke[k*ndpn  ][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
+									ke[k*ndpn  ][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
 								
-								ke[k*ndpn+1][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
-								ke[k*ndpn+1][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
-								ke[k*ndpn+1][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
+									ke[k*ndpn+1][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
+									ke[k*ndpn+1][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
+									ke[k*ndpn+1][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
 								
-								ke[k*ndpn+2][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
-								ke[k*ndpn+2][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
-								ke[k*ndpn+2][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
+									ke[k*ndpn+2][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
+									ke[k*ndpn+2][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
+									ke[k*ndpn+2][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
 								
-								ke[l*ndpn  ][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
-								ke[l*ndpn+1][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
-								ke[l*ndpn+2][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
+									ke[l*ndpn  ][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
+									ke[l*ndpn+1][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
+									ke[l*ndpn+2][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
 								
-								ke[l*ndpn  ][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
-								ke[l*ndpn+1][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
-								ke[l*ndpn+2][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
+									ke[l*ndpn  ][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
+									ke[l*ndpn+1][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
+									ke[l*ndpn+2][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
 								
-								ke[l*ndpn  ][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
-								ke[l*ndpn+1][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
-								ke[l*ndpn+2][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
+									ke[l*ndpn  ][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
+									ke[l*ndpn+1][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
+									ke[l*ndpn+2][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
+								}
 							}
 						}
-					}
 					
-					// c. M-term
-					//---------------------------------------
+						// c. M-term
+						//---------------------------------------
 					
-					vec3d Gm[2];
-					ms.ContraBaseVectors(me, r, s, Gm);
+						vec3d Gm[2];
+						ms.ContraBaseVectors(me, r, s, Gm);
 					
-					// evaluate secondary surface normal
-					vec3d mnu = Gm[0] ^ Gm[1];
-					mnu.unit();
+						// evaluate secondary surface normal
+						vec3d mnu = Gm[0] ^ Gm[1];
+						mnu.unit();
 					
-					double Hmr[FEElement::MAX_NODES], Hms[FEElement::MAX_NODES];
-					me.shape_deriv(Hmr, Hms, r, s);
-					vec3d mm[FEElement::MAX_NODES];
-					for (k=0; k<nmeln; ++k) 
-						mm[k] = Gm[0]*Hmr[k] + Gm[1]*Hms[k];
-					
-					if (!m_bsymm)
-					{	// non-symmetric
+						double Hmr[FEElement::MAX_NODES], Hms[FEElement::MAX_NODES];
+						me.shape_deriv(Hmr, Hms, r, s);
+						vec3d mm[FEElement::MAX_NODES];
 						for (k=0; k<nmeln; ++k) 
-						{
-							for (l=0; l<nseln+nmeln; ++l)
+							mm[k] = Gm[0]*Hmr[k] + Gm[1]*Hms[k];
+					
+						if (!m_bsymm)
+						{	// non-symmetric
+							for (k=0; k<nmeln; ++k) 
 							{
-								ke[(k+nseln)*ndpn  ][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
+								for (l=0; l<nseln+nmeln; ++l)
+								{
+									ke[(k+nseln)*ndpn  ][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+1][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+2][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+								}
 							}
 						}
-					}
-					else
-					{	// symmetric
-						for (k=0; k<nmeln; ++k) 
-						{
-							for (l=0; l<nseln+nmeln; ++l)
+						else
+						{	// symmetric
+							for (k=0; k<nmeln; ++k) 
 							{
-								ke[(k+nseln)*ndpn  ][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
+								for (l=0; l<nseln+nmeln; ++l)
+								{
+									ke[(k+nseln)*ndpn  ][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+1][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+2][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
 								
-								ke[l*ndpn  ][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
-								ke[l*ndpn+1][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
-								ke[l*ndpn+2][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
+									ke[l*ndpn  ][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
+									ke[l*ndpn+1][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
+									ke[l*ndpn+2][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
 								
-								ke[l*ndpn  ][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
-								ke[l*ndpn+1][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
-								ke[l*ndpn+2][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
+									ke[l*ndpn  ][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
+									ke[l*ndpn+1][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
+									ke[l*ndpn+2][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
 								
-								ke[l*ndpn  ][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
-								ke[l*ndpn+1][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
-								ke[l*ndpn+2][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+									ke[l*ndpn  ][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
+									ke[l*ndpn+1][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
+									ke[l*ndpn+2][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+								}
 							}
 						}
-					}
 					
-					// --- B I P H A S I C   S T I F F N E S S ---
-					if (sporo && mporo)
-					{
-						// the variable dt is either the timestep or one
-						// depending on whether we are using the symmetric
-						// poro version or not.
-						double dt = fem.GetTime().timeIncrement;
+						// --- B I P H A S I C   S T I F F N E S S ---
+						if (sporo && mporo)
+						{
+							// the variable dt is either the timestep or one
+							// depending on whether we are using the symmetric
+							// poro version or not.
+							double dt = fem.GetTime().timeIncrement;
 						
-						double epsp = (tn > 0) ? m_epsp*pt.m_epsp*psf : 0.;
+							double epsp = (tn > 0) ? m_epsp*pt.m_epsp*psf : 0.;
 						
-						// --- S O L I D - P R E S S U R E   C O N T A C T ---
+							// --- S O L I D - P R E S S U R E   C O N T A C T ---
 						
-						if (!m_bsymm)
-						{
+							if (!m_bsymm)
+							{
 							
-							// a. q-term
-							//-------------------------------------
+								// a. q-term
+								//-------------------------------------
 							
-							double dpmr, dpms;
-							dpmr = me.eval_deriv1(pm, r, s);
-							dpms = me.eval_deriv2(pm, r, s);
+								double dpmr, dpms;
+								dpmr = me.eval_deriv1(pm, r, s);
+								dpms = me.eval_deriv2(pm, r, s);
 							
-							for (k=0; k<nseln+nmeln; ++k)
-								for (l=0; l<nseln+nmeln; ++l)
-								{
-									ke[4*k + 3][4*l  ] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].x + dpms*Gm[1].x);
-									ke[4*k + 3][4*l+1] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].y + dpms*Gm[1].y);
-									ke[4*k + 3][4*l+2] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].z + dpms*Gm[1].z);
-								}
+								for (k=0; k<nseln+nmeln; ++k)
+									for (l=0; l<nseln+nmeln; ++l)
+									{
+										ke[4*k + 3][4*l  ] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].x + dpms*Gm[1].x);
+										ke[4*k + 3][4*l+1] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].y + dpms*Gm[1].y);
+										ke[4*k + 3][4*l+2] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].z + dpms*Gm[1].z);
+									}
 							
-							double wn = pt.m_Lmp + epsp*pt.m_pg;
+								double wn = pt.m_Lmp + epsp*pt.m_pg;
 							
-							// b. A-term
-							//-------------------------------------
+								// b. A-term
+								//-------------------------------------
 							
-							for (l=0; l<nseln; ++l)
-								for (k=0; k<nseln+nmeln; ++k)
-								{
-									ke[4*k + 3][4*l  ] -= dt*w[j]*wn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
-									ke[4*k + 3][4*l+1] -= dt*w[j]*wn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
-									ke[4*k + 3][4*l+2] -= dt*w[j]*wn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
-								}
+								for (l=0; l<nseln; ++l)
+									for (k=0; k<nseln+nmeln; ++k)
+									{
+										ke[4*k + 3][4*l  ] -= dt*w[j]*wn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
+										ke[4*k + 3][4*l+1] -= dt*w[j]*wn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
+										ke[4*k + 3][4*l+2] -= dt*w[j]*wn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
+									}
 							
-							// c. m-term
-							//---------------------------------------
+								// c. m-term
+								//---------------------------------------
 							
-							for (k=0; k<nmeln; ++k)
-								for (l=0; l<nseln+nmeln; ++l)
-								{
-									ke[4*(k+nseln) + 3][4*l  ] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].x;
-									ke[4*(k+nseln) + 3][4*l+1] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].y;
-									ke[4*(k+nseln) + 3][4*l+2] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].z;
-								}
-						}
+								for (k=0; k<nmeln; ++k)
+									for (l=0; l<nseln+nmeln; ++l)
+									{
+										ke[4*(k+nseln) + 3][4*l  ] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].x;
+										ke[4*(k+nseln) + 3][4*l+1] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].y;
+										ke[4*(k+nseln) + 3][4*l+2] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].z;
+									}
+							}
 						
 						
-						// --- P R E S S U R E - P R E S S U R E   C O N T A C T ---
+							// --- P R E S S U R E - P R E S S U R E   C O N T A C T ---
 						
-						// calculate the N-vector
-						for (k=0; k<nseln; ++k)
-						{
-							N[ndpn*k  ] = 0;
-							N[ndpn*k+1] = 0;
-							N[ndpn*k+2] = 0;
-							N[ndpn*k+3] = Hs[k];
-						}
+							// calculate the N-vector
+							for (k=0; k<nseln; ++k)
+							{
+								N[ndpn*k  ] = 0;
+								N[ndpn*k+1] = 0;
+								N[ndpn*k+2] = 0;
+								N[ndpn*k+3] = Hs[k];
+							}
 						
-						for (k=0; k<nmeln; ++k)
-						{
-							N[ndpn*(k+nseln)  ] = 0;
-							N[ndpn*(k+nseln)+1] = 0;
-							N[ndpn*(k+nseln)+2] = 0;
-							N[ndpn*(k+nseln)+3] = -Hm[k];
-						}
+							for (k=0; k<nmeln; ++k)
+							{
+								N[ndpn*(k+nseln)  ] = 0;
+								N[ndpn*(k+nseln)+1] = 0;
+								N[ndpn*(k+nseln)+2] = 0;
+								N[ndpn*(k+nseln)+3] = -Hm[k];
+							}
 						
-						for (k=0; k<ndof; ++k)
-							for (l=0; l<ndof; ++l) ke[k][l] -= dt*epsp*w[j]*detJ[j]*N[k]*N[l];
+							for (k=0; k<ndof; ++k)
+								for (l=0; l<ndof; ++l) ke[k][l] -= dt*epsp*w[j]*detJ[j]*N[k]*N[l];
 						
-					}
+						}
 					
-					// assemble the global stiffness
-					ke.SetNodes(en);
-					ke.SetIndices(LM);
-					LS.Assemble(ke);
+						// assemble the global stiffness
+						ke.SetNodes(en);
+						ke.SetIndices(LM);
+						LS.Assemble(ke);
+					}
 				}
 			}
 		}
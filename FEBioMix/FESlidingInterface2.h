@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEBioMech/FEContactInterface.h"
 #include "FEBiphasicContactSurface.h"
+#include <FECore/FEElementWorkspace.h>
 
 //-----------------------------------------------------------------------------
 class FEBIOMIX_API FESlidingSurface2 : public FEBiphasicContactSurface
@@ -193,5 +194,7 @@ public:
 protected:
 	int	m_dofP;
 
+	FEElementWorkspace	m_work;	//!< per-thread element buffers for the assembly loops
+
 	DECLARE_FECORE_CLASS();
 };
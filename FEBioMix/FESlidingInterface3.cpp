@@ -35,6 +35,7 @@ SOFTWARE.*/
 #include "FECore/DOFS.h"
 #include "FECore/FENormalProjection.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/sys.h>
 #include <FECore/FEAnalysis.h>
 
 //-----------------------------------------------------------------------------
@@ -791,13 +792,6 @@ double FESlidingInterface3::AutoConcentrationPenalty(FESurfaceElement& el, FESli
 void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface3& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
-	
-	double ps[FEElement::MAX_NODES], p1;
-	double cs[FEElement::MAX_NODES], c1;
 	
 	double R = m_srad*mesh.GetBoundingBox().radius();
 	
@@ -862,8 +856,11 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
     }
     
 	// loop over all integration points
-//    #pragma omp parallel for shared(R, bupseg)
-	for (int i=0; i<ss.Elements(); ++i)
+	// (the ray queries are read-only and each element only updates its own
+	// integration point data, so the elements can be processed in parallel)
+	int NE = ss.Elements();
+#pragma omp parallel for shared(np, R) schedule(dynamic)
+	for (int i=0; i<NE; ++i)
 	{
 		FESurfaceElement& el = ss.Element(i);
 
@@ -873,6 +870,9 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 		
 		int ne = el.Nodes();
 		int nint = el.GaussPoints();
+
+		double ps[FEElement::MAX_NODES], p1 = 0;
+		double cs[FEElement::MAX_NODES], c1 = 0;
 		
 		// get the nodal pressures
 		if (sporo)
@@ -891,7 +891,7 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 			FESlidingSurface3::Data& pt = static_cast<FESlidingSurface3::Data&>(*el.GetMaterialPoint(j));
 
 			// calculate the global position of the integration point
-			r = ss.Local2Global(el, j);
+			vec3d r = ss.Local2Global(el, j);
 			
 			// get the pressure at the integration point
 			if (sporo) p1 = el.eval(ps, j);
@@ -900,10 +900,11 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 			if (ssolu) c1 = el.eval(cs, j);
 			
 			// calculate the normal at this integration point
-			nu = ss.SurfaceNormal(el, j);
+			vec3d nu = ss.SurfaceNormal(el, j);
 			
 			// first see if the old intersected face is still good enough
-			pme = pt.m_pme;
+			FESurfaceElement* pme = pt.m_pme;
+			double rs[2] = {0,0};
 			if (pme)
 			{
 				double g;
@@ -940,7 +941,7 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 				
 				double eps = m_epsn*pt.m_epsn*psf;
 				
-				Ln = pt.m_Lmd + eps*g;
+				double Ln = pt.m_Lmd + eps*g;
 				
 				pt.m_gap = (g <= R? g : 0);
 				
@@ -1147,11 +1148,7 @@ void FESlidingInterface3::Update()
 //-----------------------------------------------------------------------------
 void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double N[10*MN];
 
 	FEModel& fem = *GetFEModel();
 
@@ -1171,198 +1168,219 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all primary surface elements
-		for (int i = 0; i<ss.Elements(); ++i)
+		// (each thread uses its own element buffers and contact force sums)
+		int NE = ss.Elements();
+		m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
 		{
-			// get the surface element
-			FESurfaceElement& se = ss.Element(i);
+			FEElementBuffer& buf = m_work.ThreadBuffer();
+			vector<int>& LM = buf.lm;
+			vector<int> sLM, mLM, en;
+			vector<double>& fe = buf.fe;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			double N[10*MN];
+			vec3d Fs(0,0,0), Fm(0,0,0);
+
+#pragma omp for schedule(dynamic)
+			for (int i=0; i<NE; ++i)
+			{
+				// get the surface element
+				FESurfaceElement& se = ss.Element(i);
 
-			bool sporo = ss.m_poro[i];
-			int sid = ss.m_solu[i];
-			bool ssolu = (sid > -1) ? true : false;
+				bool sporo = ss.m_poro[i];
+				int sid = ss.m_solu[i];
+				bool ssolu = (sid > -1) ? true : false;
 			
-			// get the nr of nodes and integration points
-			int nseln = se.Nodes();
-			int nint = se.GaussPoints();
+				// get the nr of nodes and integration points
+				int nseln = se.Nodes();
+				int nint = se.GaussPoints();
 			
-			// copy the LM vector; we'll need it later
-			ss.UnpackLM(se, sLM);
+				// copy the LM vector; we'll need it later
+				ss.UnpackLM(se, sLM);
 			
-			// we calculate all the metrics we need before we
-			// calculate the nodal forces
-			for (int j = 0; j<nint; ++j)
-			{
-				// get the base vectors
-				vec3d g[2];
-				ss.CoBaseVectors(se, j, g);
+				// we calculate all the metrics we need before we
+				// calculate the nodal forces
+				for (int j = 0; j<nint; ++j)
+				{
+					// get the base vectors
+					vec3d g[2];
+					ss.CoBaseVectors(se, j, g);
 				
-				// jacobians: J = |g0xg1|
-				detJ[j] = (g[0] ^ g[1]).norm();
+					// jacobians: J = |g0xg1|
+					detJ[j] = (g[0] ^ g[1]).norm();
 				
-				// integration weights
-				w[j] = se.GaussWeights()[j];
-			}
+					// integration weights
+					w[j] = se.GaussWeights()[j];
+				}
 			
-			// loop over all integration points
-			// note that we are integrating over the current surface
-			for (int j = 0; j<nint; ++j)
-			{
-				FESlidingSurface3::Data& pt = static_cast<FESlidingSurface3::Data&>(*se.GetMaterialPoint(j));
-				// get the secondary surface element
-				FESurfaceElement* pme = pt.m_pme;
-				if (pme)
+				// loop over all integration points
+				// note that we are integrating over the current surface
+				for (int j = 0; j<nint; ++j)
 				{
+					FESlidingSurface3::Data& pt = static_cast<FESlidingSurface3::Data&>(*se.GetMaterialPoint(j));
 					// get the secondary surface element
-					FESurfaceElement& me = *pme;
+					FESurfaceElement* pme = pt.m_pme;
+					if (pme)
+					{
+						// get the secondary surface element
+						FESurfaceElement& me = *pme;
 
-					bool mporo = ms.m_poro[pme->m_lid];
-					int mid = ms.m_solu[pme->m_lid];
-					bool msolu = (mid > -1) ? true : false;
+						bool mporo = ms.m_poro[pme->m_lid];
+						int mid = ms.m_solu[pme->m_lid];
+						bool msolu = (mid > -1) ? true : false;
 					
-					// get the nr of secondary surface element nodes
-					int nmeln = me.Nodes();
+						// get the nr of secondary surface element nodes
+						int nmeln = me.Nodes();
 					
-					// copy LM vector
-					ms.UnpackLM(me, mLM);
+						// copy LM vector
+						ms.UnpackLM(me, mLM);
 					
-					// calculate degrees of freedom
-					int ndof = 3*(nseln + nmeln);
+						// calculate degrees of freedom
+						int ndof = 3*(nseln + nmeln);
 					
-					// build the LM vector
-					LM.resize(ndof);
-					for (int k = 0; k<nseln; ++k)
-					{
-						LM[3*k  ] = sLM[3*k  ];
-						LM[3*k+1] = sLM[3*k+1];
-						LM[3*k+2] = sLM[3*k+2];
-					}
+						// build the LM vector
+						LM.resize(ndof);
+						for (int k = 0; k<nseln; ++k)
+						{
+							LM[3*k  ] = sLM[3*k  ];
+							LM[3*k+1] = sLM[3*k+1];
+							LM[3*k+2] = sLM[3*k+2];
+						}
 					
-					for (int k = 0; k<nmeln; ++k)
-					{
-						LM[3*(k+nseln)  ] = mLM[3*k  ];
-						LM[3*(k+nseln)+1] = mLM[3*k+1];
-						LM[3*(k+nseln)+2] = mLM[3*k+2];
-					}
+						for (int k = 0; k<nmeln; ++k)
+						{
+							LM[3*(k+nseln)  ] = mLM[3*k  ];
+							LM[3*(k+nseln)+1] = mLM[3*k+1];
+							LM[3*(k+nseln)+2] = mLM[3*k+2];
+						}
 					
-					// build the en vector
-					en.resize(nseln+nmeln);
-					for (int k = 0; k<nseln; ++k) en[k] = se.m_node[k];
-					for (int k = 0; k<nmeln; ++k) en[k + nseln] = me.m_node[k];
+						// build the en vector
+						en.resize(nseln+nmeln);
+						for (int k = 0; k<nseln; ++k) en[k] = se.m_node[k];
+						for (int k = 0; k<nmeln; ++k) en[k + nseln] = me.m_node[k];
 					
-					// get element shape functions
-					Hs = se.H(j);
+						// get element shape functions
+						Hs = se.H(j);
 					
-					// get secondary surface element shape functions
-					double r = pt.m_rs[0];
-					double s = pt.m_rs[1];
-					me.shape_fnc(Hm, r, s);
+						// get secondary surface element shape functions
+						double r = pt.m_rs[0];
+						double s = pt.m_rs[1];
+						me.shape_fnc(Hm, r, s);
 					
-					// get normal vector
-					vec3d nu = pt.m_nu;
+						// get normal vector
+						vec3d nu = pt.m_nu;
 					
-					// gap function
-					double g = pt.m_gap;
+						// gap function
+						double g = pt.m_gap;
 					
-					// lagrange multiplier
-					double Lm = pt.m_Lmd;
+						// lagrange multiplier
+						double Lm = pt.m_Lmd;
 					
-					// penalty 
-					double eps = m_epsn*pt.m_epsn*psf;
+						// penalty 
+						double eps = m_epsn*pt.m_epsn*psf;
 					
-					// contact traction
-					double tn = Lm + eps*g;
-					tn = MBRACKET(tn);
+						// contact traction
+						double tn = Lm + eps*g;
+						tn = MBRACKET(tn);
 					
-					// calculate the force vector
-					fe.resize(ndof);
-					zero(fe);
+						// calculate the force vector
+						fe.resize(ndof);
+						zero(fe);
 					
-					for (int k = 0; k<nseln; ++k)
-					{
-						N[3*k  ] = -Hs[k]*nu.x;
-						N[3*k+1] = -Hs[k]*nu.y;
-						N[3*k+2] = -Hs[k]*nu.z;
-					}
+						for (int k = 0; k<nseln; ++k)
+						{
+							N[3*k  ] = -Hs[k]*nu.x;
+							N[3*k+1] = -Hs[k]*nu.y;
+							N[3*k+2] = -Hs[k]*nu.z;
+						}
 					
-					for (int k = 0; k<nmeln; ++k)
-					{
-						N[3*(k+nseln)  ] = Hm[k]*nu.x;
-						N[3*(k+nseln)+1] = Hm[k]*nu.y;
-						N[3*(k+nseln)+2] = Hm[k]*nu.z;
-					}
+						for (int k = 0; k<nmeln; ++k)
+						{
+							N[3*(k+nseln)  ] = Hm[k]*nu.x;
+							N[3*(k+nseln)+1] = Hm[k]*nu.y;
+							N[3*(k+nseln)+2] = Hm[k]*nu.z;
+						}
 					
-					for (int k = 0; k<ndof; ++k) fe[k] += tn*N[k] * detJ[j] * w[j];
+						for (int k = 0; k<ndof; ++k) fe[k] += tn*N[k] * detJ[j] * w[j];
 					
-                    for (int k=0; k<nseln; ++k)
-                    {
-                        ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
-                    }
+	                    for (int k=0; k<nseln; ++k)
+	                    {
+	                        Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+	                    }
                     
-                    for (int k = 0; k<nmeln; ++k)
-                    {
-                        ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
-                    }
+	                    for (int k = 0; k<nmeln; ++k)
+	                    {
+	                        Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+	                    }
                     
-					// assemble the global residual
-					R.Assemble(en, LM, fe);
+						// assemble the global residual
+						R.Assemble(en, LM, fe);
 					
-					// do the biphasic stuff
-					if (tn > 0)
-					{
-						if (sporo && mporo)
+						// do the biphasic stuff
+						if (tn > 0)
 						{
-							// calculate nr of pressure dofs
-							int ndof = nseln + nmeln;
+							if (sporo && mporo)
+							{
+								// calculate nr of pressure dofs
+								int ndof = nseln + nmeln;
 							
-							// calculate the flow rate
-							double epsp = m_epsp*pt.m_epsp*psf;
+								// calculate the flow rate
+								double epsp = m_epsp*pt.m_epsp*psf;
 							
-							double wn = pt.m_Lmp + epsp*pt.m_pg;
+								double wn = pt.m_Lmp + epsp*pt.m_pg;
 							
-							// fill the LM
-							LM.resize(ndof);
-							for (int k = 0; k<nseln; ++k) LM[k] = sLM[3 * nseln + k];
-							for (int k = 0; k<nmeln; ++k) LM[k + nseln] = mLM[3 * nmeln + k];
+								// fill the LM
+								LM.resize(ndof);
+								for (int k = 0; k<nseln; ++k) LM[k] = sLM[3 * nseln + k];
+								for (int k = 0; k<nmeln; ++k) LM[k + nseln] = mLM[3 * nmeln + k];
 							
-							// fill the force array
-							fe.resize(ndof);
-							zero(fe);
-							for (int k = 0; k<nseln; ++k) N[k] = Hs[k];
-							for (int k = 0; k<nmeln; ++k) N[k + nseln] = -Hm[k];
+								// fill the force array
+								fe.resize(ndof);
+								zero(fe);
+								for (int k = 0; k<nseln; ++k) N[k] = Hs[k];
+								for (int k = 0; k<nmeln; ++k) N[k + nseln] = -Hm[k];
 							
-							for (int k = 0; k<ndof; ++k) fe[k] += dt*wn*N[k] * detJ[j] * w[j];
+								for (int k = 0; k<ndof; ++k) fe[k] += dt*wn*N[k] * detJ[j] * w[j];
 							
-							// assemble residual
-							R.Assemble(en, LM, fe);
-						}
-						if (ssolu && msolu && (sid == mid))
-						{
-							// calculate nr of concentration dofs
-							int ndof = nseln + nmeln;
+								// assemble residual
+								R.Assemble(en, LM, fe);
+							}
+							if (ssolu && msolu && (sid == mid))
+							{
+								// calculate nr of concentration dofs
+								int ndof = nseln + nmeln;
 							
-							// calculate the flow rate
-							double epsc = m_epsc*pt.m_epsc*psf;
+								// calculate the flow rate
+								double epsc = m_epsc*pt.m_epsc*psf;
 							
-							double jn = pt.m_Lmc + epsc*pt.m_cg;
+								double jn = pt.m_Lmc + epsc*pt.m_cg;
 							
-							// fill the LM
-							LM.resize(ndof);
-							for (int k=0; k<nseln; ++k) LM[k        ] = sLM[(4+sid)*nseln+k];
-							for (int k=0; k<nmeln; ++k) LM[k + nseln] = mLM[(4+mid)*nmeln+k];
+								// fill the LM
+								LM.resize(ndof);
+								for (int k=0; k<nseln; ++k) LM[k        ] = sLM[(4+sid)*nseln+k];
+								for (int k=0; k<nmeln; ++k) LM[k + nseln] = mLM[(4+mid)*nmeln+k];
 							
-							// fill the force array
-							fe.resize(ndof);
-							zero(fe);
-							for (int k=0; k<nseln; ++k) N[k      ] =  Hs[k];
-							for (int k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+								// fill the force array
+								fe.resize(ndof);
+								zero(fe);
+								for (int k=0; k<nseln; ++k) N[k      ] =  Hs[k];
+								for (int k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
 							
-							for (int k = 0; k<ndof; ++k) fe[k] += dt*jn*N[k] * detJ[j] * w[j];
+								for (int k = 0; k<ndof; ++k) fe[k] += dt*jn*N[k] * detJ[j] * w[j];
 							
-							// assemble residual
-							R.Assemble(en, LM, fe);
+								// assemble residual
+								R.Assemble(en, LM, fe);
+							}
 						}
 					}
 				}
 			}
+
+#pragma omp critical
+			{
+				ss.m_Ft += Fs;
+				ms.m_Ft += Fm;
+			}
 		}
 	}
 }
@@ -1370,14 +1388,7 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 //-----------------------------------------------------------------------------
 void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	int i, j, k, l;
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double pt[MN], dpr[MN], dps[MN];
-	double ct[MN], dcr[MN], dcs[MN];
-	double N[10*MN];
-	FEElementMatrix ke;
 
 	FEModel& fem = *GetFEModel();
 
@@ -1411,555 +1422,572 @@ void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		// (each thread uses its own element buffers)
+		int NE = ss.Elements();
+		m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
 		{
-			// get the next element
-			FESurfaceElement& se = ss.Element(i);
+			FEElementBuffer& buf = m_work.ThreadBuffer();
+			int j, k, l;
+			vector<int>& LM = buf.lm;
+			vector<int> sLM, mLM, en;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			double pt[MN], dpr[MN], dps[MN];
+			double ct[MN], dcr[MN], dcs[MN];
+			double N[10*MN];
+			FEElementMatrix& ke = buf.ke;
+
+#pragma omp for schedule(dynamic)
+			for (int i=0; i<NE; ++i)
+			{
+				// get the next element
+				FESurfaceElement& se = ss.Element(i);
 
-			bool sporo = ss.m_poro[i];
-			int sid = ss.m_solu[i];
-			bool ssolu = (sid > -1) ? true : false;
+				bool sporo = ss.m_poro[i];
+				int sid = ss.m_solu[i];
+				bool ssolu = (sid > -1) ? true : false;
 			
-			// get nr of nodes and integration points
-			int nseln = se.Nodes();
-			int nint = se.GaussPoints();
+				// get nr of nodes and integration points
+				int nseln = se.Nodes();
+				int nint = se.GaussPoints();
 
-			double pn[FEElement::MAX_NODES], cn[FEElement::MAX_NODES];
-			for (j=0; j<nseln; ++j)
-			{
-				pn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofP);
-				cn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofC + sid);
-			}
+				double pn[FEElement::MAX_NODES], cn[FEElement::MAX_NODES];
+				for (j=0; j<nseln; ++j)
+				{
+					pn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofP);
+					cn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofC + sid);
+				}
 			
-			// copy the LM vector
-			ss.UnpackLM(se, sLM);
+				// copy the LM vector
+				ss.UnpackLM(se, sLM);
 			
-			// we calculate all the metrics we need before we
-			// calculate the nodal forces
-			for (j=0; j<nint; ++j)
-			{
-				// get the base vectors
-				vec3d g[2];
-				ss.CoBaseVectors(se, j, g);
+				// we calculate all the metrics we need before we
+				// calculate the nodal forces
+				for (j=0; j<nint; ++j)
+				{
+					// get the base vectors
+					vec3d g[2];
+					ss.CoBaseVectors(se, j, g);
 				
-				// jacobians: J = |g0xg1|
-				detJ[j] = (g[0] ^ g[1]).norm();
+					// jacobians: J = |g0xg1|
+					detJ[j] = (g[0] ^ g[1]).norm();
 				
-				// integration weights
-				w[j] = se.GaussWeights()[j];
+					// integration weights
+					w[j] = se.GaussWeights()[j];
 				
-				// pressure
-				if (sporo)
-				{
-					pt[j] = se.eval(pn, j);
-					dpr[j] = se.eval_deriv1(pn, j);
-					dps[j] = se.eval_deriv2(pn, j);
-				}
-				// concentration
-				if (ssolu)
-				{
-					ct[j] = se.eval(cn, j);
-					dcr[j] = se.eval_deriv1(cn, j);
-					dcs[j] = se.eval_deriv2(cn, j);
+					// pressure
+					if (sporo)
+					{
+						pt[j] = se.eval(pn, j);
+						dpr[j] = se.eval_deriv1(pn, j);
+						dps[j] = se.eval_deriv2(pn, j);
+					}
+					// concentration
+					if (ssolu)
+					{
+						ct[j] = se.eval(cn, j);
+						dcr[j] = se.eval_deriv1(cn, j);
+						dcs[j] = se.eval_deriv2(cn, j);
+					}
 				}
-			}
 			
-			// loop over all integration points
-			for (j=0; j<nint; ++j)
-			{
-				FESlidingSurface3::Data& pt = static_cast<FESlidingSurface3::Data&>(*se.GetMaterialPoint(j));
-
-				// get the secondary surface element
-				FESurfaceElement* pme = pt.m_pme;
-				if (pme)
+				// loop over all integration points
+				for (j=0; j<nint; ++j)
 				{
-					FESurfaceElement& me = *pme;
+					FESlidingSurface3::Data& pt = static_cast<FESlidingSurface3::Data&>(*se.GetMaterialPoint(j));
 
-					bool mporo = ms.m_poro[pme->m_lid];
-					int mid = ms.m_solu[pme->m_lid];
-					bool msolu = (mid > -1) ? true : false;
+					// get the secondary surface element
+					FESurfaceElement* pme = pt.m_pme;
+					if (pme)
+					{
+						FESurfaceElement& me = *pme;
+
+						bool mporo = ms.m_poro[pme->m_lid];
+						int mid = ms.m_solu[pme->m_lid];
+						bool msolu = (mid > -1) ? true : false;
 					
-					// get the nr of nodes
-					int nmeln = me.Nodes();
+						// get the nr of nodes
+						int nmeln = me.Nodes();
 
-					// nodal data
-					double pm[FEElement::MAX_NODES], cm[FEElement::MAX_NODES];
-					for (k=0; k<nmeln; ++k)
-					{
-						pm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofP);
-						cm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofC + mid);
-					}
+						// nodal data
+						double pm[FEElement::MAX_NODES], cm[FEElement::MAX_NODES];
+						for (k=0; k<nmeln; ++k)
+						{
+							pm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofP);
+							cm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofC + mid);
+						}
 					
-					// copy the LM vector
-					ms.UnpackLM(me, mLM);
+						// copy the LM vector
+						ms.UnpackLM(me, mLM);
 					
-					int ndpn;	// number of dofs per node
-					int ndof;	// number of dofs in stiffness matrix
+						int ndpn;	// number of dofs per node
+						int ndof;	// number of dofs in stiffness matrix
 					
-					if (ssolu && msolu && (sid == mid)) {
-						// calculate dofs for biphasic-solute contact
-						ndpn = 5;
-						ndof = ndpn*(nseln+nmeln);
+						if (ssolu && msolu && (sid == mid)) {
+							// calculate dofs for biphasic-solute contact
+							ndpn = 5;
+							ndof = ndpn*(nseln+nmeln);
 						
-						// build the LM vector
-						LM.resize(ndof);
+							// build the LM vector
+							LM.resize(ndof);
 						
-						for (k=0; k<nseln; ++k)
-						{
-							LM[ndpn*k  ] = sLM[3*k  ];			// x-dof
-							LM[ndpn*k+1] = sLM[3*k+1];			// y-dof
-							LM[ndpn*k+2] = sLM[3*k+2];			// z-dof
-							LM[ndpn*k+3] = sLM[3*nseln+k];		// p-dof
-							LM[ndpn*k+4] = sLM[(4+sid)*nseln+k];		// c-dof
-						}
-						for (k=0; k<nmeln; ++k)
-						{
-							LM[ndpn*(k+nseln)  ] = mLM[3*k  ];			// x-dof
-							LM[ndpn*(k+nseln)+1] = mLM[3*k+1];			// y-dof
-							LM[ndpn*(k+nseln)+2] = mLM[3*k+2];			// z-dof
-							LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];		// p-dof
-							LM[ndpn*(k+nseln)+4] = mLM[(4+mid)*nmeln+k];		// c-dof
+							for (k=0; k<nseln; ++k)
+							{
+								LM[ndpn*k  ] = sLM[3*k  ];			// x-dof
+								LM[ndpn*k+1] = sLM[3*k+1];			// y-dof
+								LM[ndpn*k+2] = sLM[3*k+2];			// z-dof
+								LM[ndpn*k+3] = sLM[3*nseln+k];		// p-dof
+								LM[ndpn*k+4] = sLM[(4+sid)*nseln+k];		// c-dof
+							}
+							for (k=0; k<nmeln; ++k)
+							{
+								LM[ndpn*(k+nseln)  ] = mLM[3*k  ];			// x-dof
+								LM[ndpn*(k+nseln)+1] = mLM[3*k+1];			// y-dof
+								LM[ndpn*(k+nseln)+2] = mLM[3*k+2];			// z-dof
+								LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];		// p-dof
+								LM[ndpn*(k+nseln)+4] = mLM[(4+mid)*nmeln+k];		// c-dof
+							}
 						}
-					}
 					
-					else if (sporo && mporo) {
-						// calculate dofs for biphasic contact
-						ndpn = 4;
-						ndof = ndpn*(nseln+nmeln);
+						else if (sporo && mporo) {
+							// calculate dofs for biphasic contact
+							ndpn = 4;
+							ndof = ndpn*(nseln+nmeln);
 						
-						// build the LM vector
-						LM.resize(ndof);
+							// build the LM vector
+							LM.resize(ndof);
 						
-						for (k=0; k<nseln; ++k)
-						{
-							LM[ndpn*k  ] = sLM[3*k  ];			// x-dof
-							LM[ndpn*k+1] = sLM[3*k+1];			// y-dof
-							LM[ndpn*k+2] = sLM[3*k+2];			// z-dof
-							LM[ndpn*k+3] = sLM[3*nseln+k];		// p-dof
-						}
-						for (k=0; k<nmeln; ++k)
-						{
-							LM[ndpn*(k+nseln)  ] = mLM[3*k  ];			// x-dof
-							LM[ndpn*(k+nseln)+1] = mLM[3*k+1];			// y-dof
-							LM[ndpn*(k+nseln)+2] = mLM[3*k+2];			// z-dof
-							LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];		// p-dof
+							for (k=0; k<nseln; ++k)
+							{
+								LM[ndpn*k  ] = sLM[3*k  ];			// x-dof
+								LM[ndpn*k+1] = sLM[3*k+1];			// y-dof
+								LM[ndpn*k+2] = sLM[3*k+2];			// z-dof
+								LM[ndpn*k+3] = sLM[3*nseln+k];		// p-dof
+							}
+							for (k=0; k<nmeln; ++k)
+							{
+								LM[ndpn*(k+nseln)  ] = mLM[3*k  ];			// x-dof
+								LM[ndpn*(k+nseln)+1] = mLM[3*k+1];			// y-dof
+								LM[ndpn*(k+nseln)+2] = mLM[3*k+2];			// z-dof
+								LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];		// p-dof
+							}
 						}
-					}
 					
-					else {
-						// calculate dofs for elastic contact
-						ndpn = 3;
-						ndof = ndpn*(nseln + nmeln);
+						else {
+							// calculate dofs for elastic contact
+							ndpn = 3;
+							ndof = ndpn*(nseln + nmeln);
 						
-						// build the LM vector
-						LM.resize(ndof);
+							// build the LM vector
+							LM.resize(ndof);
 						
-						for (k=0; k<nseln; ++k)
-						{
-							LM[3*k  ] = sLM[3*k  ];
-							LM[3*k+1] = sLM[3*k+1];
-							LM[3*k+2] = sLM[3*k+2];
-						}
+							for (k=0; k<nseln; ++k)
+							{
+								LM[3*k  ] = sLM[3*k  ];
+								LM[3*k+1] = sLM[3*k+1];
+								LM[3*k+2] = sLM[3*k+2];
+							}
 						
-						for (k=0; k<nmeln; ++k)
-						{
-							LM[3*(k+nseln)  ] = mLM[3*k  ];
-							LM[3*(k+nseln)+1] = mLM[3*k+1];
-							LM[3*(k+nseln)+2] = mLM[3*k+2];
+							for (k=0; k<nmeln; ++k)
+							{
+								LM[3*(k+nseln)  ] = mLM[3*k  ];
+								LM[3*(k+nseln)+1] = mLM[3*k+1];
+								LM[3*(k+nseln)+2] = mLM[3*k+2];
+							}
 						}
-					}
-					
-					// build the en vector
-					en.resize(nseln+nmeln);
-					for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
-					for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
-					
-					// shape functions
-					Hs = se.H(j);
 					
-					// secondary surface element shape functions
-					double r = pt.m_rs[0];
-					double s = pt.m_rs[1];
-					me.shape_fnc(Hm, r, s);
+						// build the en vector
+						en.resize(nseln+nmeln);
+						for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
+						for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
 					
-					// get normal vector
-					vec3d nu = pt.m_nu;
+						// shape functions
+						Hs = se.H(j);
 					
-					// gap function
-					double g = pt.m_gap;
+						// secondary surface element shape functions
+						double r = pt.m_rs[0];
+						double s = pt.m_rs[1];
+						me.shape_fnc(Hm, r, s);
 					
-					// lagrange multiplier
-					double Lm = pt.m_Lmd;
+						// get normal vector
+						vec3d nu = pt.m_nu;
 					
-					// penalty 
-					double eps = m_epsn*pt.m_epsn*psf;
+						// gap function
+						double g = pt.m_gap;
 					
-					// contact traction
-					double tn = Lm + eps*g;
-					tn = MBRACKET(tn);
+						// lagrange multiplier
+						double Lm = pt.m_Lmd;
 					
-					//	double dtn = m_eps*HEAVYSIDE(Lm + eps*g);
-					double dtn = (tn > 0.? eps :0.);
+						// penalty 
+						double eps = m_epsn*pt.m_epsn*psf;
 					
-					// create the stiffness matrix
-					ke.resize(ndof, ndof); ke.zero();
+						// contact traction
+						double tn = Lm + eps*g;
+						tn = MBRACKET(tn);
 					
-					// --- S O L I D - S O L I D   C O N T A C T ---
+						//	double dtn = m_eps*HEAVYSIDE(Lm + eps*g);
+						double dtn = (tn > 0.? eps :0.);
 					
-					// a. NxN-term
-					//------------------------------------
+						// create the stiffness matrix
+						ke.resize(ndof, ndof); ke.zero();
 					
-					// calculate the N-vector
-					for (k=0; k<nseln; ++k)
-					{
-						N[ndpn*k  ] = Hs[k]*nu.x;
-						N[ndpn*k+1] = Hs[k]*nu.y;
-						N[ndpn*k+2] = Hs[k]*nu.z;
-					}
+						// --- S O L I D - S O L I D   C O N T A C T ---
 					
-					for (k=0; k<nmeln; ++k)
-					{
-						N[ndpn*(k+nseln)  ] = -Hm[k]*nu.x;
-						N[ndpn*(k+nseln)+1] = -Hm[k]*nu.y;
-						N[ndpn*(k+nseln)+2] = -Hm[k]*nu.z;
-					}
+						// a. NxN-term
+						//------------------------------------
 					
-					if (ndpn == 5) {
+						// calculate the N-vector
 						for (k=0; k<nseln; ++k)
 						{
-							N[ndpn*k+3] = 0;
-							N[ndpn*k+4] = 0;
+							N[ndpn*k  ] = Hs[k]*nu.x;
+							N[ndpn*k+1] = Hs[k]*nu.y;
+							N[ndpn*k+2] = Hs[k]*nu.z;
 						}
+					
 						for (k=0; k<nmeln; ++k)
 						{
-							N[ndpn*(k+nseln)+3] = 0;
-							N[ndpn*(k+nseln)+4] = 0;
+							N[ndpn*(k+nseln)  ] = -Hm[k]*nu.x;
+							N[ndpn*(k+nseln)+1] = -Hm[k]*nu.y;
+							N[ndpn*(k+nseln)+2] = -Hm[k]*nu.z;
 						}
-					}
-					else if (ndpn == 4) {
-						for (k=0; k<nseln; ++k)
-							N[ndpn*k+3] = 0;
-						for (k=0; k<nmeln; ++k)
-							N[ndpn*(k+nseln)+3] = 0;
-					}
 					
-					for (k=0; k<ndof; ++k)
-						for (l=0; l<ndof; ++l) ke[k][l] += dtn*N[k]*N[l]*detJ[j]*w[j];
+						if (ndpn == 5) {
+							for (k=0; k<nseln; ++k)
+							{
+								N[ndpn*k+3] = 0;
+								N[ndpn*k+4] = 0;
+							}
+							for (k=0; k<nmeln; ++k)
+							{
+								N[ndpn*(k+nseln)+3] = 0;
+								N[ndpn*(k+nseln)+4] = 0;
+							}
+						}
+						else if (ndpn == 4) {
+							for (k=0; k<nseln; ++k)
+								N[ndpn*k+3] = 0;
+							for (k=0; k<nmeln; ++k)
+								N[ndpn*(k+nseln)+3] = 0;
+						}
 					
-					// b. A-term
-					//-------------------------------------
+						for (k=0; k<ndof; ++k)
+							for (l=0; l<ndof; ++l) ke[k][l] += dtn*N[k]*N[l]*detJ[j]*w[j];
 					
-					for (k=0; k<nseln; ++k) N[k      ] =  Hs[k];
-					for (k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+						// b. A-term
+						//-------------------------------------
 					
-					double* Gr = se.Gr(j);
-					double* Gs = se.Gs(j);
-					vec3d gs[2];
-					ss.CoBaseVectors(se, j, gs);
+						for (k=0; k<nseln; ++k) N[k      ] =  Hs[k];
+						for (k=0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
 					
-					mat3d S1, S2;
-					S1.skew(gs[0]);
-					S2.skew(gs[1]);
-					mat3d As[FEElement::MAX_NODES];
-					for (l=0; l<nseln; ++l)
-						As[l] = S2*Gr[l] - S1*Gs[l];
+						double* Gr = se.Gr(j);
+						double* Gs = se.Gs(j);
+						vec3d gs[2];
+						ss.CoBaseVectors(se, j, gs);
 					
-					if (!m_bsymm)
-					{	// non-symmetric
+						mat3d S1, S2;
+						S1.skew(gs[0]);
+						S2.skew(gs[1]);
+						mat3d As[FEElement::MAX_NODES];
 						for (l=0; l<nseln; ++l)
-						{
-							for (k=0; k<nseln+nmeln; ++k)
+							As[l] = S2*Gr[l] - S1*Gs[l];
+					
+						if (!m_bsymm)
+						{	// non-symmetric
+							for (l=0; l<nseln; ++l)
 							{
-								ke[k*ndpn  ][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][0][0];
-								ke[k*ndpn  ][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][0][1];
-								ke[k*ndpn  ][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][0][2];
+								for (k=0; k<nseln+nmeln; ++k)
+								{
+									ke[k*ndpn  ][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][0][0];
+									ke[k*ndpn  ][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][0][1];
+									ke[k*ndpn  ][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][0][2];
 								
-								ke[k*ndpn+1][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][1][0];
-								ke[k*ndpn+1][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][1][1];
-								ke[k*ndpn+1][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][1][2];
+									ke[k*ndpn+1][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][1][0];
+									ke[k*ndpn+1][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][1][1];
+									ke[k*ndpn+1][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][1][2];
 								
-								ke[k*ndpn+2][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][2][0];
-								ke[k*ndpn+2][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][2][1];
-								ke[k*ndpn+2][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][2][2];
+									ke[k*ndpn+2][l*ndpn  ] -= knmult*tn*w[j]*N[k]*As[l][2][0];
+									ke[k*ndpn+2][l*ndpn+1] -= knmult*tn*w[j]*N[k]*As[l][2][1];
+									ke[k*ndpn+2][l*ndpn+2] -= knmult*tn*w[j]*N[k]*As[l][2][2];
+								}
 							}
-						}
-					} 
-					else 
-					{	// symmetric
-						for (l=0; l<nseln; ++l)
-						{
-							for (k=0; k<nseln+nmeln; ++k)
+						} 
+						else 
+						{	// symmetric
+							for (l=0; l<nseln; ++l)
 							{
-								ke[k*ndpn  ][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
-								ke[k*ndpn  ][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
-								ke[k*ndpn  ][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
+								for (k=0; k<nseln+nmeln; ++k)
+								{
+									ke[k*ndpn  ][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
+									ke[k*ndpn  ][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
+									ke[k*ndpn  ][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
 								
-								ke[k*ndpn+1][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
-								ke[k*ndpn+1][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
-								ke[k*ndpn+1][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
+									ke[k*ndpn+1][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
+									ke[k*ndpn+1][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
+									ke[k*ndpn+1][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
 								
-								ke[k*ndpn+2][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
-								ke[k*ndpn+2][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
-								ke[k*ndpn+2][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
+									ke[k*ndpn+2][l*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
+									ke[k*ndpn+2][l*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
+									ke[k*ndpn+2][l*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
 								
-								ke[l*ndpn  ][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
-								ke[l*ndpn+1][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
-								ke[l*ndpn+2][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
+									ke[l*ndpn  ][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][0];
+									ke[l*ndpn+1][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][1];
+									ke[l*ndpn+2][k*ndpn  ] -= 0.5*knmult*tn*w[j]*N[k]*As[l][0][2];
 								
-								ke[l*ndpn  ][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
-								ke[l*ndpn+1][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
-								ke[l*ndpn+2][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
+									ke[l*ndpn  ][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][0];
+									ke[l*ndpn+1][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][1];
+									ke[l*ndpn+2][k*ndpn+1] -= 0.5*knmult*tn*w[j]*N[k]*As[l][1][2];
 								
-								ke[l*ndpn  ][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
-								ke[l*ndpn+1][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
-								ke[l*ndpn+2][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
+									ke[l*ndpn  ][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][0];
+									ke[l*ndpn+1][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][1];
+									ke[l*ndpn+2][k*ndpn+2] -= 0.5*knmult*tn*w[j]*N[k]*As[l][2][2];
+								}
 							}
 						}
-					}
 					
-					// c. M-term
-					//---------------------------------------
+						// c. M-term
+						//---------------------------------------
 					
-					vec3d Gm[2];
-					ms.ContraBaseVectors(me, r, s, Gm);
+						vec3d Gm[2];
+						ms.ContraBaseVectors(me, r, s, Gm);
 					
-					// evaluate secondary surface normal
-					vec3d mnu = Gm[0] ^ Gm[1];
-					mnu.unit();
+						// evaluate secondary surface normal
+						vec3d mnu = Gm[0] ^ Gm[1];
+						mnu.unit();
 					
-					double Hmr[FEElement::MAX_NODES], Hms[FEElement::MAX_NODES];
-					me.shape_deriv(Hmr, Hms, r, s);
-					vec3d mm[FEElement::MAX_NODES];
-					for (k=0; k<nmeln; ++k) 
-						mm[k] = Gm[0]*Hmr[k] + Gm[1]*Hms[k];
-					
-					if (!m_bsymm)
-					{	// non-symmetric
+						double Hmr[FEElement::MAX_NODES], Hms[FEElement::MAX_NODES];
+						me.shape_deriv(Hmr, Hms, r, s);
+						vec3d mm[FEElement::MAX_NODES];
 						for (k=0; k<nmeln; ++k) 
-						{
-							for (l=0; l<nseln+nmeln; ++l)
+							mm[k] = Gm[0]*Hmr[k] + Gm[1]*Hms[k];
+					
+						if (!m_bsymm)
+						{	// non-symmetric
+							for (k=0; k<nmeln; ++k) 
 							{
-								ke[(k+nseln)*ndpn  ][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
+								for (l=0; l<nseln+nmeln; ++l)
+								{
+									ke[(k+nseln)*ndpn  ][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+1][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+2][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn  ] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+1] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+2] += tn*knmult*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+								}
 							}
 						}
-					}
-					else
-					{	// symmetric
-						for (k=0; k<nmeln; ++k) 
-						{
-							for (l=0; l<nseln+nmeln; ++l)
+						else
+						{	// symmetric
+							for (k=0; k<nmeln; ++k) 
 							{
-								ke[(k+nseln)*ndpn  ][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn  ][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
+								for (l=0; l<nseln+nmeln; ++l)
+								{
+									ke[(k+nseln)*ndpn  ][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn  ][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+1][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+1][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+1][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
 								
-								ke[(k+nseln)*ndpn+2][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
-								ke[(k+nseln)*ndpn+2][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
+									ke[(k+nseln)*ndpn+2][l*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
 								
-								ke[l*ndpn  ][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
-								ke[l*ndpn+1][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
-								ke[l*ndpn+2][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
+									ke[l*ndpn  ][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].x*N[l];
+									ke[l*ndpn+1][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].x*N[l];
+									ke[l*ndpn+2][(k+nseln)*ndpn  ] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].x*N[l];
 								
-								ke[l*ndpn  ][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
-								ke[l*ndpn+1][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
-								ke[l*ndpn+2][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
+									ke[l*ndpn  ][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].y*N[l];
+									ke[l*ndpn+1][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].y*N[l];
+									ke[l*ndpn+2][(k+nseln)*ndpn+1] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].y*N[l];
 								
-								ke[l*ndpn  ][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
-								ke[l*ndpn+1][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
-								ke[l*ndpn+2][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+									ke[l*ndpn  ][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.x*mm[k].z*N[l];
+									ke[l*ndpn+1][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.y*mm[k].z*N[l];
+									ke[l*ndpn+2][(k+nseln)*ndpn+2] += 0.5*knmult*tn*detJ[j]*w[j]*mnu.z*mm[k].z*N[l];
+								}
 							}
 						}
-					}
 					
-					// --- B I P H A S I C - S O L U T E  S T I F F N E S S ---
-					if (ssolu && msolu && (sid == mid))
-					{
-						double dt = fem.GetTime().timeIncrement;
+						// --- B I P H A S I C - S O L U T E  S T I F F N E S S ---
+						if (ssolu && msolu && (sid == mid))
+						{
+							double dt = fem.GetTime().timeIncrement;
 						
-						double epsp = (tn > 0) ? m_epsp*pt.m_epsp*psf : 0.;
-						double epsc = (tn > 0) ? m_epsc*pt.m_epsc*psf : 0.;
+							double epsp = (tn > 0) ? m_epsp*pt.m_epsp*psf : 0.;
+							double epsc = (tn > 0) ? m_epsc*pt.m_epsc*psf : 0.;
 						
-						// --- S O L I D - P R E S S U R E / S O L U T E   C O N T A C T ---
+							// --- S O L I D - P R E S S U R E / S O L U T E   C O N T A C T ---
 						
-						if (!m_bsymm)
-						{
+							if (!m_bsymm)
+							{
 							
-							// a. q-term
-							//-------------------------------------
+								// a. q-term
+								//-------------------------------------
 							
-							double dpmr, dpms;
-							dpmr = me.eval_deriv1(pm, r, s);
-							dpms = me.eval_deriv2(pm, r, s);
+								double dpmr, dpms;
+								dpmr = me.eval_deriv1(pm, r, s);
+								dpms = me.eval_deriv2(pm, r, s);
 							
-							double dcmr, dcms;
-							dcmr = me.eval_deriv1(cm, r, s);
-							dcms = me.eval_deriv2(cm, r, s);
+								double dcmr, dcms;
+								dcmr = me.eval_deriv1(cm, r, s);
+								dcms = me.eval_deriv2(cm, r, s);
 							
-							for (k=0; k<nseln+nmeln; ++k)
-								for (l=0; l<nseln+nmeln; ++l)
-								{
-									ke[ndpn*k + 3][ndpn*l  ] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].x + dpms*Gm[1].x);
-									ke[ndpn*k + 3][ndpn*l+1] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].y + dpms*Gm[1].y);
-									ke[ndpn*k + 3][ndpn*l+2] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].z + dpms*Gm[1].z);
-
-									ke[ndpn*k + 4][ndpn*l  ] += dt*w[j]*detJ[j]*epsc*N[k]*N[l]*(dcmr*Gm[0].x + dcms*Gm[1].x);
-									ke[ndpn*k + 4][ndpn*l+1] += dt*w[j]*detJ[j]*epsc*N[k]*N[l]*(dcmr*Gm[0].y + dcms*Gm[1].y);
-									ke[ndpn*k + 4][ndpn*l+2] += dt*w[j]*detJ[j]*epsc*N[k]*N[l]*(dcmr*Gm[0].z + dcms*Gm[1].z);
-								}
+								for (k=0; k<nseln+nmeln; ++k)
+									for (l=0; l<nseln+nmeln; ++l)
+									{
+										ke[ndpn*k + 3][ndpn*l  ] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].x + dpms*Gm[1].x);
+										ke[ndpn*k + 3][ndpn*l+1] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].y + dpms*Gm[1].y);
+										ke[ndpn*k + 3][ndpn*l+2] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].z + dpms*Gm[1].z);
+
+										ke[ndpn*k + 4][ndpn*l  ] += dt*w[j]*detJ[j]*epsc*N[k]*N[l]*(dcmr*Gm[0].x + dcms*Gm[1].x);
+										ke[ndpn*k + 4][ndpn*l+1] += dt*w[j]*detJ[j]*epsc*N[k]*N[l]*(dcmr*Gm[0].y + dcms*Gm[1].y);
+										ke[ndpn*k + 4][ndpn*l+2] += dt*w[j]*detJ[j]*epsc*N[k]*N[l]*(dcmr*Gm[0].z + dcms*Gm[1].z);
+									}
 							
-							double wn = pt.m_Lmp + epsp*pt.m_pg;
-							double jn = pt.m_Lmc + epsc*pt.m_cg;
+								double wn = pt.m_Lmp + epsp*pt.m_pg;
+								double jn = pt.m_Lmc + epsc*pt.m_cg;
 							
-							// b. A-term
-							//-------------------------------------
+								// b. A-term
+								//-------------------------------------
 							
-							for (l=0; l<nseln; ++l)
-								for (k=0; k<nseln+nmeln; ++k)
-								{
-									ke[ndpn*k + 3][ndpn*l  ] -= dt*w[j]*wn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
-									ke[ndpn*k + 3][ndpn*l+1] -= dt*w[j]*wn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
-									ke[ndpn*k + 3][ndpn*l+2] -= dt*w[j]*wn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
-
-									ke[ndpn*k + 4][ndpn*l  ] -= dt*w[j]*jn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
-									ke[ndpn*k + 4][ndpn*l+1] -= dt*w[j]*jn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
-									ke[ndpn*k + 4][ndpn*l+2] -= dt*w[j]*jn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
-								}
+								for (l=0; l<nseln; ++l)
+									for (k=0; k<nseln+nmeln; ++k)
+									{
+										ke[ndpn*k + 3][ndpn*l  ] -= dt*w[j]*wn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
+										ke[ndpn*k + 3][ndpn*l+1] -= dt*w[j]*wn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
+										ke[ndpn*k + 3][ndpn*l+2] -= dt*w[j]*wn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
+
+										ke[ndpn*k + 4][ndpn*l  ] -= dt*w[j]*jn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
+										ke[ndpn*k + 4][ndpn*l+1] -= dt*w[j]*jn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
+										ke[ndpn*k + 4][ndpn*l+2] -= dt*w[j]*jn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
+									}
 							
-							// c. m-term
-							//---------------------------------------
+								// c. m-term
+								//---------------------------------------
 							
-							for (k=0; k<nmeln; ++k)
-								for (l=0; l<nseln+nmeln; ++l)
-								{
-									ke[ndpn*(k+nseln) + 3][ndpn*l  ] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].x;
-									ke[ndpn*(k+nseln) + 3][ndpn*l+1] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].y;
-									ke[ndpn*(k+nseln) + 3][ndpn*l+2] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].z;
-
-									ke[ndpn*(k+nseln) + 4][ndpn*l  ] += dt*w[j]*detJ[j]*jn*N[l]*mm[k].x;
-									ke[ndpn*(k+nseln) + 4][ndpn*l+1] += dt*w[j]*detJ[j]*jn*N[l]*mm[k].y;
-									ke[ndpn*(k+nseln) + 4][ndpn*l+2] += dt*w[j]*detJ[j]*jn*N[l]*mm[k].z;
-								}
-						}
+								for (k=0; k<nmeln; ++k)
+									for (l=0; l<nseln+nmeln; ++l)
+									{
+										ke[ndpn*(k+nseln) + 3][ndpn*l  ] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].x;
+										ke[ndpn*(k+nseln) + 3][ndpn*l+1] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].y;
+										ke[ndpn*(k+nseln) + 3][ndpn*l+2] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].z;
+
+										ke[ndpn*(k+nseln) + 4][ndpn*l  ] += dt*w[j]*detJ[j]*jn*N[l]*mm[k].x;
+										ke[ndpn*(k+nseln) + 4][ndpn*l+1] += dt*w[j]*detJ[j]*jn*N[l]*mm[k].y;
+										ke[ndpn*(k+nseln) + 4][ndpn*l+2] += dt*w[j]*detJ[j]*jn*N[l]*mm[k].z;
+									}
+							}
 						
 						
-						// --- P R E S S U R E - P R E S S U R E   C O N T A C T ---
+							// --- P R E S S U R E - P R E S S U R E   C O N T A C T ---
 						
-						// calculate the N-vector
-						for (k=0; k<nseln; ++k)
-						{
-							N[ndpn*k+3] = Hs[k];
-							N[ndpn*k+4] = Hs[k];
-						}
+							// calculate the N-vector
+							for (k=0; k<nseln; ++k)
+							{
+								N[ndpn*k+3] = Hs[k];
+								N[ndpn*k+4] = Hs[k];
+							}
 						
-						for (k=0; k<nmeln; ++k)
-						{
-							N[ndpn*(k+nseln)+3] = -Hm[k];
-							N[ndpn*(k+nseln)+4] = -Hm[k];
-						}
+							for (k=0; k<nmeln; ++k)
+							{
+								N[ndpn*(k+nseln)+3] = -Hm[k];
+								N[ndpn*(k+nseln)+4] = -Hm[k];
+							}
 						
-						for (k=3; k<ndof; k+=ndpn)
-							for (l=3; l<ndof; l+=ndpn) ke[k][l] -= dt*epsp*w[j]*detJ[j]*N[k]*N[l];
+							for (k=3; k<ndof; k+=ndpn)
+								for (l=3; l<ndof; l+=ndpn) ke[k][l] -= dt*epsp*w[j]*detJ[j]*N[k]*N[l];
 
-						// --- C O N C E N T R A T I O N - C O N C E N T R A T I O N   C O N T A C T ---
+							// --- C O N C E N T R A T I O N - C O N C E N T R A T I O N   C O N T A C T ---
 						
-						for (k=4; k<ndof; k+=ndpn)
-							for (l=4; l<ndof; l+=ndpn) ke[k][l] -= dt*epsc*w[j]*detJ[j]*N[k]*N[l];
+							for (k=4; k<ndof; k+=ndpn)
+								for (l=4; l<ndof; l+=ndpn) ke[k][l] -= dt*epsc*w[j]*detJ[j]*N[k]*N[l];
 						
-					}
+						}
 					
-					// --- B I P H A S I C   S T I F F N E S S ---
-					else if (sporo && mporo)
-					{
-						// the variable dt is either the timestep or one
-						// depending on whether we are using the symmetric
-						// poro version or not.
-						double dt = fem.GetTime().timeIncrement;
+						// --- B I P H A S I C   S T I F F N E S S ---
+						else if (sporo && mporo)
+						{
+							// the variable dt is either the timestep or one
+							// depending on whether we are using the symmetric
+							// poro version or not.
+							double dt = fem.GetTime().timeIncrement;
 						
-						double epsp = (tn > 0) ? m_epsp*pt.m_epsp*psf : 0.;
+							double epsp = (tn > 0) ? m_epsp*pt.m_epsp*psf : 0.;
 						
-						// --- S O L I D - P R E S S U R E   C O N T A C T ---
+							// --- S O L I D - P R E S S U R E   C O N T A C T ---
 						
-						if (!m_bsymm)
-						{
+							if (!m_bsymm)
+							{
 							
-							// a. q-term
-							//-------------------------------------
+								// a. q-term
+								//-------------------------------------
 							
-							double dpmr, dpms;
-							dpmr = me.eval_deriv1(pm, r, s);
-							dpms = me.eval_deriv2(pm, r, s);
+								double dpmr, dpms;
+								dpmr = me.eval_deriv1(pm, r, s);
+								dpms = me.eval_deriv2(pm, r, s);
 							
-							for (k=0; k<nseln+nmeln; ++k)
-								for (l=0; l<nseln+nmeln; ++l)
-								{
-									ke[ndpn*k + 3][ndpn*l  ] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].x + dpms*Gm[1].x);
-									ke[ndpn*k + 3][ndpn*l+1] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].y + dpms*Gm[1].y);
-									ke[ndpn*k + 3][ndpn*l+2] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].z + dpms*Gm[1].z);
-								}
+								for (k=0; k<nseln+nmeln; ++k)
+									for (l=0; l<nseln+nmeln; ++l)
+									{
+										ke[ndpn*k + 3][ndpn*l  ] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].x + dpms*Gm[1].x);
+										ke[ndpn*k + 3][ndpn*l+1] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].y + dpms*Gm[1].y);
+										ke[ndpn*k + 3][ndpn*l+2] += dt*w[j]*detJ[j]*epsp*N[k]*N[l]*(dpmr*Gm[0].z + dpms*Gm[1].z);
+									}
 							
-							double wn = pt.m_Lmp + epsp*pt.m_pg;
+								double wn = pt.m_Lmp + epsp*pt.m_pg;
 							
-							// b. A-term
-							//-------------------------------------
+								// b. A-term
+								//-------------------------------------
 							
-							for (l=0; l<nseln; ++l)
-								for (k=0; k<nseln+nmeln; ++k)
-								{
-									ke[ndpn*k + 3][ndpn*l  ] -= dt*w[j]*wn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
-									ke[ndpn*k + 3][ndpn*l+1] -= dt*w[j]*wn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
-									ke[ndpn*k + 3][ndpn*l+2] -= dt*w[j]*wn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
-								}
+								for (l=0; l<nseln; ++l)
+									for (k=0; k<nseln+nmeln; ++k)
+									{
+										ke[ndpn*k + 3][ndpn*l  ] -= dt*w[j]*wn*N[k]*(As[l][0][0]*nu.x + As[l][0][1]*nu.y + As[l][0][2]*nu.z);
+										ke[ndpn*k + 3][ndpn*l+1] -= dt*w[j]*wn*N[k]*(As[l][1][0]*nu.x + As[l][1][1]*nu.y + As[l][1][2]*nu.z);
+										ke[ndpn*k + 3][ndpn*l+2] -= dt*w[j]*wn*N[k]*(As[l][2][0]*nu.x + As[l][2][1]*nu.y + As[l][2][2]*nu.z);
+									}
 							
-							// c. m-term
-							//---------------------------------------
+								// c. m-term
+								//---------------------------------------
 							
-							for (k=0; k<nmeln; ++k)
-								for (l=0; l<nseln+nmeln; ++l)
-								{
-									ke[ndpn*(k+nseln) + 3][ndpn*l  ] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].x;
-									ke[ndpn*(k+nseln) + 3][ndpn*l+1] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].y;
-									ke[ndpn*(k+nseln) + 3][ndpn*l+2] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].z;
-								}
-						}
+								for (k=0; k<nmeln; ++k)
+									for (l=0; l<nseln+nmeln; ++l)
+									{
+										ke[ndpn*(k+nseln) + 3][ndpn*l  ] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].x;
+										ke[ndpn*(k+nseln) + 3][ndpn*l+1] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].y;
+										ke[ndpn*(k+nseln) + 3][ndpn*l+2] += dt*w[j]*detJ[j]*wn*N[l]*mm[k].z;
+									}
+							}
 						
 						
-						// --- P R E S S U R E - P R E S S U R E   C O N T A C T ---
+							// --- P R E S S U R E - P R E S S U R E   C O N T A C T ---
 						
-						// calculate the N-vector
-						for (k=0; k<nseln; ++k)
-						{
-							N[ndpn*k+3] = Hs[k];
-						}
+							// calculate the N-vector
+							for (k=0; k<nseln; ++k)
+							{
+								N[ndpn*k+3] = Hs[k];
+							}
 						
-						for (k=0; k<nmeln; ++k)
-						{
-							N[ndpn*(k+nseln)+3] = -Hm[k];
-						}
+							for (k=0; k<nmeln; ++k)
+							{
+								N[ndpn*(k+nseln)+3] = -Hm[k];
+							}
 						
-						for (k=3; k<ndof; k+=ndpn)
-							for (l=3; l<ndof; l+=ndpn) ke[k][l] -= dt*epsp*w[j]*detJ[j]*N[k]*N[l];
+							for (k=3; k<ndof; k+=ndpn)
+								for (l=3; l<ndof; l+=ndpn) ke[k][l] -= dt*epsp*w[j]*detJ[j]*N[k]*N[l];
 						
-					}
+						}
 					
-					// assemble the global stiffness
-					ke.SetNodes(en);
-					ke.SetIndices(LM);
-					LS.Assemble(ke);
+						// assemble the global stiffness
+						ke.SetNodes(en);
+						ke.SetIndices(LM);
+						LS.Assemble(ke);
+					}
 				}
 			}
 		}
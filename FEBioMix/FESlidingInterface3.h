@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEBioMech/FEContactInterface.h"
 #include "FEBiphasicContactSurface.h"
+#include <FECore/FEElementWorkspace.h>
 
 //-----------------------------------------------------------------------------
 class FEBIOMIX_API FESlidingSurface3 : public FEBiphasicContactSurface
@@ -210,5 +211,7 @@ protected:
 	int	m_dofP;
 	int	m_dofC;
 
+	FEElementWorkspace	m_work;	//!< per-thread element buffers for the assembly loops
+
 	DECLARE_FECORE_CLASS();
 };
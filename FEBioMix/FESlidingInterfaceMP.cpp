@@ -38,6 +38,7 @@ SOFTWARE.*/
 #include "FECore/FENormalProjection.h"
 #include "FECore/FEAnalysis.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/sys.h>
 
 //-----------------------------------------------------------------------------
 BEGIN_FECORE_CLASS(FEAmbientConcentration, FECoreClass)
@@ -1092,17 +1093,9 @@ double FESlidingInterfaceMP::AutoConcentrationPenalty(FESurfaceElement& el,
 void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfaceMP& ms, bool bupseg, bool bmove)
 {
     FEMesh& mesh = GetFEModel()->GetMesh();
-    FESurfaceElement* pme;
-    vec3d r, nu;
-    double rs[2] = {0,0};
-    double Ln;
     
     const int MN = FEElement::MAX_NODES;
     int nsol = (int)m_sid.size();
-    double ps[MN], p1 = 0.0;
-    vector< vector<double> > cs(nsol, vector<double>(MN));
-    vector<double> c1(nsol);
-    c1.assign(nsol,0);
     
     double psf = GetPenaltyScaleFactor();
     
@@ -1165,9 +1158,11 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
     }
     
     // loop over all integration points
-    // TODO: commenting this pragma line made my code recover slidingelastic test case results
-//#pragma omp parallel for
-    for (int i=0; i<ss.Elements(); ++i)
+    // (the pressure and concentration buffers are private to each thread,
+    // and each element only updates its own integration point data)
+    int NE = ss.Elements();
+#pragma omp parallel for shared(np) schedule(dynamic)
+    for (int i=0; i<NE; ++i)
     {
         FESurfaceElement& el = ss.Element(i);
         
@@ -1176,6 +1171,10 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
         int ne = el.Nodes();
         int nint = el.GaussPoints();
         
+        double ps[MN], p1 = 0.0;
+        vector< vector<double> > cs(nsol, vector<double>(MN));
+        vector<double> c1(nsol, 0.0);
+        
         // get the nodal pressures
         if (sporo)
         {
@@ -1192,7 +1191,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
             FESlidingSurfaceMP::Data& pt = static_cast<FESlidingSurfaceMP::Data&>(*el.GetMaterialPoint(j));
 
             // calculate the global position of the integration point
-            r = ss.Local2Global(el, j);
+            vec3d r = ss.Local2Global(el, j);
             
             // get the pressure at the integration point
             if (sporo) p1 = el.eval(ps, j);
@@ -1201,10 +1200,11 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
             for (int isol=0; isol<nsol; ++isol) c1[isol] = el.eval(&cs[isol][0], j);
             
             // calculate the normal at this integration point
-            nu = ss.SurfaceNormal(el, j);
+            vec3d nu = ss.SurfaceNormal(el, j);
             
             // first see if the old intersected face is still good enough
-            pme = pt.m_pme;
+            FESurfaceElement* pme = pt.m_pme;
+            double rs[2] = {0,0};
             if (pme)
             {
                 double g;
@@ -1241,7 +1241,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
                 
                 double eps = m_epsn*pt.m_epsn*psf;
                 
-                Ln = pt.m_Lmd + eps*g;
+                double Ln = pt.m_Lmd + eps*g;
                 
                 pt.m_gap = (g <= m_srad? g : 0);
                 
@@ -1836,11 +1836,7 @@ vec3d FESlidingInterfaceMP::ContactTraction(FESlidingSurfaceMP& ss, const int ne
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
     const int MN = FEElement::MAX_NODES;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    double N[MN*10];
     int nsol = (int)m_sid.size();
     
     FEModel& fem = *GetFEModel();
@@ -1863,185 +1859,206 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
         // loop over all primary surface elements
-        for (int i=0; i<ss.Elements(); ++i)
+        // (each thread uses its own element buffers and contact force sums)
+        int NE = ss.Elements();
+        m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
         {
-            // get the surface element
-            FESurfaceElement& se = ss.Element(i);
+            FEElementBuffer& buf = m_work.ThreadBuffer();
+            vector<int>& LM = buf.lm;
+            vector<int> sLM, mLM, en;
+            vector<double>& fe = buf.fe;
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            double N[MN*10];
+            vec3d Fs(0,0,0), Fm(0,0,0);
+
+#pragma omp for schedule(dynamic)
+            for (int i=0; i<NE; ++i)
+            {
+                // get the surface element
+                FESurfaceElement& se = ss.Element(i);
             
-            bool sporo = ss.m_bporo;
+                bool sporo = ss.m_bporo;
             
-            // get the nr of nodes and integration points
-            int nseln = se.Nodes();
-            int nint = se.GaussPoints();
+                // get the nr of nodes and integration points
+                int nseln = se.Nodes();
+                int nint = se.GaussPoints();
             
-            // copy the LM vector; we'll need it later
-            ss.UnpackLM(se, sLM);
+                // copy the LM vector; we'll need it later
+                ss.UnpackLM(se, sLM);
             
-            // we calculate all the metrics we need before we
-            // calculate the nodal forces
-            for (int j=0; j<nint; ++j)
-            {
-                // get the base vectors
-                vec3d g[2];
-                ss.CoBaseVectors(se, j, g);
+                // we calculate all the metrics we need before we
+                // calculate the nodal forces
+                for (int j=0; j<nint; ++j)
+                {
+                    // get the base vectors
+                    vec3d g[2];
+                    ss.CoBaseVectors(se, j, g);
                 
-                // jacobians: J = |g0xg1|
-                detJ[j] = (g[0] ^ g[1]).norm();
+                    // jacobians: J = |g0xg1|
+                    detJ[j] = (g[0] ^ g[1]).norm();
                 
-                // integration weights
-                w[j] = se.GaussWeights()[j];
-            }
+                    // integration weights
+                    w[j] = se.GaussWeights()[j];
+                }
             
-            // loop over all integration points
-            // note that we are integrating over the current surface
-            for (int j=0; j<nint; ++j)
-            {
-                // get integration point data
-                FESlidingSurfaceMP::Data& pt = static_cast<FESlidingSurfaceMP::Data&>(*se.GetMaterialPoint(j));
-                
-                // calculate contact pressure and account for stick
-                double pn;
-                vec3d t = ContactTraction(ss, i, j, ms, pn);
+                // loop over all integration points
+                // note that we are integrating over the current surface
+                for (int j=0; j<nint; ++j)
+                {
+                    // get integration point data
+                    FESlidingSurfaceMP::Data& pt = static_cast<FESlidingSurfaceMP::Data&>(*se.GetMaterialPoint(j));
                 
-                // get the secondary surface element
-                FESurfaceElement* pme = pt.m_pme;
+                    // calculate contact pressure and account for stick
+                    double pn;
+                    vec3d t = ContactTraction(ss, i, j, ms, pn);
                 
-                if (pme)
-                {
                     // get the secondary surface element
-                    FESurfaceElement& me = *pme;
-                    
-                    bool mporo = ms.m_bporo;
-                    
-                    // get the nr of secondary element nodes
-                    int nmeln = me.Nodes();
-                    
-                    // copy LM vector
-                    ms.UnpackLM(me, mLM);
-                    
-                    // calculate degrees of freedom
-                    int ndof = 3*(nseln + nmeln);
-                    
-                    // build the LM vector
-                    LM.resize(ndof);
-                    for (int k=0; k<nseln; ++k)
+                    FESurfaceElement* pme = pt.m_pme;
+                
+                    if (pme)
                     {
-                        LM[3*k  ] = sLM[3*k  ];
-                        LM[3*k+1] = sLM[3*k+1];
-                        LM[3*k+2] = sLM[3*k+2];
-                    }
+                        // get the secondary surface element
+                        FESurfaceElement& me = *pme;
                     
-                    for (int k=0; k<nmeln; ++k)
-                    {
-                        LM[3*(k+nseln)  ] = mLM[3*k  ];
-                        LM[3*(k+nseln)+1] = mLM[3*k+1];
-                        LM[3*(k+nseln)+2] = mLM[3*k+2];
-                    }
+                        bool mporo = ms.m_bporo;
                     
-                    // build the en vector
-                    en.resize(nseln+nmeln);
-                    for (int k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
-                    for (int k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
+                        // get the nr of secondary element nodes
+                        int nmeln = me.Nodes();
                     
-                    // get primary element shape functions
-                    Hs = se.H(j);
+                        // copy LM vector
+                        ms.UnpackLM(me, mLM);
                     
-                    // get secondary element shape functions
-                    double r = pt.m_rs[0];
-                    double s = pt.m_rs[1];
-                    me.shape_fnc(Hm, r, s);
+                        // calculate degrees of freedom
+                        int ndof = 3*(nseln + nmeln);
                     
-                    if (pn > 0) {
-                        // calculate the force vector
-                        fe.resize(ndof);
-                        zero(fe);
-                        
+                        // build the LM vector
+                        LM.resize(ndof);
                         for (int k=0; k<nseln; ++k)
                         {
-                            N[3*k  ] = Hs[k]*t.x;
-                            N[3*k+1] = Hs[k]*t.y;
-                            N[3*k+2] = Hs[k]*t.z;
+                            LM[3*k  ] = sLM[3*k  ];
+                            LM[3*k+1] = sLM[3*k+1];
+                            LM[3*k+2] = sLM[3*k+2];
                         }
-                        
+                    
                         for (int k=0; k<nmeln; ++k)
                         {
-                            N[3*(k+nseln)  ] = -Hm[k]*t.x;
-                            N[3*(k+nseln)+1] = -Hm[k]*t.y;
-                            N[3*(k+nseln)+2] = -Hm[k]*t.z;
+                            LM[3*(k+nseln)  ] = mLM[3*k  ];
+                            LM[3*(k+nseln)+1] = mLM[3*k+1];
+                            LM[3*(k+nseln)+2] = mLM[3*k+2];
                         }
+                    
+                        // build the en vector
+                        en.resize(nseln+nmeln);
+                        for (int k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
+                        for (int k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
+                    
+                        // get primary element shape functions
+                        Hs = se.H(j);
+                    
+                        // get secondary element shape functions
+                        double r = pt.m_rs[0];
+                        double s = pt.m_rs[1];
+                        me.shape_fnc(Hm, r, s);
+                    
+                        if (pn > 0) {
+                            // calculate the force vector
+                            fe.resize(ndof);
+                            zero(fe);
                         
-                        for (int k=0; k<ndof; ++k) fe[k] += N[k]*detJ[j]*w[j];
+                            for (int k=0; k<nseln; ++k)
+                            {
+                                N[3*k  ] = Hs[k]*t.x;
+                                N[3*k+1] = Hs[k]*t.y;
+                                N[3*k+2] = Hs[k]*t.z;
+                            }
                         
-                        // calculate contact forces
-                        for (int k=0; k<nseln; ++k)
-                            ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                            for (int k=0; k<nmeln; ++k)
+                            {
+                                N[3*(k+nseln)  ] = -Hm[k]*t.x;
+                                N[3*(k+nseln)+1] = -Hm[k]*t.y;
+                                N[3*(k+nseln)+2] = -Hm[k]*t.z;
+                            }
                         
-                        for (int k = 0; k<nmeln; ++k)
-                            ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                            for (int k=0; k<ndof; ++k) fe[k] += N[k]*detJ[j]*w[j];
                         
-                        // assemble the global residual
-                        R.Assemble(en, LM, fe);
+                            // calculate contact forces
+                            for (int k=0; k<nseln; ++k)
+                                Fs += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
                         
-                        // do the biphasic stuff
-                        if (sporo && mporo)
-                        {
-                            // calculate nr of pressure dofs
-                            int ndof = nseln + nmeln;
+                            for (int k = 0; k<nmeln; ++k)
+                                Fm += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                        
+                            // assemble the global residual
+                            R.Assemble(en, LM, fe);
+                        
+                            // do the biphasic stuff
+                            if (sporo && mporo)
+                            {
+                                // calculate nr of pressure dofs
+                                int ndof = nseln + nmeln;
                             
-                            // normal fluid flux
-                            double epsp = m_epsp*pt.m_epsp*psf;
-                            double wn = pt.m_Lmp + epsp*pt.m_pg;
+                                // normal fluid flux
+                                double epsp = m_epsp*pt.m_epsp*psf;
+                                double wn = pt.m_Lmp + epsp*pt.m_pg;
                             
-                            // fill the LM
-                            LM.resize(ndof);
-                            for (int k=0; k<nseln; ++k) LM[k      ] = sLM[3*nseln+k];
-                            for (int k=0; k<nmeln; ++k) LM[k+nseln] = mLM[3*nmeln+k];
+                                // fill the LM
+                                LM.resize(ndof);
+                                for (int k=0; k<nseln; ++k) LM[k      ] = sLM[3*nseln+k];
+                                for (int k=0; k<nmeln; ++k) LM[k+nseln] = mLM[3*nmeln+k];
                             
-                            // fill the force array
-                            fe.resize(ndof);
-                            zero(fe);
-                            for (int k = 0; k<nseln; ++k) N[k      ] = Hs[k];
-                            for (int k = 0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+                                // fill the force array
+                                fe.resize(ndof);
+                                zero(fe);
+                                for (int k = 0; k<nseln; ++k) N[k      ] = Hs[k];
+                                for (int k = 0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
                             
-                            for (int k = 0; k<ndof; ++k) fe[k] += dt*N[k]*wn*detJ[j]*w[j];
+                                for (int k = 0; k<ndof; ++k) fe[k] += dt*N[k]*wn*detJ[j]*w[j];
                             
                             
-                            // assemble residual
-                            R.Assemble(en, LM, fe);
-                        }
+                                // assemble residual
+                                R.Assemble(en, LM, fe);
+                            }
                         
-                        // do the solute stuff
-                        for (int isol=0; isol<nsol; ++isol)
-                        {
-                            int sid = m_sid[isol];
+                            // do the solute stuff
+                            for (int isol=0; isol<nsol; ++isol)
+                            {
+                                int sid = m_sid[isol];
                             
-                            // calculate nr of concentration dofs
-                            int ndof = nseln + nmeln;
+                                // calculate nr of concentration dofs
+                                int ndof = nseln + nmeln;
                             
-                            // calculate normal effective solute flux
-                            int l = sl[isol];
-                            double epsc = m_epsc*pt.m_epsc[l]*psf;
-                            double jn = pt.m_Lmc[l] + epsc*pt.m_cg[l];
+                                // calculate normal effective solute flux
+                                int l = sl[isol];
+                                double epsc = m_epsc*pt.m_epsc[l]*psf;
+                                double jn = pt.m_Lmc[l] + epsc*pt.m_cg[l];
                             
-                            // fill the LM
-                            LM.resize(ndof);
-                            for (int k = 0; k<nseln; ++k) LM[k      ] = sLM[(4+sid)*nseln+k];
-                            for (int k = 0; k<nmeln; ++k) LM[k+nseln] = mLM[(4+sid)*nmeln+k];
+                                // fill the LM
+                                LM.resize(ndof);
+                                for (int k = 0; k<nseln; ++k) LM[k      ] = sLM[(4+sid)*nseln+k];
+                                for (int k = 0; k<nmeln; ++k) LM[k+nseln] = mLM[(4+sid)*nmeln+k];
                             
-                            // fill the force array
-                            fe.resize(ndof);
-                            zero(fe);
-                            for (int k = 0; k<nseln; ++k) N[k] = Hs[k];
-                            for (int k = 0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
+                                // fill the force array
+                                fe.resize(ndof);
+                                zero(fe);
+                                for (int k = 0; k<nseln; ++k) N[k] = Hs[k];
+                                for (int k = 0; k<nmeln; ++k) N[k+nseln] = -Hm[k];
                             
-                            for (int k = 0; k<ndof; ++k) fe[k] += dt*N[k]*jn*detJ[j]*w[j];
+                                for (int k = 0; k<ndof; ++k) fe[k] += dt*N[k]*jn*detJ[j]*w[j];
                             
-                            // assemble residual
-                            R.Assemble(en, LM, fe);
+                                // assemble residual
+                                R.Assemble(en, LM, fe);
+                            }
                         }
                     }
                 }
             }
+
+#pragma omp critical
+            {
+                ss.m_Ft += Fs;
+                ms.m_Ft += Fm;
+            }
         }
     }
 }
@@ -2049,13 +2066,8 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-    int i, j, k, l;
-    vector<int> sLM, mLM, LM, en;
     const int MN = FEElement::MAX_NODES;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    FEElementMatrix ke;
     int nsol = (int)m_sid.size();
-    vector<double> jn(nsol);
     
     FEModel& fem = *GetFEModel();
      
@@ -2090,678 +2102,693 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
         // loop over all primary surface elements
-        for (i=0; i<ss.Elements(); ++i)
+        // (each thread uses its own element buffers)
+        int NE = ss.Elements();
+        m_work.Resize(omp_get_max_threads());
+#pragma omp parallel shared(ss, ms)
         {
-            // get the next element
-            FESurfaceElement& se = ss.Element(i);
+            FEElementBuffer& buf = m_work.ThreadBuffer();
+            int j, k, l;
+            vector<int>& LM = buf.lm;
+            vector<int> sLM, mLM, en;
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            FEElementMatrix& ke = buf.ke;
+            vector<double> jn(nsol);
+
+#pragma omp for schedule(dynamic)
+            for (int i=0; i<NE; ++i)
+            {
+                // get the next element
+                FESurfaceElement& se = ss.Element(i);
             
-            bool sporo = ss.m_bporo;
+                bool sporo = ss.m_bporo;
             
-            // get nr of nodes and integration points
-            int nseln = se.Nodes();
-            int nint = se.GaussPoints();
+                // get nr of nodes and integration points
+                int nseln = se.Nodes();
+                int nint = se.GaussPoints();
             
-            double pn[MN] = {0};
-            vector< vector<double> >cn(nsol,vector<double>(MN));
-            if (sporo) {
-                for (j=0; j<nseln; ++j)
-                {
-                    pn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofP);
-                    for (int isol=0; isol<nsol; ++isol) {
-                        cn[isol][j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofC + m_sid[isol]);
+                double pn[MN] = {0};
+                vector< vector<double> >cn(nsol,vector<double>(MN));
+                if (sporo) {
+                    for (j=0; j<nseln; ++j)
+                    {
+                        pn[j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofP);
+                        for (int isol=0; isol<nsol; ++isol) {
+                            cn[isol][j] = ss.GetMesh()->Node(se.m_node[j]).get(m_dofC + m_sid[isol]);
+                        }
                     }
                 }
-            }
             
-            // copy the LM vector
-            ss.UnpackLM(se, sLM);
+                // copy the LM vector
+                ss.UnpackLM(se, sLM);
             
-            // we calculate all the metrics we need before we
-            // calculate the nodal forces
-            for (j=0; j<nint; ++j)
-            {
-                // get the base vectors
-                vec3d g[2];
-                ss.CoBaseVectors(se, j, g);
+                // we calculate all the metrics we need before we
+                // calculate the nodal forces
+                for (j=0; j<nint; ++j)
+                {
+                    // get the base vectors
+                    vec3d g[2];
+                    ss.CoBaseVectors(se, j, g);
                 
-                // jacobians: J = |g0xg1|
-                detJ[j] = (g[0] ^ g[1]).norm();
+                    // jacobians: J = |g0xg1|
+                    detJ[j] = (g[0] ^ g[1]).norm();
                 
-                // integration weights
-                w[j] = se.GaussWeights()[j];
-            }
+                    // integration weights
+                    w[j] = se.GaussWeights()[j];
+                }
             
-            // loop over all integration points
-            for (j=0; j<nint; ++j)
-            {
-                // get integration point data
-                FESlidingSurfaceMP::Data& pt = static_cast<FESlidingSurfaceMP::Data&>(*se.GetMaterialPoint(j));
+                // loop over all integration points
+                for (j=0; j<nint; ++j)
+                {
+                    // get integration point data
+                    FESlidingSurfaceMP::Data& pt = static_cast<FESlidingSurfaceMP::Data&>(*se.GetMaterialPoint(j));
                 
-                // calculate contact traction and account for stick
-                double pn;
-                vec3d t = ContactTraction(ss, i, j, ms, pn);
+                    // calculate contact traction and account for stick
+                    double pn;
+                    vec3d t = ContactTraction(ss, i, j, ms, pn);
                 
-                // get the secondary element
-                FESurfaceElement* pme = pt.m_pme;
+                    // get the secondary element
+                    FESurfaceElement* pme = pt.m_pme;
                 
-                // calculate normal effective solute flux
-                for (int isol=0; isol<nsol; ++isol)
-                {
-                    int l = sl[isol];
-                    double epsc = m_epsc*pt.m_epsc[l]*psf;
-                    jn[isol] = pt.m_Lmc[l] + epsc*pt.m_cg[l];
-                }
+                    // calculate normal effective solute flux
+                    for (int isol=0; isol<nsol; ++isol)
+                    {
+                        int l = sl[isol];
+                        double epsc = m_epsc*pt.m_epsc[l]*psf;
+                        jn[isol] = pt.m_Lmc[l] + epsc*pt.m_cg[l];
+                    }
                 
-                // normal fluid flux
-                double epsp = m_epsp*pt.m_epsp*psf;
-                double wn = pt.m_Lmp + epsp*pt.m_pg;
+                    // normal fluid flux
+                    double epsp = m_epsp*pt.m_epsp*psf;
+                    double wn = pt.m_Lmp + epsp*pt.m_pg;
                 
-                if (pme)
-                {
-                    FESurfaceElement& me = *pme;
+                    if (pme)
+                    {
+                        FESurfaceElement& me = *pme;
                     
-                    bool mporo = ms.m_bporo;
+                        bool mporo = ms.m_bporo;
                     
-                    // get the nr of secondary nodes
-                    int nmeln = me.Nodes();
+                        // get the nr of secondary nodes
+                        int nmeln = me.Nodes();
                     
-                    // nodal data
-                    double pm[MN] = {0};
-                    vector< vector<double> > cm(nsol,vector<double>(MN));
-                    for (k=0; k<nmeln; ++k)
-                    {
-                        pm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofP);
-                        for (int isol=0; isol<nsol; ++isol) {
-                            cm[isol][k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofC + m_sid[isol]);
+                        // nodal data
+                        double pm[MN] = {0};
+                        vector< vector<double> > cm(nsol,vector<double>(MN));
+                        for (k=0; k<nmeln; ++k)
+                        {
+                            pm[k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofP);
+                            for (int isol=0; isol<nsol; ++isol) {
+                                cm[isol][k] = ms.GetMesh()->Node(me.m_node[k]).get(m_dofC + m_sid[isol]);
+                            }
                         }
-                    }
                     
-                    // copy the LM vector
-                    ms.UnpackLM(me, mLM);
+                        // copy the LM vector
+                        ms.UnpackLM(me, mLM);
                     
-                    int ndpn;    // number of dofs per node
-                    int ndof;    // number of dofs in stiffness matrix
+                        int ndpn;    // number of dofs per node
+                        int ndof;    // number of dofs in stiffness matrix
                     
-                    if (nsol) {
-                        // calculate dofs for biphasic-solute contact
-                        ndpn = 4+nsol;
-                        ndof = ndpn*(nseln+nmeln);
+                        if (nsol) {
+                            // calculate dofs for biphasic-solute contact
+                            ndpn = 4+nsol;
+                            ndof = ndpn*(nseln+nmeln);
                         
-                        // build the LM vector
-                        LM.resize(ndof);
+                            // build the LM vector
+                            LM.resize(ndof);
                         
-                        for (k=0; k<nseln; ++k)
-                        {
-                            LM[ndpn*k  ] = sLM[3*k  ];            // x-dof
-                            LM[ndpn*k+1] = sLM[3*k+1];            // y-dof
-                            LM[ndpn*k+2] = sLM[3*k+2];            // z-dof
-                            LM[ndpn*k+3] = sLM[3*nseln+k];        // p-dof
-                            for (int isol=0; isol<nsol; ++isol)
-                                LM[ndpn*k+4+isol] = sLM[(4+m_sid[isol])*nseln+k];        // c-dof
-                        }
-                        for (k=0; k<nmeln; ++k)
-                        {
-                            LM[ndpn*(k+nseln)  ] = mLM[3*k  ];            // x-dof
-                            LM[ndpn*(k+nseln)+1] = mLM[3*k+1];            // y-dof
-                            LM[ndpn*(k+nseln)+2] = mLM[3*k+2];            // z-dof
-                            LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];        // p-dof
-                            for (int isol=0; isol<nsol; ++isol)
-                                LM[ndpn*(k+nseln)+4+isol] = mLM[(4+m_sid[isol])*nmeln+k];        // c-dof
+                            for (k=0; k<nseln; ++k)
+                            {
+                                LM[ndpn*k  ] = sLM[3*k  ];            // x-dof
+                                LM[ndpn*k+1] = sLM[3*k+1];            // y-dof
+                                LM[ndpn*k+2] = sLM[3*k+2];            // z-dof
+                                LM[ndpn*k+3] = sLM[3*nseln+k];        // p-dof
+                                for (int isol=0; isol<nsol; ++isol)
+                                    LM[ndpn*k+4+isol] = sLM[(4+m_sid[isol])*nseln+k];        // c-dof
+                            }
+                            for (k=0; k<nmeln; ++k)
+                            {
+                                LM[ndpn*(k+nseln)  ] = mLM[3*k  ];            // x-dof
+                                LM[ndpn*(k+nseln)+1] = mLM[3*k+1];            // y-dof
+                                LM[ndpn*(k+nseln)+2] = mLM[3*k+2];            // z-dof
+                                LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];        // p-dof
+                                for (int isol=0; isol<nsol; ++isol)
+                                    LM[ndpn*(k+nseln)+4+isol] = mLM[(4+m_sid[isol])*nmeln+k];        // c-dof
+                            }
                         }
-                    }
                     
-                    else if (sporo && mporo) {
-                        // calculate dofs for biphasic contact
-                        ndpn = 4;
-                        ndof = ndpn*(nseln+nmeln);
+                        else if (sporo && mporo) {
+                            // calculate dofs for biphasic contact
+                            ndpn = 4;
+                            ndof = ndpn*(nseln+nmeln);
                         
-                        // build the LM vector
-                        LM.resize(ndof);
+                            // build the LM vector
+                            LM.resize(ndof);
                         
-                        for (k=0; k<nseln; ++k)
-                        {
-                            LM[ndpn*k  ] = sLM[3*k  ];            // x-dof
-                            LM[ndpn*k+1] = sLM[3*k+1];            // y-dof
-                            LM[ndpn*k+2] = sLM[3*k+2];            // z-dof
-                            LM[ndpn*k+3] = sLM[3*nseln+k];        // p-dof
-                        }
-                        for (k=0; k<nmeln; ++k)
-                        {
-                            LM[ndpn*(k+nseln)  ] = mLM[3*k  ];            // x-dof
-                            LM[ndpn*(k+nseln)+1] = mLM[3*k+1];            // y-dof
-                            LM[ndpn*(k+nseln)+2] = mLM[3*k+2];            // z-dof
-                            LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];        // p-dof
+                            for (k=0; k<nseln; ++k)
+                            {
+                                LM[ndpn*k  ] = sLM[3*k  ];            // x-dof
+                                LM[ndpn*k+1] = sLM[3*k+1];            // y-dof
+                                LM[ndpn*k+2] = sLM[3*k+2];            // z-dof
+                                LM[ndpn*k+3] = sLM[3*nseln+k];        // p-dof
+                            }
+                            for (k=0; k<nmeln; ++k)
+                            {
+                                LM[ndpn*(k+nseln)  ] = mLM[3*k  ];            // x-dof
+                                LM[ndpn*(k+nseln)+1] = mLM[3*k+1];            // y-dof
+                                LM[ndpn*(k+nseln)+2] = mLM[3*k+2];            // z-dof
+                                LM[ndpn*(k+nseln)+3] = mLM[3*nmeln+k];        // p-dof
+                            }
                         }
-                    }
                     
-                    else {
-                        // calculate dofs for elastic contact
-                        ndpn = 3;
-                        ndof = ndpn*(nseln + nmeln);
+                        else {
+                            // calculate dofs for elastic contact
+                            ndpn = 3;
+                            ndof = ndpn*(nseln + nmeln);
                         
-                        // build the LM vector
-                        LM.resize(ndof);
+                            // build the LM vector
+                            LM.resize(ndof);
                         
-                        for (k=0; k<nseln; ++k)
-                        {
-                            LM[3*k  ] = sLM[3*k  ];
-                            LM[3*k+1] = sLM[3*k+1];
-                            LM[3*k+2] = sLM[3*k+2];
-                        }
+                            for (k=0; k<nseln; ++k)
+                            {
+                                LM[3*k  ] = sLM[3*k  ];
+                                LM[3*k+1] = sLM[3*k+1];
+                                LM[3*k+2] = sLM[3*k+2];
+                            }
                         
-                        for (k=0; k<nmeln; ++k)
-                        {
-                            LM[3*(k+nseln)  ] = mLM[3*k  ];
-                            LM[3*(k+nseln)+1] = mLM[3*k+1];
-                            LM[3*(k+nseln)+2] = mLM[3*k+2];
+                            for (k=0; k<nmeln; ++k)
+                            {
+                                LM[3*(k+nseln)  ] = mLM[3*k  ];
+                                LM[3*(k+nseln)+1] = mLM[3*k+1];
+                                LM[3*(k+nseln)+2] = mLM[3*k+2];
+                            }
                         }
-                    }
                     
-                    // build the en vector
-                    en.resize(nseln+nmeln);
-                    for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
-                    for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
+                        // build the en vector
+                        en.resize(nseln+nmeln);
+                        for (k=0; k<nseln; ++k) en[k      ] = se.m_node[k];
+                        for (k=0; k<nmeln; ++k) en[k+nseln] = me.m_node[k];
                     
-                    // primary shape functions
-                    Hs = se.H(j);
+                        // primary shape functions
+                        Hs = se.H(j);
                     
-                    // secondary shape functions
-                    double r = pt.m_rs[0];
-                    double s = pt.m_rs[1];
-                    me.shape_fnc(Hm, r, s);
+                        // secondary shape functions
+                        double r = pt.m_rs[0];
+                        double s = pt.m_rs[1];
+                        me.shape_fnc(Hm, r, s);
                     
-                    // get primary normal vector
-                    vec3d nu = pt.m_nu;
+                        // get primary normal vector
+                        vec3d nu = pt.m_nu;
                     
-                    // gap function
-                    double g = pt.m_gap;
+                        // gap function
+                        double g = pt.m_gap;
                     
-                    // penalty
-                    double eps = m_epsn*pt.m_epsn*psf;
+                        // penalty
+                        double eps = m_epsn*pt.m_epsn*psf;
                     
-                    // only evaluate stiffness matrix if contact traction is non-zero
-                    if (pn > 0) {
-                        // if stick
-                        if (pt.m_bstick) {
-                            
-                            // create the stiffness matrix
-                            ke.resize(ndof, ndof); ke.zero();
+                        // only evaluate stiffness matrix if contact traction is non-zero
+                        if (pn > 0) {
+                            // if stick
+                            if (pt.m_bstick) {
                             
-                            // evaluate basis vectors on primary surface
-                            vec3d gscov[2];
-                            ss.CoBaseVectors(se, j, gscov);
+                                // create the stiffness matrix
+                                ke.resize(ndof, ndof); ke.zero();
                             
-                            // identity tensor
-                            mat3d I = mat3dd(1);
-                            
-                            // evaluate Mc and Ac and combine them into As
-                            double* Gr = se.Gr(j);
-                            double* Gs = se.Gs(j);
-                            mat3d Ac[MN], As[MN];
-                            mat3d gscovh[2];
-                            gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
-                            for (int k=0; k<nseln; ++k) {
-                                Ac[k] = (gscovh[1]*Gr[k] - gscovh[0]*Gs[k])/detJ[j];
-                                As[k] = t & (Ac[k]*nu);
-                            }
+                                // evaluate basis vectors on primary surface
+                                vec3d gscov[2];
+                                ss.CoBaseVectors(se, j, gscov);
                             
-                            // --- S O L I D - S O L I D   C O N T A C T ---
+                                // identity tensor
+                                mat3d I = mat3dd(1);
                             
-                            double tmp = detJ[j]*w[j];
-                            for (int a=0; a<nseln; ++a) {
-                                k = a*ndpn;
-                                for (int c=0; c<nseln; ++c) {
-                                    l = c*ndpn;
-                                    mat3d Kac = (I*Hs[a]*Hs[c]*eps - As[c]*Hs[a])*tmp;
-                                    ke[k  ][l  ] += Kac(0,0); ke[k  ][l+1] += Kac(0,1); ke[k  ][l+2] += Kac(0,2);
-                                    ke[k+1][l  ] += Kac(1,0); ke[k+1][l+1] += Kac(1,1); ke[k+1][l+2] += Kac(1,2);
-                                    ke[k+2][l  ] += Kac(2,0); ke[k+2][l+1] += Kac(2,1); ke[k+2][l+2] += Kac(2,2);
-                                }
-                                for (int d=0; d<nmeln; ++d) {
-                                    l = (nseln+d)*ndpn;
-                                    mat3d Kad = I*(-Hs[a]*Hm[d]*eps)*tmp;
-                                    ke[k  ][l  ] += Kad(0,0); ke[k  ][l+1] += Kad(0,1); ke[k  ][l+2] += Kad(0,2);
-                                    ke[k+1][l  ] += Kad(1,0); ke[k+1][l+1] += Kad(1,1); ke[k+1][l+2] += Kad(1,2);
-                                    ke[k+2][l  ] += Kad(2,0); ke[k+2][l+1] += Kad(2,1); ke[k+2][l+2] += Kad(2,2);
-                                }
-                            }
-                            for (int b=0; b<nmeln; ++b) {
-                                k = (nseln+b)*ndpn;
-                                for (int c=0; c<nseln; ++c) {
-                                    l = c*ndpn;
-                                    mat3d Kbc = (I*(-Hm[b]*Hs[c]*eps) + As[c]*Hm[b])*tmp;
-                                    ke[k  ][l  ] += Kbc(0,0); ke[k  ][l+1] += Kbc(0,1); ke[k  ][l+2] += Kbc(0,2);
-                                    ke[k+1][l  ] += Kbc(1,0); ke[k+1][l+1] += Kbc(1,1); ke[k+1][l+2] += Kbc(1,2);
-                                    ke[k+2][l  ] += Kbc(2,0); ke[k+2][l+1] += Kbc(2,1); ke[k+2][l+2] += Kbc(2,2);
-                                }
-                                for (int d=0; d<nmeln; ++d) {
-                                    l = (nseln+d)*ndpn;
-                                    mat3d Kbd = I*Hm[b]*Hm[d]*eps*tmp;
-                                    ke[k  ][l  ] += Kbd(0,0); ke[k  ][l+1] += Kbd(0,1); ke[k  ][l+2] += Kbd(0,2);
-                                    ke[k+1][l  ] += Kbd(1,0); ke[k+1][l+1] += Kbd(1,1); ke[k+1][l+2] += Kbd(1,2);
-                                    ke[k+2][l  ] += Kbd(2,0); ke[k+2][l+1] += Kbd(2,1); ke[k+2][l+2] += Kbd(2,2);
+                                // evaluate Mc and Ac and combine them into As
+                                double* Gr = se.Gr(j);
+                                double* Gs = se.Gs(j);
+                                mat3d Ac[MN], As[MN];
+                                mat3d gscovh[2];
+                                gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
+                                for (int k=0; k<nseln; ++k) {
+                                    Ac[k] = (gscovh[1]*Gr[k] - gscovh[0]*Gs[k])/detJ[j];
+                                    As[k] = t & (Ac[k]*nu);
                                 }
-                            }
                             
-                            // --- M U L T I P H A S I C   S T I F F N E S S ---
-                            if (sporo && mporo)
-                            {
-                                // need to multiply biphasic stiffness entries by the timestep
-                                double dt = fem.GetTime().timeIncrement;
-                                
-                                // --- S O L I D - P R E S S U R E / S O L U T E   C O N T A C T ---
-                                
+                                // --- S O L I D - S O L I D   C O N T A C T ---
+                            
+                                double tmp = detJ[j]*w[j];
                                 for (int a=0; a<nseln; ++a) {
                                     k = a*ndpn;
                                     for (int c=0; c<nseln; ++c) {
                                         l = c*ndpn;
-                                        vec3d gac = (Ac[c]*nu)*(-Hs[a]*wn)*tmp*dt;
-                                        ke[k+3][l  ] += gac.x; ke[k+3][l+1] += gac.y; ke[k+3][l+2] += gac.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            vec3d hac = (Ac[c]*nu)*(-Hs[a]*jn[isol])*tmp*dt;
-                                            ke[k+4+isol][l  ] += hac.x; ke[k+4+isol][l+1] += hac.y; ke[k+4+isol][l+2] += hac.z;
-                                        }
+                                        mat3d Kac = (I*Hs[a]*Hs[c]*eps - As[c]*Hs[a])*tmp;
+                                        ke[k  ][l  ] += Kac(0,0); ke[k  ][l+1] += Kac(0,1); ke[k  ][l+2] += Kac(0,2);
+                                        ke[k+1][l  ] += Kac(1,0); ke[k+1][l+1] += Kac(1,1); ke[k+1][l+2] += Kac(1,2);
+                                        ke[k+2][l  ] += Kac(2,0); ke[k+2][l+1] += Kac(2,1); ke[k+2][l+2] += Kac(2,2);
                                     }
                                     for (int d=0; d<nmeln; ++d) {
                                         l = (nseln+d)*ndpn;
-                                        vec3d gad = vec3d(0,0,0);
-                                        ke[k+3][l  ] += gad.x; ke[k+3][l+1] += gad.y; ke[k+3][l+2] += gad.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            vec3d had = vec3d(0,0,0);
-                                            ke[k+4+isol][l  ] += had.x; ke[k+4+isol][l+1] += had.y; ke[k+4+isol][l+2] += had.z;
-                                        }
+                                        mat3d Kad = I*(-Hs[a]*Hm[d]*eps)*tmp;
+                                        ke[k  ][l  ] += Kad(0,0); ke[k  ][l+1] += Kad(0,1); ke[k  ][l+2] += Kad(0,2);
+                                        ke[k+1][l  ] += Kad(1,0); ke[k+1][l+1] += Kad(1,1); ke[k+1][l+2] += Kad(1,2);
+                                        ke[k+2][l  ] += Kad(2,0); ke[k+2][l+1] += Kad(2,1); ke[k+2][l+2] += Kad(2,2);
                                     }
                                 }
                                 for (int b=0; b<nmeln; ++b) {
                                     k = (nseln+b)*ndpn;
                                     for (int c=0; c<nseln; ++c) {
                                         l = c*ndpn;
-                                        vec3d gbc = (Ac[c]*nu)*Hm[b]*wn*tmp*dt;
-                                        ke[k+3][l  ] += gbc.x; ke[k+3][l+1] += gbc.y; ke[k+3][l+2] += gbc.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            vec3d hbc = (Ac[c]*nu)*Hm[b]*jn[isol]*tmp*dt;
-                                            ke[k+4+isol][l  ] += hbc.x; ke[k+4+isol][l+1] += hbc.y; ke[k+4+isol][l+2] += hbc.z;
-                                        }
+                                        mat3d Kbc = (I*(-Hm[b]*Hs[c]*eps) + As[c]*Hm[b])*tmp;
+                                        ke[k  ][l  ] += Kbc(0,0); ke[k  ][l+1] += Kbc(0,1); ke[k  ][l+2] += Kbc(0,2);
+                                        ke[k+1][l  ] += Kbc(1,0); ke[k+1][l+1] += Kbc(1,1); ke[k+1][l+2] += Kbc(1,2);
+                                        ke[k+2][l  ] += Kbc(2,0); ke[k+2][l+1] += Kbc(2,1); ke[k+2][l+2] += Kbc(2,2);
                                     }
                                     for (int d=0; d<nmeln; ++d) {
                                         l = (nseln+d)*ndpn;
-                                        vec3d gbd = vec3d(0,0,0);
-                                        ke[k+3][l  ] += gbd.x; ke[k+3][l+1] += gbd.y; ke[k+3][l+2] += gbd.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            vec3d hbd = vec3d(0,0,0);
-                                            ke[k+4+isol][l  ] += hbd.x; ke[k+4+isol][l+1] += hbd.y; ke[k+4+isol][l+2] += hbd.z;
-                                        }
+                                        mat3d Kbd = I*Hm[b]*Hm[d]*eps*tmp;
+                                        ke[k  ][l  ] += Kbd(0,0); ke[k  ][l+1] += Kbd(0,1); ke[k  ][l+2] += Kbd(0,2);
+                                        ke[k+1][l  ] += Kbd(1,0); ke[k+1][l+1] += Kbd(1,1); ke[k+1][l+2] += Kbd(1,2);
+                                        ke[k+2][l  ] += Kbd(2,0); ke[k+2][l+1] += Kbd(2,1); ke[k+2][l+2] += Kbd(2,2);
                                     }
                                 }
+                            
+                                // --- M U L T I P H A S I C   S T I F F N E S S ---
+                                if (sporo && mporo)
+                                {
+                                    // need to multiply biphasic stiffness entries by the timestep
+                                    double dt = fem.GetTime().timeIncrement;
                                 
-                                // --- P R E S S U R E - P R E S S U R E  /  C O N C E N T R A T I O N - C O N C E N T R A T I O N  C O N T A C T ---
+                                    // --- S O L I D - P R E S S U R E / S O L U T E   C O N T A C T ---
                                 
-                                for (int a=0; a<nseln; ++a) {
-                                    k = a*ndpn;
-                                    for (int c=0; c<nseln; ++c) {
-                                        l = c*ndpn;
-                                        double gac = (-Hs[a]*Hs[c]*epsp)*tmp*dt;
-                                        ke[k+3][l+3] += gac;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
-                                                double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double hac = (-Hs[a]*Hs[c]*epsc*z)*tmp*dt;
-                                                ke[k+4+isol][l+4+jsol] += hac;
+                                    for (int a=0; a<nseln; ++a) {
+                                        k = a*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            vec3d gac = (Ac[c]*nu)*(-Hs[a]*wn)*tmp*dt;
+                                            ke[k+3][l  ] += gac.x; ke[k+3][l+1] += gac.y; ke[k+3][l+2] += gac.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                vec3d hac = (Ac[c]*nu)*(-Hs[a]*jn[isol])*tmp*dt;
+                                                ke[k+4+isol][l  ] += hac.x; ke[k+4+isol][l+1] += hac.y; ke[k+4+isol][l+2] += hac.z;
+                                            }
+                                        }
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            vec3d gad = vec3d(0,0,0);
+                                            ke[k+3][l  ] += gad.x; ke[k+3][l+1] += gad.y; ke[k+3][l+2] += gad.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                vec3d had = vec3d(0,0,0);
+                                                ke[k+4+isol][l  ] += had.x; ke[k+4+isol][l+1] += had.y; ke[k+4+isol][l+2] += had.z;
                                             }
                                         }
                                     }
-                                    for (int d=0; d<nmeln; ++d) {
-                                        l = (nseln+d)*ndpn;
-                                        double gad = (Hs[a]*Hm[d]*epsp)*tmp*dt;
-                                        ke[k+3][l+3] += gad;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
-                                                double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double had = (Hs[a]*Hm[d]*epsc*z)*tmp*dt;
-                                                ke[k+4+isol][l+4+jsol] += had;
+                                    for (int b=0; b<nmeln; ++b) {
+                                        k = (nseln+b)*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            vec3d gbc = (Ac[c]*nu)*Hm[b]*wn*tmp*dt;
+                                            ke[k+3][l  ] += gbc.x; ke[k+3][l+1] += gbc.y; ke[k+3][l+2] += gbc.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                vec3d hbc = (Ac[c]*nu)*Hm[b]*jn[isol]*tmp*dt;
+                                                ke[k+4+isol][l  ] += hbc.x; ke[k+4+isol][l+1] += hbc.y; ke[k+4+isol][l+2] += hbc.z;
+                                            }
+                                        }
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            vec3d gbd = vec3d(0,0,0);
+                                            ke[k+3][l  ] += gbd.x; ke[k+3][l+1] += gbd.y; ke[k+3][l+2] += gbd.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                vec3d hbd = vec3d(0,0,0);
+                                                ke[k+4+isol][l  ] += hbd.x; ke[k+4+isol][l+1] += hbd.y; ke[k+4+isol][l+2] += hbd.z;
                                             }
                                         }
                                     }
-                                }
-                                for (int b=0; b<nmeln; ++b) {
-                                    k = (nseln+b)*ndpn;
-                                    for (int c=0; c<nseln; ++c) {
-                                        l = c*ndpn;
-                                        double gbc = (Hm[b]*Hs[c]*epsp)*tmp*dt;
-                                        ke[k+3][l+3] += gbc;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
-                                                double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double hbc = (Hm[b]*Hs[c]*epsc*z)*tmp*dt;
-                                                ke[k+4+isol][l+4+jsol] += hbc;
+                                
+                                    // --- P R E S S U R E - P R E S S U R E  /  C O N C E N T R A T I O N - C O N C E N T R A T I O N  C O N T A C T ---
+                                
+                                    for (int a=0; a<nseln; ++a) {
+                                        k = a*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            double gac = (-Hs[a]*Hs[c]*epsp)*tmp*dt;
+                                            ke[k+3][l+3] += gac;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double hac = (-Hs[a]*Hs[c]*epsc*z)*tmp*dt;
+                                                    ke[k+4+isol][l+4+jsol] += hac;
+                                                }
+                                            }
+                                        }
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            double gad = (Hs[a]*Hm[d]*epsp)*tmp*dt;
+                                            ke[k+3][l+3] += gad;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double had = (Hs[a]*Hm[d]*epsc*z)*tmp*dt;
+                                                    ke[k+4+isol][l+4+jsol] += had;
+                                                }
                                             }
                                         }
                                     }
-                                    for (int d=0; d<nmeln; ++d) {
-                                        l = (nseln+d)*ndpn;
-                                        double gbd = (-Hm[b]*Hm[d]*epsp)*tmp*dt;
-                                        ke[k+3][l+3] += gbd;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
-                                                double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double hbd = (-Hm[b]*Hm[d]*epsc*z)*tmp*dt;
-                                                ke[k+4+isol][l+4+jsol] += hbd;
+                                    for (int b=0; b<nmeln; ++b) {
+                                        k = (nseln+b)*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            double gbc = (Hm[b]*Hs[c]*epsp)*tmp*dt;
+                                            ke[k+3][l+3] += gbc;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double hbc = (Hm[b]*Hs[c]*epsc*z)*tmp*dt;
+                                                    ke[k+4+isol][l+4+jsol] += hbc;
+                                                }
+                                            }
+                                        }
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            double gbd = (-Hm[b]*Hm[d]*epsp)*tmp*dt;
+                                            ke[k+3][l+3] += gbd;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double hbd = (-Hm[b]*Hm[d]*epsc*z)*tmp*dt;
+                                                    ke[k+4+isol][l+4+jsol] += hbd;
+                                                }
                                             }
                                         }
                                     }
                                 }
-                            }
-                            
-                            // assemble the global stiffness
-                            ke.SetNodes(en);
-                            ke.SetIndices(LM);
-                            LS.Assemble(ke);
-                        }
-                        // if slip
-                        else {
                             
-                            // create the stiffness matrix
-                            ke.resize(ndof, ndof); ke.zero();
+                                // assemble the global stiffness
+                                ke.SetNodes(en);
+                                ke.SetIndices(LM);
+                                LS.Assemble(ke);
+                            }
+                            // if slip
+                            else {
                             
-                            double tn = -pn;
+                                // create the stiffness matrix
+                                ke.resize(ndof, ndof); ke.zero();
                             
-                            // obtain the slip direction s1 and inverse of spatial increment dh
-                            double dh = 0, hd = 0;
-                            vec3d dr(0,0,0);
-                            vec3d s1 = SlipTangent(ss, i, j, ms, dh, dr);
+                                double tn = -pn;
                             
-                            if (dh != 0) hd = 1.0 / dh;
+                                // obtain the slip direction s1 and inverse of spatial increment dh
+                                double dh = 0, hd = 0;
+                                vec3d dr(0,0,0);
+                                vec3d s1 = SlipTangent(ss, i, j, ms, dh, dr);
                             
-                            // evaluate basis vectors on both surfaces
-                            vec3d gscov[2], gmcov[2];
-                            ss.CoBaseVectors(se, j, gscov);
-                            ms.CoBaseVectors(me, r, s, gmcov);
-                            mat2d A;
-                            A[0][0] = gscov[0]*gmcov[0]; A[0][1] = gscov[0]*gmcov[1];
-                            A[1][0] = gscov[1]*gmcov[0]; A[1][1] = gscov[1]*gmcov[1];
-                            mat2d a = A.inverse();
+                                if (dh != 0) hd = 1.0 / dh;
                             
-                            // evaluate covariant basis vectors on primary surface at previous time step
-                            vec3d gscovp[2];
-                            ss.CoBaseVectorsP(se, j, gscovp);
+                                // evaluate basis vectors on both surfaces
+                                vec3d gscov[2], gmcov[2];
+                                ss.CoBaseVectors(se, j, gscov);
+                                ms.CoBaseVectors(me, r, s, gmcov);
+                                mat2d A;
+                                A[0][0] = gscov[0]*gmcov[0]; A[0][1] = gscov[0]*gmcov[1];
+                                A[1][0] = gscov[1]*gmcov[0]; A[1][1] = gscov[1]*gmcov[1];
+                                mat2d a = A.inverse();
                             
-                            // calculate delta gscov
-                            vec3d dgscov[2];
-                            dgscov[0] = gscov[0] - gscovp[0];
-                            dgscov[1] = gscov[1] - gscovp[1];
+                                // evaluate covariant basis vectors on primary surface at previous time step
+                                vec3d gscovp[2];
+                                ss.CoBaseVectorsP(se, j, gscovp);
                             
-                            // evaluate approximate contravariant basis vectors when gap != 0
-                            vec3d gscnt[2], gmcnt[2];
-                            gmcnt[0] = gscov[0]*a[0][0] + gscov[1]*a[0][1];
-                            gmcnt[1] = gscov[0]*a[1][0] + gscov[1]*a[1][1];
-                            gscnt[0] = gmcov[0]*a[0][0] + gmcov[1]*a[1][0];
-                            gscnt[1] = gmcov[0]*a[0][1] + gmcov[1]*a[1][1];
+                                // calculate delta gscov
+                                vec3d dgscov[2];
+                                dgscov[0] = gscov[0] - gscovp[0];
+                                dgscov[1] = gscov[1] - gscovp[1];
                             
-                            // evaluate N and S tensors and approximations when gap != 0
-                            mat3ds N1 = dyad(nu);
-                            mat3d Pn = mat3dd(1) - (nu & nu);
-                            mat3d Nb1 = mat3dd(1) - (gscov[0] & gscnt[0]) - (gscov[1] & gscnt[1]);
-                            mat3d Nt1 = nu & (Nb1*nu);
-                            mat3d S1 = s1 & nu;
-                            mat3d Ps = (mat3dd(1) - (s1 & s1))*hd;
-                            mat3d St1 = s1 & (Nb1*nu);
+                                // evaluate approximate contravariant basis vectors when gap != 0
+                                vec3d gscnt[2], gmcnt[2];
+                                gmcnt[0] = gscov[0]*a[0][0] + gscov[1]*a[0][1];
+                                gmcnt[1] = gscov[0]*a[1][0] + gscov[1]*a[1][1];
+                                gscnt[0] = gmcov[0]*a[0][0] + gmcov[1]*a[1][0];
+                                gscnt[1] = gmcov[0]*a[0][1] + gmcov[1]*a[1][1];
                             
-                            // evaluate frictional contact vectors and tensors
-                            vec3d m = ((dgscov[0] ^ gscov[1]) + (gscov[0] ^ dgscov[1]));
-                            vec3d c1 = Pn*m*(1/detJ[j]);
-                            mat3d Q1 = (mat3dd(1)*(nu * m) + (nu & m))*(1/detJ[j]);
-                            mat3d B = ((Ps*c1) & (Nb1*nu)) - Ps*Pn;
-                            mat3d R = (mat3dd(1)*(nu * dr) + (nu & dr))/(-g);
-                            mat3d L1 = Ps*(Pn*Q1 + R - mat3dd(1))*Pn*(-g);
+                                // evaluate N and S tensors and approximations when gap != 0
+                                mat3ds N1 = dyad(nu);
+                                mat3d Pn = mat3dd(1) - (nu & nu);
+                                mat3d Nb1 = mat3dd(1) - (gscov[0] & gscnt[0]) - (gscov[1] & gscnt[1]);
+                                mat3d Nt1 = nu & (Nb1*nu);
+                                mat3d S1 = s1 & nu;
+                                mat3d Ps = (mat3dd(1) - (s1 & s1))*hd;
+                                mat3d St1 = s1 & (Nb1*nu);
                             
-                            // evaluate Ac, Mc, and combine into As
-                            double* Gr = se.Gr(j);
-                            double* Gs = se.Gs(j);
-                            mat3d gscovh[2];
-                            mat3d dgscovh[2];
-                            gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
-                            dgscovh[0].skew(dgscov[0]); dgscovh[1].skew(dgscov[1]);
-                            mat3d Ac[MN];
-                            mat3d As[MN];
-                            mat3d Pc[MN];
-                            for (int c=0; c<nseln; ++c){
-                                vec3d mc = gscnt[0]*Gr[c] + gscnt[1]*Gs[c];
-                                mat3d Mc = nu & mc;
-                                Ac[c] = (gscovh[1]*Gr[c] - gscovh[0]*Gs[c])/detJ[j];
-                                mat3d Acb = (dgscovh[1]*Gr[c] - dgscovh[0]*Gs[c])/detJ[j];
-                                vec3d hcp = (N1*mc + Ac[c]*nu);
-                                vec3d hcmb = (N1*mc*m_mu - Ac[c]*nu*pt.m_mueff);
-                                As[c] = Ac[c]+Mc*N1;
-                                mat3d Jc = (L1*Ac[c]) - Ps*Pn*Acb*(-g);
-                                Pc[c] = (s1 & hcmb) + ((Ps*c1) & hcp)*pt.m_mueff*(-g) - Jc*pt.m_mueff;
-                            }
+                                // evaluate frictional contact vectors and tensors
+                                vec3d m = ((dgscov[0] ^ gscov[1]) + (gscov[0] ^ dgscov[1]));
+                                vec3d c1 = Pn*m*(1/detJ[j]);
+                                mat3d Q1 = (mat3dd(1)*(nu * m) + (nu & m))*(1/detJ[j]);
+                                mat3d B = ((Ps*c1) & (Nb1*nu)) - Ps*Pn;
+                                mat3d R = (mat3dd(1)*(nu * dr) + (nu & dr))/(-g);
+                                mat3d L1 = Ps*(Pn*Q1 + R - mat3dd(1))*Pn*(-g);
                             
-                            // evaluate mb and Mb
-                            double Hmr[MN], Hms[MN];
-                            me.shape_deriv(Hmr, Hms, r, s);
-                            vec3d mb[MN];
-                            mat3d Pb[MN];
-                            for (k=0; k<nmeln; ++k) {
-                                mb[k] = gmcnt[0]*Hmr[k] + gmcnt[1]*Hms[k];
-                                Pb[k] = ((-nu) & mb[k]) - (s1 & mb[k])*pt.m_mueff;
-                            }
+                                // evaluate Ac, Mc, and combine into As
+                                double* Gr = se.Gr(j);
+                                double* Gs = se.Gs(j);
+                                mat3d gscovh[2];
+                                mat3d dgscovh[2];
+                                gscovh[0].skew(gscov[0]); gscovh[1].skew(gscov[1]);
+                                dgscovh[0].skew(dgscov[0]); dgscovh[1].skew(dgscov[1]);
+                                mat3d Ac[MN];
+                                mat3d As[MN];
+                                mat3d Pc[MN];
+                                for (int c=0; c<nseln; ++c){
+                                    vec3d mc = gscnt[0]*Gr[c] + gscnt[1]*Gs[c];
+                                    mat3d Mc = nu & mc;
+                                    Ac[c] = (gscovh[1]*Gr[c] - gscovh[0]*Gs[c])/detJ[j];
+                                    mat3d Acb = (dgscovh[1]*Gr[c] - dgscovh[0]*Gs[c])/detJ[j];
+                                    vec3d hcp = (N1*mc + Ac[c]*nu);
+                                    vec3d hcmb = (N1*mc*m_mu - Ac[c]*nu*pt.m_mueff);
+                                    As[c] = Ac[c]+Mc*N1;
+                                    mat3d Jc = (L1*Ac[c]) - Ps*Pn*Acb*(-g);
+                                    Pc[c] = (s1 & hcmb) + ((Ps*c1) & hcp)*pt.m_mueff*(-g) - Jc*pt.m_mueff;
+                                }
                             
-                            // evaluate Gbc
-                            matrix Gbc(nmeln,nseln);
-                            for (int b=0; b<nmeln; ++b) {
-                                for (int c=0; c<nseln; ++c) {
-                                    Gbc(b,c)
-                                    = (a[0][0]*Hmr[b]*Gr[c]
-                                       + a[0][1]*Hmr[b]*Gs[c]
-                                       + a[1][0]*Hms[b]*Gr[c]
-                                       + a[1][1]*Hms[b]*Gs[c])*(-g);
+                                // evaluate mb and Mb
+                                double Hmr[MN], Hms[MN];
+                                me.shape_deriv(Hmr, Hms, r, s);
+                                vec3d mb[MN];
+                                mat3d Pb[MN];
+                                for (k=0; k<nmeln; ++k) {
+                                    mb[k] = gmcnt[0]*Hmr[k] + gmcnt[1]*Hms[k];
+                                    Pb[k] = ((-nu) & mb[k]) - (s1 & mb[k])*pt.m_mueff;
                                 }
-                            }
                             
-                            // define Tt, T
-                            mat3d Tt = Nt1 + St1*m_mu;
-                            mat3d T = N1 + S1*pt.m_mueff;
+                                // evaluate Gbc
+                                matrix Gbc(nmeln,nseln);
+                                for (int b=0; b<nmeln; ++b) {
+                                    for (int c=0; c<nseln; ++c) {
+                                        Gbc(b,c)
+                                        = (a[0][0]*Hmr[b]*Gr[c]
+                                           + a[0][1]*Hmr[b]*Gs[c]
+                                           + a[1][0]*Hms[b]*Gr[c]
+                                           + a[1][1]*Hms[b]*Gs[c])*(-g);
+                                    }
+                                }
                             
-                            // --- S O L I D - S O L I D   C O N T A C T ---
+                                // define Tt, T
+                                mat3d Tt = Nt1 + St1*m_mu;
+                                mat3d T = N1 + S1*pt.m_mueff;
                             
-                            // All Kmn terms have the opposite sign from Brandon's notes
-                            // Does FEBio put the negative sign in the stiffness matrix? K*u = f => f - K*u = 0?
+                                // --- S O L I D - S O L I D   C O N T A C T ---
                             
-                            double tmp = detJ[j]*w[j];
-                            for (int a=0; a<nseln; ++a) {
-                                k = a*ndpn;
-                                for (int c=0; c<nseln; ++c) {
-                                    l = c*ndpn;
-                                    mat3d Kac = ((Tt*eps+B*tn*pt.m_mueff)*Hs[a]*Hs[c]+(As[c]+Pc[c])*Hs[a]*tn)*tmp;
-                                    ke[k  ][l  ] += Kac(0,0); ke[k  ][l+1] += Kac(0,1); ke[k  ][l+2] += Kac(0,2);
-                                    ke[k+1][l  ] += Kac(1,0); ke[k+1][l+1] += Kac(1,1); ke[k+1][l+2] += Kac(1,2);
-                                    ke[k+2][l  ] += Kac(2,0); ke[k+2][l+1] += Kac(2,1); ke[k+2][l+2] += Kac(2,2);
-                                }
-                                for (int d=0; d<nmeln; ++d) {
-                                    l = (nseln+d)*ndpn;
-                                    mat3d Kad = (Tt*eps+B*tn*pt.m_mueff)*(-Hs[a]*Hm[d]*tmp);
-                                    ke[k  ][l  ] += Kad(0,0); ke[k  ][l+1] += Kad(0,1); ke[k  ][l+2] += Kad(0,2);
-                                    ke[k+1][l  ] += Kad(1,0); ke[k+1][l+1] += Kad(1,1); ke[k+1][l+2] += Kad(1,2);
-                                    ke[k+2][l  ] += Kad(2,0); ke[k+2][l+1] += Kad(2,1); ke[k+2][l+2] += Kad(2,2);
-                                }
-                            }
-                            for (int b=0; b<nmeln; ++b) {
-                                k = (nseln+b)*ndpn;
-                                for (int c=0; c<nseln; ++c) {
-                                    l = c*ndpn;
-                                    mat3d Kbc = ((Tt*eps+B*tn*pt.m_mueff)*(-Hm[b]*Hs[c])-(As[c]+Pc[c])*(Hm[b]*tn)-Pb[b]*(Hs[c]*tn)-T*(Gbc[b][c]*tn))*tmp;
-                                    ke[k  ][l  ] += Kbc(0,0); ke[k  ][l+1] += Kbc(0,1); ke[k  ][l+2] += Kbc(0,2);
-                                    ke[k+1][l  ] += Kbc(1,0); ke[k+1][l+1] += Kbc(1,1); ke[k+1][l+2] += Kbc(1,2);
-                                    ke[k+2][l  ] += Kbc(2,0); ke[k+2][l+1] += Kbc(2,1); ke[k+2][l+2] += Kbc(2,2);
-                                }
-                                for (int d=0; d<nmeln; ++d) {
-                                    l = (nseln+d)*ndpn;
-                                    mat3d Kbd = ((Tt*eps+B*tn*pt.m_mueff)*Hm[b]*Hm[d]+Pb[b]*Hm[d]*tn)*tmp;
-                                    ke[k  ][l  ] += Kbd(0,0); ke[k  ][l+1] += Kbd(0,1); ke[k  ][l+2] += Kbd(0,2);
-                                    ke[k+1][l  ] += Kbd(1,0); ke[k+1][l+1] += Kbd(1,1); ke[k+1][l+2] += Kbd(1,2);
-                                    ke[k+2][l  ] += Kbd(2,0); ke[k+2][l+1] += Kbd(2,1); ke[k+2][l+2] += Kbd(2,2);
-                                }
-                            }
+                                // All Kmn terms have the opposite sign from Brandon's notes
+                                // Does FEBio put the negative sign in the stiffness matrix? K*u = f => f - K*u = 0?
                             
-                            // --- M U L T I P H A S I C   S T I F F N E S S ---
-                            if (sporo && mporo)
-                            {
-                                double dt = fem.GetTime().timeIncrement;
-                                
-                                double epsp = m_epsp*pt.m_epsp*psf;
-                                
-                                // p vector (gradients of effective solute concentrations on master surface)
-                                double dpmr = me.eval_deriv1(pm, r, s);
-                                double dpms = me.eval_deriv2(pm, r, s);
-                                vec3d p = gmcnt[0]*dpmr + gmcnt[1]*dpms;
-                                
-                                // evaluate Pc
-                                double Pc[MN];
-                                for (int k=0; k<nseln; ++k) {
-                                    Pc[k] = (a[0][0]*dpmr*Gr[k]
-                                             + a[0][1]*dpmr*Gs[k]
-                                             + a[1][0]*dpms*Gr[k]
-                                             + a[1][1]*dpms*Gs[k])*(-g);
-                                }
-                                
-                                // q vectors (gradients of effective solute concentrations on master surface)
-                                // Cc scalars
-                                vector<vec3d> q(nsol);
-                                vector< vector<double> > Cc(nsol, vector<double>(MN));
-                                for (int isol=0; isol<nsol; ++isol) {
-                                    double dcmr = me.eval_deriv1(&cm[isol][0], r, s);
-                                    double dcms = me.eval_deriv2(&cm[isol][0], r, s);
-                                    q[isol] = gmcnt[0]*dcmr + gmcnt[1]*dcms;
-                                    for (int k=0; k<nseln; ++k) {
-                                        Cc[isol][k] = (a[0][0]*dcmr*Gr[k]
-                                                       + a[0][1]*dcmr*Gs[k]
-                                                       + a[1][0]*dcms*Gr[k]
-                                                       + a[1][1]*dcms*Gs[k])*(-g);
-                                    }
-                                }
-                                
-                                // --- S O L I D - P R E S S U R E / S O L U T E   C O N T A C T ---
-                                
+                                double tmp = detJ[j]*w[j];
                                 for (int a=0; a<nseln; ++a) {
                                     k = a*ndpn;
                                     for (int c=0; c<nseln; ++c) {
                                         l = c*ndpn;
-                                        vec3d gac = (p*Hs[a]*Hs[c]*epsp-((Ac[c]*nu)*wn+nu*epsp*Pc[c])*Hs[a])*tmp*dt;
-                                        ke[k+3][l  ] += gac.x; ke[k+3][l+1] += gac.y; ke[k+3][l+2] += gac.z;
-                                        vec3d kac = (s1*m_mu*(1.0-m_phi))*(-Hs[a]*Hs[c])*tmp*dt;
-                                        ke[k  ][l+3] += kac.x; ke[k+1][l+3] += kac.y; ke[k+2][l+3] += kac.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                            vec3d hac = (q[isol]*Hs[a]*Hs[c]*epsc-((Ac[c]*nu)*jn[isol]+nu*Cc[isol][c]*epsc)*Hs[a])*tmp*dt;
-                                            ke[k+4+isol][l  ] += hac.x; ke[k+4+isol][l+1] += hac.y; ke[k+4+isol][l+2] += hac.z;
-                                        }
+                                        mat3d Kac = ((Tt*eps+B*tn*pt.m_mueff)*Hs[a]*Hs[c]+(As[c]+Pc[c])*Hs[a]*tn)*tmp;
+                                        ke[k  ][l  ] += Kac(0,0); ke[k  ][l+1] += Kac(0,1); ke[k  ][l+2] += Kac(0,2);
+                                        ke[k+1][l  ] += Kac(1,0); ke[k+1][l+1] += Kac(1,1); ke[k+1][l+2] += Kac(1,2);
+                                        ke[k+2][l  ] += Kac(2,0); ke[k+2][l+1] += Kac(2,1); ke[k+2][l+2] += Kac(2,2);
                                     }
                                     for (int d=0; d<nmeln; ++d) {
                                         l = (nseln+d)*ndpn;
-                                        vec3d gad = p*(-Hs[a]*Hm[d]*epsp)*tmp*dt;
-                                        ke[k+3][l  ] += gad.x; ke[k+3][l+1] += gad.y; ke[k+3][l+2] += gad.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                            vec3d had = q[isol]*(-Hs[a]*Hm[d]*epsc)*tmp*dt;
-                                            ke[k+4+isol][l  ] += had.x; ke[k+4+isol][l+1] += had.y; ke[k+4+isol][l+2] += had.z;
-                                        }
+                                        mat3d Kad = (Tt*eps+B*tn*pt.m_mueff)*(-Hs[a]*Hm[d]*tmp);
+                                        ke[k  ][l  ] += Kad(0,0); ke[k  ][l+1] += Kad(0,1); ke[k  ][l+2] += Kad(0,2);
+                                        ke[k+1][l  ] += Kad(1,0); ke[k+1][l+1] += Kad(1,1); ke[k+1][l+2] += Kad(1,2);
+                                        ke[k+2][l  ] += Kad(2,0); ke[k+2][l+1] += Kad(2,1); ke[k+2][l+2] += Kad(2,2);
                                     }
                                 }
                                 for (int b=0; b<nmeln; ++b) {
                                     k = (nseln+b)*ndpn;
                                     for (int c=0; c<nseln; ++c) {
                                         l = c*ndpn;
-                                        vec3d gbc = (p*(-Hm[b]*Hs[c]*epsp)+((Ac[c]*nu)*wn + nu*Pc[c]*epsp)*Hm[b] + (mb[b]*wn*Hs[c]) - nu*Gbc[b][c]*wn)*tmp*dt;
-                                        ke[k+3][l  ] += gbc.x; ke[k+3][l+1] += gbc.y; ke[k+3][l+2] += gbc.z;
-                                        vec3d kbc = (s1*m_mu*(1.0-m_phi))*(Hm[b]*Hs[c])*tmp*dt;
-                                        ke[k  ][l+3] += kbc.x; ke[k+1][l+3] += kbc.y; ke[k+2][l+3] += kbc.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                            vec3d hbc = (q[isol]*(-Hm[b]*Hs[c]*epsc)+((Ac[c]*nu)*jn[isol]+nu*epsc*Cc[isol][c])*Hm[b]+(mb[b]*jn[isol]*Hs[c])-(nu*Gbc[b][c]*jn[isol]))*tmp*dt;
-                                            ke[k+4+isol][l  ] += hbc.x; ke[k+4+isol][l+1] += hbc.y; ke[k+4+isol][l+2] += hbc.z;
-                                        }
+                                        mat3d Kbc = ((Tt*eps+B*tn*pt.m_mueff)*(-Hm[b]*Hs[c])-(As[c]+Pc[c])*(Hm[b]*tn)-Pb[b]*(Hs[c]*tn)-T*(Gbc[b][c]*tn))*tmp;
+                                        ke[k  ][l  ] += Kbc(0,0); ke[k  ][l+1] += Kbc(0,1); ke[k  ][l+2] += Kbc(0,2);
+                                        ke[k+1][l  ] += Kbc(1,0); ke[k+1][l+1] += Kbc(1,1); ke[k+1][l+2] += Kbc(1,2);
+                                        ke[k+2][l  ] += Kbc(2,0); ke[k+2][l+1] += Kbc(2,1); ke[k+2][l+2] += Kbc(2,2);
                                     }
                                     for (int d=0; d<nmeln; ++d) {
                                         l = (nseln+d)*ndpn;
-                                        vec3d gbd = (p*(Hm[b]*Hm[d]*epsp)-(mb[b]*wn*Hm[d]))*tmp*dt;
-                                        ke[k+3][l  ] += gbd.x; ke[k+3][l+1] += gbd.y; ke[k+3][l+2] += gbd.z;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                            vec3d hbd = (q[isol]*(Hm[b]*Hm[d]*epsc)-(mb[b]*jn[isol]*Hm[d]))*tmp*dt;
-                                            ke[k+4+isol][l  ] += hbd.x; ke[k+4+isol][l+1] += hbd.y; ke[k+4+isol][l+2] += hbd.z;
-                                        }
+                                        mat3d Kbd = ((Tt*eps+B*tn*pt.m_mueff)*Hm[b]*Hm[d]+Pb[b]*Hm[d]*tn)*tmp;
+                                        ke[k  ][l  ] += Kbd(0,0); ke[k  ][l+1] += Kbd(0,1); ke[k  ][l+2] += Kbd(0,2);
+                                        ke[k+1][l  ] += Kbd(1,0); ke[k+1][l+1] += Kbd(1,1); ke[k+1][l+2] += Kbd(1,2);
+                                        ke[k+2][l  ] += Kbd(2,0); ke[k+2][l+1] += Kbd(2,1); ke[k+2][l+2] += Kbd(2,2);
                                     }
                                 }
+                            
+                                // --- M U L T I P H A S I C   S T I F F N E S S ---
+                                if (sporo && mporo)
+                                {
+                                    double dt = fem.GetTime().timeIncrement;
                                 
-                                // --- P R E S S U R E - P R E S S U R E  /  C O N C E N T R A T I O N - C O N C E N T R A T I O N  C O N T A C T ---
+                                    double epsp = m_epsp*pt.m_epsp*psf;
                                 
-                                for (int a=0; a<nseln; ++a) {
-                                    k = a*ndpn;
-                                    for (int c=0; c<nseln; ++c) {
-                                        l = c*ndpn;
-                                        double gac = (-Hs[a]*Hs[c]*epsp)*tmp*dt;
-                                        ke[k+3][l+3] += gac;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
+                                    // p vector (gradients of effective solute concentrations on master surface)
+                                    double dpmr = me.eval_deriv1(pm, r, s);
+                                    double dpms = me.eval_deriv2(pm, r, s);
+                                    vec3d p = gmcnt[0]*dpmr + gmcnt[1]*dpms;
+                                
+                                    // evaluate Pc
+                                    double Pc[MN];
+                                    for (int k=0; k<nseln; ++k) {
+                                        Pc[k] = (a[0][0]*dpmr*Gr[k]
+                                                 + a[0][1]*dpmr*Gs[k]
+                                                 + a[1][0]*dpms*Gr[k]
+                                                 + a[1][1]*dpms*Gs[k])*(-g);
+                                    }
+                                
+                                    // q vectors (gradients of effective solute concentrations on master surface)
+                                    // Cc scalars
+                                    vector<vec3d> q(nsol);
+                                    vector< vector<double> > Cc(nsol, vector<double>(MN));
+                                    for (int isol=0; isol<nsol; ++isol) {
+                                        double dcmr = me.eval_deriv1(&cm[isol][0], r, s);
+                                        double dcms = me.eval_deriv2(&cm[isol][0], r, s);
+                                        q[isol] = gmcnt[0]*dcmr + gmcnt[1]*dcms;
+                                        for (int k=0; k<nseln; ++k) {
+                                            Cc[isol][k] = (a[0][0]*dcmr*Gr[k]
+                                                           + a[0][1]*dcmr*Gs[k]
+                                                           + a[1][0]*dcms*Gr[k]
+                                                           + a[1][1]*dcms*Gs[k])*(-g);
+                                        }
+                                    }
+                                
+                                    // --- S O L I D - P R E S S U R E / S O L U T E   C O N T A C T ---
+                                
+                                    for (int a=0; a<nseln; ++a) {
+                                        k = a*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            vec3d gac = (p*Hs[a]*Hs[c]*epsp-((Ac[c]*nu)*wn+nu*epsp*Pc[c])*Hs[a])*tmp*dt;
+                                            ke[k+3][l  ] += gac.x; ke[k+3][l+1] += gac.y; ke[k+3][l+2] += gac.z;
+                                            vec3d kac = (s1*m_mu*(1.0-m_phi))*(-Hs[a]*Hs[c])*tmp*dt;
+                                            ke[k  ][l+3] += kac.x; ke[k+1][l+3] += kac.y; ke[k+2][l+3] += kac.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
                                                 double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double hac = (-Hs[a]*Hs[c]*epsc*z)*(dt*detJ[j]*w[j]);
-                                                ke[k+4+isol][l+4+jsol] += hac;
+                                                vec3d hac = (q[isol]*Hs[a]*Hs[c]*epsc-((Ac[c]*nu)*jn[isol]+nu*Cc[isol][c]*epsc)*Hs[a])*tmp*dt;
+                                                ke[k+4+isol][l  ] += hac.x; ke[k+4+isol][l+1] += hac.y; ke[k+4+isol][l+2] += hac.z;
                                             }
                                         }
-                                    }
-                                    for (int d=0; d<nmeln; ++d) {
-                                        l = (nseln+d)*ndpn;
-                                        double gad = (Hs[a]*Hm[d]*epsp)*(dt*detJ[j]*w[j]);
-                                        ke[k+3][l+3] += gad;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            vec3d gad = p*(-Hs[a]*Hm[d]*epsp)*tmp*dt;
+                                            ke[k+3][l  ] += gad.x; ke[k+3][l+1] += gad.y; ke[k+3][l+2] += gad.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
                                                 double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double had = (Hs[a]*Hm[d]*epsc*z)*(dt*detJ[j]*w[j]);
-                                                ke[k+4+isol][l+4+jsol] += had;
+                                                vec3d had = q[isol]*(-Hs[a]*Hm[d]*epsc)*tmp*dt;
+                                                ke[k+4+isol][l  ] += had.x; ke[k+4+isol][l+1] += had.y; ke[k+4+isol][l+2] += had.z;
                                             }
                                         }
                                     }
-                                }
-                                for (int b=0; b<nmeln; ++b) {
-                                    k = (nseln+b)*ndpn;
-                                    for (int c=0; c<nseln; ++c) {
-                                        l = c*ndpn;
-                                        double gbc = (Hm[b]*Hs[c]*epsp)*(dt*detJ[j]*w[j]);
-                                        ke[k+3][l+3] += gbc;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
+                                    for (int b=0; b<nmeln; ++b) {
+                                        k = (nseln+b)*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            vec3d gbc = (p*(-Hm[b]*Hs[c]*epsp)+((Ac[c]*nu)*wn + nu*Pc[c]*epsp)*Hm[b] + (mb[b]*wn*Hs[c]) - nu*Gbc[b][c]*wn)*tmp*dt;
+                                            ke[k+3][l  ] += gbc.x; ke[k+3][l+1] += gbc.y; ke[k+3][l+2] += gbc.z;
+                                            vec3d kbc = (s1*m_mu*(1.0-m_phi))*(Hm[b]*Hs[c])*tmp*dt;
+                                            ke[k  ][l+3] += kbc.x; ke[k+1][l+3] += kbc.y; ke[k+2][l+3] += kbc.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
                                                 double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double hbc = (Hm[b]*Hs[c]*epsc*z)*(dt*detJ[j]*w[j]);
-                                                ke[k+4+isol][l+4+jsol] += hbc;
+                                                vec3d hbc = (q[isol]*(-Hm[b]*Hs[c]*epsc)+((Ac[c]*nu)*jn[isol]+nu*epsc*Cc[isol][c])*Hm[b]+(mb[b]*jn[isol]*Hs[c])-(nu*Gbc[b][c]*jn[isol]))*tmp*dt;
+                                                ke[k+4+isol][l  ] += hbc.x; ke[k+4+isol][l+1] += hbc.y; ke[k+4+isol][l+2] += hbc.z;
                                             }
                                         }
-                                    }
-                                    for (int d=0; d<nmeln; ++d) {
-                                        l = (nseln+d)*ndpn;
-                                        double gbd = (-Hm[b]*Hm[d]*epsp)*(dt*detJ[j]*w[j]);
-                                        ke[k+3][l+3] += gbd;
-                                        for (int isol=0; isol<nsol; ++isol) {
-                                            for (int jsol=0; jsol<nsol; ++jsol) {
-                                                int z = (isol == jsol? 1.0 : 0.0);
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            vec3d gbd = (p*(Hm[b]*Hm[d]*epsp)-(mb[b]*wn*Hm[d]))*tmp*dt;
+                                            ke[k+3][l  ] += gbd.x; ke[k+3][l+1] += gbd.y; ke[k+3][l+2] += gbd.z;
+                                            for (int isol=0; isol<nsol; ++isol) {
                                                 double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
-                                                double hbd = (-Hm[b]*Hm[d]*epsc*z)*(dt*detJ[j]*w[j]);
-                                                ke[k+4+isol][l+4+jsol] += hbd;
+                                                vec3d hbd = (q[isol]*(Hm[b]*Hm[d]*epsc)-(mb[b]*jn[isol]*Hm[d]))*tmp*dt;
+                                                ke[k+4+isol][l  ] += hbd.x; ke[k+4+isol][l+1] += hbd.y; ke[k+4+isol][l+2] += hbd.z;
+                                            }
+                                        }
+                                    }
+                                
+                                    // --- P R E S S U R E - P R E S S U R E  /  C O N C E N T R A T I O N - C O N C E N T R A T I O N  C O N T A C T ---
+                                
+                                    for (int a=0; a<nseln; ++a) {
+                                        k = a*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            double gac = (-Hs[a]*Hs[c]*epsp)*tmp*dt;
+                                            ke[k+3][l+3] += gac;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double hac = (-Hs[a]*Hs[c]*epsc*z)*(dt*detJ[j]*w[j]);
+                                                    ke[k+4+isol][l+4+jsol] += hac;
+                                                }
+                                            }
+                                        }
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            double gad = (Hs[a]*Hm[d]*epsp)*(dt*detJ[j]*w[j]);
+                                            ke[k+3][l+3] += gad;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double had = (Hs[a]*Hm[d]*epsc*z)*(dt*detJ[j]*w[j]);
+                                                    ke[k+4+isol][l+4+jsol] += had;
+                                                }
+                                            }
+                                        }
+                                    }
+                                    for (int b=0; b<nmeln; ++b) {
+                                        k = (nseln+b)*ndpn;
+                                        for (int c=0; c<nseln; ++c) {
+                                            l = c*ndpn;
+                                            double gbc = (Hm[b]*Hs[c]*epsp)*(dt*detJ[j]*w[j]);
+                                            ke[k+3][l+3] += gbc;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double hbc = (Hm[b]*Hs[c]*epsc*z)*(dt*detJ[j]*w[j]);
+                                                    ke[k+4+isol][l+4+jsol] += hbc;
+                                                }
+                                            }
+                                        }
+                                        for (int d=0; d<nmeln; ++d) {
+                                            l = (nseln+d)*ndpn;
+                                            double gbd = (-Hm[b]*Hm[d]*epsp)*(dt*detJ[j]*w[j]);
+                                            ke[k+3][l+3] += gbd;
+                                            for (int isol=0; isol<nsol; ++isol) {
+                                                for (int jsol=0; jsol<nsol; ++jsol) {
+                                                    int z = (isol == jsol? 1.0 : 0.0);
+                                                    double epsc = m_epsc*pt.m_epsc[sl[isol]]*psf;
+                                                    double hbd = (-Hm[b]*Hm[d]*epsc*z)*(dt*detJ[j]*w[j]);
+                                                    ke[k+4+isol][l+4+jsol] += hbd;
+                                                }
                                             }
                                         }
                                     }
                                 }
+                                // assemble the global stiffness
+                                ke.SetNodes(en);
+                                ke.SetIndices(LM);
+                                LS.Assemble(ke);
                             }
-                            // assemble the global stiffness
-                            ke.SetNodes(en);
-                            ke.SetIndices(LM);
-                            LS.Assemble(ke);
                         }
                     }
                 }
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEBioMech/FEContactInterface.h"
 #include "FEBiphasicContactSurface.h"
+#include <FECore/FEElementWorkspace.h>
 #include "FESolute.h"
 #include <FECore/FECoreClass.h>
 #include <map>
@@ -269,6 +270,8 @@ public:
 protected:
 	int	m_dofP;
 	int	m_dofC;
+
+	FEElementWorkspace	m_work;	//!< per-thread element buffers for the assembly loops
 	
 	DECLARE_FECORE_CLASS();
 };
@@ -302,12 +302,14 @@ void FETriphasicDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 void FETriphasicDomain::InternalForces(FEGlobalVector& R)
 {
 	size_t NE = m_Elem.size();
+	PrepareElementBuffers();
 	#pragma omp parallel for shared (NE)
 	for (int i=0; i<NE; ++i)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		vector<double>& fe = buf.fe;
+		vector<int>& lm = buf.lm;
 		
 		// get the element
 		FESolidElement& el = m_Elem[i];
@@ -422,12 +424,14 @@ void FETriphasicDomain::ElementInternalForce(FESolidElement& el, vector<double>&
 void FETriphasicDomain::InternalForcesSS(FEGlobalVector& R)
 {
     size_t NE = m_Elem.size();
+    PrepareElementBuffers();
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
+        FEElementBuffer& buf = ElementBuffer();
         // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        vector<double>& fe = buf.fe;
+        vector<int>& lm = buf.lm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -530,16 +534,19 @@ void FETriphasicDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 	// repeat over all solid elements
 	size_t NE = m_Elem.size();
     
+	PrepareElementBuffers();
 	#pragma omp parallel for shared(NE)
 	for (int iel=0; iel<NE; ++iel)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 
 		// get the lm vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 		
@@ -563,13 +570,16 @@ void FETriphasicDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 	// repeat over all solid elements
 	size_t NE = m_Elem.size();
     
+    PrepareElementBuffers();
     #pragma omp parallel for shared(NE)
 	for (int iel=0; iel<NE; ++iel)
 	{
+		FEElementBuffer& buf = ElementBuffer();
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEElementMatrix& ke = buf.ke;
+		ke.SetNodes(el.m_node);
 
 		// allocate stiffness matrix
 		int neln = el.Nodes();
@@ -581,7 +591,7 @@ void FETriphasicDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		ElementTriphasicStiffnessSS(el, ke, bsymm);
 
 		//  get the lm vector
-		vector<int> lm;
+		vector<int>& lm = buf.lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -35,6 +35,7 @@ SOFTWARE.*/
 #include <FECore/FESurface.h>
 #include <FECore/FEPlotDataStore.h>
 #include <FECore/log.h>
+#include <FECore/sys.h>
 #include <FECore/FEPIDController.h>
 #include <sstream>
 
@@ -654,6 +655,10 @@ void FEBioPlotFile::PlotObject::AddData(const char* szname, Var_Type type, FEPlo
 FEBioPlotFile::FEBioPlotFile(FEModel* fem) : PlotFile(fem)
 {
 	m_ncompress = 0;
+	m_filter = PLT_FILTER_NONE;
+	m_quantizeBits = 0;
+	m_deltaInterval = 0;
+	m_statesWritten = 0;
 	m_meshesWritten = 0;
 	m_exportUnitsFlag = false;
 }
@@ -710,6 +715,20 @@ void FEBioPlotFile::SetCompression(int n)
 	m_ncompress = n;
 }
 
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::SetFilter(const FEPlotDataStore& data)
+{
+	m_filter = PLT_FILTER_NONE;
+	m_deltaInterval = data.GetPlotDeltaInterval();
+	m_quantizeBits = data.GetPlotQuantizeBits();
+	if (m_deltaInterval > 0) m_filter |= PLT_FILTER_DELTA;
+	if (data.GetPlotShuffle()) m_filter |= PLT_FILTER_SHUFFLE;
+	if (m_quantizeBits > 0) m_filter |= PLT_FILTER_QUANTIZE;
+
+	m_ar.SetFilter(m_filter, m_quantizeBits);
+	m_statesWritten = 0;
+}
+
 //-----------------------------------------------------------------------------
 //! set the version string
 void FEBioPlotFile::SetSoftwareString(const std::string& softwareString)
@@ -726,7 +745,7 @@ bool FEBioPlotFile::IsValid() const
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::Close()
 {
-	m_ar.Close();
+	if (m_ar.Close() == false) feLogError("An error occurred while writing the plot file.");
 }
 
 //-----------------------------------------------------------------------------
@@ -751,6 +770,22 @@ bool FEBioPlotFile::Open(const char *szfile)
 	FEPlotDataStore& pltData = fem->GetPlotDataStore();
 	SetCompression(pltData.GetPlotCompression());
 
+	// write the states on a background thread if requested
+	m_ar.SetAsync(pltData.GetPlotAsync());
+
+	// set the pre-filters
+	SetFilter(pltData);
+
+	// create the state index if requested
+	if (pltData.GetPlotIndex())
+	{
+		string indexFile = string(szfile) + ".idx";
+		if (m_ar.CreateIndex(indexFile.c_str()) == false)
+		{
+			feLogWarning("Failed creating plot state index %s", indexFile.c_str());
+		}
+	}
+
 	BuildDictionary();
 
 	try
@@ -800,7 +835,9 @@ bool FEBioPlotFile::WriteRoot(FEModel& fem)
 bool FEBioPlotFile::WriteHeader(FEModel& fem)
 {
 	// setup the header
-	unsigned int nversion = PLT_VERSION;
+	// Filtered state data cannot be read by readers that do not know the filters, 
+	// so these files get a new version number, which older readers reject.
+	unsigned int nversion = (m_filter != PLT_FILTER_NONE ? PLT_VERSION_FILTERED : PLT_VERSION);
 
 	// output header
 	m_ar.WriteChunk(PLT_HDR_VERSION, nversion);
@@ -808,6 +845,17 @@ bool FEBioPlotFile::WriteHeader(FEModel& fem)
 	// compression flag
 	m_ar.WriteChunk(PLT_HDR_COMPRESSION, m_ncompress);
 
+	// pre-filters
+	if (m_filter != PLT_FILTER_NONE)
+	{
+		m_ar.WriteChunk(PLT_HDR_FILTER, m_filter);
+		if (m_filter & PLT_FILTER_QUANTIZE)
+		{
+			unsigned int nbits = (unsigned int)m_quantizeBits;
+			m_ar.WriteChunk(PLT_HDR_QUANTIZE_BITS, nbits);
+		}
+	}
+
 	// software flag
 	if (m_softwareString.empty() == false)
 	{
@@ -1548,6 +1596,15 @@ bool FEBioPlotFile::Write(float ftime, int flag)
 
 	// compress these sections if requested
 	m_ar.SetCompression(m_ncompress);
+	m_ar.SetIndexState(ftime);
+
+	// Delta-encode this state, unless it is a key frame. 
+	// (The first state after opening the file is always a key frame.)
+	unsigned int delta = 0;
+	if (m_filter & PLT_FILTER_DELTA) delta = ((m_statesWritten % m_deltaInterval) != 0 ? 1 : 0);
+	m_ar.SetDeltaState(delta != 0);
+	m_statesWritten++;
+
 	m_ar.BeginChunk(PLT_STATE);
 	{
 		// state header
@@ -1555,6 +1612,7 @@ bool FEBioPlotFile::Write(float ftime, int flag)
 		{
 			m_ar.WriteChunk(PLT_STATE_HDR_TIME, ftime);
 			m_ar.WriteChunk(PLT_STATE_STATUS, flag);
+			if (m_filter & PLT_FILTER_DELTA) m_ar.WriteChunk(PLT_STATE_HDR_DELTA, delta);
 		}
 		m_ar.EndChunk();
 
@@ -1620,7 +1678,8 @@ bool FEBioPlotFile::Write(float ftime, int flag)
 	}
 	m_ar.EndChunk();
 
-	return true;
+	// In async mode, this reports the write errors of the previous states.
+	return (m_ar.IOError() == false);
 }
 
 //-----------------------------------------------------------------------------
@@ -1636,6 +1695,7 @@ void FEBioPlotFile::WriteGlobalData(FEModel& fem)
 		{
 			unsigned int nid = i + 1;
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
+			m_ar.SetIndexKey(PLT_GLOBAL_DATA, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
 				if (it->m_psave) WriteGlobalDataField(fem, it->m_psave);
@@ -1644,6 +1704,7 @@ void FEBioPlotFile::WriteGlobalData(FEModel& fem)
 		}
 		m_ar.EndChunk();
 	}
+	m_ar.SetIndexKey(0, 0);
 }
 
 //-----------------------------------------------------------------------------
@@ -1658,6 +1719,7 @@ void FEBioPlotFile::WriteNodeData(FEModel& fem)
 		{
 			unsigned int nid = i+1;
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
+			m_ar.SetIndexKey(PLT_NODE_DATA, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
 				if (it->m_psave) WriteNodeDataField(fem, it->m_psave);
@@ -1666,6 +1728,7 @@ void FEBioPlotFile::WriteNodeData(FEModel& fem)
 		}
 		m_ar.EndChunk();
 	}
+	m_ar.SetIndexKey(0, 0);
 }
 
 //-----------------------------------------------------------------------------
@@ -1673,21 +1736,42 @@ void FEBioPlotFile::WriteDomainData(FEModel& fem)
 {
 	PlotFile::Dictionary& dic = GetDictionary();
 	auto& elemData = dic.DomainVariableList();
+
+	// evaluate all variables first
+	vector<PlotDataJob> jobs;
 	list<DICTIONARY_ITEM>::iterator it = elemData.begin();
-	for (int i=0; i<(int)elemData.size(); ++i, ++it)
+	for (int i = 0; i < (int)elemData.size(); ++i, ++it)
+	{
+		if (it->m_psave) AddDomainDataJobs(fem, it->m_psave, i, jobs);
+	}
+	EvaluatePlotData(jobs);
+
+	// write the data to the archive
+	size_t n = 0;
+	for (int i=0; i<(int)elemData.size(); ++i)
 	{
 		m_ar.BeginChunk(PLT_STATE_VARIABLE);
 		{
 			unsigned int nid = i+1;
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
+			m_ar.SetIndexKey(PLT_ELEMENT_DATA, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteDomainDataField(fem, it->m_psave);
+				for (; (n < jobs.size()) && (jobs[n].nvar == i); ++n)
+				{
+					PlotDataJob& job = jobs[n];
+					if (job.bok)
+					{
+						assert(job.a.size() == job.nsize);
+						m_ar.WriteData(job.nid, job.a.data());
+					}
+				}
 			}
 			m_ar.EndChunk();
 		}
 		m_ar.EndChunk();
 	}
+	m_ar.SetIndexKey(0, 0);
 }
 
 //-----------------------------------------------------------------------------
@@ -1695,21 +1779,70 @@ void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
 {
 	PlotFile::Dictionary& dic = GetDictionary();
 	auto& surfData = dic.SurfaceVariableList();
+
+	// evaluate all variables first
+	vector<PlotDataJob> jobs;
 	list<DICTIONARY_ITEM>::iterator it = surfData.begin();
-	for (int i=0; i<(int)surfData.size(); ++i, ++it)
+	for (int i = 0; i < (int)surfData.size(); ++i, ++it)
+	{
+		if (it->m_psave) AddSurfaceDataJobs(fem, it->m_psave, i, jobs);
+	}
+	EvaluatePlotData(jobs);
+
+	// write the data to the archive
+	size_t n = 0;
+	for (int i=0; i<(int)surfData.size(); ++i)
 	{
 		m_ar.BeginChunk(PLT_STATE_VARIABLE);
 		{
 			unsigned int nid = i+1;
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
+			m_ar.SetIndexKey(PLT_FACE_DATA, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteSurfaceDataField(fem, it->m_psave);
+				for (; (n < jobs.size()) && (jobs[n].nvar == i); ++n)
+				{
+					if (jobs[n].bok) WriteSurfaceDataField(jobs[n]);
+				}
 			}
 			m_ar.EndChunk();
 		}
 		m_ar.EndChunk();
 	}
+	m_ar.SetIndexKey(0, 0);
+}
+
+//-----------------------------------------------------------------------------
+// Evaluate the plot data. Only plot variables that are marked thread-safe are
+// evaluated in parallel. If there are enough of those jobs, the jobs are distributed 
+// over the threads. Otherwise, the jobs are evaluated one after another and the
+// element loops inside the Save functions run in parallel.
+void FEBioPlotFile::EvaluatePlotData(vector<PlotDataJob>& jobs)
+{
+	vector<int> safeJobs;
+	for (int i = 0; i < (int)jobs.size(); ++i)
+	{
+		PlotDataJob& job = jobs[i];
+		job.a.reserve(job.nsize);
+		job.a.setParallel(job.pd->IsThreadSafe());
+
+		if (job.pd->IsThreadSafe()) safeJobs.push_back(i);
+		else
+		{
+			if (job.dom) job.bok = job.pd->Save(*job.dom, job.a);
+			else job.bok = job.pd->Save(*job.surf, job.a);
+		}
+	}
+
+	int NJ = (int)safeJobs.size();
+	bool bparallelJobs = (NJ >= omp_get_max_threads());
+#pragma omp parallel for schedule(dynamic) if (bparallelJobs)
+	for (int i = 0; i < NJ; ++i)
+	{
+		PlotDataJob& job = jobs[safeJobs[i]];
+		if (job.dom) job.bok = job.pd->Save(*job.dom, job.a);
+		else job.bok = job.pd->Save(*job.surf, job.a);
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -1736,6 +1869,7 @@ void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
 
 	int N = fem.GetMesh().Nodes();
 	FEDataStream a; a.reserve(ndata*N);
+	a.setParallel(pd->IsThreadSafe());
 	if (pd->Save(fem.GetMesh(), a))
 	{
 		// pad mismatches
@@ -1746,7 +1880,7 @@ void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
+void FEBioPlotFile::AddSurfaceDataJobs(FEModel& fem, FEPlotData* pd, int nvar, vector<PlotDataJob>& jobs)
 {
 	// get the domain name (if any)
 	string domName;
@@ -1786,46 +1920,62 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 				assert(false);
 			}
 
-			// save data
-			FEDataStream a; a.reserve(nsize);
-			if (pd->Save(S, a))
-			{
-				// in FEBio 3.0, the data streams are assumed to have no padding, but for now we still need to pad 
-				// the data stream before we write it to the file
-				if (a.size() == nsize)
-				{
-					// assumed padding is already there, or not needed
-					m_ar.WriteData(i + 1, a.data());
-				}
-				else
-				{
-					// this is only needed for FMT_MULT storage
-					assert(pd->StorageFormat() == FMT_MULT);
-
-					// add padding
-					const int M = surf.maxNodes;
-					int m = 0;
-					FEDataStream b; b.assign(nsize, 0.f);
-					for (int n = 0; n < S.Elements(); ++n)
-					{
-						FESurfaceElement& el = S.Element(n);
-						int ne = el.Nodes();
-						for (int j = 0; j < ne; ++j)
-						{
-							for (int k = 0; k < datasize; ++k) b[n * M * datasize + j * datasize + k] = a[m++];
-						}
-					}
+			PlotDataJob job;
+			job.pd = pd;
+			job.dom = nullptr;
+			job.surf = &S;
+			job.nvar = nvar;
+			job.nid = i + 1;
+			job.nsize = nsize;
+			job.maxNodes = surf.maxNodes;
+			job.bok = false;
+			jobs.push_back(job);
+		}
+	}
+}
 
-					// write the padded data
-					m_ar.WriteData(i + 1, b.data());
-				}
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::WriteSurfaceDataField(PlotDataJob& job)
+{
+	FEPlotData* pd = job.pd;
+	FESurface& S = *job.surf;
+	int nsize = job.nsize;
+	FEDataStream& a = job.a;
+
+	// in FEBio 3.0, the data streams are assumed to have no padding, but for now we still need to pad 
+	// the data stream before we write it to the file
+	if (a.size() == nsize)
+	{
+		// assumed padding is already there, or not needed
+		m_ar.WriteData(job.nid, a.data());
+	}
+	else
+	{
+		// this is only needed for FMT_MULT storage
+		assert(pd->StorageFormat() == FMT_MULT);
+
+		// add padding
+		int datasize = pd->VarSize(pd->DataType());
+		const int M = job.maxNodes;
+		int m = 0;
+		FEDataStream b; b.assign(nsize, 0.f);
+		for (int n = 0; n < S.Elements(); ++n)
+		{
+			FESurfaceElement& el = S.Element(n);
+			int ne = el.Nodes();
+			for (int j = 0; j < ne; ++j)
+			{
+				for (int k = 0; k < datasize; ++k) b[n * M * datasize + j * datasize + k] = a[m++];
 			}
 		}
+
+		// write the padded data
+		m_ar.WriteData(job.nid, b.data());
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
+void FEBioPlotFile::AddDomainDataJobs(FEModel &fem, FEPlotData* pd, int nvar, vector<PlotDataJob>& jobs)
 {
 	FEMesh& m = fem.GetMesh();
 	int ND = m.Domains();
@@ -1881,14 +2031,16 @@ void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
 			}
 			assert(nsize > 0);
 
-			// fill data vector and save
-			FEDataStream a;
-			a.reserve(nsize);
-			if (pd->Save(D, a))
-			{
-				assert(a.size() == nsize);
-				m_ar.WriteData(item[i] + 1, a.data());
-			}
+			PlotDataJob job;
+			job.pd = pd;
+			job.dom = &D;
+			job.surf = nullptr;
+			job.nvar = nvar;
+			job.nid = item[i] + 1;
+			job.nsize = nsize;
+			job.maxNodes = 0;
+			job.bok = false;
+			jobs.push_back(job);
 		}
 	}
 }
@@ -1947,7 +2099,24 @@ bool FEBioPlotFile::Append(const char *szfile)
 	BuildSurfaceTable();
 
 	// ... and open for appending
-	if (bok) return m_ar.Append(szfile);
+	if (bok && m_ar.Append(szfile))
+	{
+		m_ar.SetAsync(pltData.GetPlotAsync());
+
+		// set the pre-filters. We assume these are the same as when the file was created.
+		SetFilter(pltData);
+
+		// continue the state index, if there is one
+		if (pltData.GetPlotIndex())
+		{
+			string indexFile = string(szfile) + ".idx";
+			if (m_ar.CreateIndex(indexFile.c_str(), true) == false)
+			{
+				feLogWarning("No plot state index found. States will not be indexed.");
+			}
+		}
+		return true;
+	}
 
 	return false;
 }
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "PlotFile.h"
 #include "PltArchive.h"
+#include "FECore/FEPlotDataStore.h"
 #include "FECore/FESolidDomain.h"
 #include "FECore/FEShellDomain.h"
 #include "FECore/FEBeamDomain.h"
@@ -46,7 +47,9 @@ public:
 	// file version
 	// 32: added PLT_ELEMENTSET_SECTION
 	// 33: node IDs are now stored in Node Section
+	// 34: state data can be pre-filtered (PLT_HDR_FILTER). Files without filters are still written as version 33.
 	enum { PLT_VERSION = 0x0033 };
+	enum { PLT_VERSION_FILTERED = 0x0034 };
 
 	// file tags
 	enum { 
@@ -59,6 +62,8 @@ public:
 			PLT_HDR_AUTHOR				= 0x01010005,	// new in 2.0
 			PLT_HDR_SOFTWARE			= 0x01010006,	// new in 2.0
 			PLT_HDR_UNITS				= 0x01010007,	// new in 4.0
+			PLT_HDR_FILTER				= 0x01010008,	// pre-filter flags (see PltFilter.h), only written when filters are used
+			PLT_HDR_QUANTIZE_BITS		= 0x01010009,	// mantissa bits used by the quantization filter
 		PLT_DICTIONARY					= 0x01020000,
 			PLT_DIC_ITEM				= 0x01020001,
 			PLT_DIC_ITEM_TYPE			= 0x01020002,
@@ -151,6 +156,7 @@ public:
 				PLT_STATE_HDR_ID		= 0x02010001,
 				PLT_STATE_HDR_TIME		= 0x02010002,
 				PLT_STATE_STATUS        = 0x02010003,	// new in 3.1
+				PLT_STATE_HDR_DELTA		= 0x02010004,	// state is delta-encoded (only written with the delta filter)
 			PLT_STATE_DATA				= 0x02020000,
 				PLT_STATE_VARIABLE		= 0x02020001,
 				PLT_STATE_VAR_ID		= 0x02020002,
@@ -254,6 +260,9 @@ public:
 	//! Set the compression level
 	void SetCompression(int n);
 
+	//! Set the pre-filters for compression
+	void SetFilter(const FEPlotDataStore& data);
+
 	// Write a mesh section
 	bool WriteMeshSection(FEModel& fem);
 
@@ -269,6 +278,23 @@ public:
 	LineObject* GetLineObject(int i);
 	LineObject* AddLineObject(const std::string& name);
 
+protected:
+	// Evaluation of a plot variable on a domain or surface.
+	// The domain and surface data is evaluated for all variables before it is written
+	// to the archive, so that the evaluation can be done in parallel.
+	struct PlotDataJob
+	{
+		FEPlotData*		pd;			// plot variable
+		FEDomain*		dom;		// domain to evaluate (domain data)
+		FESurface*		surf;		// surface to evaluate (surface data)
+		int				nvar;		// index of the variable in the dictionary
+		unsigned int	nid;		// data chunk ID
+		int				nsize;		// expected size of the data
+		int				maxNodes;	// max nodes per facet (surface data)
+		bool			bok;		// Save was successful
+		FEDataStream	a;			// the evaluated data
+	};
+
 protected:
 	bool WriteRoot      (FEModel& fem);
 	bool WriteHeader    (FEModel& fem);
@@ -302,8 +328,11 @@ protected:
 
 	void WriteGlobalDataField(FEModel& fem, FEPlotData* pd);
 	void WriteNodeDataField(FEModel& fem, FEPlotData* pd);
-	void WriteDomainDataField(FEModel& fem, FEPlotData* pd);
-	void WriteSurfaceDataField(FEModel& fem, FEPlotData* pd);
+	void WriteSurfaceDataField(PlotDataJob& job);
+
+	void AddDomainDataJobs (FEModel& fem, FEPlotData* pd, int nvar, std::vector<PlotDataJob>& jobs);
+	void AddSurfaceDataJobs(FEModel& fem, FEPlotData* pd, int nvar, std::vector<PlotDataJob>& jobs);
+	void EvaluatePlotData(std::vector<PlotDataJob>& jobs);
 
 	void WriteMeshState(FEMesh& mesh);
 
@@ -316,6 +345,10 @@ protected:
 protected:
 	PltArchive	m_ar;	// the data archive
 	int			m_ncompress;	// compression level
+	unsigned int	m_filter;		// pre-filter flags
+	int			m_quantizeBits;	// mantissa bits for quantization filter
+	int			m_deltaInterval;	// key frame interval for delta filter
+	int			m_statesWritten;	// nr of states written since the file was opened
 	int			m_meshesWritten;	// nr of meshes written
 	string		m_softwareString;	// the software string
 	bool		m_exportUnitsFlag;	// flag that indicates whether to write units
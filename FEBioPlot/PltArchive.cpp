@@ -47,6 +47,8 @@ FileStream::FileStream(FILE* fp, bool owner)
 	m_ncompress = 0;
 	m_fp = fp;
 	m_fileOwner = owner;
+	m_nbytes = 0;
+	m_error = false;
 }
 
 FileStream::~FileStream()
@@ -68,21 +70,38 @@ bool FileStream::Open(const char* szfile)
 bool FileStream::Append(const char* szfile)
 {
 	m_fp = fopen(szfile, "a+b");
-	return (m_fp != 0);
+	if (m_fp == 0) return false;
+
+	// get the current file size
+	fseek(m_fp, 0, SEEK_END);
+#ifdef WIN32
+	m_nbytes = (unsigned long long) _ftelli64(m_fp);
+#else
+	m_nbytes = (unsigned long long) ftello(m_fp);
+#endif
+	return true;
 }
 
 bool FileStream::Create(const char* szfile)
 {
 	m_fp = fopen(szfile, "wb");
+	m_nbytes = 0;
 	return (m_fp != 0);
 }
 
+void FileStream::write_file(void* pd, size_t nsize)
+{
+	if (fwrite(pd, 1, nsize, m_fp) != nsize) m_error = true;
+	m_nbytes += nsize;
+}
+
 void FileStream::Close()
 {
 	if (m_fp)
 	{
 		Flush();
-		if (m_fileOwner) fclose(m_fp);
+		if (m_fileOwner) { if (fclose(m_fp) != 0) m_error = true; }
+		else if (fflush(m_fp) != 0) m_error = true;
 	}
 	m_fp = 0;
 }
@@ -117,7 +136,7 @@ void FileStream::EndStreaming()
 			int ret = deflate(&strm, Z_FINISH);    /* no bad return value */
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
 			int have = m_bufsize - strm.avail_out;
-			fwrite(m_pout, 1, have, m_fp);
+			write_file(m_pout, have);
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
 
@@ -168,16 +187,16 @@ void FileStream::Flush()
 			int ret = deflate(&strm, Z_NO_FLUSH);    /* no bad return value */
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
 			int have = m_bufsize - strm.avail_out;
-			fwrite(m_pout, 1, have, m_fp);
+			write_file(m_pout, have);
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
 	}
 	else
 	{
-		if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
+		if (m_fp) write_file(m_buf, m_current);
 	}
 #else
-	if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
+	if (m_fp) write_file(m_buf, m_current);
 #endif
 
 	// flush the file
@@ -213,6 +232,23 @@ PltArchive::PltArchive()
 	m_pRoot = 0;
 	m_pChunk = 0;
 	m_bSaving = true;
+	m_ncompress = 0;
+
+	m_async = false;
+	m_maxQueued = 2;
+	m_busy = false;
+	m_stop = false;
+	m_ioError = false;
+
+	m_index = nullptr;
+	m_indexState = false;
+	m_indexTime = 0.f;
+	m_keyRegion = 0;
+	m_keyVar = 0;
+
+	m_filter = PLT_FILTER_NONE;
+	m_quantizeBits = 0;
+	m_deltaState = false;
 }
 
 PltArchive::~PltArchive()
@@ -220,11 +256,17 @@ PltArchive::~PltArchive()
 	Close();
 }
 
-void PltArchive::Close()
+bool PltArchive::Close()
 {
 	if (m_bSaving)
 	{
 		if (m_pRoot) Flush();
+
+		// make sure all pending data is written before we close the file
+		StopWriter();
+
+		if (m_index) fclose(m_index);
+		m_index = nullptr;
 	}
 	else 
 	{
@@ -236,35 +278,236 @@ void PltArchive::Close()
 	if (m_fp)
 	{
 		m_fp->Close();
+		if (m_fp->HasError()) m_ioError = true;
 		delete m_fp;
 		m_fp = 0;
 	}
+
+	bool ok = (m_ioError == false);
+	m_ioError = false;
+	return ok;
 }
 
 void PltArchive::SetCompression(int n)
 {
-	if (m_fp) m_fp->SetCompression(n);
+	// In async mode the file stream may be in use by the writer thread,
+	// so the compression level is passed along with the chunk tree instead.
+	m_ncompress = n;
+	if (m_fp && !m_async) m_fp->SetCompression(n);
 }
 
 void PltArchive::Flush()
 {
+	// collect the index data of this tree
+	PltIndexState* index = nullptr;
+	if (m_fp && m_pRoot && m_index && m_indexState)
+	{
+		index = new PltIndexState;
+		index->time = m_indexTime;
+		index->delta = (m_deltaState && (m_filter & PLT_FILTER_DELTA));
+		index->rawSize = m_pRoot->SetOffset(0);
+		for (INDEX_ITEM& it : m_indexItems)
+		{
+			PltIndexEntry e;
+			e.region = it.region;
+			e.var = it.var;
+			e.item = it.item;
+			e.offset = it.pc->DataOffset();
+			e.size = it.pc->Size();
+			index->entries.push_back(e);
+		}
+	}
+	m_indexItems.clear();
+	m_indexState = false;
+	m_keyRegion = 0;
+
 	if (m_fp && m_pRoot)
 	{
-		m_fp->BeginStreaming();
-		m_pRoot->Write(m_fp);
-		m_fp->EndStreaming();
+		if (m_async)
+		{
+			// hand the tree to the writer thread
+			if (m_writer.joinable() == false)
+			{
+				m_stop = false;
+				m_writer = std::thread(&PltArchive::WriterThread, this);
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cv.wait(lock, [this]() { return m_queue.size() < m_maxQueued; });
+			m_queue.push_back({ m_pRoot, m_ncompress, index });
+			lock.unlock();
+			m_cv.notify_all();
+
+			m_pRoot = 0;
+			m_pChunk = 0;
+			return;
+		}
+
+		WriteTree(m_pRoot, m_ncompress, index);
 	}
 	delete m_pRoot;
 	m_pRoot = 0;
 	m_pChunk = 0;
 }
 
+void PltArchive::WriteTree(OBranch* root, int ncompress, PltIndexState* index)
+{
+	unsigned long long pos = m_fp->Position();
+
+	m_fp->SetCompression(ncompress);
+	m_fp->BeginStreaming();
+	root->Write(m_fp);
+	m_fp->EndStreaming();
+
+	if (index)
+	{
+		index->offset = pos;
+		index->storedSize = m_fp->BytesWritten() - pos;
+#ifdef HAVE_ZLIB
+		index->compressed = (ncompress != 0);
+#else
+		index->compressed = false;
+#endif
+		PltWriteIndexState(m_index, *index);
+		if (ferror(m_index)) m_ioError = true;
+		delete index;
+	}
+
+	// This can run on the writer thread, so we only record the error here.
+	if (m_fp->HasError()) m_ioError = true;
+}
+
+bool PltArchive::CreateIndex(const char* szfile, bool append)
+{
+	assert(m_index == nullptr);
+	if (append)
+	{
+		// only append to an existing index. Otherwise, the index would miss the earlier states.
+		FILE* fp = fopen(szfile, "rb");
+		if (fp == nullptr) return false;
+		fclose(fp);
+		m_index = fopen(szfile, "ab");
+		return (m_index != nullptr);
+	}
+
+	m_index = fopen(szfile, "wb");
+	if (m_index == nullptr) return false;
+	return PltWriteIndexHeader(m_index, m_filter, m_quantizeBits);
+}
+
+void PltArchive::SetIndexState(float time)
+{
+	m_indexState = true;
+	m_indexTime = time;
+}
+
+void PltArchive::SetIndexKey(unsigned int region, unsigned int var)
+{
+	m_keyRegion = region;
+	m_keyVar = var;
+}
+
+void PltArchive::SetFilter(unsigned int flags, int quantizeBits)
+{
+	m_filter = flags;
+	m_quantizeBits = quantizeBits;
+	m_prevData.clear();
+}
+
+void PltArchive::SetDeltaState(bool b)
+{
+	m_deltaState = b;
+}
+
+void PltArchive::WriteData(int nid, std::vector<float>& data)
+{
+	if ((m_filter == PLT_FILTER_NONE) || (m_keyRegion == 0) || data.empty())
+	{
+		WriteChunk(nid, data);
+	}
+	else
+	{
+		std::vector<float>& buf = m_filterBuf;
+		buf = data;
+		size_t n = buf.size();
+
+		if (m_filter & PLT_FILTER_QUANTIZE) PltQuantize(buf.data(), n, m_quantizeBits);
+
+		if (m_filter & PLT_FILTER_DELTA)
+		{
+			std::vector<float>& prev = m_prevData[BLOCK_KEY(m_keyRegion, m_keyVar, (unsigned int)nid)];
+			bool delta = (m_deltaState && (prev.size() == n));
+			std::vector<float> cur(buf);
+			if (delta) PltDeltaXOR(buf.data(), prev.data(), n);
+			prev.swap(cur);
+		}
+
+		if (m_filter & PLT_FILTER_SHUFFLE) PltShuffle(buf.data(), n, m_shuffleBuf);
+
+		WriteChunk(nid, buf);
+	}
+
+	if (m_index && m_indexState && m_keyRegion) m_indexItems.push_back({ m_pChunk->LastChild(), m_keyRegion, m_keyVar, (unsigned int)nid });
+}
+
+void PltArchive::SetAsync(bool b, int maxQueued)
+{
+	if (b == false) StopWriter();
+	m_async = b;
+	m_maxQueued = (maxQueued > 0 ? maxQueued : 1);
+}
+
+void PltArchive::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_cv.wait(lock, [this]() { return (m_queue.empty() == false) || m_stop; });
+		if (m_queue.empty()) break;
+
+		QUEUED_TREE item = m_queue.front();
+		m_queue.pop_front();
+		m_busy = true;
+		lock.unlock();
+
+		// let the solver thread know there is room in the queue
+		m_cv.notify_all();
+
+		WriteTree(item.root, item.ncompress, item.index);
+		delete item.root;
+
+		lock.lock();
+		m_busy = false;
+		m_cv.notify_all();
+	}
+}
+
+void PltArchive::WaitForWriter()
+{
+	if (m_writer.joinable() == false) return;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cv.wait(lock, [this]() { return m_queue.empty() && !m_busy; });
+}
+
+void PltArchive::StopWriter()
+{
+	if (m_writer.joinable() == false) return;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_cv.notify_all();
+	m_writer.join();
+	m_stop = false;
+}
+
 bool PltArchive::Create(const char* szfile)
 {
 	// attempt to create the file
 	assert(m_fp == 0);
 	m_fp = new FileStream();
 	if (m_fp->Create(szfile) == false) return false;
+	m_ncompress = 0;
 
 	// write the root tag 
 	unsigned int ntag = 0x00464542;
@@ -333,6 +576,7 @@ bool PltArchive::Append(const char* szfile)
 	assert(m_fp == 0);
 	m_fp = new FileStream();
 	if (m_fp->Append(szfile) == false) return false;
+	m_ncompress = 0;
 	m_bSaving = true;
 	return true;
 }
@@ -34,6 +34,15 @@ SOFTWARE.*/
 #include <list>
 #include <vector>
 #include <stack>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "PltStateIndex.h"
+#include "PltFilter.h"
+#include <map>
+#include <tuple>
 
 //-----------------------------------------------------------------------------
 enum IOResult { IO_ERROR, IO_OK, IO_END };
@@ -69,14 +78,28 @@ public:
 
 	bool IsValid() { return (m_fp != nullptr); }
 
+	// file position of the next byte that is written (uncompressed data only)
+	unsigned long long Position() const { return m_nbytes + m_current; }
+
+	// nr of bytes written to the file
+	unsigned long long BytesWritten() const { return m_nbytes; }
+
+	// returns true if writing to the file has failed
+	bool HasError() const { return m_error; }
+
+private:
+	void write_file(void* pd, size_t nsize);
+
 private:
 	FILE*	m_fp;
 	bool	m_fileOwner;
+	unsigned long long	m_nbytes;	//!< nr of bytes written to file
 	size_t	m_bufsize;		//!< buffer size
 	size_t	m_current;		//!< current index
 	unsigned char*	m_buf;	//!< buffer
 	unsigned char*	m_pout;	//!< temp buffer when writing
 	int		m_ncompress;	//!< compression level
+	bool	m_error;		//!< a write to the file has failed
 };
 
 class OBranch;
@@ -84,7 +107,7 @@ class OBranch;
 class OChunk
 {
 public:
-	OChunk(unsigned int nid) { m_nID = nid; m_pParent = 0; }
+	OChunk(unsigned int nid) { m_nID = nid; m_pParent = 0; m_offset = 0; }
 	virtual ~OChunk(){}
 
 	unsigned int GetID() { return m_nID; }
@@ -92,12 +115,20 @@ public:
 	virtual void Write(FileStream* fp) = 0;
 	virtual int Size() = 0;
 
+	// set the offset of this chunk (relative to the start of the tree) and 
+	// return the offset of the next chunk
+	virtual size_t SetOffset(size_t off) { m_offset = off; return off + 2*sizeof(unsigned int) + Size(); }
+
+	// offset of this chunk's data
+	size_t DataOffset() const { return m_offset + 2*sizeof(unsigned int); }
+
 	void SetParent(OBranch* pparent) { m_pParent = pparent; }
 	OBranch* GetParent() { return m_pParent; }
 
 protected:
 	int			m_nID;
 	OBranch*	m_pParent;
+	size_t		m_offset;
 };
 
 class OBranch : public OChunk
@@ -132,6 +163,17 @@ public:
 
 	void AddChild(OChunk* pc) { m_child.push_back(pc); pc->SetParent(this); }
 
+	OChunk* LastChild() { return m_child.back(); }
+
+	size_t SetOffset(size_t off) override
+	{
+		m_offset = off;
+		off += 2*sizeof(unsigned int);
+		std::list<OChunk*>::iterator pc;
+		for (pc = m_child.begin(); pc != m_child.end(); ++pc) off = (*pc)->SetOffset(off);
+		return off;
+	}
+
 protected:
 	std::list<OChunk*>	m_child;
 };
@@ -259,8 +301,8 @@ public:
 	//! destructor
 	~PltArchive();
 
-	// Close archive
-	void Close();
+	// Close archive. Returns false if an error occurred while writing to the file.
+	bool Close();
 
 	// flush data to file
 	void Flush();
@@ -302,10 +344,8 @@ public:
 		m_pChunk->AddChild(new OLeaf<std::vector<T> >(nid, a));
 	}
 
-	void WriteData(int nid, std::vector<float>& data)
-	{
-		WriteChunk(nid, data);
-	}
+	// write a data block. State data (i.e. when an index key is set) is passed through the pre-filters.
+	void WriteData(int nid, std::vector<float>& data);
 
 public:
 	// --- Reading ---
@@ -352,14 +392,102 @@ public:
 
 	bool IsValid() const { return (m_fp != 0); }
 
+public:
+	// --- Asynchronous writing ---
+
+	// When set, completed chunk trees are handed to a background thread that does the
+	// compression and the file output. The chunk tree already holds a copy of
+	// all the data, so the caller can continue as soon as the tree is queued.
+	// At most maxQueued trees can be pending. Flush blocks when the queue is full.
+	void SetAsync(bool b, int maxQueued = 2);
+
+	// wait until all queued data was written to file
+	void WaitForWriter();
+
+	// Returns true if an error occurred while writing to the file. In async mode, 
+	// write errors are only detected after the data was handed to the writer thread,
+	// so they are reported by the next call.
+	bool IOError() const { return m_ioError; }
+
+public:
+	// --- State index ---
+
+	// Create the state index file. When append is true, records are added to an existing index.
+	bool CreateIndex(const char* szfile, bool append = false);
+
+	// Mark the current chunk tree as a state. Only states are added to the index.
+	void SetIndexState(float time);
+
+	// Set the key for the data blocks that are written next (see PltStateIndex.h).
+	// Set region to zero to stop adding data blocks to the index.
+	void SetIndexKey(unsigned int region, unsigned int var);
+
+public:
+	// --- Pre-filters ---
+
+	// set the pre-filters (see PltFilter.h) that are applied to the state data
+	void SetFilter(unsigned int flags, int quantizeBits = 0);
+
+	// Set whether the current state is delta-encoded. A data block is only delta-encoded if the 
+	// same block was written before (in an earlier state) with the same size.
+	void SetDeltaState(bool b);
+
+private:
+	struct INDEX_ITEM
+	{
+		OChunk*			pc;
+		unsigned int	region;
+		unsigned int	var;
+		unsigned int	item;
+	};
+
+	void WriteTree(OBranch* root, int ncompress, PltIndexState* index);
+	void WriterThread();
+	void StopWriter();
+
 protected:
 	FileStream*	m_fp;		// pointer to file stream
 	bool		m_bSaving;	// read or write mode?
+	int			m_ncompress;	// compression level for the next chunk tree
 
 	// write data
 	OBranch*	m_pRoot;	// chunk tree root
 	OBranch*	m_pChunk;	// current chunk
 
+	// async writer
+	struct QUEUED_TREE
+	{
+		OBranch*	root;
+		int			ncompress;
+		PltIndexState*	index;
+	};
+	bool			m_async;		// write on a background thread
+	size_t			m_maxQueued;	// max nr of pending trees
+	bool			m_busy;			// the writer is processing a tree
+	bool			m_stop;			// request the writer to stop
+	std::thread		m_writer;
+	std::mutex		m_mutex;
+	std::condition_variable	m_cv;
+	std::deque<QUEUED_TREE>	m_queue;
+	std::atomic<bool>		m_ioError;		// set when writing to the file has failed
+
+	// state index
+	FILE*					m_index;		// index file
+	bool					m_indexState;	// the current tree is a state
+	float					m_indexTime;	// time of current state
+	unsigned int			m_keyRegion;	// current index key
+	unsigned int			m_keyVar;
+	std::vector<INDEX_ITEM>	m_indexItems;	// indexed data blocks of current tree
+
+	// pre-filters
+	typedef std::tuple<unsigned int, unsigned int, unsigned int>	BLOCK_KEY;
+	unsigned int	m_filter;		// filter flags
+	int				m_quantizeBits;	// mantissa bits for quantization
+	bool			m_deltaState;	// delta-encode the current state
+	std::map<BLOCK_KEY, std::vector<float> >	m_prevData;	// (quantized) data of previous state
+	std::vector<float>			m_filterBuf;
+	std::vector<unsigned char>	m_shuffleBuf;
+
 	// read data
 	bool			m_bend;		// chunk end flag
 	std::stack<CHUNK*>	m_Chunk;
@@ -0,0 +1,90 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "PltFilter.h"
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+void PltQuantize(float* a, size_t n, int nbits)
+{
+	const int drop = 23 - nbits;
+	if ((nbits < 0) || (drop <= 0)) return;
+
+	const unsigned int mask = ~((1u << drop) - 1u);
+	const unsigned int half = 1u << (drop - 1);
+	for (size_t i = 0; i < n; ++i)
+	{
+		unsigned int u;
+		memcpy(&u, a + i, sizeof(float));
+
+		// leave inf and nan alone
+		if ((u & 0x7F800000u) == 0x7F800000u) continue;
+
+		// round to nearest, but truncate if rounding would overflow to inf
+		unsigned int r = (u + half) & mask;
+		if ((r & 0x7F800000u) == 0x7F800000u) r = u & mask;
+
+		memcpy(a + i, &r, sizeof(float));
+	}
+}
+
+//-----------------------------------------------------------------------------
+void PltDeltaXOR(float* a, const float* prev, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		unsigned int u, v;
+		memcpy(&u, a + i, sizeof(float));
+		memcpy(&v, prev + i, sizeof(float));
+		u ^= v;
+		memcpy(a + i, &u, sizeof(float));
+	}
+}
+
+//-----------------------------------------------------------------------------
+void PltShuffle(float* a, size_t n, std::vector<unsigned char>& tmp)
+{
+	const size_t nb = sizeof(float);
+	tmp.resize(n*nb);
+	const unsigned char* src = (const unsigned char*)a;
+	for (size_t i = 0; i < n; ++i)
+		for (size_t k = 0; k < nb; ++k) tmp[k*n + i] = src[i*nb + k];
+	memcpy(a, tmp.data(), n*nb);
+}
+
+//-----------------------------------------------------------------------------
+void PltUnshuffle(float* a, size_t n, std::vector<unsigned char>& tmp)
+{
+	const size_t nb = sizeof(float);
+	tmp.resize(n*nb);
+	const unsigned char* src = (const unsigned char*)a;
+	for (size_t i = 0; i < n; ++i)
+		for (size_t k = 0; k < nb; ++k) tmp[i*nb + k] = src[k*n + i];
+	memcpy(a, tmp.data(), n*nb);
+}
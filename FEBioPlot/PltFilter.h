@@ -0,0 +1,57 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Pre-filters that can be applied to the state data before it is compressed.
+// The filters are applied in the order quantize, delta, shuffle, and are
+// recorded in the plot file header (PLT_HDR_FILTER) so that readers can invert them.
+enum PltFilterFlags
+{
+	PLT_FILTER_NONE		= 0,
+	PLT_FILTER_DELTA	= 1,	// XOR the bits of each value with the value of the previous state
+	PLT_FILTER_SHUFFLE	= 2,	// store the bytes of the values in separate byte planes
+	PLT_FILTER_QUANTIZE	= 4		// round values to a given number of mantissa bits (lossy)
+};
+
+//-----------------------------------------------------------------------------
+// Round the values to nbits mantissa bits. The relative error is bounded by 2^-(nbits+1).
+void PltQuantize(float* a, size_t n, int nbits);
+
+// XOR the bit patterns of a and prev and store the result in a.
+// Since this is its own inverse, it is used for both encoding and decoding.
+void PltDeltaXOR(float* a, const float* prev, size_t n);
+
+// Reorder the bytes so that byte k of all values is stored in plane k.
+void PltShuffle(float* a, size_t n, std::vector<unsigned char>& tmp);
+
+// inverse of PltShuffle
+void PltUnshuffle(float* a, size_t n, std::vector<unsigned char>& tmp);
@@ -0,0 +1,293 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "PltStateIndex.h"
+#include "PltFilter.h"
+#include <string>
+#include <string.h>
+
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
+
+// index file identifier ("PIDX") and version
+#define PLT_INDEX_MAGIC		0x58444950
+#define PLT_INDEX_VERSION	1
+
+//-----------------------------------------------------------------------------
+static int plt_seek(FILE* fp, unsigned long long off)
+{
+#ifdef WIN32
+	return _fseeki64(fp, (__int64)off, SEEK_SET);
+#else
+	return fseeko(fp, (off_t)off, SEEK_SET);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+bool PltWriteIndexHeader(FILE* fp, unsigned int filter, int quantizeBits)
+{
+	unsigned int hdr[4] = { PLT_INDEX_MAGIC, PLT_INDEX_VERSION, filter, (unsigned int)quantizeBits };
+	return (fwrite(hdr, sizeof(unsigned int), 4, fp) == 4);
+}
+
+//-----------------------------------------------------------------------------
+bool PltWriteIndexState(FILE* fp, const PltIndexState& state)
+{
+	unsigned long long a[3] = { state.offset, state.storedSize, state.rawSize };
+	unsigned int flags = (state.compressed ? PLT_INDEX_COMPRESSED : 0) | (state.delta ? PLT_INDEX_DELTA : 0);
+	unsigned int n = (unsigned int)state.entries.size();
+	if (fwrite(a, sizeof(unsigned long long), 3, fp) != 3) return false;
+	if (fwrite(&flags, sizeof(unsigned int), 1, fp) != 1) return false;
+	if (fwrite(&state.time, sizeof(float), 1, fp) != 1) return false;
+	if (fwrite(&n, sizeof(unsigned int), 1, fp) != 1) return false;
+	for (const PltIndexEntry& e : state.entries)
+	{
+		unsigned int d[4] = { e.region, e.var, e.item, e.size };
+		if (fwrite(d, sizeof(unsigned int), 4, fp) != 4) return false;
+		if (fwrite(&e.offset, sizeof(unsigned long long), 1, fp) != 1) return false;
+	}
+	fflush(fp);
+	return true;
+}
+
+//=============================================================================
+PltIndexReader::PltIndexReader()
+{
+	m_fp = nullptr;
+	m_rawState = -1;
+	m_filter = PLT_FILTER_NONE;
+}
+
+PltIndexReader::~PltIndexReader()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+bool PltIndexReader::Open(const char* szplotfile, const char* szindexfile)
+{
+	Close();
+
+	std::string indexFile = (szindexfile ? szindexfile : std::string(szplotfile) + ".idx");
+	FILE* fi = fopen(indexFile.c_str(), "rb");
+	if (fi == nullptr) return false;
+	bool bok = ReadIndex(fi);
+	fclose(fi);
+	if (bok == false) { m_state.clear(); return false; }
+
+	m_fp = fopen(szplotfile, "rb");
+	if (m_fp == nullptr) { m_state.clear(); return false; }
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool PltIndexReader::ReadIndex(FILE* fp)
+{
+	unsigned int hdr[4];
+	if (fread(hdr, sizeof(unsigned int), 4, fp) != 4) return false;
+	if ((hdr[0] != PLT_INDEX_MAGIC) || (hdr[1] != PLT_INDEX_VERSION)) return false;
+	m_filter = hdr[2];
+
+	// read state records until the end of the file. 
+	// An incomplete last record (e.g. when the run was aborted) is ignored.
+	while (true)
+	{
+		PltIndexState s;
+		unsigned long long a[3];
+		unsigned int flags, n;
+		if (fread(a, sizeof(unsigned long long), 3, fp) != 3) break;
+		if (fread(&flags, sizeof(unsigned int), 1, fp) != 1) break;
+		if (fread(&s.time, sizeof(float), 1, fp) != 1) break;
+		if (fread(&n, sizeof(unsigned int), 1, fp) != 1) break;
+		s.offset = a[0];
+		s.storedSize = a[1];
+		s.rawSize = a[2];
+		s.compressed = ((flags & PLT_INDEX_COMPRESSED) != 0);
+		s.delta = ((flags & PLT_INDEX_DELTA) != 0);
+
+		s.entries.resize(n);
+		bool bok = true;
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			PltIndexEntry& e = s.entries[i];
+			unsigned int d[4];
+			if ((fread(d, sizeof(unsigned int), 4, fp) != 4) ||
+				(fread(&e.offset, sizeof(unsigned long long), 1, fp) != 1)) { bok = false; break; }
+			e.region = d[0];
+			e.var = d[1];
+			e.item = d[2];
+			e.size = d[3];
+		}
+		if (bok == false) break;
+
+		m_state.push_back(s);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void PltIndexReader::Close()
+{
+	if (m_fp) fclose(m_fp);
+	m_fp = nullptr;
+	m_state.clear();
+	m_raw.clear();
+	m_rawState = -1;
+	m_filter = PLT_FILTER_NONE;
+}
+
+//-----------------------------------------------------------------------------
+int PltIndexReader::States() const
+{
+	return (int)m_state.size();
+}
+
+//-----------------------------------------------------------------------------
+const PltIndexState& PltIndexReader::State(int n) const
+{
+	return m_state[n];
+}
+
+//-----------------------------------------------------------------------------
+float PltIndexReader::StateTime(int n) const
+{
+	return m_state[n].time;
+}
+
+//-----------------------------------------------------------------------------
+const PltIndexEntry* PltIndexReader::FindEntry(int state, unsigned int region, unsigned int var, unsigned int item) const
+{
+	if ((state < 0) || (state >= States())) return nullptr;
+	const PltIndexState& s = m_state[state];
+	for (const PltIndexEntry& e : s.entries)
+	{
+		if ((e.region == region) && (e.var == var) && (e.item == item)) return &e;
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Compressed states are stored as a single deflate stream, so they need to be 
+// inflated completely. The last inflated state is kept so that reading several 
+// variables of the same state only inflates it once.
+bool PltIndexReader::LoadRawState(int n)
+{
+	if (m_rawState == n) return true;
+	m_rawState = -1;
+
+#ifdef HAVE_ZLIB
+	const PltIndexState& s = m_state[n];
+	std::vector<unsigned char> buf((size_t)s.storedSize);
+	if (plt_seek(m_fp, s.offset) != 0) return false;
+	if (fread(buf.data(), 1, buf.size(), m_fp) != buf.size()) return false;
+
+	m_raw.resize((size_t)s.rawSize);
+
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	strm.avail_in = 0;
+	strm.next_in = Z_NULL;
+	if (inflateInit(&strm) != Z_OK) return false;
+
+	strm.avail_in = (uInt)buf.size();
+	strm.next_in = buf.data();
+	strm.avail_out = (uInt)m_raw.size();
+	strm.next_out = m_raw.data();
+	int ret = inflate(&strm, Z_FINISH);
+	inflateEnd(&strm);
+	if ((ret != Z_STREAM_END) || (strm.avail_out != 0)) return false;
+
+	m_rawState = n;
+	return true;
+#else
+	// can't read compressed data
+	return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// read the data block as it is stored in the file
+bool PltIndexReader::ReadBlock(int state, const PltIndexEntry& e, std::vector<float>& data)
+{
+	const PltIndexState& s = m_state[state];
+	if ((e.offset + e.size) > s.rawSize) return false;
+
+	data.resize(e.size / sizeof(float));
+	if (data.empty()) return true;
+
+	if (s.compressed == false)
+	{
+		// uncompressed data can be read directly from the file
+		if (plt_seek(m_fp, s.offset + e.offset) != 0) return false;
+		return (fread(data.data(), sizeof(float), data.size(), m_fp) == data.size());
+	}
+
+	if (LoadRawState(state) == false) return false;
+	memcpy(data.data(), m_raw.data() + e.offset, data.size() * sizeof(float));
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool PltIndexReader::ReadData(int state, unsigned int region, unsigned int var, unsigned int item, std::vector<float>& data)
+{
+	if (m_fp == nullptr) return false;
+
+	const PltIndexEntry* pe = FindEntry(state, region, var, item);
+	if (pe == nullptr) return false;
+
+	if (ReadBlock(state, *pe, data) == false) return false;
+	if (m_filter & PLT_FILTER_SHUFFLE) PltUnshuffle(data.data(), data.size(), m_tmp);
+
+	if ((m_filter & PLT_FILTER_DELTA) && m_state[state].delta)
+	{
+		// The block was delta-encoded against the last earlier state that has this 
+		// block with the same size, so that one needs to be decoded first.
+		for (int n = state - 1; n >= 0; --n)
+		{
+			const PltIndexEntry* pp = FindEntry(n, region, var, item);
+			if (pp)
+			{
+				if (pp->size == pe->size)
+				{
+					std::vector<float> prev;
+					if (ReadData(n, region, var, item, prev) == false) return false;
+					PltDeltaXOR(data.data(), prev.data(), data.size());
+				}
+				break;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,121 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <stdio.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// The state index is an optional sidecar file (<plotfile>.idx) that stores where
+// each state and each variable block is located in the plot file. This allows 
+// readers to extract a single field from a state without scanning the file.
+//
+// The index file starts with a header (magic, version, filter flags, quantization bits), 
+// followed by one record per state:
+//   uint64 offset, uint64 storedSize, uint64 rawSize, uint32 flags, float time, uint32 entries
+// followed by one entry per variable block:
+//   uint32 region, uint32 var, uint32 item, uint32 size, uint64 offset
+// The region is the chunk ID of the data section (e.g. PLT_NODE_DATA), var is the
+// variable ID (as stored in PLT_STATE_VAR_ID), and item is the chunk ID of the 
+// data block (i.e. domain or surface ID + 1, or 0). The entry offset is the offset 
+// of the block's data relative to the start of the (uncompressed) state.
+// The state flags are a combination of PLT_INDEX_COMPRESSED and PLT_INDEX_DELTA.
+enum { PLT_INDEX_COMPRESSED = 1, PLT_INDEX_DELTA = 2 };
+
+//-----------------------------------------------------------------------------
+struct PltIndexEntry
+{
+	unsigned int		region;	// data region (PLT_GLOBAL_DATA, PLT_NODE_DATA, ...)
+	unsigned int		var;	// variable ID
+	unsigned int		item;	// data block ID
+	unsigned int		size;	// size of data (in bytes)
+	unsigned long long	offset;	// offset of data, relative to start of state
+};
+
+//-----------------------------------------------------------------------------
+struct PltIndexState
+{
+	unsigned long long	offset;		// file offset of state chunk
+	unsigned long long	storedSize;	// nr of bytes of state chunk in file
+	unsigned long long	rawSize;	// uncompressed size of state chunk
+	bool				compressed;	// is the state compressed?
+	bool				delta;		// is the state delta-encoded?
+	float				time;		// time value of state
+	std::vector<PltIndexEntry>	entries;
+};
+
+//-----------------------------------------------------------------------------
+// helper functions for writing the index file
+bool PltWriteIndexHeader(FILE* fp, unsigned int filter, int quantizeBits);
+bool PltWriteIndexState(FILE* fp, const PltIndexState& state);
+
+//-----------------------------------------------------------------------------
+// Class for extracting data from a plot file using its state index.
+class PltIndexReader
+{
+public:
+	PltIndexReader();
+	~PltIndexReader();
+
+	// Open the plot file. If the index file name is not given, <plotfile>.idx is used.
+	bool Open(const char* szplotfile, const char* szindexfile = nullptr);
+
+	void Close();
+
+	// number of states in index
+	int States() const;
+
+	// get a state record
+	const PltIndexState& State(int n) const;
+
+	// time value of a state
+	float StateTime(int n) const;
+
+	// find the index entry of a data block. Returns nullptr if not found.
+	const PltIndexEntry* FindEntry(int state, unsigned int region, unsigned int var, unsigned int item) const;
+
+	// read the data of a variable block. Any pre-filters (see PltFilter.h) are inverted.
+	bool ReadData(int state, unsigned int region, unsigned int var, unsigned int item, std::vector<float>& data);
+
+	// the pre-filters that were applied to the data
+	unsigned int Filter() const { return m_filter; }
+
+private:
+	bool ReadIndex(FILE* fp);
+	bool LoadRawState(int n);
+	bool ReadBlock(int state, const PltIndexEntry& e, std::vector<float>& data);
+
+private:
+	FILE*	m_fp;		// plot file
+	std::vector<PltIndexState>	m_state;
+	unsigned int	m_filter;		// pre-filter flags
+	std::vector<unsigned char>	m_tmp;
+
+	int		m_rawState;	// state currently stored in m_raw
+	std::vector<unsigned char>	m_raw;	// uncompressed state data
+};
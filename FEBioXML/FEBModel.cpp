@@ -133,6 +133,7 @@ FEBModel::Domain::Domain(const FEBModel::Domain& dom)
 	m_spec = dom.m_spec;
 	m_name = dom.m_name;
 	m_matName = dom.m_matName;
+	m_elemType = dom.m_elemType;
 	m_Elem = dom.m_Elem;
 	m_defaultShellThickness = dom.m_defaultShellThickness;
 }
@@ -150,6 +151,10 @@ void FEBModel::Domain::SetMaterialName(const string& name) { m_matName = name; }
 
 const string& FEBModel::Domain::MaterialName() const { return m_matName; }
 
+void FEBModel::Domain::SetElementType(const string& type) { m_elemType = type; }
+
+const string& FEBModel::Domain::ElementType() const { return m_elemType; }
+
 void FEBModel::Domain::SetElementList(const vector<ELEMENT>& el) { m_Elem = el; }
 
 const vector<FEBModel::ELEMENT>& FEBModel::Domain::ElementList() const { return m_Elem; }
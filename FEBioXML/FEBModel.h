@@ -82,6 +82,9 @@ public:
 		void SetMaterialName(const std::string& name);
 		const std::string& MaterialName() const;
 
+		void SetElementType(const std::string& type);
+		const std::string& ElementType() const;
+
 		void SetElementList(const std::vector<ELEMENT>& el);
 		const std::vector<ELEMENT>& ElementList() const;
 
@@ -100,6 +103,7 @@ public:
 		FE_Element_Spec		m_spec;
 		std::string			m_name;
 		std::string			m_matName;
+		std::string			m_elemType;	// element type as defined in the input file
 		std::vector<ELEMENT>	m_Elem;
 
 	public:
@@ -265,6 +269,7 @@ public:
 		int Domains() const { return (int)m_Dom.size(); }
 		void AddDomain(Domain* dom);
 		const Domain& GetDomain(int i) const { return *m_Dom[i]; }
+		Domain& GetDomain(int i) { return *m_Dom[i]; }
 		Domain* FindDomain(const std::string& name);
 
 		int Surfaces() const { return (int) m_Surf.size(); }
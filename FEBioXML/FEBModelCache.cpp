@@ -0,0 +1,501 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBModelCache.h"
+#include <XML/XMLReader.h>
+#include <stdio.h>
+#include <random>
+using namespace std;
+
+// magic number and version of the cache files
+#define FEBCACHE_MAGIC		0x4D424546		// = "FEBM"
+#define FEBCACHE_VERSION	1
+
+std::string FEBModelCache::m_folder;
+
+//-----------------------------------------------------------------------------
+// 64-bit FNV-1a hash, processed in 8-byte words for speed
+static uint64_t hash_text(const char* sz, size_t len)
+{
+	const uint64_t prime = 0x100000001b3ULL;
+	uint64_t h = 0xcbf29ce484222325ULL;
+	size_t n = len / 8;
+	for (size_t i = 0; i < n; ++i)
+	{
+		uint64_t w;
+		memcpy(&w, sz + 8 * i, 8);
+		h = (h ^ w) * prime;
+		h ^= (h >> 32);
+	}
+	for (size_t i = 8 * n; i < len; ++i)
+	{
+		h = (h ^ (unsigned char)sz[i]) * prime;
+	}
+	return h;
+}
+
+//-----------------------------------------------------------------------------
+// helper class for reading and writing the cache file
+class CacheFile
+{
+public:
+	CacheFile(FILE* fp) : m_fp(fp), m_ok(fp != nullptr) {}
+
+	bool ok() const { return m_ok; }
+
+	void write(const void* pd, size_t size, size_t count)
+	{
+		if (m_ok && (count > 0)) m_ok = (fwrite(pd, size, count, m_fp) == count);
+	}
+
+	void read(void* pd, size_t size, size_t count)
+	{
+		if (m_ok && (count > 0)) m_ok = (fread(pd, size, count, m_fp) == count);
+	}
+
+	template <typename T> void write(const T& v) { write(&v, sizeof(T), 1); }
+	template <typename T> void read(T& v) { read(&v, sizeof(T), 1); }
+
+	void write(const string& s)
+	{
+		uint64_t n = s.size();
+		write(n);
+		write(s.data(), 1, (size_t)n);
+	}
+
+	void read(string& s)
+	{
+		uint64_t n = read_count();
+		s.resize((size_t)n);
+		if (n > 0) read(&s[0], 1, (size_t)n);
+	}
+
+	template <typename T> void write(const vector<T>& v)
+	{
+		uint64_t n = v.size();
+		write(n);
+		write(v.data(), sizeof(T), (size_t)n);
+	}
+
+	template <typename T> void read(vector<T>& v)
+	{
+		uint64_t n = read_count();
+		v.resize((size_t)n);
+		read(v.data(), sizeof(T), (size_t)n);
+	}
+
+	// reads a count and makes sure it is sensible
+	uint64_t read_count()
+	{
+		uint64_t n = 0;
+		read(n);
+		if (n > ((uint64_t)1 << 40)) m_ok = false;
+		return (m_ok ? n : 0);
+	}
+
+private:
+	FILE*	m_fp;
+	bool	m_ok;
+};
+
+//-----------------------------------------------------------------------------
+FEBModelCache::FEBModelCache()
+{
+	m_hash = 0;
+	m_size = 0;
+	m_version = 0;
+	m_valid = false;
+}
+
+//-----------------------------------------------------------------------------
+void FEBModelCache::SetFolder(const std::string& folder)
+{
+	m_folder = folder;
+}
+
+//-----------------------------------------------------------------------------
+const std::string& FEBModelCache::GetFolder()
+{
+	return m_folder;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBModelCache::Init(XMLTag& tag, int fileVersion)
+{
+	m_valid = false;
+	if (m_folder.empty() || (tag.m_preader == nullptr)) return false;
+
+	// get the raw text of the mesh section
+	const char* sz = nullptr;
+	size_t len = 0;
+	if (tag.m_preader->GetTagContent(tag, sz, len) == false) return false;
+
+	m_hash = hash_text(sz, len);
+	m_size = len;
+	m_version = (uint32_t)fileVersion;
+	m_valid = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+std::string FEBModelCache::FileName() const
+{
+	char szkey[64] = { 0 };
+	snprintf(szkey, sizeof(szkey), "%016llx_%x.febc", (unsigned long long)m_hash, m_version);
+
+	string file = m_folder;
+	char c = file.back();
+	if ((c != '/') && (c != '\\')) file += '/';
+	return file + szkey;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBModelCache::Read(FEBModel::Part& part)
+{
+	if (m_valid == false) return false;
+
+	string fileName = FileName();
+	FILE* fp = fopen(fileName.c_str(), "rb");
+	if (fp == nullptr) return false;
+
+	CacheFile ar(fp);
+
+	// check the header
+	uint32_t magic = 0, version = 0, fileVersion = 0, elemSize = 0;
+	uint64_t hash = 0, size = 0;
+	ar.read(magic);
+	ar.read(version);
+	ar.read(fileVersion);
+	ar.read(elemSize);
+	ar.read(hash);
+	ar.read(size);
+	if (!ar.ok() || (magic != FEBCACHE_MAGIC) || (version != FEBCACHE_VERSION) || (fileVersion != m_version) ||
+		(elemSize != sizeof(FEBModel::ELEMENT)) || (hash != m_hash) || (size != m_size))
+	{
+		fclose(fp);
+		return false;
+	}
+
+	// nodes
+	vector<FEBModel::NODE> nodes;
+	ar.read(nodes);
+
+	// domains
+	vector<FEBModel::Domain*> domains;
+	uint64_t ndom = ar.read_count();
+	for (uint64_t i = 0; (i < ndom) && ar.ok(); ++i)
+	{
+		string type, name, matName;
+		double h = 0.0;
+		vector<FEBModel::ELEMENT> elems;
+		ar.read(type);
+		ar.read(name);
+		ar.read(matName);
+		ar.read(h);
+		ar.read(elems);
+
+		FEBModel::Domain* dom = new FEBModel::Domain;
+		dom->SetElementType(type);
+		dom->SetName(name);
+		dom->SetMaterialName(matName);
+		dom->m_defaultShellThickness = h;
+		dom->SetElementList(elems);
+		domains.push_back(dom);
+	}
+
+	// part lists
+	vector<FEBModel::PartList*> partLists;
+	uint64_t nlist = ar.read_count();
+	for (uint64_t i = 0; (i < nlist) && ar.ok(); ++i)
+	{
+		string name;
+		uint64_t n = 0;
+		ar.read(name);
+		n = ar.read_count();
+		vector<string> parts((size_t)n);
+		for (string& s : parts) ar.read(s);
+
+		FEBModel::PartList* pl = new FEBModel::PartList(name);
+		pl->SetPartList(parts);
+		partLists.push_back(pl);
+	}
+
+	// surfaces
+	vector<FEBModel::Surface*> surfaces;
+	uint64_t nsurf = ar.read_count();
+	for (uint64_t i = 0; (i < nsurf) && ar.ok(); ++i)
+	{
+		string name, partListName;
+		vector<FEBModel::FACET> faces;
+		ar.read(name);
+		ar.read(partListName);
+		ar.read(faces);
+
+		FEBModel::PartList* pl = nullptr;
+		for (FEBModel::PartList* pli : partLists) if (pli->Name() == partListName) pl = pli;
+
+		FEBModel::Surface* surf = (pl ? new FEBModel::Surface(name, pl) : new FEBModel::Surface(name));
+		surf->SetFacetList(faces);
+		surfaces.push_back(surf);
+	}
+
+	// node sets
+	vector<FEBModel::NodeSet*> nodeSets;
+	uint64_t nset = ar.read_count();
+	for (uint64_t i = 0; (i < nset) && ar.ok(); ++i)
+	{
+		string name;
+		vector<int> nodeList;
+		ar.read(name);
+		ar.read(nodeList);
+
+		FEBModel::NodeSet* ns = new FEBModel::NodeSet(name);
+		ns->SetNodeList(nodeList);
+		nodeSets.push_back(ns);
+	}
+
+	// edge sets
+	vector<FEBModel::EdgeSet*> edgeSets;
+	uint64_t nedge = ar.read_count();
+	for (uint64_t i = 0; (i < nedge) && ar.ok(); ++i)
+	{
+		string name;
+		vector<FEBModel::EDGE> edges;
+		ar.read(name);
+		ar.read(edges);
+
+		FEBModel::EdgeSet* es = new FEBModel::EdgeSet(name);
+		es->SetEdgeList(edges);
+		edgeSets.push_back(es);
+	}
+
+	// element sets
+	vector<FEBModel::ElementSet*> elemSets;
+	uint64_t neset = ar.read_count();
+	for (uint64_t i = 0; (i < neset) && ar.ok(); ++i)
+	{
+		string name;
+		vector<int> elemList;
+		ar.read(name);
+		ar.read(elemList);
+
+		FEBModel::ElementSet* es = new FEBModel::ElementSet(name);
+		es->SetElementList(elemList);
+		elemSets.push_back(es);
+	}
+
+	// surface pairs
+	vector<FEBModel::SurfacePair*> surfPairs;
+	uint64_t npair = ar.read_count();
+	for (uint64_t i = 0; (i < npair) && ar.ok(); ++i)
+	{
+		FEBModel::SurfacePair* sp = new FEBModel::SurfacePair;
+		ar.read(sp->m_name);
+		ar.read(sp->m_primary);
+		ar.read(sp->m_secondary);
+		surfPairs.push_back(sp);
+	}
+
+	// discrete sets
+	vector<FEBModel::DiscreteSet*> discSets;
+	uint64_t ndisc = ar.read_count();
+	for (uint64_t i = 0; (i < ndisc) && ar.ok(); ++i)
+	{
+		string name;
+		vector<FEBModel::DiscreteSet::ELEM> elems;
+		ar.read(name);
+		ar.read(elems);
+
+		FEBModel::DiscreteSet* ds = new FEBModel::DiscreteSet;
+		ds->SetName(name);
+		for (auto& el : elems) ds->AddElement(el.node[0], el.node[1]);
+		discSets.push_back(ds);
+	}
+
+	// check the end-of-file marker
+	uint32_t eof = 0;
+	ar.read(eof);
+	fclose(fp);
+
+	if (!ar.ok() || (eof != FEBCACHE_MAGIC))
+	{
+		for (auto p : domains) delete p;
+		for (auto p : partLists) delete p;
+		for (auto p : surfaces) delete p;
+		for (auto p : nodeSets) delete p;
+		for (auto p : edgeSets) delete p;
+		for (auto p : elemSets) delete p;
+		for (auto p : surfPairs) delete p;
+		for (auto p : discSets) delete p;
+		return false;
+	}
+
+	// all good, so let's fill the part
+	part.AddNodes(nodes);
+	for (auto p : domains  ) part.AddDomain(p);
+	for (auto p : partLists) part.AddPartList(p);
+	for (auto p : surfaces ) part.AddSurface(p);
+	for (auto p : nodeSets ) part.AddNodeSet(p);
+	for (auto p : edgeSets ) part.AddEdgeSet(p);
+	for (auto p : elemSets ) part.AddElementSet(p);
+	for (auto p : surfPairs) part.AddSurfacePair(p);
+	for (auto p : discSets ) part.AddDiscreteSet(p);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBModelCache::Write(FEBModel::Part& part)
+{
+	if (m_valid == false) return false;
+
+	// We write to a temporary file first and then rename it, so that concurrent
+	// runs never see a partially written cache file.
+	string fileName = FileName();
+	std::random_device rd;
+	char sztmp[32] = { 0 };
+	snprintf(sztmp, sizeof(sztmp), ".%08x.tmp", (unsigned int)rd());
+	string tmpName = fileName + sztmp;
+
+	FILE* fp = fopen(tmpName.c_str(), "wb");
+	if (fp == nullptr) return false;
+
+	CacheFile ar(fp);
+
+	// header
+	ar.write((uint32_t)FEBCACHE_MAGIC);
+	ar.write((uint32_t)FEBCACHE_VERSION);
+	ar.write(m_version);
+	ar.write((uint32_t)sizeof(FEBModel::ELEMENT));
+	ar.write(m_hash);
+	ar.write(m_size);
+
+	// nodes
+	uint64_t nodes = part.Nodes();
+	ar.write(nodes);
+	if (nodes > 0) ar.write(&part.GetNode(0), sizeof(FEBModel::NODE), (size_t)nodes);
+
+	// domains
+	ar.write((uint64_t)part.Domains());
+	for (int i = 0; i < part.Domains(); ++i)
+	{
+		const FEBModel::Domain& dom = part.GetDomain(i);
+		ar.write(dom.ElementType());
+		ar.write(dom.Name());
+		ar.write(dom.MaterialName());
+		ar.write(dom.m_defaultShellThickness);
+		ar.write(dom.ElementList());
+	}
+
+	// part lists
+	ar.write((uint64_t)part.PartLists());
+	for (int i = 0; i < part.PartLists(); ++i)
+	{
+		FEBModel::PartList* pl = part.GetPartList(i);
+		const vector<string>& parts = pl->GetPartList();
+		ar.write(pl->Name());
+		ar.write((uint64_t)parts.size());
+		for (const string& s : parts) ar.write(s);
+	}
+
+	// surfaces
+	ar.write((uint64_t)part.Surfaces());
+	for (int i = 0; i < part.Surfaces(); ++i)
+	{
+		FEBModel::Surface* surf = part.GetSurface(i);
+		FEBModel::PartList* pl = surf->GetPartList();
+		ar.write(surf->Name());
+		ar.write(pl ? pl->Name() : string());
+		ar.write(surf->FacetList());
+	}
+
+	// node sets
+	ar.write((uint64_t)part.NodeSets());
+	for (int i = 0; i < part.NodeSets(); ++i)
+	{
+		FEBModel::NodeSet* ns = part.GetNodeSet(i);
+		ar.write(ns->Name());
+		ar.write(ns->NodeList());
+	}
+
+	// edge sets
+	ar.write((uint64_t)part.EdgeSets());
+	for (int i = 0; i < part.EdgeSets(); ++i)
+	{
+		FEBModel::EdgeSet* es = part.GetEdgeSet(i);
+		ar.write(es->Name());
+		ar.write(es->EdgeList());
+	}
+
+	// element sets
+	ar.write((uint64_t)part.ElementSets());
+	for (int i = 0; i < part.ElementSets(); ++i)
+	{
+		FEBModel::ElementSet* es = part.GetElementSet(i);
+		ar.write(es->Name());
+		ar.write(es->ElementList());
+	}
+
+	// surface pairs
+	ar.write((uint64_t)part.SurfacePairs());
+	for (int i = 0; i < part.SurfacePairs(); ++i)
+	{
+		FEBModel::SurfacePair* sp = part.GetSurfacePair(i);
+		ar.write(sp->m_name);
+		ar.write(sp->m_primary);
+		ar.write(sp->m_secondary);
+	}
+
+	// discrete sets
+	ar.write((uint64_t)part.DiscreteSets());
+	for (int i = 0; i < part.DiscreteSets(); ++i)
+	{
+		FEBModel::DiscreteSet* ds = part.GetDiscreteSet(i);
+		ar.write(ds->Name());
+		ar.write(ds->ElementList());
+	}
+
+	// end-of-file marker
+	ar.write((uint32_t)FEBCACHE_MAGIC);
+
+	bool ok = ar.ok();
+	if (fclose(fp) != 0) ok = false;
+
+	if (ok)
+	{
+		if (rename(tmpName.c_str(), fileName.c_str()) != 0)
+		{
+			// another run may have created the file in the meantime
+			remove(tmpName.c_str());
+		}
+	}
+	else remove(tmpName.c_str());
+
+	return ok;
+}
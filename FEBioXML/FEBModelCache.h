@@ -0,0 +1,75 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEBModel.h"
+#include "febioxml_api.h"
+#include <string>
+#include <stdint.h>
+
+class XMLTag;
+
+//-----------------------------------------------------------------------------
+// This class implements an (optional) cache for the mesh sections of the input
+// file. After a mesh section is parsed, the resulting part is stored in a binary
+// file in the cache folder. The file name is derived from a hash of the raw text
+// of the mesh section, so repeated runs of models that share the same mesh (e.g.
+// parameter studies) can read the part back in with bulk reads instead of parsing
+// the XML. Caching is disabled unless a cache folder is set.
+class FEBIOXML_API FEBModelCache
+{
+public:
+	FEBModelCache();
+
+	//! set the folder where cached meshes are stored (empty string disables the cache)
+	static void SetFolder(const std::string& folder);
+
+	//! get the cache folder
+	static const std::string& GetFolder();
+
+	//! Compute the cache key for the mesh section that starts at tag.
+	//! Returns false if the mesh cannot be cached.
+	bool Init(XMLTag& tag, int fileVersion);
+
+	//! Read the cached part. Returns false if no (valid) cache file was found.
+	bool Read(FEBModel::Part& part);
+
+	//! Store the part in the cache
+	bool Write(FEBModel::Part& part);
+
+private:
+	std::string FileName() const;
+
+private:
+	uint64_t	m_hash;		//!< hash of the mesh section
+	uint64_t	m_size;		//!< size (in bytes) of the mesh section
+	uint32_t	m_version;	//!< file version of the input file
+	bool		m_valid;	//!< Init was successful
+
+	static std::string	m_folder;
+};
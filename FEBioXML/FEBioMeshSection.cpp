@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEBioMeshSection.h"
+#include "FEBModelCache.h"
 #include <FECore/FESolidDomain.h>
 #include <FECore/FEShellDomain.h>
 #include <FECore/FETrussDomain.h>
@@ -36,6 +37,7 @@ SOFTWARE.*/
 #include <FECore/FEMaterial.h>
 #include <FECore/FECoreKernel.h>
 #include <FECore/FENodeNodeList.h>
+#include <FECore/log.h>
 #include <sstream>
 
 //-----------------------------------------------------------------------------
@@ -54,6 +56,24 @@ void FEBioMeshSection::Parse(XMLTag& tag)
 	assert(feb.Parts() == 0);
 	FEBModel::Part* part = feb.AddPart("");
 
+	// see if this mesh was already parsed (and cached) by a previous run
+	FEBModelCache cache;
+	bool bcache = cache.Init(tag, GetFileReader()->GetFileVersion());
+	if (bcache && cache.Read(*part))
+	{
+		// The element specs depend on the builder's state, so they are not cached.
+		for (int i = 0; i < part->Domains(); ++i)
+		{
+			FEBModel::Domain& dom = part->GetDomain(i);
+			FE_Element_Spec espec = builder->ElementSpec(dom.ElementType().c_str());
+			if (FEElementLibrary::IsValid(espec) == false) throw FEBioImport::InvalidElementType();
+			dom.SetElementSpec(espec);
+		}
+
+		tag.skip();
+		return;
+	}
+
 	// read all sections
 	++tag;
 	do
@@ -70,6 +90,12 @@ void FEBioMeshSection::Parse(XMLTag& tag)
 		++tag;
 	}
 	while (!tag.isend());
+
+	// store the mesh in the cache
+	if (bcache && (cache.Write(*part) == false))
+	{
+		feLogWarningEx(GetFEModel(), "Failed writing mesh cache file to %s", FEBModelCache::GetFolder().c_str());
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -149,6 +175,7 @@ void FEBioMeshSection::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 
 	// create the new domain
 	dom = new FEBModel::Domain(espec);
+	dom->SetElementType(sztype);
 	if (szname) dom->SetName(szname);
 
 	// add domain it to the mesh
@@ -405,6 +405,36 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
 				tag.value(ncomp);
 				plotData.SetPlotCompression(ncomp);
 			}
+			else if (tag == "async")
+			{
+				bool b;
+				tag.value(b);
+				plotData.SetPlotAsync(b);
+			}
+			else if (tag == "index")
+			{
+				bool b;
+				tag.value(b);
+				plotData.SetPlotIndex(b);
+			}
+			else if (tag == "delta")
+			{
+				int n;
+				tag.value(n);
+				plotData.SetPlotDeltaInterval(n);
+			}
+			else if (tag == "shuffle")
+			{
+				bool b;
+				tag.value(b);
+				plotData.SetPlotShuffle(b);
+			}
+			else if (tag == "quantize")
+			{
+				int n;
+				tag.value(n);
+				plotData.SetPlotQuantizeBits(n);
+			}
 			++tag;
 		}
 		while (!tag.isend());
@@ -0,0 +1,504 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "BSRMatrix.h"
+#include "FEModel.h"
+#include "FEMesh.h"
+#include <algorithm>
+#include <assert.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// add v to a, using an atomic update if requested
+static inline void addValue(double& a, double v, bool batomic)
+{
+	if (batomic)
+	{
+#pragma omp atomic
+		a += v;
+	}
+	else a += v;
+}
+
+//-----------------------------------------------------------------------------
+BSRMatrix::BSRMatrix(FEModel* fem, bool symmetric) : m_fem(fem), m_bsymm(symmetric)
+{
+	m_nbr = 0;
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Zero()
+{
+	std::fill(m_val.begin(), m_val.end(), 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Clear()
+{
+	m_nbr = 0;
+	m_bptr.clear();
+	m_bcol.clear();
+	m_bdiag.clear();
+	m_val.clear();
+	m_eqpos.clear();
+	m_beq.clear();
+	m_tptr.clear();
+	m_tblk.clear();
+	m_trow.clear();
+	m_xb.clear();
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+//! The blocks are filled in the order of the equations. Each node has its own
+//! open block, so that the equations of a node end up in the same block, even
+//! if they are not numbered consecutively. Equations that do not belong to a
+//! node share an open block. Without a model, this reduces to blocks of three
+//! consecutive equations.
+void BSRMatrix::BuildBlockMap(int neq)
+{
+	// find the node of each equation
+	vector<int> eqNode(neq, -1);
+	int NN = 0;
+	if (m_fem)
+	{
+		FEMesh& mesh = m_fem->GetMesh();
+		NN = mesh.Nodes();
+		for (int n = 0; n < NN; ++n)
+		{
+			const vector<int>& id = mesh.Node(n).m_ID;
+			for (int eq : id)
+			{
+				if ((eq >= 0) && (eq < neq)) eqNode[eq] = n;
+			}
+		}
+	}
+
+	// the open block of each node (entry 0 is for equations without a node)
+	vector<int> openBlock(NN + 1, -1);
+
+	m_eqpos.assign(neq, -1);
+	m_beq.clear();
+	for (int i = 0; i < neq; ++i)
+	{
+		int& B = openBlock[eqNode[i] + 1];
+		if ((B < 0) || (m_beq[BSIZE*B + BSIZE - 1] >= 0))
+		{
+			// start a new block
+			B = (int)m_beq.size() / BSIZE;
+			m_beq.resize(m_beq.size() + BSIZE, -1);
+		}
+
+		int p = 0;
+		while (m_beq[BSIZE*B + p] >= 0) ++p;
+		m_beq[BSIZE*B + p] = i;
+		m_eqpos[i] = BSIZE*B + p;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! The block structure is obtained by collapsing the (scalar) profile onto the
+//! blocks: block (I,J) is allocated if any entry in it is in the profile.
+void BSRMatrix::Create(SparseMatrixProfile& mp)
+{
+	int nr = mp.Rows();
+	int nc = mp.Columns();
+	assert(nr == nc);
+
+	// assign the equations to the blocks
+	BuildBlockMap(nr);
+	int nbr = (int)m_beq.size() / BSIZE;
+
+	// collect the block rows for each block column
+	// (the profile is column based, so this gives us the transpose of the block structure)
+	vector< vector<int> > colBlocks(nbr);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int J = 0; J < nbr; ++J)
+	{
+		vector<int>& cb = colBlocks[J];
+		for (int q = 0; q < BSIZE; ++q)
+		{
+			int j = m_beq[BSIZE*J + q];
+			if (j < 0) continue;
+
+			SparseMatrixProfile::ColumnProfile& a = mp.Column(j);
+			for (int k = 0; k < a.size(); ++k)
+			{
+				for (int i = a[k].start; i <= a[k].end; ++i)
+				{
+					int I = m_eqpos[i] / BSIZE;
+
+					// symmetric matrices only store the upper block triangle
+					if (m_bsymm && (I > J)) continue;
+
+					if (cb.empty() || (cb.back() != I)) cb.push_back(I);
+				}
+			}
+		}
+		std::sort(cb.begin(), cb.end());
+		cb.erase(std::unique(cb.begin(), cb.end()), cb.end());
+	}
+
+	// count the blocks in each block row
+	m_bptr.assign(nbr + 1, 0);
+	for (int J = 0; J < nbr; ++J)
+	{
+		vector<int>& cb = colBlocks[J];
+		for (int I : cb) m_bptr[I + 1]++;
+	}
+	for (int I = 0; I < nbr; ++I) m_bptr[I + 1] += m_bptr[I];
+
+	// fill the column indices (these come out sorted since we loop over J)
+	int nblocks = m_bptr[nbr];
+	m_bcol.resize(nblocks);
+	vector<int> pos(m_bptr.begin(), m_bptr.end() - 1);
+	for (int J = 0; J < nbr; ++J)
+	{
+		vector<int>& cb = colBlocks[J];
+		for (int I : cb) m_bcol[pos[I]++] = J;
+	}
+
+	m_nbr = nbr;
+
+	// find the diagonal blocks
+	m_bdiag.assign(nbr, -1);
+	for (int I = 0; I < nbr; ++I) m_bdiag[I] = FindBlock(I, I);
+
+	// For symmetric matrices, the product with the lower block triangle is
+	// evaluated with the transpose of the upper blocks. We store the upper
+	// blocks per block column, so that each block row of the result can be
+	// evaluated independently.
+	m_tptr.clear();
+	m_tblk.clear();
+	m_trow.clear();
+	if (m_bsymm)
+	{
+		m_tptr.assign(nbr + 1, 0);
+		for (int I = 0; I < nbr; ++I)
+			for (int k = m_bptr[I]; k < m_bptr[I + 1]; ++k)
+			{
+				if (m_bcol[k] != I) m_tptr[m_bcol[k] + 1]++;
+			}
+		for (int J = 0; J < nbr; ++J) m_tptr[J + 1] += m_tptr[J];
+
+		m_tblk.resize(m_tptr[nbr]);
+		m_trow.resize(m_tptr[nbr]);
+		vector<int> tpos(m_tptr.begin(), m_tptr.end() - 1);
+		for (int I = 0; I < nbr; ++I)
+			for (int k = m_bptr[I]; k < m_bptr[I + 1]; ++k)
+			{
+				int J = m_bcol[k];
+				if (J != I)
+				{
+					m_tblk[tpos[J]] = k;
+					m_trow[tpos[J]++] = I;
+				}
+			}
+	}
+
+	m_val.assign(9 * (size_t)nblocks, 0.0);
+
+	m_nrow = nr;
+	m_ncol = nc;
+	m_nsize = 9 * nblocks;
+}
+
+//-----------------------------------------------------------------------------
+int BSRMatrix::FindBlock(int I, int J) const
+{
+	const int* pc = &m_bcol[0];
+	int n0 = m_bptr[I];
+	int n1 = m_bptr[I + 1];
+	const int* p = std::lower_bound(pc + n0, pc + n1, J);
+	if ((p == pc + n1) || (*p != J)) return -1;
+	return (int)(p - pc);
+}
+
+//-----------------------------------------------------------------------------
+// Find the block nb and the component (p,q) in the block where entry (i,j) is 
+// stored. For symmetric matrices, only entries with i <= j are stored and the 
+// entries in the lower block triangle are moved to the transposed block.
+bool BSRMatrix::FindEntry(int i, int j, int& nb, int& p, int& q) const
+{
+	assert((i >= 0) && (i < m_nrow));
+	assert((j >= 0) && (j < m_ncol));
+	if (m_bsymm && (i > j)) return false;
+
+	int I = m_eqpos[i] / BSIZE; p = m_eqpos[i] % BSIZE;
+	int J = m_eqpos[j] / BSIZE; q = m_eqpos[j] % BSIZE;
+	if (m_bsymm && (I > J))
+	{
+		std::swap(I, J);
+		std::swap(p, q);
+	}
+
+	nb = (I == J ? m_bdiag[I] : FindBlock(I, J));
+	return (nb >= 0);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Assemble(const matrix& ke, const std::vector<int>& lm)
+{
+	Assemble(ke, lm, lm);
+}
+
+//-----------------------------------------------------------------------------
+// The element dofs that fall in the same block (i.e. usually the dofs of one node)
+struct BSRElementBlock
+{
+	int	block;						// block row/column
+	int	loc[BSRMatrix::BSIZE];		// local index in the element matrix of each block component (or -1)
+};
+
+//-----------------------------------------------------------------------------
+// Group the element dofs by block. Each component of an element block refers to
+// at most one element dof, so if an equation appears more than once in lm, a
+// second element block is added for the same block.
+static void groupElementBlocks(const std::vector<int>& lm, const std::vector<int>& eqpos, std::vector<BSRElementBlock>& eb)
+{
+	const int B = BSRMatrix::BSIZE;
+	eb.clear();
+	const int n = (int)lm.size();
+	for (int i = 0; i < n; ++i)
+	{
+		int I = lm[i];
+		if (I < 0) continue;
+
+		int bi = eqpos[I] / B;
+		int ci = eqpos[I] % B;
+
+		// the dofs of a node are usually consecutive, so search from the back
+		int k = (int)eb.size() - 1;
+		while ((k >= 0) && ((eb[k].block != bi) || (eb[k].loc[ci] >= 0))) --k;
+		if (k < 0)
+		{
+			BSRElementBlock b = { bi, { -1, -1, -1 } };
+			eb.push_back(b);
+			k = (int)eb.size() - 1;
+		}
+		eb[k].loc[ci] = i;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! The element dofs are first grouped by block, so that each block of the global
+//! matrix is only looked up once per pair of element blocks (i.e. node pairs)
+//! instead of once per matrix entry.
+void BSRMatrix::Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj)
+{
+	// these buffers keep their memory between calls
+	static thread_local std::vector<BSRElementBlock> rowBlocks, colBlocks;
+	groupElementBlocks(lmi, m_eqpos, rowBlocks);
+	if (&lmj != &lmi) groupElementBlocks(lmj, m_eqpos, colBlocks);
+	const std::vector<BSRElementBlock>& cb = (&lmj != &lmi ? colBlocks : rowBlocks);
+
+	const int NR = (int)rowBlocks.size();
+	const int NC = (int)cb.size();
+	for (int r = 0; r < NR; ++r)
+	{
+		const BSRElementBlock& R = rowBlocks[r];
+		const int bi = R.block;
+		for (int c = 0; c < NC; ++c)
+		{
+			const BSRElementBlock& C = cb[c];
+			const int bj = C.block;
+
+			// symmetric matrices only store the upper block triangle, so lower 
+			// blocks are assembled into the transposed block
+			int nb = -1;
+			if (bi == bj) nb = m_bdiag[bi];
+			else nb = (m_bsymm && (bj < bi) ? FindBlock(bj, bi) : FindBlock(bi, bj));
+			assert(nb >= 0);
+			if (nb < 0) continue;
+			double* a = &m_val[9 * nb];
+
+			for (int ri = 0; ri < BSIZE; ++ri)
+			{
+				const int i = R.loc[ri];
+				if (i < 0) continue;
+				const int I = lmi[i];
+				const double* kei = ke[i];
+
+				for (int cj = 0; cj < BSIZE; ++cj)
+				{
+					const int j = C.loc[cj];
+					if (j < 0) continue;
+
+					// symmetric matrices only assemble the upper triangle
+					if (m_bsymm && (lmj[j] < I)) continue;
+
+					const double v = kei[j];
+					if (!m_bsymm || (bi < bj)) addValue(a[BSIZE*ri + cj], v, m_batomic);
+					else if (bi > bj) addValue(a[BSIZE*cj + ri], v, m_batomic);
+					else
+					{
+						// diagonal blocks of symmetric matrices are stored in full
+						addValue(a[BSIZE*ri + cj], v, m_batomic);
+						if (ri != cj) addValue(a[BSIZE*cj + ri], v, m_batomic);
+					}
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::add(int i, int j, double v)
+{
+	int nb, p, q;
+	if (FindEntry(i, j, nb, p, q) == false) return;
+
+	double* a = &m_val[9 * nb];
+	addValue(a[BSIZE*p + q], v, m_batomic);
+
+	// diagonal blocks of symmetric matrices are stored in full
+	if (m_bsymm && (nb == m_bdiag[m_eqpos[i] / BSIZE]) && (p != q)) addValue(a[BSIZE*q + p], v, m_batomic);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::set(int i, int j, double v)
+{
+	int nb, p, q;
+	if (FindEntry(i, j, nb, p, q) == false) return;
+
+	double* a = &m_val[9 * nb];
+	bool bmirror = (m_bsymm && (nb == m_bdiag[m_eqpos[i] / BSIZE]) && (p != q));
+
+#pragma omp critical
+	{
+		a[BSIZE*p + q] = v;
+		if (bmirror) a[BSIZE*q + p] = v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double BSRMatrix::get(int i, int j)
+{
+	if (m_bsymm && (i > j)) std::swap(i, j);
+
+	int nb, p, q;
+	if (FindEntry(i, j, nb, p, q) == false) return 0.0;
+	return m_val[9 * nb + BSIZE*p + q];
+}
+
+//-----------------------------------------------------------------------------
+double BSRMatrix::diag(int i)
+{
+	int nb = m_bdiag[m_eqpos[i] / BSIZE];
+	return m_val[9 * nb + (BSIZE + 1)*(m_eqpos[i] % BSIZE)];
+}
+
+//-----------------------------------------------------------------------------
+bool BSRMatrix::check(int i, int j)
+{
+	if (m_bsymm && (i > j)) std::swap(i, j);
+
+	int nb, p, q;
+	return FindEntry(i, j, nb, p, q);
+}
+
+//-----------------------------------------------------------------------------
+bool BSRMatrix::mult_vector(double* x, double* r)
+{
+	const int nbr = m_nbr;
+	const int nb3 = BSIZE*nbr;
+
+	// the vector in block ordering (unused block components are zero)
+	m_xb.resize(nb3);
+	double* xb = m_xb.data();
+
+#pragma omp parallel
+	{
+#pragma omp for schedule(static)
+		for (int k = 0; k < nb3; ++k)
+		{
+			int i = m_beq[k];
+			xb[k] = (i >= 0 ? x[i] : 0.0);
+		}
+
+#pragma omp for schedule(dynamic, 256)
+		for (int I = 0; I < nbr; ++I)
+		{
+			double r0 = 0.0, r1 = 0.0, r2 = 0.0;
+			for (int k = m_bptr[I]; k < m_bptr[I + 1]; ++k)
+			{
+				const double* a = &m_val[9 * k];
+				const double* xj = xb + 3 * m_bcol[k];
+				r0 += a[0] * xj[0] + a[1] * xj[1] + a[2] * xj[2];
+				r1 += a[3] * xj[0] + a[4] * xj[1] + a[5] * xj[2];
+				r2 += a[6] * xj[0] + a[7] * xj[1] + a[8] * xj[2];
+			}
+
+			// add the transposed upper blocks of block column I
+			if (m_bsymm)
+			{
+				for (int l = m_tptr[I]; l < m_tptr[I + 1]; ++l)
+				{
+					const double* a = &m_val[9 * m_tblk[l]];
+					const double* xi = xb + 3 * m_trow[l];
+					r0 += a[0] * xi[0] + a[3] * xi[1] + a[6] * xi[2];
+					r1 += a[1] * xi[0] + a[4] * xi[1] + a[7] * xi[2];
+					r2 += a[2] * xi[0] + a[5] * xi[1] + a[8] * xi[2];
+				}
+			}
+
+			const int* eq = &m_beq[3 * I];
+			if (eq[0] >= 0) r[eq[0]] = r0;
+			if (eq[1] >= 0) r[eq[1]] = r1;
+			if (eq[2] >= 0) r[eq[2]] = r2;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::scale(const vector<double>& L, const vector<double>& R)
+{
+#pragma omp parallel for
+	for (int I = 0; I < m_nbr; ++I)
+	{
+		for (int k = m_bptr[I]; k < m_bptr[I + 1]; ++k)
+		{
+			const int J = m_bcol[k];
+			double* a = &m_val[9 * k];
+			for (int p = 0; p < BSIZE; ++p)
+			{
+				int i = m_beq[BSIZE*I + p];
+				if (i < 0) continue;
+				for (int q = 0; q < BSIZE; ++q)
+				{
+					int j = m_beq[BSIZE*J + q];
+					if (j < 0) continue;
+					a[BSIZE*p + q] *= L[i] * R[j];
+				}
+			}
+		}
+	}
+}
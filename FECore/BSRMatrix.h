@@ -0,0 +1,143 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "SparseMatrix.h"
+#include <vector>
+
+class FEModel;
+
+//=============================================================================
+//! This class stores a sparse matrix in block compressed row (BSR) format with
+//! dense 3x3 blocks. It is intended for problems where the degrees of freedom
+//! come in triplets (e.g. displacements), so that a single column index
+//! addresses nine matrix entries.
+//! When a model is given, the blocks follow the nodes: the equations of a node
+//! are collected in one block (or several, if the node has more than three
+//! equations). Equations that do not belong to a node (e.g. rigid bodies) are
+//! grouped in the order they are numbered. Unused block components are zero.
+//! For symmetric matrices only the blocks (I,J) with I <= J are stored. The
+//! diagonal blocks are stored in full.
+class FECORE_API BSRMatrix : public SparseMatrix
+{
+public:
+	enum { BSIZE = 3 };
+
+public:
+	//! constructor
+	BSRMatrix(FEModel* fem = nullptr, bool symmetric = false);
+
+	//! zero matrix elements
+	void Zero() override;
+
+	//! Clear
+	void Clear() override;
+
+	//! Create the matrix structure from the SparseMatrixProfile.
+	void Create(SparseMatrixProfile& mp) override;
+
+	//! Assemble an element matrix into the global matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! add a matrix item
+	void add(int i, int j, double v) override;
+
+	//! set matrix item
+	void set(int i, int j, double v) override;
+
+	//! get a matrix item
+	double get(int i, int j) override;
+
+	//! return the diagonal component
+	double diag(int i) override;
+
+	//! see if a matrix element is defined
+	bool check(int i, int j) override;
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! do row (L) and column (R) scaling
+	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+public:
+	//! is only the upper block triangle stored?
+	bool IsSymmetric() const { return m_bsymm; }
+
+	//! number of block rows
+	int BlockRows() const { return m_nbr; }
+
+	//! number of blocks allocated
+	int Blocks() const { return (int)m_bcol.size(); }
+
+	//! block row pointers (size BlockRows()+1)
+	const int* BlockPointers() const { return &m_bptr[0]; }
+
+	//! block column indices
+	const int* BlockIndices() const { return &m_bcol[0]; }
+
+	//! equation of each block component (size 3*BlockRows(), -1 for unused components)
+	const int* BlockEquations() const { return &m_beq[0]; }
+
+	//! values of block n (stored row-major)
+	double* Block(int n) { return &m_val[9*n]; }
+
+	//! return the index of block (I,J), or -1 if the block is not allocated
+	int FindBlock(int I, int J) const;
+
+private:
+	// assign the equations to the block components
+	void BuildBlockMap(int neq);
+
+	// find the stored location of entry (i,j). Returns false if the entry is
+	// not stored (i.e. it is in the lower triangle of a symmetric matrix)
+	bool FindEntry(int i, int j, int& nb, int& p, int& q) const;
+
+private:
+	FEModel*	m_fem;		//!< model that defines the node of each equation (can be null)
+	bool		m_bsymm;	//!< store only the upper block triangle
+
+	int		m_nbr;					//!< number of block rows (and columns)
+	std::vector<int>	m_bptr;		//!< block row pointers
+	std::vector<int>	m_bcol;		//!< block column indices (sorted per block row)
+	std::vector<int>	m_bdiag;	//!< index of the diagonal block of each block row
+	std::vector<double>	m_val;		//!< block values
+
+	std::vector<int>	m_eqpos;	//!< block component (3*block + component) of each equation
+	std::vector<int>	m_beq;		//!< equation of each block component (or -1)
+
+	// transposed structure of the off-diagonal blocks (symmetric matrices only)
+	std::vector<int>	m_tptr;		//!< pointers into m_tblk for each block column
+	std::vector<int>	m_tblk;		//!< block indices
+	std::vector<int>	m_trow;		//!< block row of each block
+
+	std::vector<double>	m_xb;		//!< x in block ordering (used in mult_vector)
+};
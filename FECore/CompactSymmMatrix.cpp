@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactSymmMatrix.h"
+#include "sys.h"
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -37,6 +38,50 @@ CompactSymmMatrix::CompactSymmMatrix(int offset) : CompactMatrix(offset)
 	
 }
 
+//-----------------------------------------------------------------------------
+// Multiply column j of the lower-triangular storage with x. The lower-triangular
+// contributions are scattered into rs, the diagonal and upper-triangular
+// contributions for row j are returned.
+static inline double symm_column_product(const double* pv, const int* pi, int n, int offset, const double* x, double xj, double* rs)
+{
+	// add off-diagonal elements
+	for (int i = 1; i<n - 7; i += 8)
+	{
+		// add lower triangular element
+		rs[pi[i    ] - offset] += pv[i    ] * xj;
+		rs[pi[i + 1] - offset] += pv[i + 1] * xj;
+		rs[pi[i + 2] - offset] += pv[i + 2] * xj;
+		rs[pi[i + 3] - offset] += pv[i + 3] * xj;
+		rs[pi[i + 4] - offset] += pv[i + 4] * xj;
+		rs[pi[i + 5] - offset] += pv[i + 5] * xj;
+		rs[pi[i + 6] - offset] += pv[i + 6] * xj;
+		rs[pi[i + 7] - offset] += pv[i + 7] * xj;
+	}
+	for (int i = 0; i<(n - 1) % 8; ++i)
+		rs[pi[n - 1 - i] - offset] += pv[n - 1 - i] * xj;
+
+	// add diagonal element
+	double rj = pv[0] * xj;
+
+	// add upper-triangular elements
+	for (int i = 1; i<n - 7; i += 8)
+	{
+		// add upper triangular element
+		rj += pv[i    ] * x[pi[i    ] - offset];
+		rj += pv[i + 1] * x[pi[i + 1] - offset];
+		rj += pv[i + 2] * x[pi[i + 2] - offset];
+		rj += pv[i + 3] * x[pi[i + 3] - offset];
+		rj += pv[i + 4] * x[pi[i + 4] - offset];
+		rj += pv[i + 5] * x[pi[i + 5] - offset];
+		rj += pv[i + 6] * x[pi[i + 6] - offset];
+		rj += pv[i + 7] * x[pi[i + 7] - offset];
+	}
+	for (int i = 0; i<(n - 1) % 8; ++i)
+		rj += pv[n - 1 - i] * x[pi[n - 1 - i] - offset];
+
+	return rj;
+}
+
 //-----------------------------------------------------------------------------
 bool CompactSymmMatrix::mult_vector(double* x, double* r)
 {
@@ -44,57 +89,107 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 	int N = Rows();
 	int M = Columns();
 
-	// zero result vector
-	for (int j = 0; j<N; ++j) r[j] = 0.0;
-
-	// loop over all columns
-	for (int j = 0; j<M; ++j)
+	int nt = omp_get_max_threads();
+	if ((nt == 1) || (N < 1000))
 	{
-		double* pv = m_pd + m_ppointers[j] - m_offset;
-		int* pi = m_pindices + m_ppointers[j] - m_offset;
-		int n = m_ppointers[j + 1] - m_ppointers[j];
+		// zero result vector
+		for (int j = 0; j<N; ++j) r[j] = 0.0;
 
-		// add off-diagonal elements
-		for (int i = 1; i<n - 7; i += 8)
+		// loop over all columns
+		for (int j = 0; j<M; ++j)
 		{
-			// add lower triangular element
-			r[pi[i    ] - m_offset] += pv[i    ] * x[j];
-			r[pi[i + 1] - m_offset] += pv[i + 1] * x[j];
-			r[pi[i + 2] - m_offset] += pv[i + 2] * x[j];
-			r[pi[i + 3] - m_offset] += pv[i + 3] * x[j];
-			r[pi[i + 4] - m_offset] += pv[i + 4] * x[j];
-			r[pi[i + 5] - m_offset] += pv[i + 5] * x[j];
-			r[pi[i + 6] - m_offset] += pv[i + 6] * x[j];
-			r[pi[i + 7] - m_offset] += pv[i + 7] * x[j];
+			double* pv = m_pd + m_ppointers[j] - m_offset;
+			int* pi = m_pindices + m_ppointers[j] - m_offset;
+			int n = m_ppointers[j + 1] - m_ppointers[j];
+
+			r[j] += symm_column_product(pv, pi, n, m_offset, x, x[j], r);
 		}
-		for (int i = 0; i<(n - 1) % 8; ++i)
-			r[pi[n - 1 - i] - m_offset] += pv[n - 1 - i] * x[j];
 
-		// add diagonal element
-		double rj = pv[0] * x[j];
+		return true;
+	}
 
-		// add upper-triangular elements
-		for (int i = 1; i<n - 7; i += 8)
+	// Each row is computed by a single thread: the upper-triangular part of row i 
+	// is column i of the storage, and the lower-triangular part is gathered through 
+	// the row index. This needs no per-thread buffers and the summation order does 
+	// not depend on the number of threads.
+	UpdateRowIndex();
+
+	const int* rptr = m_rptr.data();
+	const int* rcol = m_rcol.data();
+	const int* rpos = m_rpos.data();
+
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int i = 0; i < N; ++i)
+	{
+		// lower-triangular part
+		double ri = 0.0;
+		for (int k = rptr[i]; k < rptr[i + 1]; ++k) ri += m_pd[rpos[k]] * x[rcol[k]];
+
+		// diagonal and upper-triangular part
+		if (i < M)
 		{
-			// add upper triangular element
-			rj += pv[i    ] * x[pi[i    ] - m_offset];
-			rj += pv[i + 1] * x[pi[i + 1] - m_offset];
-			rj += pv[i + 2] * x[pi[i + 2] - m_offset];
-			rj += pv[i + 3] * x[pi[i + 3] - m_offset];
-			rj += pv[i + 4] * x[pi[i + 4] - m_offset];
-			rj += pv[i + 5] * x[pi[i + 5] - m_offset];
-			rj += pv[i + 6] * x[pi[i + 6] - m_offset];
-			rj += pv[i + 7] * x[pi[i + 7] - m_offset];
+			const double* pv = m_pd + m_ppointers[i] - m_offset;
+			const int* pi = m_pindices + m_ppointers[i] - m_offset;
+			int n = m_ppointers[i + 1] - m_ppointers[i];
+
+			ri += pv[0] * x[i];
+			for (int k = 1; k < n; ++k) ri += pv[k] * x[pi[k] - m_offset];
 		}
-		for (int i = 0; i<(n - 1) % 8; ++i)
-			rj += pv[n - 1 - i] * x[pi[n - 1 - i] - m_offset];
 
-		r[j] += rj;
+		r[i] = ri;
 	}
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void CompactSymmMatrix::GetRowIndex(const int*& rptr, const int*& rcol, const int*& rpos)
+{
+	UpdateRowIndex();
+	rptr = m_rptr.data();
+	rcol = m_rcol.data();
+	rpos = m_rpos.data();
+}
+
+//-----------------------------------------------------------------------------
+// Build a row-wise index of the strictly lower-triangular entries, so that the
+// lower-triangular part of a row can be evaluated without scattering.
+void CompactSymmMatrix::UpdateRowIndex()
+{
+	int N = Rows();
+	int M = Columns();
+
+	// the index is still valid if the structure did not change
+	int nnz = m_ppointers[M] - m_ppointers[0];
+	if ((m_rptr.size() == (size_t)N + 1) && (m_rptr[N] == nnz - M)) return;
+
+	m_rptr.assign(N + 1, 0);
+	for (int j = 0; j < M; ++j)
+	{
+		for (int k = m_ppointers[j] + 1; k < m_ppointers[j + 1]; ++k)
+		{
+			int i = m_pindices[k - m_offset] - m_offset;
+			m_rptr[i + 1]++;
+		}
+	}
+	for (int i = 0; i < N; ++i) m_rptr[i + 1] += m_rptr[i];
+
+	int nlow = m_rptr[N];
+	m_rcol.resize(nlow);
+	m_rpos.resize(nlow);
+	vector<int> pos(m_rptr.begin(), m_rptr.end() - 1);
+	for (int j = 0; j < M; ++j)
+	{
+		for (int k = m_ppointers[j] + 1; k < m_ppointers[j + 1]; ++k)
+		{
+			int i = m_pindices[k - m_offset] - m_offset;
+			int n = pos[i]++;
+			m_rcol[n] = j;
+			m_rpos[n] = k - m_offset;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 {
@@ -173,6 +268,9 @@ void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 
 	// create the stiffness matrix
 	CompactMatrix::alloc(nr, nc, nsize, pvalues, pindices, pointers);
+
+	// the row index is rebuilt on the next multiplication
+	m_rptr.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -221,8 +319,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
-					#pragma omp atomic
-					pm[n] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
@@ -257,8 +359,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 				for (int n = 0; n<l; ++n) 
 					if (pi[n] - m_offset == I)
 					{
-						#pragma omp atomic
-						pv[n] += ke[i][j];
+						if (m_batomic)
+						{
+							#pragma omp atomic
+							pv[n] += ke[i][j];
+						}
+						else pv[n] += ke[i][j];
 						break;
 					}
 			}
@@ -289,8 +395,12 @@ void CompactSymmMatrix::add(int i, int j, double v)
 			int m = pi[n];
 			if (m == i)
 			{
-				#pragma omp atomic
-				pd[n] += v;
+				if (m_batomic)
+				{
+					#pragma omp atomic
+					pd[n] += v;
+				}
+				else pd[n] += v;
 				return;
 			}
 			else if (m < i)
@@ -86,4 +86,18 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+	//! Get the row-wise index of the strictly lower-triangular entries. For each row i, the 
+	//! entries rptr[i] to rptr[i+1] give the column and the position in the values array.
+	//! Together with column i, this gives access to all the entries of row i.
+	void GetRowIndex(const int*& rptr, const int*& rcol, const int*& rpos);
+
+private:
+	//! build the row-wise index of the lower-triangular entries, if necessary
+	void UpdateRowIndex();
+
+private:
+	std::vector<int>	m_rptr;	//!< start of each row in m_rcol and m_rpos
+	std::vector<int>	m_rcol;	//!< column of each strictly lower-triangular entry
+	std::vector<int>	m_rpos;	//!< position of each strictly lower-triangular entry in the values array
 };
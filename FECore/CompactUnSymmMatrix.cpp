@@ -223,8 +223,12 @@ void CRSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == J)
 				{
-#pragma omp atomic
-					pm[n] += kij;
+					if (m_batomic)
+					{
+	#pragma omp atomic
+						pm[n] += kij;
+					}
+					else pm[n] += kij;
 					break;
 				}
 		}
@@ -270,8 +274,12 @@ void CRSSparseMatrix::add(int i, int j, double v)
 		int m = pi[n];
 		if (m == j)
 		{
-#pragma omp atomic
-			pd[n] += v;
+			if (m_batomic)
+			{
+	#pragma omp atomic
+				pd[n] += v;
+			}
+			else pd[n] += v;
 			return;
 		}
 		else if (m < j)
@@ -633,8 +641,12 @@ void CCSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
-#pragma omp atomic
-					pm[n] += ke[i][j];
+					if (m_batomic)
+					{
+	#pragma omp atomic
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
@@ -680,8 +692,12 @@ void CCSSparseMatrix::add(int i, int j, double v)
 		int m = pi[n];
 		if (m == i)
 		{
-#pragma omp atomic
-			pd[n] += v;
+			if (m_batomic)
+			{
+	#pragma omp atomic
+				pd[n] += v;
+			}
+			else pd[n] += v;
 			return;
 		}
 		else if (m < i)
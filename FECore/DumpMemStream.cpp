@@ -57,9 +57,13 @@ void DumpMemStream::clear()
 }
 
 //-----------------------------------------------------------------------------
+//! Opening the stream for writing truncates it, but keeps the allocated buffer,
+//! so that a stream that is written repeatedly (e.g. for time step retries) 
+//! only needs to grow once.
 void DumpMemStream::Open(bool bsave, bool bshallow)
 {
 	DumpStream::Open(bsave, bshallow);
+	if (bsave) m_nsize = 0;
 	if (m_pb) set_position(0);
 }
 
@@ -98,6 +102,12 @@ void DumpMemStream::grow_buffer(size_t l)
 	m_nreserved += l;
 }
 
+//-----------------------------------------------------------------------------
+void DumpMemStream::reserve(size_t n)
+{
+	if (n > m_nreserved) grow_buffer(n - m_nreserved);
+}
+
 //-----------------------------------------------------------------------------
 size_t DumpMemStream::write(const void* pd, size_t size, size_t count)
 {
@@ -45,6 +45,9 @@ public: // overloaded from base class
 	void clear();
 	void Open(bool bsave, bool bshallow);
 
+	//! make sure the buffer can hold at least n bytes
+	void reserve(size_t n);
+
 	size_t size() const { return m_nsize; }
 	size_t reserved() const { return m_nreserved; }
 	bool EndOfStream() const;
@@ -408,6 +408,13 @@ bool FEAnalysis::Solve()
 
 	// dump stream for running restarts
 	DumpMemStream dmp(fem);
+	if (m_timeController && (m_timeController->m_maxretries > 0))
+	{
+		// The nodal state is written as one block, so we can allocate it up front. 
+		// The rest of the snapshot grows the buffer on the first time step only, 
+		// since the buffer is reused for the following snapshots.
+		dmp.reserve(fem.GetMesh().NodalStateSize());
+	}
 
 	// repeat for all timesteps
 	if (m_timeController) m_timeController->m_nretries = 0;
@@ -417,7 +424,8 @@ bool FEAnalysis::Solve()
 		// we need to retry this time step
 		if (m_timeController && (m_timeController->m_maxretries > 0))
 		{ 
-			dmp.clear();
+			// this reuses the buffer of the previous snapshot
+			dmp.Open(true, true);
 			fem.Serialize(dmp); 
 		}
 
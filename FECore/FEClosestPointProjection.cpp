@@ -33,26 +33,27 @@ SOFTWARE.*/
 
 //-----------------------------------------------------------------------------
 // constructor
-FEClosestPointProjection::FEClosestPointProjection(FESurface& s) : m_surf(s)
+// The search structures are owned by the surface, so they are only built once
+// and shared by all projections onto the same surface.
+FEClosestPointProjection::FEClosestPointProjection(FESurface& s) : m_surf(s), m_bvh(s.SpatialIndex()), m_NEL(s.NodeElemList()), m_EEL(s.ElemElemList())
 {
 	// set default options
 	m_tol = 0.01;
 	m_rad = 0.0;	// 0 means don't use search radius
 	m_bspecial = false;
 	m_projectBoundary = false;
-
-	// calculate node-element list
-	m_NEL.Create(m_surf);
-	m_EEL.Create(&m_surf);
 }
 
 //-----------------------------------------------------------------------------
 //! Initialization of data structures
 bool FEClosestPointProjection::Init()
 {
-	// initialize the nearest neighbor search
-	m_SNQ.Attach(&m_surf);
-	m_SNQ.Init();
+	// make sure the topology lists are up to date
+	m_surf.NodeElemList();
+	m_surf.ElemElemList();
+
+	// update the nearest neighbor search to the current positions
+	m_bvh.Update();
 
 	return true;
 }
@@ -169,7 +170,7 @@ FESurfaceElement* FEClosestPointProjection::Project(const vec3d& x, vec3d& q, ve
 	FEMesh& mesh = *m_surf.GetMesh();
 
 	// let's find the closest node
-	int mn = m_SNQ.Find(x);
+	int mn = m_bvh.FindClosestNode(x);
 	if (mn < 0) return nullptr;
 
 	// make sure it is within the search radius
@@ -218,40 +219,16 @@ FESurfaceElement* FEClosestPointProjection::Project(int nodeIndex, vec3d& q, vec
 	// Find the closest surface node to x that:
 	// 1. is within the search radius
 	// 2. its star does not contain n
-	int mn = -1;	// local index of closest node
-	double d2min;	// min squared distance
-	int N = m_surf.Nodes();
 	double R2 = m_rad * m_rad;
-	for (int i = 0; i < N; ++i)
-	{
-		if (m_surf.NodeIndex(i) != nodeIndex)
-		{
-			vec3d r = m_surf.Node(i).m_rt;
-			double d2 = (r - x)*(r - x);
+	int mn = m_bvh.FindClosestNode(x, R2, [&](int i) {
+		if (m_surf.NodeIndex(i) == nodeIndex) return false;
 
-			// make sure the node lies within the search radius
-			if ((m_rad == 0) || (d2 <= R2))
-			{
-				bool bok = true;
-
-				// The node cannot be part of the star of the closest point
-				FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
-				if (patch.HasNode(nodeIndex))
-				{
-					bok = false;
-				}
-
-				// make sure the point is closer than the last one
-				if (bok && ((mn == -1) || (d2 < d2min)))
-				{
-					d2min = d2;
-					mn = i;
-					q = r;
-				}
-			}
-		}
-	}
+		// The node cannot be part of the star of the closest point
+		FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
+		return (patch.HasNode(nodeIndex) == false);
+	});
 	if (mn == -1) return nullptr;
+	q = m_surf.Node(mn).m_rt;
 
 	// now that we found the closest node, lets see if we can find 
 	// the best element
@@ -299,38 +276,16 @@ FESurfaceElement* FEClosestPointProjection::Project(FESurfaceElement* pse, int i
 	}
 
 	// find the closest point
-	int mn = -1;
-	double d2min;
 	double R2 = m_rad * m_rad;
-	int N = m_surf.Nodes();
-	for (int i = 0; i < N; ++i)
-	{
-		vec3d ri = m_surf.Node(i).m_rt;
-		double d2 = (ri - x)*(ri - x);
+	int mn = m_bvh.FindClosestNode(x, R2, [&](int i) {
+		if (check_self_projection == false) return true;
 
-		// make sure the node lies within the search radius
-		if ((R2 == 0) || (d2 <= R2))
-		{
-			bool bok = true;
-			if (check_self_projection)
-			{
-				// The pse element cannot be part of the star of the closest point
-				FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
-				if (patch.Contains(*pse))
-				{
-					bok = false;
-				}
-			}
-
-			if (bok && ((mn == -1) || (d2 < d2min)))
-			{
-				d2min = d2;
-				mn = i;
-				q = ri;
-			}
-		}
-	}
+		// The pse element cannot be part of the star of the closest point
+		FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
+		return (patch.Contains(*pse) == false);
+	});
 	if (mn == -1) return nullptr;
+	q = m_surf.Node(mn).m_rt;
 
 	// mn is a local index, so get the global node number too
 	int m = m_surf.NodeIndex(mn);
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FENNQuery.h"
 #include "FEElemElemList.h"
 #include "FENodeElemList.h"
+#include "FESurfaceBVH.h"
 
 //-----------------------------------------------------------------------------
 // This class can be used to find the closest point projection of a point
@@ -81,7 +82,7 @@ protected:
 
 protected:
 	FESurface&		m_surf;		//!< reference to surface
-	FENNQuery		m_SNQ;		//!< used to find the nearest neighbour
-	FENodeElemList	m_NEL;		//!< node-element tree
-	FEElemElemList	m_EEL;		//!< element neighbor list
+	FESurfaceBVH&	m_bvh;		//!< used to find the nearest neighbour
+	FENodeElemList&	m_NEL;		//!< node-element tree
+	FEElemElemList&	m_EEL;		//!< element neighbor list
 };
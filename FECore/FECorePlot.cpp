@@ -262,6 +262,38 @@ void FEPlotParameter::Serialize(DumpStream& ar)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// Write the nodal projection of a scalar parameter. The parameter is evaluated 
+// at all the integration points of an element at once.
+static void writeNodalProjectedParamValues(FEDomain& dom, FEDataStream& ar, FEParamDouble& p)
+{
+	int NE = dom.Elements();
+	vector<size_t> off(NE + 1, 0);
+	for (int i = 0; i < NE; ++i) off[i + 1] = off[i] + dom.ElementRef(i).Nodes();
+	size_t n0 = ar.allocate<double>(off[NE]);
+
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i < NE; ++i)
+	{
+		const FEMaterialPoint* mp[FEElement::MAX_INTPOINTS];
+		double si[FEElement::MAX_INTPOINTS];
+		double sn[FEElement::MAX_NODES];
+
+		FEElement& e = dom.ElementRef(i);
+		int ne = e.Nodes();
+		int ni = e.GaussPoints();
+
+		// evaluate the parameter at the integration points
+		for (int k = 0; k < ni; ++k) mp[k] = e.GetMaterialPoint(k);
+		p(mp, ni, si);
+
+		// project to nodes
+		e.project_to_nodes(si, sn);
+
+		for (int j = 0; j < ne; ++j) ar.write(n0 + off[i] + j, sn[j]);
+	}
+}
+
 //-----------------------------------------------------------------------------
 // The Save function stores the material parameter data to the plot file.
 bool FEPlotParameter::Save(FEDomain& dom, FEDataStream& a)
@@ -317,7 +349,7 @@ bool FEPlotParameter::Save(FEDomain& dom, FEDataStream& a)
 				}
 			}
 
-			writeNodalProjectedElementValues<double>(sd, a, mapDouble);
+			writeNodalProjectedParamValues(sd, a, mapDouble);
 		}
 		else if (m_param.type() == FE_PARAM_VEC3D_MAPPED)
 		{
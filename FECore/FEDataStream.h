@@ -39,7 +39,7 @@ SOFTWARE.*/
 class FEDataStream
 {
 public:
-	FEDataStream(){}
+	FEDataStream() { m_bparallel = false; }
 
 	void clear() { m_a.clear(); }
 
@@ -109,11 +109,61 @@ public:
 
 	template <class T> T get(int i);
 
+public:
+	// The following functions write a value at a given position of a stream that was 
+	// resized in advance. This allows multiple threads to fill disjoint parts of the stream.
+	void write(size_t n, const double& f) { m_a[n] = (float)f; }
+	void write(size_t n, const vec3d& v)
+	{
+		float* p = &m_a[n];
+		p[0] = (float)v.x; p[1] = (float)v.y; p[2] = (float)v.z;
+	}
+	void write(size_t n, const mat3ds& m)
+	{
+		float* p = &m_a[n];
+		p[0] = (float)m.xx(); p[1] = (float)m.yy(); p[2] = (float)m.zz();
+		p[3] = (float)m.xy(); p[4] = (float)m.yz(); p[5] = (float)m.xz();
+	}
+	void write(size_t n, const mat3d& m)
+	{
+		float* p = &m_a[n];
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j) p[3*i + j] = (float)m(i, j);
+	}
+	void write(size_t n, const tens4ds& a)
+	{
+		float* p = &m_a[n];
+		for (int k = 0; k < 21; ++k) p[k] = (float)a.d[k];
+	}
+
+	// number of floats that a value of type T takes up in the stream
+	template <class T> static int components();
+
+	// Allocate room for n values of type T at the end of the stream and return
+	// the position of the first one.
+	template <class T> size_t allocate(size_t n)
+	{
+		size_t n0 = m_a.size();
+		m_a.resize(n0 + n*components<T>(), 0.f);
+		return n0;
+	}
+
+	// Set whether the data of this stream can be evaluated by multiple threads.
+	void setParallel(bool b) { m_bparallel = b; }
+	bool isParallel() const { return m_bparallel; }
+
 private:
 	std::vector<float>	m_a;
+	bool				m_bparallel;	//!< allow multi-threaded evaluation
 };
 
 template <class T> inline T FEDataStream::get(int i) { return T(0.0);  }
 
 template <> inline double FEDataStream::get<double>(int i) { return (double) m_a[i]; }
 template <> inline vec3d  FEDataStream::get<vec3d >(int i) { return vec3d(m_a[3*i], m_a[3*i+1], m_a[3*i+2]); }
+
+template <> inline int FEDataStream::components<double >() { return 1; }
+template <> inline int FEDataStream::components<vec3d  >() { return 3; }
+template <> inline int FEDataStream::components<mat3ds >() { return 6; }
+template <> inline int FEDataStream::components<mat3d  >() { return 9; }
+template <> inline int FEDataStream::components<tens4ds>() { return 21; }
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "DumpStream.h"
 #include "FEMesh.h"
 #include "FEGlobalMatrix.h"
+#include "sys.h"
 
 //-----------------------------------------------------------------------------
 FEDomain::FEDomain(int nclass, FEModel* fem) : FEMeshPartition(nclass, fem)
@@ -36,6 +37,30 @@ FEDomain::FEDomain(int nclass, FEModel* fem) : FEMeshPartition(nclass, fem)
 
 }
 
+//-----------------------------------------------------------------------------
+bool FEDomain::Init()
+{
+	if (FEMeshPartition::Init() == false) return false;
+
+	// size the element buffers for the largest element
+	int maxNodes = 0;
+	int NE = Elements();
+	for (int i = 0; i < NE; ++i)
+	{
+		int ne = ElementRef(i).Nodes();
+		if (ne > maxNodes) maxNodes = ne;
+	}
+	m_work.Reserve(maxNodes * GetDOFList().Size());
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::PrepareElementBuffers()
+{
+	m_work.Resize(omp_get_max_threads());
+}
+
 //-----------------------------------------------------------------------------
 void FEDomain::SetMaterial(FEMaterial* pm)
 {
@@ -57,7 +82,19 @@ void FEDomain::CreateMaterialPointData()
 {
 	FEMaterial* pmat = GetMaterial();
 	FEMesh* mesh = GetMesh();
-	if (pmat) ForEachElement([=](FEElement& el) {
+	if (pmat == nullptr) return;
+
+	// count the integration points
+	size_t nint = 0;
+	ForEachElement([&](FEElement& el) { nint += el.GaussPoints(); });
+
+	// The material points are allocated from the domain's pool, in element order. 
+	// All points of the material need the same amount of memory, so after the first
+	// one is created, we reserve a contiguous block for all the others.
+	FEMaterialPointArena::Scope scope(m_pool);
+	size_t n0 = m_pool.Allocated();
+	bool reserved = false;
+	ForEachElement([&](FEElement& el) {
 
 		vec3d r[FEElement::MAX_NODES];
 		int ne = el.Nodes();
@@ -69,6 +106,12 @@ void FEDomain::CreateMaterialPointData()
 			mp->m_r0 = el.Evaluate(r, k);
 			mp->m_index = k;
 			el.SetMaterialPointData(mp, k);
+
+			if (reserved == false)
+			{
+				m_pool.Reserve((m_pool.Allocated() - n0) * (nint - 1));
+				reserved = true;
+			}
 		}
 	});
 }
@@ -113,11 +156,18 @@ void FEDomain::Serialize(DumpStream& ar)
 			ar >> pmat;
 			SetMaterial(pmat);
 
+			// Delete the current material points, so that their memory can be reused 
+			// for the new ones. (The pool does not free the memory of deleted points.)
+			ForEachElement([](FEElement& el) { el.ClearData(); });
+			m_pool.Reset();
+
 			FE_Element_Spec espec; // invalid element spec!
 
 			int NEL = 0;
 			ar >> NEL;
 			Create(NEL, espec);
+
+			FEMaterialPointArena::Scope scope(m_pool);
 			for (int i = 0; i < NEL; ++i)
 			{
 				FEElement& el = ElementRef(i);
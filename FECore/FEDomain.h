@@ -28,6 +28,8 @@ SOFTWARE.*/
 
 #pragma once
 #include "FEMeshPartition.h"
+#include "FEElementWorkspace.h"
+#include "FEMaterialPointArena.h"
 
 // forward declaration of material class
 class FEMaterial;
@@ -53,6 +55,9 @@ public:
 	//! \todo Perhaps I can make this part of the "creation" routine
 	void CreateMaterialPointData();
 
+	//! initialization
+	bool Init() override;
+
 	// serialization
 	void Serialize(DumpStream& ar) override;
 
@@ -77,10 +82,22 @@ public:
 	//! Activate the domain
 	virtual void Activate();
 
+	//! Get the element scratch buffers of the calling thread.
+	//! These can be used in parallel element loops to avoid allocations.
+	FEElementBuffer& ElementBuffer() { return m_work.ThreadBuffer(); }
+
+	//! Make sure each thread has its own element buffers.
+	//! Call this before entering a parallel element loop that uses ElementBuffer().
+	void PrepareElementBuffers();
+
 protected:
 	// helper function for activating dof lists
 	void Activate(const FEDofList& dof);
 
 	// helper function for unpacking element dofs
 	void UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm);
+
+private:
+	FEMaterialPointArena	m_pool;	//!< memory pool for the material point data
+	FEElementWorkspace	m_work;	//!< per-thread scratch buffers for element loops
 };
@@ -0,0 +1,98 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEElementWorkspace.h"
+#include <assert.h>
+#include "sys.h"
+
+//-----------------------------------------------------------------------------
+FEElementWorkspace::FEElementWorkspace()
+{
+	m_ndof = 0;
+	Resize(omp_get_max_threads());
+}
+
+//-----------------------------------------------------------------------------
+// Make sure there are buffers for at least nthreads threads. Existing buffers
+// are kept. This must not be called from inside a parallel region.
+void FEElementWorkspace::Resize(int nthreads)
+{
+	if (nthreads < 1) nthreads = 1;
+	int n0 = (int)m_buf.size();
+	if (nthreads <= n0) return;
+
+	m_buf.resize(nthreads);
+	for (int i = n0; i < nthreads; ++i) Reserve(m_buf[i], m_ndof);
+}
+
+//-----------------------------------------------------------------------------
+// reserve space for elements with up to ndof degrees of freedom
+void FEElementWorkspace::Reserve(int ndof)
+{
+	m_ndof = ndof;
+	for (FEElementBuffer& buf : m_buf) Reserve(buf, ndof);
+}
+
+//-----------------------------------------------------------------------------
+void FEElementWorkspace::Reserve(FEElementBuffer& buf, int ndof)
+{
+	if (ndof <= 0) return;
+	buf.lm.reserve(ndof);
+	buf.fe.reserve(ndof);
+
+	// The element matrix only reallocates when its size changes. Since all the
+	// elements of a domain are usually of the same type, this allocates the
+	// memory that all elements will need.
+	buf.ke.resize(ndof, ndof);
+}
+
+//-----------------------------------------------------------------------------
+// return the buffers of the calling thread
+FEElementBuffer& FEElementWorkspace::ThreadBuffer()
+{
+	// The buffers cannot be added here, since other threads may be using them.
+	// Callers must call Resize before entering the parallel region. If they did
+	// not, we fall back to a buffer that is owned by the calling thread, since we
+	// cannot throw from inside a parallel region.
+	int n = omp_get_thread_num();
+	assert((n >= 0) && (n < (int)m_buf.size()));
+	if ((n < 0) || (n >= (int)m_buf.size()))
+	{
+		static thread_local FEElementBuffer tmp;
+		tmp.lm.clear();
+		tmp.fe.clear();
+		return tmp;
+	}
+	FEElementBuffer& buf = m_buf[n];
+
+	// empty the vectors, but keep their memory
+	buf.lm.clear();
+	buf.fe.clear();
+	return buf;
+}
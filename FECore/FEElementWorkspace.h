@@ -0,0 +1,70 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEGlobalMatrix.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Scratch buffers for evaluating and assembling the contributions of an element.
+class FECORE_API FEElementBuffer
+{
+public:
+	std::vector<int>	lm;		//!< element equation numbers
+	std::vector<double>	fe;		//!< element vector
+	FEElementMatrix		ke;		//!< element matrix
+};
+
+//-----------------------------------------------------------------------------
+//! This class manages one set of element buffers for each thread. Parallel 
+//! element loops can use these buffers instead of allocating new ones for each
+//! element. Since the buffers keep their memory, the loops no longer allocate
+//! once the buffers have grown to the largest element size.
+class FECORE_API FEElementWorkspace
+{
+public:
+	FEElementWorkspace();
+
+	//! Make sure there are buffers for at least nthreads threads.
+	//! Call this serially before entering a parallel element loop.
+	void Resize(int nthreads);
+
+	//! reserve space for elements with up to ndof degrees of freedom
+	void Reserve(int ndof);
+
+	//! Return the buffers of the calling thread.
+	//! The vectors are returned empty, but keep the memory they had allocated.
+	FEElementBuffer& ThreadBuffer();
+
+private:
+	void Reserve(FEElementBuffer& buf, int ndof);
+
+private:
+	std::vector<FEElementBuffer>	m_buf;	//!< buffers for each thread
+	int								m_ndof;	//!< reserved size of the buffers
+};
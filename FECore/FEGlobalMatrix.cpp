@@ -90,6 +90,10 @@ FEGlobalMatrix::FEGlobalMatrix(SparseMatrix* pK, bool del)
 	m_pMP = 0;
 	m_nlm = 0;
 	m_delA = del;
+
+	m_bsticky = false;
+	m_ndecay = 0;
+	m_nsticky = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -173,6 +177,18 @@ void FEGlobalMatrix::build_end()
 
 //-----------------------------------------------------------------------------
 bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
+{
+	// build the profile
+	BuildProfile(pfem, neq, breset);
+
+	// create the actual sparse matrix
+	CreateFromProfile();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::BuildProfile(FEModel* pfem, int neq, bool breset)
 {
 	// The first time we come here we build the "static" profile.
 	// This static profile stores the contribution to the matrix profile
@@ -213,9 +229,64 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 		// Add the "dynamic" profile
 		pfem->BuildMatrixProfile(*this, false);
 	}
+	// make sure the LM buffer is flushed
+	if (m_nlm > 0) build_flush();
+
+	m_nsticky++;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::CreateFromProfile()
+{
+	if (m_bsticky)
+	{
+		// add the entries of the previous profile, unless they have decayed
+		bool bdecay = ((m_ndecay > 0) && (m_nsticky > m_ndecay));
+		if ((bdecay == false) && (m_MPa.Rows() == m_pMP->Rows()) && (m_MPa.Columns() == m_pMP->Columns()))
+		{
+			m_pMP->Merge(m_MPa);
+		}
+		else m_nsticky = 0;
+
+		// store the profile so we can check if the matrix can be reused later
+		m_MPa = *m_pMP;
+	}
+
 	// All done! We can now finish building the profile and create 
 	// the actual sparse matrix. This is done in the following function
 	build_end();
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::SetStickyProfile(bool b, int ndecay)
+{
+	m_bsticky = b;
+	m_ndecay = ndecay;
+	if (b == false) m_MPa.Clear();
+}
+
+//-----------------------------------------------------------------------------
+bool FEGlobalMatrix::ReuseMatrix()
+{
+	if ((m_bsticky == false) || (m_pMP == nullptr)) return false;
+
+	// make sure the sparse matrix was created and has the right size
+	if ((m_pA == nullptr) || (m_pA->Rows() != m_pMP->Rows())) return false;
+
+	// see if the new profile is a subset of the one the matrix was created from
+	if (m_MPa.Contains(*m_pMP) == false) return false;
+
+	// Once the retained entries have decayed, the matrix is only reused if 
+	// it does not hold any retained entries. Otherwise, we recreate it so 
+	// that the retained entries are dropped.
+	if ((m_ndecay > 0) && (m_nsticky > m_ndecay))
+	{
+		if (m_pMP->Contains(m_MPa) == false) return false;
+		m_nsticky = 0;
+	}
+
+	// BuildProfile overwrote the profile, so we restore the profile of the matrix
+	*m_pMP = m_MPa;
 
 	return true;
 }
@@ -116,6 +116,12 @@ public:
 	//! construct the stiffness matrix from a FEM object
 	bool Create(FEModel* pfem, int neq, bool breset);
 
+	//! build the matrix profile from a FEM object, without creating the sparse matrix
+	void BuildProfile(FEModel* pfem, int neq, bool breset);
+
+	//! create the sparse matrix from the profile built in BuildProfile
+	void CreateFromProfile();
+
 	//! construct the stiffness matrix from a mesh
 	bool Create(FEMesh& mesh, int neq);
 
@@ -153,6 +159,19 @@ public:
 	//! get the sparse matrix profile
 	SparseMatrixProfile* GetSparseMatrixProfile() { return m_pMP; }
 
+public: // sticky profile
+	//! Turn the sticky profile on or off. In sticky mode, entries of previous profiles 
+	//! (e.g. from contact) are retained when the sparse matrix is created, so that the 
+	//! matrix only needs to be reallocated when new entries appear. The retained entries
+	//! are dropped at the first reallocation after ndecay reformations (0 = never).
+	void SetStickyProfile(bool b, int ndecay = 0);
+
+	//! See if the current sparse matrix can hold the profile built in BuildProfile, and
+	//! if so, restore the profile of the sparse matrix. (This is only done in sticky mode.)
+	//! Returns false when the matrix must be recreated, which includes the case where the 
+	//! retained entries have decayed.
+	bool ReuseMatrix();
+
 public:
 	void build_begin(int neq);
 	void build_add(std::vector<int>& lm);
@@ -170,4 +189,10 @@ protected:
 	SparseMatrixProfile		m_MPs;		//!< the "static" part of the matrix profile
 	vector< vector<int> >	m_LM;		//!< used for building the stiffness matrix
 	int	m_nlm;				//!< nr of elements in m_LM array
+
+	// sticky profile data
+	bool					m_bsticky;	//!< sticky profile flag
+	int						m_ndecay;	//!< nr of reformations after which retained entries are dropped
+	int						m_nsticky;	//!< nr of reformations since retained entries were last dropped
+	SparseMatrixProfile		m_MPa;		//!< profile the current sparse matrix was created from
 };
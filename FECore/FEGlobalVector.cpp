@@ -34,6 +34,7 @@ SOFTWARE.*/
 //-----------------------------------------------------------------------------
 FEGlobalVector::FEGlobalVector(FEModel& fem, vector<double>& R, vector<double>& Fr) : m_fem(fem), m_R(R), m_Fr(Fr)
 {
+	m_batomic = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -53,13 +54,21 @@ void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>&
 	{
 		int I = elm[i];
 		if ( I >= 0) {
+			if (m_batomic)
+			{
 #pragma omp atomic
-			R[I] += fe[i];
+				R[I] += fe[i];
+			}
+			else R[I] += fe[i];
 		}
 // TODO: Find another way to store reaction forces
 		else if (-I-2 >= 0) {
+			if (m_batomic)
+			{
 #pragma omp atomic
-			m_Fr[-I-2] -= fe[i];
+				m_Fr[-I-2] -= fe[i];
+			}
+			else m_Fr[-I-2] -= fe[i];
 		}
 	}
 }
@@ -74,8 +83,12 @@ void FEGlobalVector::Assemble(vector<int>& lm, vector<double>& fe)
 	{
 		int nid = lm[i];
 		if (nid >= 0) {
+			if (m_batomic)
+			{
 #pragma omp atomic
-			R[nid] += fe[i];
+				R[nid] += fe[i];
+			}
+			else R[nid] += fe[i];
 		}
 	}
 }
@@ -90,7 +103,11 @@ void FEGlobalVector::Assemble(int nodeId, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
+		if (m_batomic)
+		{
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
+		else m_R[n] += f;
 	}
 }
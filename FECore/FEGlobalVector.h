@@ -65,8 +65,17 @@ public:
 
 	operator std::vector<double>& () { return m_R; }
 
+	//! Set whether concurrent assembly into the same entries must be protected.
+	//! This can only be turned off when the caller guarantees that threads never
+	//! assemble into the same entries (e.g. colored element assembly).
+	void SetAtomicAssembly(bool b) { m_batomic = b; }
+
+	//! see if atomic assembly is used
+	bool AtomicAssembly() const { return m_batomic; }
+
 protected:
 	FEModel&			m_fem;	//!< model
 	std::vector<double>&		m_R;	//!< residual
 	std::vector<double>&		m_Fr;	//!< nodal reaction forces \todo I want to remove this
+	bool						m_batomic;	//!< use atomic updates during assembly
 };
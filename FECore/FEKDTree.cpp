@@ -0,0 +1,262 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEKDTree.h"
+#include <algorithm>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+// max number of points in a leaf
+const int MAX_LEAF_POINTS = 8;
+
+// max depth of the tree (the median split keeps the depth at log2(N))
+const int MAX_STACK = 128;
+
+// min number of queries for doing a batched search in parallel
+const int MIN_PARALLEL_QUERIES = 64;
+
+//-----------------------------------------------------------------------------
+// squared distance from x to the box (r0, r1)
+static double boxDistance2(const vec3d& x, const vec3d& r0, const vec3d& r1)
+{
+	double dx = (x.x < r0.x ? r0.x - x.x : (x.x > r1.x ? x.x - r1.x : 0.0));
+	double dy = (x.y < r0.y ? r0.y - x.y : (x.y > r1.y ? x.y - r1.y : 0.0));
+	double dz = (x.z < r0.z ? r0.z - x.z : (x.z > r1.z ? x.z - r1.z : 0.0));
+	return dx*dx + dy*dy + dz*dz;
+}
+
+//-----------------------------------------------------------------------------
+// See if point (a, ia) is closer than (b, ib), where a and b are squared distances. 
+// For equal distances, the point with the higher index is taken as the closest.
+static inline bool isCloser(double a, int ia, double b, int ib)
+{
+	return (a < b) || ((a == b) && (ia > ib));
+}
+
+//-----------------------------------------------------------------------------
+FEKDTree::FEKDTree()
+{
+
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::Clear()
+{
+	m_node.clear();
+	m_pt.clear();
+	m_idx.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::Build(const std::vector<vec3d>& points)
+{
+	Clear();
+	int N = (int)points.size();
+	if (N == 0) return;
+
+	m_pt = points;
+	m_idx.resize(N);
+	for (int i = 0; i < N; ++i) m_idx[i] = i;
+	m_node.reserve(2 * (N / MAX_LEAF_POINTS + 1));
+
+	BuildNode(0, N);
+
+	// store the points in leaf order, so that the leaves can be searched
+	// without the indirection
+	for (int i = 0; i < N; ++i) m_pt[i] = points[m_idx[i]];
+}
+
+//-----------------------------------------------------------------------------
+// Builds the subtree for the points [first, first+count), splitting at the
+// median along the longest axis. Note that m_pt is still in the original 
+// order while the tree is built.
+int FEKDTree::BuildNode(int first, int count)
+{
+	int n = (int)m_node.size();
+	m_node.push_back(NODE());
+	m_node[n].right = -1;
+	m_node[n].first = first;
+	m_node[n].count = count;
+
+	// find the bounding box
+	vec3d r0 = m_pt[m_idx[first]], r1 = r0;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		const vec3d& r = m_pt[m_idx[i]];
+		if (r.x < r0.x) r0.x = r.x;
+		if (r.y < r0.y) r0.y = r.y;
+		if (r.z < r0.z) r0.z = r.z;
+		if (r.x > r1.x) r1.x = r.x;
+		if (r.y > r1.y) r1.y = r.y;
+		if (r.z > r1.z) r1.z = r.z;
+	}
+	m_node[n].rmin = r0;
+	m_node[n].rmax = r1;
+	if (count <= MAX_LEAF_POINTS) return n;
+
+	vec3d d = r1 - r0;
+	int axis = ((d.x >= d.y) && (d.x >= d.z) ? 0 : (d.y >= d.z ? 1 : 2));
+
+	// split at the median
+	int half = count / 2;
+	std::vector<int>::iterator it = m_idx.begin() + first;
+	std::nth_element(it, it + half, it + count, [&](int a, int b) {
+		const vec3d& ra = m_pt[a];
+		const vec3d& rb = m_pt[b];
+		double va = (axis == 0 ? ra.x : (axis == 1 ? ra.y : ra.z));
+		double vb = (axis == 0 ? rb.x : (axis == 1 ? rb.y : rb.z));
+		return (va < vb) || ((va == vb) && (a < b));
+	});
+
+	m_node[n].count = 0;
+	BuildNode(first, half);
+	int right = BuildNode(first + half, count - half);
+	m_node[n].right = right;
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+int FEKDTree::FindNearest(const vec3d& x) const
+{
+	if (m_node.empty()) return -1;
+
+	int imin = -1;
+	double d2min = 0.0;
+
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const NODE& node = m_node[stack[--ns]];
+
+		// Skip this node if it cannot contain a closer point. Note that we don't skip
+		// nodes at the same distance, since they may contain a point with a higher index.
+		if ((imin >= 0) && (boxDistance2(x, node.rmin, node.rmax) > d2min)) continue;
+
+		if (node.right < 0)
+		{
+			for (int i = node.first; i < node.first + node.count; ++i)
+			{
+				vec3d r = m_pt[i] - x;
+				double d2 = r*r;
+				if ((imin == -1) || isCloser(d2, m_idx[i], d2min, imin))
+				{
+					imin = m_idx[i];
+					d2min = d2;
+				}
+			}
+		}
+		else
+		{
+			// visit the closest child first
+			int a = (int)(&node - &m_node[0]) + 1;
+			int b = node.right;
+			double da = boxDistance2(x, m_node[a].rmin, m_node[a].rmax);
+			double db = boxDistance2(x, m_node[b].rmin, m_node[b].rmax);
+			assert(ns + 2 <= MAX_STACK);
+			if (da <= db) { stack[ns++] = b; stack[ns++] = a; }
+			else { stack[ns++] = a; stack[ns++] = b; }
+		}
+	}
+
+	return imin;
+}
+
+//-----------------------------------------------------------------------------
+int FEKDTree::FindNearest(const vec3d& x, int k, std::vector<int>& closest) const
+{
+	int N = (int)m_pt.size();
+	if (N < k) k = N;
+	closest.resize(k);
+	if (k <= 0) return 0;
+
+	// the squared distances of the points found so far
+	std::vector<double> dist(k, 0.0);
+	int n = 0;
+
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const NODE& node = m_node[stack[--ns]];
+
+		// once we have k points, we can skip nodes that are farther than the last one
+		if ((n == k) && (boxDistance2(x, node.rmin, node.rmax) > dist[k - 1])) continue;
+
+		if (node.right < 0)
+		{
+			for (int i = node.first; i < node.first + node.count; ++i)
+			{
+				vec3d r = m_pt[i] - x;
+				double d2 = r*r;
+				int id = m_idx[i];
+				if ((n == k) && !isCloser(d2, id, dist[k - 1], closest[k - 1])) continue;
+
+				// insert the point in the sorted list
+				int m = 0;
+				while ((m < n) && !isCloser(d2, id, dist[m], closest[m])) ++m;
+				if (n < k) n++;
+				for (int l = n - 1; l > m; --l)
+				{
+					closest[l] = closest[l - 1];
+					dist[l] = dist[l - 1];
+				}
+				closest[m] = id;
+				dist[m] = d2;
+			}
+		}
+		else
+		{
+			// visit the closest child first
+			int a = (int)(&node - &m_node[0]) + 1;
+			int b = node.right;
+			double da = boxDistance2(x, m_node[a].rmin, m_node[a].rmax);
+			double db = boxDistance2(x, m_node[b].rmin, m_node[b].rmax);
+			assert(ns + 2 <= MAX_STACK);
+			if (da <= db) { stack[ns++] = b; stack[ns++] = a; }
+			else { stack[ns++] = a; stack[ns++] = b; }
+		}
+	}
+
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::FindNearest(const std::vector<vec3d>& x, int k, std::vector< std::vector<int> >& closest) const
+{
+	int N = (int)x.size();
+	closest.resize(N);
+#pragma omp parallel for schedule(dynamic, 64) if (N > MIN_PARALLEL_QUERIES)
+	for (int i = 0; i < N; ++i)
+	{
+		FindNearest(x[i], k, closest[i]);
+	}
+}
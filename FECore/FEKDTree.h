@@ -0,0 +1,80 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "vec3d.h"
+#include "fecore_api.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! k-d tree over a static point set, for (k-)nearest neighbour searches.
+//! The tree is built by splitting the points at the median along the longest
+//! axis of their bounding box, so it stays balanced for any point distribution.
+//! The queries don't modify the tree, so they can be done from multiple threads.
+class FECORE_API FEKDTree
+{
+	struct NODE
+	{
+		vec3d	rmin, rmax;	//!< bounding box of the points in this node
+		int		right;		//!< index of right child (left child is the next node), or -1 for leaves
+		int		first;		//!< first point in leaf
+		int		count;		//!< number of points in leaf
+	};
+
+public:
+	FEKDTree();
+
+	//! build the tree for the given points (the points are copied)
+	void Build(const std::vector<vec3d>& points);
+
+	//! remove all points
+	void Clear();
+
+	//! number of points in the tree
+	int Points() const { return (int)m_pt.size(); }
+
+	//! Find the point closest to x. Returns -1 if the tree is empty.
+	int FindNearest(const vec3d& x) const;
+
+	//! Find the k points closest to x. On return, closest contains the point 
+	//! indices in order of increasing distance. Points at equal distance are
+	//! ordered by decreasing index, which gives the same result as 
+	//! findNeirestNeighbors. Returns the number of points found.
+	int FindNearest(const vec3d& x, int k, std::vector<int>& closest) const;
+
+	//! Find the k closest points for each point in x. The queries are done in parallel.
+	void FindNearest(const std::vector<vec3d>& x, int k, std::vector< std::vector<int> >& closest) const;
+
+private:
+	int BuildNode(int first, int count);
+
+private:
+	std::vector<NODE>	m_node;	//!< nodes of the tree (in depth-first order)
+	std::vector<vec3d>	m_pt;	//!< points, sorted by leaf
+	std::vector<int>	m_idx;	//!< original index of the sorted points
+};
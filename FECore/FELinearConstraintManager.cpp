@@ -64,6 +64,7 @@ void FELinearConstraintManager::CopyFrom(const FELinearConstraintManager& lcm)
 		m_LinC.push_back(lc);
 	}
 	InitTable();
+	BuildTransform();
 }
 
 //-----------------------------------------------------------------------------
@@ -130,126 +131,91 @@ void FELinearConstraintManager::Serialize(DumpStream& ar)
 			m_LCT.resize(nr, nc);
 			ar.read(&m_LCT(0,0), sizeof(int), nr*nc);
 		}
+
+		// the mesh (and its equation numbers) was restored before the constraints
+		BuildTransform();
 	}
 }
 
 
 //-----------------------------------------------------------------------------
+//! The profile of the reduced system is built from the constraint transformation:
+//! the constrained dofs of each element are replaced by the child equations of their
+//! constraints, so each element contributes a single (expanded) entry to the profile.
+//! Note that this only considers the constraints that are connected to domain elements.
 void FELinearConstraintManager::BuildMatrixProfile(FEGlobalMatrix& G)
 {
 	int nlin = (int)m_LinC.size();
 	if (nlin == 0) return;
 
+	// equation numbers may have changed, so recompile the transformation
+	BuildTransform();
+
 	FEAnalysis* pstep = m_fem->GetCurrentStep();
-	FEMesh& mesh = m_fem->GetMesh();
 
-	// Add linear constraints to the profile
-	// TODO: we need to add a function build_add(lmi, lmj) for
-	// this type of "elements". Now we allocate too much memory
 	vector<int> lm, elm;
-
-	// do the cross-term
-	// TODO: I have to make this easier. For instance,
-	// keep a list that stores for each node the list of
-	// elements connected to that node.
-	// loop over all solid elements
 	for (int nd = 0; nd<pstep->Domains(); ++nd)
 	{
 		FEDomain& dom = *pstep->Domain(nd);
 		for (int i = 0; i<dom.Elements(); ++i)
 		{
 			FEElement& el = dom.ElementRef(i);
-			dom.UnpackLM(el, elm);
-			int ne = (int)elm.size();
-
-			// keep a list of the constraints this element connects to
-			vector<int> constraintList;
 
-			// see if this element connects to the 
-			// parent node of a linear constraint ...
+			// see if this element connects to the parent node of a linear constraint
+			bool bconstrained = false;
 			int m = el.Nodes();
+			int ncols = m_LCT.columns();
+			lm.clear();
 			for (int j = 0; j<m; ++j)
-			{	
-				int ncols = m_LCT.columns();
+			{
 				for (int k = 0; k<ncols; ++k)
 				{
 					int n = m_LCT(el.m_node[j], k);
 					if (n >= 0)
 					{
-						// ... it does so we need to connect the 
-						// element to the linear constraint
-						FELinearConstraint* plc = m_LinC[n];
-						constraintList.push_back(n);
-						
-						int ns = (int)plc->Size();
-
-						lm.resize(ne + ns);
-						for (int l = 0; l<ne; ++l) lm[l] = elm[l];
-
-						FELinearConstraint::dof_iterator is = plc->begin();
-						for (int l = ne; l<ne + ns; ++l, ++is) 
-						{
-							int neq = mesh.Node((*is)->node).m_ID[(*is)->dof];
-							lm[l] = neq;
-						}
-
-						G.build_add(lm);
+						// it does, so add the child equations of this constraint
+						bconstrained = true;
+						for (int l = m_Tptr[n]; l < m_Tptr[n + 1]; ++l) lm.push_back(m_Teq[l]);
 					}
 				}
 			}
 
-			// This replaces the commented out section below, which sets up the connectivity 
-			// for the constraint block of the stiffness matrix. 
-			// The problem is that this will only work for linear constraints that are connected
-			// the element, so not for constraints connected to contact "elements". Howerver, I
-			// don't think this was working anyway, so this is okay for now.
-			// TODO: Replace this with a more generic algorithm that looks at the matrix profile 
-			// directly instead of element by element. 
-			if (constraintList.empty() == false)
+			if (bconstrained)
 			{
-				// do the constraint term
-				int n = 0;
-				for (int i = 0; i<constraintList.size(); ++i) n += (int)m_LinC[constraintList[i]]->Size();
-				lm.resize(n);
-				n = 0;
-				for (int i = 0; i<constraintList.size(); ++i)
-				{
-					FELinearConstraint& lc = *m_LinC[constraintList[i]];
-					int ni = (int)lc.Size();
-					for (int j = 0; j<ni; ++j)
-					{
-						const FELinearConstraintDOF& sj = lc.GetChildDof(j);
-						int neq = mesh.Node(sj.node).m_ID[sj.dof];
-						lm[n++] = neq;
-					}
-				}
+				dom.UnpackLM(el, elm);
+				lm.insert(lm.end(), elm.begin(), elm.end());
 				G.build_add(lm);
 			}
 		}
 	}
+}
 
-	// do the constraint term
-	// NOTE: This block was replaced by the section above which reduces the size
-	// of the stiffness matrix, but might be less generic (altough not entirely sure
-	// about that). 
-/*	vector<FELinearConstraint>::iterator ic = m_LinC.begin();
-	int n = 0;
-	for (int i = 0; i<nlin; ++i, ++ic) n += (int) ic->m_childDof.size();
-	lm.resize(n);
-	ic = m_LinC.begin();
-	n = 0;
-	for (int i = 0; i<nlin; ++i, ++ic)
+//-----------------------------------------------------------------------------
+//! Compile the linear constraints into a sparse transformation that maps each
+//! constrained (parent) dof to the equations of its child dofs. 
+void FELinearConstraintManager::BuildTransform()
+{
+	FEMesh& mesh = m_fem->GetMesh();
+
+	int nlin = LinearConstraints();
+	m_Tptr.assign(nlin + 1, 0);
+	m_Toff.assign(nlin, false);
+	for (int i = 0; i < nlin; ++i) m_Tptr[i + 1] = m_Tptr[i] + (int)m_LinC[i]->Size();
+
+	m_Teq.resize(m_Tptr[nlin]);
+	m_Tval.resize(m_Tptr[nlin]);
+	for (int i = 0; i < nlin; ++i)
 	{
-		int ni = (int)ic->m_childDof.size();
-		vector<FELinearConstraintDOF>::iterator is = ic->m_childDof.begin();
-		for (int j = 0; j<ni; ++j, ++is) 
+		FELinearConstraint& lc = *m_LinC[i];
+		int n0 = m_Tptr[i];
+		for (int j = 0; j < (int)lc.Size(); ++j)
 		{
-			int neq = mesh.Node(is->node).m_ID[is->dof];
-			lm[n++] = neq;
+			const FELinearConstraintDOF& dofj = lc.GetChildDof(j);
+			m_Teq[n0 + j] = mesh.Node(dofj.node).m_ID[dofj.dof];
+			m_Tval[n0 + j] = dofj.val;
 		}
+		m_Toff[i] = (lc.GetOffset() != 0.0);
 	}
-	G.build_add(lm);
-*/
 }
 
 //-----------------------------------------------------------------------------
@@ -267,6 +233,9 @@ bool FELinearConstraintManager::Initialize()
 		if (lci.Init() == false) return false;
 	}
 
+	// the equation numbers are known at this point
+	BuildTransform();
+
 	return true;
 }
 
@@ -360,14 +329,15 @@ bool FELinearConstraintManager::Activate()
 		}
 	}
 
+	// keep the transformation consistent with the lookup table
+	BuildTransform();
+
 	return true;
 }
 
 //-----------------------------------------------------------------------------
 void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>& en, vector<int>& elm, vector<double>& fe)
 {
-	FEMesh& mesh = m_fem->GetMesh();
-
 	int ndof = (int)fe.size();
 	int ndn = ndof / (int)en.size();
 	const int nodes = (int)en.size();
@@ -381,20 +351,15 @@ void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>&
 			int l = m_LCT(en[nodei], i%ndn);
 			if (l >= 0)
 			{
-				// if so, get the linear constraint
-				FELinearConstraint& lc = *m_LinC[l];
 				assert(elm[i] == -1);
 
-				// now loop over all child nodes and
-				// add the contribution to the residual
-				int ns = (int)lc.Size();
-				FELinearConstraint::dof_iterator is = lc.begin();
-				for (int j = 0; j < ns; ++j, ++is)
+				// if so, add the contribution to the residual of the child dofs
+				for (int k = m_Tptr[l]; k < m_Tptr[l + 1]; ++k)
 				{
-					int I = mesh.Node((*is)->node).m_ID[(*is)->dof];
+					int I = m_Teq[k];
 					if (I >= 0)
 					{
-						double A = (*is)->val;
+						double A = m_Tval[k];
 #pragma omp atomic
 						R[I] += A*fe[i];
 					}
@@ -405,10 +370,12 @@ void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>&
 }
 
 //-----------------------------------------------------------------------------
+//! This applies the constraint transformation to the element matrix. Each constrained
+//! row (column) is replaced by the rows (columns) of the child equations of its constraint.
+//! This does not lock. The global matrix and residual are updated atomically, so 
+//! this can be called concurrently from the element assembly loops.
 void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<double>& R, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke)
 {
-	FEMesh& mesh = m_fem->GetMesh();
-
 	// make sure we have a node list
 	// (rigid matrices will not have the node list set and therefore should be ignored, since
 	// you cannot use rigid nodes in linear constraints)
@@ -420,109 +387,86 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 
 	SparseMatrix& K = *(&G);
 
+	// find the constraint of each dof
+	const int MAX_DOFS = 512;
+	int lcb[MAX_DOFS];
+	vector<int> lcv;
+	int* lc = lcb;
+	if (ndof > MAX_DOFS) { lcv.resize(ndof); lc = &lcv[0]; }
+
+	bool bconstrained = false;
+	for (int i = 0; i < ndof; ++i)
+	{
+		int nodei = i / ndn;
+		lc[i] = (nodei < nodes ? m_LCT(en[nodei], i%ndn) : -1);
+		if (lc[i] >= 0) bconstrained = true;
+	}
+	if (bconstrained == false) return;
+
 	// loop over all stiffness components 
 	// and correct for linear constraints
 	for (int i = 0; i<ndof; ++i)
 	{
-		int nodei = i / ndn;
-		int li = (nodei < nodes ? m_LCT(en[nodei], i%ndn) : -1);
+		int li = lc[i];
+
+		// rows that dof i maps to
+		int ni = 1;
+		const int* Ii = &lmi[i];
+		const double* ai = nullptr;
+		if (li >= 0)
+		{
+			assert(lmi[i] == -1);
+			ni = m_Tptr[li + 1] - m_Tptr[li];
+			Ii = &m_Teq[m_Tptr[li]];
+			ai = &m_Tval[m_Tptr[li]];
+		}
+
 		for (int j = 0; j < ndof; ++j)
 		{
-			int nodej = j / ndn;
-			int lj = (nodej < nodes ? m_LCT(en[nodej], j%ndn) : -1);
-			if ((li >= 0) && (lj < 0))
+			int lj = lc[j];
+			if ((li < 0) && (lj < 0)) continue;
+
+			// columns that dof j maps to
+			int nj = 1;
+			const int* Jj = &lmj[j];
+			const double* aj = nullptr;
+			if (lj >= 0)
 			{
-				// dof i is constrained
-				FELinearConstraint& Li = *m_LinC[li];
-
-				assert(lmi[i] == -1);
-
-				FELinearConstraint::dof_iterator is = Li.begin();
-				for (int k = 0; k < (int)Li.Size(); ++k, ++is)
-				{
-					int I = mesh.Node((*is)->node).m_ID[(*is)->dof];
-					int J = lmj[j];
-					double kij = (*is)->val*ke[i][j];
-					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
-					else
-					{
-						// adjust for prescribed dofs
-						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
-					}
-				}
+				assert(lmj[j] == -1);
+				nj = m_Tptr[lj + 1] - m_Tptr[lj];
+				Jj = &m_Teq[m_Tptr[lj]];
+				aj = &m_Tval[m_Tptr[lj]];
 			}
-			else if ((lj >= 0) && (li < 0))
-			{
-				// dof j is constrained
-				FELinearConstraint& Lj = *m_LinC[lj];
 
-				assert(lmj[j] == -1);
+			double kij = ke[i][j];
+			for (int k = 0; k < ni; ++k)
+			{
+				int I = Ii[k];
+				if (I < 0) continue;
+				double ak = (ai ? ai[k] : 1.0)*kij;
 
-				FELinearConstraint::dof_iterator js = Lj.begin();
-				for (int k = 0; k < (int)Lj.Size(); ++k, ++js)
+				for (int l = 0; l < nj; ++l)
 				{
-					int I = lmi[i];
-					int J = mesh.Node((*js)->node).m_ID[(*js)->dof];
-					double kij = (*js)->val*ke[i][j];
-					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
+					int J = Jj[l];
+					double kkl = (aj ? aj[l] : 1.0)*ak;
+					if (J >= 0) K.add(I, J, kkl);
 					else
 					{
 						// adjust for prescribed dofs
 						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
-					}
-				}
-
-				// adjust right-hand side for inhomogeneous linear constraints
-				if (Lj.GetOffset() != 0.0)
-				{
-					double ri = ke[i][j] * m_up[lj];
-					int I = lmi[i];
-					if (I >= 0) R[I] -= ri;
-				}
-			}
-			else if ((li >= 0) && (lj >= 0))
-			{
-				// both dof i and j are constrained
-				FELinearConstraint& Li = *m_LinC[li];
-				FELinearConstraint& Lj = *m_LinC[lj];
-
-				FELinearConstraint::dof_iterator is = Li.begin();
-				FELinearConstraint::dof_iterator js = Lj.begin();
-
-				assert(lmi[i] == -1);
-				assert(lmj[j] == -1);
-
-				for (int k = 0; k < (int)Li.Size(); ++k, ++is)
-				{
-					js = Lj.begin();
-					for (int l = 0; l < (int)Lj.Size(); ++l, ++js)
-					{
-						int I = mesh.Node((*is)->node).m_ID[(*is)->dof];
-						int J = mesh.Node((*js)->node).m_ID[(*js)->dof];;
-						double kij = ke[i][j] * (*is)->val*(*js)->val;
-
-						if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
-						else
+						if (J >= 0)
 						{
-							// adjust for prescribed dofs
-							J = -J - 2;
-							if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+#pragma omp atomic
+							R[I] -= kkl*ui[J];
 						}
 					}
 				}
 
-				// adjust for inhomogeneous linear constraints
-				if (Lj.GetOffset() != 0.0)
+				// adjust right-hand side for inhomogeneous linear constraints
+				if ((lj >= 0) && m_Toff[lj])
 				{
-					is = Li.begin();
-					for (int k = 0; k < (int)Li.Size(); ++k, ++is)
-					{
-						int I = mesh.Node((*is)->node).m_ID[(*is)->dof];
-						double ri = (*is)->val * ke[i][j] * m_up[lj];
-						if (I >= 0) R[I] -= ri;
-					}
+#pragma omp atomic
+					R[I] -= ak*m_up[lj];
 				}
 			}
 		}
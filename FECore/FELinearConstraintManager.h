@@ -87,6 +87,9 @@ public:
 	// update nodal variables
 	void Update();
 
+	// compile the linear constraints into a sparse transformation
+	void BuildTransform();
+
 protected:
 	void InitTable();
 
@@ -95,4 +98,12 @@ private:
 	vector<FELinearConstraint*>	m_LinC;		//!< linear constraints data
 	table<int>					m_LCT;		//!< linear constraint table
 	vector<double>				m_up;		//!< the inhomogenous component of the linear constraint
+
+	// The linear constraints compiled to a sparse transformation, i.e. for each constraint the
+	// equation numbers and coefficients of the child dofs (in compressed row format).
+	// This needs to be rebuilt whenever the equation numbers change.
+	vector<int>		m_Tptr;		//!< start of each constraint in m_Teq, m_Tval
+	vector<int>		m_Teq;		//!< equation numbers of the child dofs
+	vector<double>	m_Tval;		//!< coefficients of the child dofs
+	vector<bool>	m_Toff;		//!< flag for inhomogeneous constraints
 };
@@ -35,6 +35,7 @@ SOFTWARE.*/
 FELinearSystem::FELinearSystem(FESolver* solver, FEGlobalMatrix& K, vector<double>& F, vector<double>& u, bool bsymm) : m_K(K), m_F(F), m_u(u), m_solver(solver)
 {
 	m_bsymm = bsymm;
+	m_batomic = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -57,6 +58,15 @@ FESolver* FELinearSystem::GetSolver()
 	return m_solver;
 }
 
+//-----------------------------------------------------------------------------
+// Set whether concurrent assembly must be protected with atomic updates.
+void FELinearSystem::SetAtomicAssembly(bool b)
+{
+	m_batomic = b;
+	SparseMatrix& K = m_K;
+	K.SetAtomicAssembly(b);
+}
+
 //-----------------------------------------------------------------------------
 //! assemble global stiffness matrix
 void FELinearSystem::Assemble(const FEElementMatrix& ke)
@@ -88,8 +98,12 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 				if (I >= 0)
 				{
 					// dof i is not a prescribed degree of freedom
+					if (m_batomic)
+					{
 #pragma omp atomic
-					m_F[I] -= ke[i][j] * m_u[J];
+						m_F[I] -= ke[i][j] * m_u[J];
+					}
+					else m_F[I] -= ke[i][j] * m_u[J];
 				}
 			}
 
@@ -98,8 +112,7 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 	}
 
-#pragma omp critical
-	{
+	// adjust for linear constraints
 	FEModel* fem = m_solver->GetFEModel();
 	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 	if (LCM.LinearConstraints())
@@ -107,7 +120,6 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		const vector<int>& en = ke.Nodes();
 		LCM.AssembleStiffness(m_K, m_F, m_u, en, lmi, lmj, ke);
 	}
-	} // omp critical
 }
 
 //-----------------------------------------------------------------------------
@@ -55,6 +55,11 @@ public:
 	// Get the solver that is using this linear system
 	FESolver* GetSolver();
 
+	// Set whether concurrent assembly must be protected with atomic updates.
+	// This can only be turned off when the caller guarantees that element matrices
+	// that are assembled concurrently do not share any nodes (e.g. colored assembly).
+	void SetAtomicAssembly(bool b);
+
 public:
 	// Assembly routine
 	// This assembles the element stiffness matrix ke into the global matrix.
@@ -70,6 +75,7 @@ public:
 
 protected:
 	bool					m_bsymm;	//!< symmetry flag
+	bool					m_batomic;	//!< use atomic updates during assembly
 	FESolver*				m_solver;
 	FEGlobalMatrix&			m_K;	//!< The global stiffness matrix
 	std::vector<double>&	m_F;	//!< Contributions from prescribed degrees of freedom
@@ -32,15 +32,29 @@ SOFTWARE.*/
 
 FELoadController::FELoadController(FEModel* fem) : FEModelComponent(fem)
 {
+	m_value = 0.0;
+	m_time = 0.0;
+	m_cached = false;
+}
+
+bool FELoadController::Init()
+{
+	Invalidate();
+	return FEModelComponent::Init();
 }
 
 void FELoadController::Evaluate(double time)
 {
+	if (m_cached && (time == m_time)) return;
+
 	m_value = GetValue(time);
+	m_time = time;
+	m_cached = DependsOnTimeOnly();
 }
 
 void FELoadController::Serialize(DumpStream& ar)
 {
 	FECoreBase::Serialize(ar);
 	ar & m_value;
+	if (ar.IsLoading()) Invalidate();
 }
@@ -40,6 +40,9 @@ class FECORE_API FELoadController : public FEModelComponent
 public:
 	FELoadController(FEModel* fem);
 
+	//! initialization
+	bool Init() override;
+
 	//! evaluate the load controller 
 	void Evaluate(double time);
 
@@ -49,10 +52,19 @@ public:
 	//! serialization
 	void Serialize(DumpStream& ar) override;
 
+	//! Controllers whose value only depends on time should return true. Their
+	//! value is then calculated only once for each time value.
+	virtual bool DependsOnTimeOnly() const { return false; }
+
+	//! force the value to be recalculated on the next call to Evaluate
+	void Invalidate() { m_cached = false; }
+
 protected:
 	// This must be implemented by derived classes
 	virtual double GetValue(double time) = 0;
 
 private:
 	double	m_value;	//!< last calculated value
+	double	m_time;		//!< time at which the last value was calculated
+	bool	m_cached;	//!< can the last value be reused?
 };
@@ -48,11 +48,13 @@ FELoadCurve::FELoadCurve(FEModel* fem) : FELoadController(fem)
 FELoadCurve::FELoadCurve(const FELoadCurve& lc) : FELoadController(lc)
 {
 	m_fnc = lc.m_fnc;
+	Invalidate();
 }
 
 void FELoadCurve::operator = (const FELoadCurve& lc)
 {
 	m_fnc = lc.m_fnc;
+	Invalidate();
 }
 
 FELoadCurve::~FELoadCurve()
@@ -117,6 +119,7 @@ bool FELoadCurve::CopyFrom(FELoadCurve* lc)
 	m_points = lc->m_points;
 
 	m_fnc = lc->m_fnc;
+	Invalidate();
 	return true;
 }
 
@@ -129,6 +132,7 @@ void FELoadCurve::Add(double time, double value)
 void FELoadCurve::Clear()
 {
 	m_fnc.Clear();
+	Invalidate();
 }
 
 void FELoadCurve::SetInterpolation(PointCurve::INTFUNC f)
@@ -67,6 +67,8 @@ public:
 
 	double GetValue(double time) override;
 
+	bool DependsOnTimeOnly() const override { return true; }
+
 private:
 	int		m_int;
 	int		m_ext;
@@ -112,6 +112,41 @@ void FEMaterialPoint::Serialize(DumpStream& ar)
 	{
 		ar & m_r0 & m_J0 & m_Jt;
 	}
+	else if (m_data && (ar.HasTypeInfo() == false))
+	{
+		// if all the data supports fast state snapshots, we copy the state 
+		// as a single block instead of serializing each item
+		int nsize = 0;
+		for (FEMaterialPointData* pd = m_data; pd; pd = pd->Next())
+		{
+			int n = pd->StateSize();
+			if (n < 0) { nsize = -1; break; }
+			nsize += n;
+		}
+
+		if (nsize >= 0)
+		{
+			const int MAX_STATE = 1024;
+			char buf[MAX_STATE];
+			std::vector<char> tmp;
+			char* pb = buf;
+			if (nsize > MAX_STATE) { tmp.resize(nsize); pb = &tmp[0]; }
+
+			if (ar.IsSaving())
+			{
+				char* p = pb;
+				for (FEMaterialPointData* pd = m_data; pd; pd = pd->Next()) { pd->SaveState(p); p += pd->StateSize(); }
+				ar.write(pb, 1, nsize);
+			}
+			else
+			{
+				ar.read(pb, 1, nsize);
+				const char* p = pb;
+				for (FEMaterialPointData* pd = m_data; pd; pd = pd->Next()) { pd->RestoreState(p); p += pd->StateSize(); }
+			}
+			return;
+		}
+	}
 	if (m_data) m_data->Serialize(ar);
 }
 
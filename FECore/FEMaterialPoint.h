@@ -31,11 +31,35 @@ SOFTWARE.*/
 #include "mat3d.h"
 #include "quatd.h"
 #include "FETimeInfo.h"
+#include "FEMaterialPointArena.h"
 #include <vector>
+#include <string.h>
+#include <typeinfo>
 
 class FEElement;
 class FEMaterialPoint;
 
+//-----------------------------------------------------------------------------
+// Location of a material point data item in the list of a material point, as
+// found by ExtractData. All the points of a material have the same data list,
+// so once we know where an item is, we can find it again by checking the types
+// of the list items, instead of searching the list with dynamic casts.
+struct FEMaterialPointDataLocation
+{
+	enum { MAX_DEPTH = 4 };
+
+	const std::type_info*	type[MAX_DEPTH];	// types of the list items, up to the one that was found
+	int			depth;		// index of the item (or -1 if not set)
+	ptrdiff_t	offset;		// offset of the requested type within the item
+};
+
+// the last location found by ExtractData<T> on this thread
+template <class T> inline FEMaterialPointDataLocation& FEMaterialPointDataLastLocation()
+{
+	static thread_local FEMaterialPointDataLocation loc = { { nullptr }, -1, 0 };
+	return loc;
+}
+
 //-----------------------------------------------------------------------------
 //! Material point class
 
@@ -52,6 +76,10 @@ public:
 	FEMaterialPointData(FEMaterialPointData* ppt = 0);
 	virtual ~FEMaterialPointData();
 
+	// material point data can be allocated from the domain's memory pool
+	static void* operator new(size_t size) { return FEMaterialPointArena::New(size); }
+	static void operator delete(void* p) { FEMaterialPointArena::Delete(p); }
+
 public:
 	//! The init function is used to intialize data
 	virtual void Init();
@@ -66,6 +94,20 @@ public:
 	// serialization
 	virtual void Serialize(DumpStream& ar);
 
+public:
+	//! Fast state snapshots (used by shallow archives, e.g. for time step retries).
+	//! Classes can opt in by returning the size (in bytes) of their mutable state, and by
+	//! copying only that state (not the data of the next item in the list) to and from
+	//! a raw buffer. The default returns -1, in which case Serialize is used.
+	virtual int StateSize() const { return -1; }
+	virtual void SaveState(char* pb) const {}
+	virtual void RestoreState(const char* pb) {}
+
+protected:
+	// helper functions for SaveState and RestoreState
+	template <class T> static void SaveValue(char*& pb, const T& v) { memcpy(pb, &v, sizeof(T)); pb += sizeof(T); }
+	template <class T> static void RestoreValue(const char*& pb, T& v) { memcpy(&v, pb, sizeof(T)); pb += sizeof(T); }
+
 public:
 	//! Get the next material point data
 	FEMaterialPointData* Next() { return m_pNext; }
@@ -93,6 +135,14 @@ public:
 	template <class T> T* ExtractData();
 	template <class T> const T* ExtractData() const;
 
+private:
+	// find data of type T by searching the list
+	template <class T> T* FindData();
+
+	// these try to find the item at the given location and return null if the list doesn't match
+	FEMaterialPointData* DataAt(const FEMaterialPointDataLocation& loc);
+	void StoreLocation(FEMaterialPointDataLocation& loc, const FEMaterialPointData* pt, const void* p) const;
+
 protected:
 	FEMaterialPointData*	m_pNext;    //!< next data in the list
 	FEMaterialPointData*	m_pPrev;    //!< previous data in the list
@@ -107,6 +157,10 @@ public:
 	FEMaterialPoint(FEMaterialPointData* data = nullptr);
 	virtual ~FEMaterialPoint();
 
+	// material points can be allocated from the domain's memory pool
+	static void* operator new(size_t size) { return FEMaterialPointArena::New(size); }
+	static void operator delete(void* p) { FEMaterialPointArena::Delete(p); }
+
 	//! The init function is used to intialize data
 	virtual void Init();
 
@@ -152,12 +206,57 @@ protected:
 	FEMaterialPointData* m_data;
 };
 
+//-----------------------------------------------------------------------------
+inline FEMaterialPointData* FEMaterialPointData::DataAt(const FEMaterialPointDataLocation& loc)
+{
+	FEMaterialPointData* pt = this;
+	for (int i = 0; i < loc.depth; ++i)
+	{
+		if (&typeid(*pt) != loc.type[i]) return nullptr;
+		pt = pt->m_pNext;
+		if (pt == nullptr) return nullptr;
+	}
+	return (&typeid(*pt) == loc.type[loc.depth] ? pt : nullptr);
+}
+
+//-----------------------------------------------------------------------------
+inline void FEMaterialPointData::StoreLocation(FEMaterialPointDataLocation& loc, const FEMaterialPointData* pt, const void* p) const
+{
+	// find the depth of the item
+	int depth = 0;
+	const FEMaterialPointData* pi = this;
+	while (pi && (pi != pt) && (depth < FEMaterialPointDataLocation::MAX_DEPTH)) { pi = pi->m_pNext; depth++; }
+	if ((pi != pt) || (depth >= FEMaterialPointDataLocation::MAX_DEPTH)) return;
+
+	pi = this;
+	for (int i = 0; i <= depth; ++i, pi = pi->m_pNext) loc.type[i] = &typeid(*pi);
+	loc.offset = (const char*)p - (const char*)pt;
+	loc.depth = depth;
+}
+
 //-----------------------------------------------------------------------------
 template <class T> inline T* FEMaterialPointData::ExtractData()
+{
+	// the most common case is that we're looking for the first item
+	if (&typeid(*this) == &typeid(T)) return dynamic_cast<T*>(this);
+
+	// see if the data is where we found it last time
+	FEMaterialPointDataLocation& loc = FEMaterialPointDataLastLocation<T>();
+	if (loc.depth >= 0)
+	{
+		FEMaterialPointData* pt = DataAt(loc);
+		if (pt) return reinterpret_cast<T*>((char*)pt + loc.offset);
+	}
+
+	return FindData<T>();
+}
+
+//-----------------------------------------------------------------------------
+template <class T> inline T* FEMaterialPointData::FindData()
 {
 	// first see if this is the correct type
 	T* p = dynamic_cast<T*>(this);
-	if (p) return p;
+	if (p) { StoreLocation(FEMaterialPointDataLastLocation<T>(), this, p); return p; }
 
 	// check all the child classes 
 	FEMaterialPointData* pt = this;
@@ -165,7 +264,7 @@ template <class T> inline T* FEMaterialPointData::ExtractData()
 	{
 		pt = pt->m_pNext;
 		p = dynamic_cast<T*>(pt);
-		if (p) return p;
+		if (p) { StoreLocation(FEMaterialPointDataLastLocation<T>(), pt, p); return p; }
 	}
 
 	// search up
@@ -194,6 +293,17 @@ template <class T> inline T* FEMaterialPointData::ExtractData()
 //-----------------------------------------------------------------------------
 template <class T> inline const T* FEMaterialPointData::ExtractData() const
 {
+	// the most common case is that we're looking for the first item
+	if (&typeid(*this) == &typeid(T)) return dynamic_cast<const T*>(this);
+
+	// see if the data is where we found it last time
+	const FEMaterialPointDataLocation& loc = FEMaterialPointDataLastLocation<T>();
+	if (loc.depth >= 0)
+	{
+		const FEMaterialPointData* pt = const_cast<FEMaterialPointData*>(this)->DataAt(loc);
+		if (pt) return reinterpret_cast<const T*>((const char*)pt + loc.offset);
+	}
+
 	// first see if this is the correct type
 	const T* p = dynamic_cast<const T*>(this);
 	if (p) return p;
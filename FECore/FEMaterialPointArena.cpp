@@ -0,0 +1,150 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMaterialPointArena.h"
+#include <stdlib.h>
+#include <new>
+
+namespace {
+	// the arena that is active on this thread
+	thread_local FEMaterialPointArena* activeArena = nullptr;
+
+	// Every allocation is preceded by a header, so that Delete knows where
+	// the memory came from. The header also keeps the object 16-byte aligned.
+	enum { HEADER_SIZE = 16 };
+	enum { FROM_HEAP = 0x48454150, FROM_ARENA = 0x4152454E };
+
+	// default size of an arena block
+	const size_t BLOCK_SIZE = 1 << 20;
+
+	inline size_t align16(size_t n) { return (n + 15) & ~(size_t)15; }
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::Scope::Scope(FEMaterialPointArena& arena)
+{
+	m_prev = activeArena;
+	activeArena = &arena;
+}
+
+FEMaterialPointArena::Scope::~Scope()
+{
+	activeArena = m_prev;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::FEMaterialPointArena()
+{
+	m_allocated = 0;
+}
+
+FEMaterialPointArena::~FEMaterialPointArena()
+{
+	for (Block& b : m_block) free(b.data);
+	m_block.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointArena::Reset()
+{
+	// keep the largest block
+	size_t imax = 0;
+	for (size_t i = 1; i < m_block.size(); ++i)
+	{
+		if (m_block[i].size > m_block[imax].size) imax = i;
+	}
+	for (size_t i = 0; i < m_block.size(); ++i)
+	{
+		if (i != imax) free(m_block[i].data);
+	}
+	if (m_block.empty() == false)
+	{
+		Block b = m_block[imax];
+		b.used = 0;
+		m_block.assign(1, b);
+	}
+	m_allocated = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointArena::Reserve(size_t size)
+{
+	size = align16(size);
+	if (m_block.empty() == false)
+	{
+		Block& b = m_block.back();
+		if (b.size - b.used >= size) return;
+	}
+
+	Block b;
+	b.size = (size > BLOCK_SIZE ? size : BLOCK_SIZE);
+	b.used = 0;
+	b.data = (char*)malloc(b.size);
+	if (b.data == nullptr) throw std::bad_alloc();
+	m_block.push_back(b);
+}
+
+//-----------------------------------------------------------------------------
+void* FEMaterialPointArena::Allocate(size_t size)
+{
+	size = align16(size);
+	Reserve(size);
+	Block& b = m_block.back();
+	void* p = b.data + b.used;
+	b.used += size;
+	m_allocated += size;
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+void* FEMaterialPointArena::New(size_t size)
+{
+	size_t n = HEADER_SIZE + size;
+	char* p = nullptr;
+	if (activeArena)
+	{
+		p = (char*)activeArena->Allocate(n);
+		*((int*)p) = FROM_ARENA;
+	}
+	else
+	{
+		p = (char*)malloc(n);
+		if (p == nullptr) throw std::bad_alloc();
+		*((int*)p) = FROM_HEAP;
+	}
+	return p + HEADER_SIZE;
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointArena::Delete(void* p)
+{
+	if (p == nullptr) return;
+	char* h = (char*)p - HEADER_SIZE;
+	if (*((int*)h) == FROM_HEAP) free(h);
+}
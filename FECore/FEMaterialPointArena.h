@@ -0,0 +1,94 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+// Memory pool for material point data. A domain allocates the material points
+// of all its elements from its own pool, so that they are stored contiguously 
+// (in element and integration point order) instead of being scattered over the
+// heap. The pool is activated for the calling thread with a Scope object, which
+// redirects the operator new of FEMaterialPoint and FEMaterialPointData.
+// Memory is only returned when the pool is reset or destroyed (deleting a pooled
+// object calls its destructor, but does not free its memory).
+class FECORE_API FEMaterialPointArena
+{
+public:
+	// Route the material point allocations of the calling thread to an arena
+	// for the lifetime of this object.
+	class FECORE_API Scope
+	{
+	public:
+		Scope(FEMaterialPointArena& arena);
+		~Scope();
+
+	private:
+		FEMaterialPointArena* m_prev;
+	};
+
+public:
+	FEMaterialPointArena();
+	~FEMaterialPointArena();
+
+	// make sure that the next allocations, up to a total of size bytes, are stored contiguously
+	void Reserve(size_t size);
+
+	// allocate a block of memory (aligned to 16 bytes)
+	void* Allocate(size_t size);
+
+	// total nr of bytes allocated from this arena
+	size_t Allocated() const { return m_allocated; }
+
+	// Release all allocations, but keep the largest block for the next allocations.
+	// All the objects that were allocated from this arena must have been deleted.
+	void Reset();
+
+public:
+	// These implement the operator new and delete of the material point classes.
+	// Allocations are made from the active arena, or from the heap if there is none.
+	static void* New(size_t size);
+	static void Delete(void* p);
+
+private:
+	FEMaterialPointArena(const FEMaterialPointArena&) = delete;
+	void operator = (const FEMaterialPointArena&) = delete;
+
+private:
+	struct Block
+	{
+		char*	data;
+		size_t	size;
+		size_t	used;
+	};
+
+	std::vector<Block>	m_block;
+	size_t				m_allocated;
+};
@@ -39,6 +39,8 @@ public:
 
 	bool Init() override;
 
+	bool DependsOnTimeOnly() const override { return m_param.empty(); }
+
 protected:
 	double GetValue(double time) override;
 
@@ -83,20 +83,89 @@ int FEMesh::Nodes() const
 	return (int)m_Node.size(); 
 }
 
+//-----------------------------------------------------------------------------
+// returns the number of values per node in the nodal state if it is the same 
+// for all nodes, or -1 otherwise
+static int nodalStateSize(const vector<FENode>& nodes)
+{
+	if (nodes.empty()) return 0;
+	int nv = nodes[0].StateSize();
+	for (const FENode& node : nodes)
+	{
+		if (node.StateSize() != nv) return -1;
+	}
+	return nv;
+}
+
+//-----------------------------------------------------------------------------
+size_t FEMesh::NodalStateSize() const
+{
+	int nv = nodalStateSize(m_Node);
+	if (nv < 0) return sizeof(int);
+	return sizeof(int) + m_Node.size()*nv*sizeof(double);
+}
+
+//-----------------------------------------------------------------------------
+// For shallow archives without type info (e.g. the time step retry snapshots), the 
+// state of all the nodes is copied to a flat buffer that is written as one block, 
+// instead of serializing the nodes one field at a time. This requires that all 
+// nodes have the same number of dofs, otherwise the nodes are serialized as usual.
+void FEMesh::SerializeNodalState(DumpStream& ar)
+{
+	int nv = 0;
+	if (ar.IsSaving())
+	{
+		nv = nodalStateSize(m_Node);
+		ar << nv;
+	}
+	else ar >> nv;
+
+	if (nv < 0)
+	{
+		ar.LockPointerTable();
+		ar & m_Node;
+		ar.UnlockPointerTable();
+		return;
+	}
+
+	int NN = Nodes();
+	m_nodeState.resize((size_t)NN*nv);
+	if (ar.IsSaving())
+	{
+#pragma omp parallel for
+		for (int i = 0; i < NN; ++i) m_Node[i].SaveState(&m_nodeState[(size_t)i*nv]);
+		ar.write(m_nodeState.data(), sizeof(double), m_nodeState.size());
+	}
+	else
+	{
+		ar.read(m_nodeState.data(), sizeof(double), m_nodeState.size());
+#pragma omp parallel for
+		for (int i = 0; i < NN; ++i) m_Node[i].RestoreState(&m_nodeState[(size_t)i*nv]);
+	}
+}
+
 //-----------------------------------------------------------------------------
 void FEMesh::Serialize(DumpStream& ar)
 {
 	// clear the mesh if we are loading from an archive
 	if ((ar.IsShallow() == false) && (ar.IsLoading())) Clear();
 
-	// we don't want to store pointers to all the nodes
-	// mostly for efficiency, so we tell the archive not to store the pointers
-	ar.LockPointerTable();
+	if (ar.IsShallow() && (ar.HasTypeInfo() == false))
 	{
-		// store the node list
-		ar & m_Node;
+		// store the nodal state in one block
+		SerializeNodalState(ar);
+	}
+	else
+	{
+		// we don't want to store pointers to all the nodes
+		// mostly for efficiency, so we tell the archive not to store the pointers
+		ar.LockPointerTable();
+		{
+			// store the node list
+			ar & m_Node;
+		}
+		ar.UnlockPointerTable();
 	}
-	ar.UnlockPointerTable();
 
 	// stream domain data
 	ar & m_Domain;
@@ -222,6 +222,9 @@ public:
 	//! stream mesh data
 	void Serialize(DumpStream& dmp);
 
+	//! size (in bytes) of the nodal state in a shallow archive without type info
+	size_t NodalStateSize() const;
+
 	static void SaveClass(DumpStream& ar, FEMesh* p);
 	static FEMesh* LoadClass(DumpStream& ar, FEMesh* p);
 
@@ -282,6 +285,13 @@ private:
 	FEElementLUT*	m_LUT;
 
 	FEModel*	m_fem;
+
+	std::vector<double>	m_nodeState;	//!< buffer for the nodal state of shallow archives
+
+private:
+	//! stream the nodal state of a shallow archive
+	void SerializeNodalState(DumpStream& ar);
+
 private:
 	//! hide the copy constructor
 	FEMesh(FEMesh& m){}
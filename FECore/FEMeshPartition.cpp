@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include "DOFS.h"
 #include <string.h>
 #include "FEModel.h"
+#include "FEAnalysis.h"
+#include "FELinearConstraintManager.h"
 #include "DumpStream.h"
 
 //-----------------------------------------------------------------------------
@@ -159,6 +161,85 @@ bool FEMeshPartition::Init()
 	}
 #endif
 
+	// The element coloring is only needed for colored assembly, so it is built
+	// on first use (see UseColoredAssembly). Clear any old coloring here.
+	m_elemColor.clear();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Partition the elements in colors such that elements of the same color do not 
+// share nodes. This uses a greedy (first-fit) coloring of the element graph.
+// NOTE: This assumes that the local node numbering was set up in Init.
+void FEMeshPartition::BuildElementColoring()
+{
+	int NE = Elements();
+	int NN = Nodes();
+
+	// build the node-to-element table (using local node numbers)
+	vector<int> pval(NN + 1, 0);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		int ne = el.Nodes();
+		for (int j = 0; j < ne; ++j) pval[el.m_lnode[j] + 1]++;
+	}
+	for (int i = 0; i < NN; ++i) pval[i + 1] += pval[i];
+
+	vector<int> nelem(pval[NN]);
+	vector<int> pos(pval.begin(), pval.end() - 1);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		int ne = el.Nodes();
+		for (int j = 0; j < ne; ++j) nelem[pos[el.m_lnode[j]]++] = i;
+	}
+
+	// assign each element the lowest color not used by any of its neighbors
+	vector<int> color(NE, -1);
+	vector<int> tag;	// tag[c] == i if color c is taken by a neighbor of element i
+	int ncolors = 0;
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		int ne = el.Nodes();
+		for (int j = 0; j < ne; ++j)
+		{
+			int n = el.m_lnode[j];
+			for (int k = pval[n]; k < pval[n + 1]; ++k)
+			{
+				int c = color[nelem[k]];
+				if (c >= 0) tag[c] = i;
+			}
+		}
+
+		int c = 0;
+		while ((c < ncolors) && (tag[c] == i)) ++c;
+		if (c == ncolors) { tag.push_back(-1); ncolors++; }
+		color[i] = c;
+	}
+
+	// store the element lists
+	m_elemColor.assign(ncolors, vector<int>());
+	for (int i = 0; i < NE; ++i) m_elemColor[color[i]].push_back(i);
+}
+
+//-----------------------------------------------------------------------------
+// See if the element contributions should be assembled per color.
+bool FEMeshPartition::UseColoredAssembly()
+{
+	FEModel* fem = GetFEModel();
+	FEAnalysis* step = (fem ? fem->GetCurrentStep() : nullptr);
+	FESolver* solver = (step ? step->GetFESolver() : nullptr);
+	if ((solver == nullptr) || (solver->m_assembly_mode != COLORED_ASSEMBLY)) return false;
+
+	// linear constraints add contributions to the dofs of other nodes
+	if (fem->GetLinearConstraintManager().LinearConstraints() > 0) return false;
+
+	// the coloring is built on first use (and is not stored in restart files)
+	if (m_elemColor.empty()) BuildElementColoring();
+
 	return true;
 }
 
@@ -182,3 +263,26 @@ void FEMeshPartition::ForEachElement(std::function<void(FEElement& el)> f)
 	int NE = Elements();
 	for (int i = 0; i < NE; ++i) f(ElementRef(i));
 }
+
+//-----------------------------------------------------------------------------
+void FEMeshPartition::ForEachElementParallel(bool bcolored, std::function<void(int iel)> f)
+{
+	if (bcolored)
+	{
+		// process the colors in sequence and the elements of each color in parallel
+		int NC = ElementColors();
+		for (int c = 0; c < NC; ++c)
+		{
+			const vector<int>& elemList = m_elemColor[c];
+			int NE = (int)elemList.size();
+#pragma omp parallel for shared(f)
+			for (int i = 0; i < NE; ++i) f(elemList[i]);
+		}
+	}
+	else
+	{
+		int NE = Elements();
+#pragma omp parallel for shared(f)
+		for (int i = 0; i < NE; ++i) f(i);
+	}
+}
@@ -123,6 +123,26 @@ public:
 	// Loop over all elements
 	void ForEachElement(std::function<void(FEElement& el)> f);
 
+	// Loop over all elements in parallel and call f with the element index.
+	// If bcolored is true, the element colors are processed one after another, so that
+	// elements that are processed concurrently never share a node.
+	void ForEachElementParallel(bool bcolored, std::function<void(int iel)> f);
+
+public: // element coloring
+	//! Partition the elements in colors such that elements of the same color do not share nodes.
+	void BuildElementColoring();
+
+	//! return the number of element colors
+	int ElementColors() const { return (int)m_elemColor.size(); }
+
+	//! return the list of elements with a given color
+	const std::vector<int>& ElementColor(int i) const { return m_elemColor[i]; }
+
+	//! See if the element contributions should be assembled per color.
+	//! This is the case when the current solver requests colored assembly and 
+	//! no linear constraints couple the element dofs to other nodes.
+	bool UseColoredAssembly();
+
 public:
 	// This is an experimental feature.
 	// The idea is to let the class define what data it wants to export
@@ -145,6 +165,8 @@ protected:
 
 	bool	m_bactive;
 
+	std::vector< std::vector<int> >	m_elemColor;	//!< element coloring (lists of elements per color)
+
 private:
 	vector<FEDataExport*>	m_Data;	//!< list of data export classes
 };
@@ -147,7 +147,7 @@ public:
 	void PushState()
 	{
 		DumpMemStream& ar = m_dmp;
-		ar.clear(); // this also prepares the stream for writing
+		ar.Open(true, true); // this keeps the buffer from the previous state
 		m_fem->Serialize(ar);
 	}
 
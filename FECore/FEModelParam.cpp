@@ -105,6 +105,12 @@ FEScalarValuator* FEParamDouble::valuator()
 // is this a const value
 bool FEParamDouble::isConst() const { return m_val->isConst(); };
 
+void FEParamDouble::operator () (const FEMaterialPoint* const* pt, int n, double* out)
+{
+	m_val->evaluate(pt, n, out);
+	if (m_scl != 1.0) for (int i = 0; i < n; ++i) out[i] *= m_scl;
+}
+
 // get the const value (returns 0 if param is not const)
 double& FEParamDouble::constValue() { assert(isConst());  return *m_val->constValue(); }
 double FEParamDouble::constValue() const { assert(isConst()); return *m_val->constValue(); }
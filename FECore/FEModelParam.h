@@ -83,6 +83,9 @@ public:
 	// evaluate the parameter at a material point
 	double operator () (const FEMaterialPoint& pt) { return m_scl*(*m_val)(pt); }
 
+	// evaluate the parameter at n material points
+	void operator () (const FEMaterialPoint* const* pt, int n, double* out);
+
 	// is this a const value
 	bool isConst() const;
 
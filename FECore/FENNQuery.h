@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "vec3d.h"
 #include <vector>
 #include "fecore_api.h"
+#include "FEKDTree.h"
 
 class FESurface;
 
@@ -38,15 +39,6 @@ class FESurface;
 
 class FECORE_API FENNQuery
 {
-public:
-	struct NODE
-	{
-		int		i;	// index of node
-		vec3d	r;	// position of node
-		double	d1;	// distance to pivot 1
-		double	d2;	// distance to pivot 2
-	};
-
 public:
 	FENNQuery(FESurface* ps = 0);
 	virtual ~FENNQuery();
@@ -62,18 +54,11 @@ public:
 	int Find(vec3d x);	
 	int FindReference(vec3d x);	
 
-protected:
-	int FindRadius(double r);
-
 protected:
 	FESurface*	m_ps;	//!< the surface to search
-	std::vector<NODE>	m_bk;	// BK tree
-
-	vec3d	m_q1;	// pivot 1
-	vec3d	m_q2;	// pivot 2
-
-	int		m_imin;	// last found index
+	FEKDTree	m_tree;	//!< search tree over the surface nodes
 };
 
 // function for finding the k closest neighbors
+// (this does a linear search, so use FEKDTree for repeated searches on the same points)
 int FECORE_API findNeirestNeighbors(const std::vector<vec3d>& point, const vec3d& x, int k, std::vector<int>& closestNodes);
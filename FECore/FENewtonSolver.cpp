@@ -57,6 +57,8 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 		ADD_PARAMETER(m_breformtimestep     , "reform_each_time_step");
 		ADD_PARAMETER(m_breformAugment      , "reform_augment");
 		ADD_PARAMETER(m_bdivreform          , "diverge_reform");
+		ADD_PARAMETER(m_stickyProfile       , "sticky_profile");
+		ADD_PARAMETER(m_stickyDecay         , FE_RANGE_GREATER_OR_EQUAL(0), "sticky_profile_decay");
 //		ADD_PARAMETER(m_bdoreforms          , "do_reforms"  );
 		ADD_PARAMETER(m_Rmin, FE_RANGE_GREATER_OR_EQUAL(0.0), "min_residual");
 		ADD_PARAMETER(m_Rmax, FE_RANGE_GREATER_OR_EQUAL(0.0), "max_residual");
@@ -99,6 +101,9 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_force_partition = 0;
 	m_breformtimestep = true;
 	m_breformAugment = false;
+
+	m_stickyProfile = false;
+	m_stickyDecay = 10;
 }
 
 //-----------------------------------------------------------------------------
@@ -275,6 +280,20 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 {
 	{
 		TRACK_TIME(TimerID::Timer_Reform);
+
+		// With a sticky profile, we first build the new profile and see if it fits in the current
+		// matrix. If so, we can keep the matrix and the linear solver's symbolic factorization.
+		m_pK->SetStickyProfile(m_stickyProfile, m_stickyDecay);
+		if (m_stickyProfile)
+		{
+			m_pK->BuildProfile(GetFEModel(), m_neq, breset);
+			if (m_pK->ReuseMatrix())
+			{
+				feLogDebug("reusing stiffness matrix profile");
+				return true;
+			}
+		}
+
 		// clean up the solver
 		m_plinsolve->Destroy();
 
@@ -283,7 +302,10 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 
 		// create the stiffness matrix
 		feLog("===== reforming stiffness matrix:\n");
-		if (m_pK->Create(GetFEModel(), m_neq, breset) == false)
+		bool bret = true;
+		if (m_stickyProfile) m_pK->CreateFromProfile();
+		else bret = m_pK->Create(GetFEModel(), m_neq, breset);
+		if (bret == false)
 		{
 			feLogError("An error occured while building the stiffness matrix\n\n");
 			return false;
@@ -244,6 +244,8 @@ public:
 	FEGlobalMatrix*		m_pK;			//!< global stiffness matrix
     bool				m_breshape;		//!< Matrix reshape flag
 	bool				m_persistMatrix;//!< Don't delete stiffness matrix until necessary (if true, K is deleted at end of time step)
+	bool				m_stickyProfile;//!< keep matrix profile entries between reformations and reuse the matrix when possible
+	int					m_stickyDecay;	//!< nr of reformations after which retained profile entries are dropped (0 = never)
 
 	// data used by Quasin
 	vector<double> m_R0;	//!< residual at iteration i-1
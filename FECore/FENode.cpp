@@ -56,6 +56,34 @@ void FENode::SetDOFS(int n)
 	m_Fr.assign(n, 0.0);
 }
 
+//-----------------------------------------------------------------------------
+void FENode::SaveState(double* pd) const
+{
+	const vec3d* v[7] = { &m_rt, &m_at, &m_rp, &m_vp, &m_ap, &m_dt, &m_dp };
+	for (int i = 0; i < 7; ++i, pd += 3) { pd[0] = v[i]->x; pd[1] = v[i]->y; pd[2] = v[i]->z; }
+
+	const int ndof = dofs();
+	for (int i = 0; i < ndof; ++i) pd[i] = m_Fr[i];
+	pd += ndof;
+	for (int i = 0; i < ndof; ++i) pd[i] = m_val_t[i];
+	pd += ndof;
+	for (int i = 0; i < ndof; ++i) pd[i] = m_val_p[i];
+}
+
+//-----------------------------------------------------------------------------
+void FENode::RestoreState(const double* pd)
+{
+	vec3d* v[7] = { &m_rt, &m_at, &m_rp, &m_vp, &m_ap, &m_dt, &m_dp };
+	for (int i = 0; i < 7; ++i, pd += 3) *v[i] = vec3d(pd[0], pd[1], pd[2]);
+
+	const int ndof = dofs();
+	for (int i = 0; i < ndof; ++i) m_Fr[i] = pd[i];
+	pd += ndof;
+	for (int i = 0; i < ndof; ++i) m_val_t[i] = pd[i];
+	pd += ndof;
+	for (int i = 0; i < ndof; ++i) m_val_p[i] = pd[i];
+}
+
 //-----------------------------------------------------------------------------
 FENode::FENode(const FENode& n)
 {
@@ -93,6 +93,12 @@ public:
 	// Serialize
 	void Serialize(DumpStream& ar);
 
+	//! Fast state snapshots (used by shallow archives, e.g. for time step retries).
+	//! StateSize returns the number of values that SaveState copies to the buffer.
+	int StateSize() const { return 21 + 3*dofs(); }
+	void SaveState(double* pd) const;
+	void RestoreState(const double* pd);
+
 	//! Update nodal values, which copies the current values to the previous array
 	void UpdateValues();
 
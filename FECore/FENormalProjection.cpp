@@ -53,12 +53,12 @@ void FENormalProjection::Init()
 FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
+	vector<int> selist;
 	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
+	vector<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
@@ -97,12 +97,12 @@ FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
+	vector<int> selist;
 	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
+	vector<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
@@ -140,7 +140,7 @@ FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, double rs[2], int* pei)
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
+	vector<int> selist;
 	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
 
 	double g, gmax = -1e99, r2[2] = {rs[0], rs[1]};
@@ -148,7 +148,7 @@ FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, d
 	FESurfaceElement* pme = 0;
 
 	// loop over all surface element
-	set<int>::iterator it;
+	vector<int>::iterator it;
 	for (it = selist.begin(); it != selist.end(); ++it)
 	{
 		FESurfaceElement& el = m_surf.Element(*it);
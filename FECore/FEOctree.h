@@ -35,33 +35,9 @@ SOFTWARE.*/
 class FESurface;
 
 //-----------------------------------------------------------------------------
-//! This is a class for an octree node
-
-class OTnode
-{
-public:
-	OTnode() {}
-	~OTnode() {}
-	void Clear() {children.clear(); }
-	void CreateChildren(const int max_level, const int max_elem);
-	void FillNode(std::vector<int> parent_selist);
-	bool ElementIntersectsNode(const int j);
-	void PrintNodeContent();
-	bool RayIntersectsNode(vec3d p, vec3d n);
-	void FindIntersectedLeaves(vec3d p, vec3d n, std::set<int>& sel, double srad);
-	void CountNodes(int& nnode, int& nlevel);
-	
-public:
-	int				level;		//!< node level
-	vec3d			cmin, cmax;	//!< node bounding box
-	std::vector<int>		selist;		//!< list of surface elements inside this node
-	std::vector<OTnode>	children;	//!< children of this node
-	FESurface*		m_ps;		//!< the surface to search
-};
-
-//-----------------------------------------------------------------------------
-//! This class is a helper class to find ray intersection with a surface
-
+//! This is a helper class to find ray intersection with a surface.
+//! It uses the surface's spatial index (see FESurface::SpatialIndex), which
+//! is only refitted when the nodes move instead of being rebuilt every time.
 class FECORE_API FEOctree
 {
 	
@@ -77,10 +53,11 @@ public:
 	
 	//! find all candidate surface elements intersected by ray
 	void FindCandidateSurfaceElements(vec3d p, vec3d n, std::set<int>& sel, double srad);
+
+	//! find all candidate surface elements intersected by ray (returned in ascending order)
+	void FindCandidateSurfaceElements(const vec3d& p, const vec3d& n, std::vector<int>& sel, double srad);
 	
 protected:
 	FESurface*	m_ps;	//!< the surface to search
-	OTnode root;		//!< root node in octree
-	int max_level;		//!< maximum allowable number of levels in octree
-	int max_elem;		//!< maximum allowable number of elements in any node
+	double		m_tol;	//!< search tolerance
 };
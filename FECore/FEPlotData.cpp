@@ -39,6 +39,7 @@ FEPlotData::FEPlotData(FEModel* fem) : FECoreBase(fem)
 	m_arraySize = 0;
 	m_szdom[0] = 0;
 	m_szunit = nullptr;
+	m_bthreadSafe = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +53,7 @@ FEPlotData::FEPlotData(FEModel* fem, Region_Type R, Var_Type t, Storage_Fmt s) :
 	m_szdom[0] = 0;
 
 	m_szunit = nullptr;
+	m_bthreadSafe = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -118,6 +118,15 @@ public:
 	void SetUnits(const char* sz) { m_szunit = sz; }
 	const char* GetUnits() const { return m_szunit; }
 
+public:
+	// Plot data can be evaluated concurrently for different domains and elements.
+	// This is only done for classes that set this flag, which should only be set
+	// when Save (and the functions it calls) don't modify any shared state.
+	bool IsThreadSafe() const { return m_bthreadSafe; }
+
+protected:
+	void SetThreadSafe(bool b) { m_bthreadSafe = b; }
+
 private:
 	Region_Type		m_nregion;		//!< region type
 	Var_Type		m_ntype;		//!< data type
@@ -127,6 +136,7 @@ private:
 	const char*		m_szunit;
 	int				m_arraySize;	//!< size of arrays (used by arrays)
 	vector<string>	m_arrayNames;	//!< optional names of array components (used by arrays)
+	bool			m_bthreadSafe;	//!< can Save be called from multiple threads
 };
 
 //-----------------------------------------------------------------------------
@@ -65,6 +65,11 @@ FEPlotDataStore::FEPlotDataStore()
 {
     m_plot.clear();
     m_nplot_compression = 0;
+    m_bplot_async = false;
+    m_bplot_index = false;
+    m_nplot_delta = 0;
+    m_bplot_shuffle = false;
+    m_nplot_quantize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -72,6 +77,11 @@ FEPlotDataStore::FEPlotDataStore(const FEPlotDataStore& plt)
 {
     m_splot_type = plt.m_splot_type;
     m_nplot_compression = plt.m_nplot_compression;
+    m_bplot_async = plt.m_bplot_async;
+    m_bplot_index = plt.m_bplot_index;
+    m_nplot_delta = plt.m_nplot_delta;
+    m_bplot_shuffle = plt.m_bplot_shuffle;
+    m_nplot_quantize = plt.m_nplot_quantize;
     m_plot = plt.m_plot;
 }
 
@@ -80,6 +90,11 @@ void FEPlotDataStore::operator = (const FEPlotDataStore& plt)
 {
     m_splot_type = plt.m_splot_type;
     m_nplot_compression = plt.m_nplot_compression;
+    m_bplot_async = plt.m_bplot_async;
+    m_bplot_index = plt.m_bplot_index;
+    m_nplot_delta = plt.m_nplot_delta;
+    m_bplot_shuffle = plt.m_bplot_shuffle;
+    m_nplot_quantize = plt.m_nplot_quantize;
     m_plot = plt.m_plot;
 }
 
@@ -102,6 +117,66 @@ void FEPlotDataStore::SetPlotCompression(int n)
     m_nplot_compression = n;
 }
 
+//-----------------------------------------------------------------------------
+bool FEPlotDataStore::GetPlotAsync() const
+{
+    return m_bplot_async;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotAsync(bool b)
+{
+    m_bplot_async = b;
+}
+
+//-----------------------------------------------------------------------------
+bool FEPlotDataStore::GetPlotIndex() const
+{
+    return m_bplot_index;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotIndex(bool b)
+{
+    m_bplot_index = b;
+}
+
+//-----------------------------------------------------------------------------
+int FEPlotDataStore::GetPlotDeltaInterval() const
+{
+    return m_nplot_delta;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotDeltaInterval(int n)
+{
+    m_nplot_delta = n;
+}
+
+//-----------------------------------------------------------------------------
+bool FEPlotDataStore::GetPlotShuffle() const
+{
+    return m_bplot_shuffle;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotShuffle(bool b)
+{
+    m_bplot_shuffle = b;
+}
+
+//-----------------------------------------------------------------------------
+int FEPlotDataStore::GetPlotQuantizeBits() const
+{
+    return m_nplot_quantize;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotQuantizeBits(int n)
+{
+    m_nplot_quantize = n;
+}
+
 //-----------------------------------------------------------------------------
 void FEPlotDataStore::SetPlotFileType(const std::string& fileType)
 {
@@ -62,6 +62,22 @@ public:
 	int GetPlotCompression() const;
 	void SetPlotCompression(int n);
 
+	bool GetPlotAsync() const;
+	void SetPlotAsync(bool b);
+
+	bool GetPlotIndex() const;
+	void SetPlotIndex(bool b);
+
+	// pre-filters for plot compression
+	int GetPlotDeltaInterval() const;
+	void SetPlotDeltaInterval(int n);
+
+	bool GetPlotShuffle() const;
+	void SetPlotShuffle(bool b);
+
+	int GetPlotQuantizeBits() const;
+	void SetPlotQuantizeBits(int n);
+
 	void SetPlotFileType(const std::string& fileType);
 	std::string GetPlotFileType();
 
@@ -74,4 +90,9 @@ private:
 	std::string					m_splot_type;
 	std::vector<FEPlotVariable>	m_plot;
 	int							m_nplot_compression;
+	bool						m_bplot_async;	//!< write plot file on a background thread
+	bool						m_bplot_index;	//!< write a state index file
+	int							m_nplot_delta;	//!< key frame interval for delta filter (0 = off)
+	bool						m_bplot_shuffle;	//!< byte-shuffle filter
+	int							m_nplot_quantize;	//!< mantissa bits for quantization (0 = off)
 };
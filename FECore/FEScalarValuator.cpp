@@ -115,9 +115,8 @@ void FEMathExpression::operator = (const FEMathExpression& me)
 	m_vars = me.m_vars;
 }
 
-double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
+void FEMathExpression::setVariables(FEModel* fem, const FEMaterialPoint& pt, double* var)
 {
-	std::vector<double> var(4 + m_vars.size());
 	var[0] = pt.m_r0.x;
 	var[1] = pt.m_r0.y;
 	var[2] = pt.m_r0.z;
@@ -144,7 +143,52 @@ double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
 			}
 		}
 	}
-	return value_s(var);
+}
+
+double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
+{
+	// use a stack buffer for the common case of a few variables
+	const int MAX_VARS = 16;
+	int nvar = Variables();
+	if (nvar <= MAX_VARS)
+	{
+		double var[MAX_VARS];
+		setVariables(fem, pt, var);
+		return value_s(var);
+	}
+	else
+	{
+		std::vector<double> var(nvar);
+		setVariables(fem, pt, var.data());
+		return value_s(var.data());
+	}
+}
+
+void FEMathExpression::value(FEModel* fem, const FEMaterialPoint* const* pt, int n, double* out)
+{
+	// process the points in blocks, so we don't need to allocate memory
+	const int MAX_VARS = 16;
+	const int B = 64;
+	int nvar = Variables();
+	if (nvar > MAX_VARS)
+	{
+		for (int i = 0; i < n; ++i) out[i] = value(fem, *pt[i]);
+		return;
+	}
+
+	double var[MAX_VARS*B];
+	for (int i0 = 0; i0 < n; i0 += B)
+	{
+		int nb = (n - i0 < B ? n - i0 : B);
+		for (int k = 0; k < nb; ++k) setVariables(fem, *pt[i0 + k], var + k*nvar);
+		value_s(var, nvar, nb, out + i0);
+	}
+}
+
+//=============================================================================
+void FEScalarValuator::evaluate(const FEMaterialPoint* const* pt, int n, double* out)
+{
+	for (int i = 0; i < n; ++i) out[i] = (*this)(*pt[i]);
 }
 
 //=============================================================================
@@ -239,6 +283,11 @@ double FEMathValue::operator()(const FEMaterialPoint& pt)
 	return m_math.value(GetFEModel(), pt);
 }
 
+void FEMathValue::evaluate(const FEMaterialPoint* const* pt, int n, double* out)
+{
+	m_math.value(GetFEModel(), pt, n, out);
+}
+
 //---------------------------------------------------------------------------------------
 
 FEMappedValue::FEMappedValue(FEModel* fem) : FEScalarValuator(fem), m_val(nullptr)
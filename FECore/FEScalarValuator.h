@@ -44,6 +44,9 @@ public:
 
 	virtual double operator()(const FEMaterialPoint& pt) = 0;
 
+	// evaluate at n material points at once
+	virtual void evaluate(const FEMaterialPoint* const* pt, int n, double* out);
+
 	virtual FEScalarValuator* copy() = 0;
 
 	virtual bool isConst() { return false; }
@@ -87,6 +90,12 @@ public:
 
 	double value(FEModel* fem, const FEMaterialPoint& pt);
 
+	// evaluate the expression at n material points
+	void value(FEModel* fem, const FEMaterialPoint* const* pt, int n, double* out);
+
+private:
+	void setVariables(FEModel* fem, const FEMaterialPoint& pt, double* var);
+
 private:
 	std::vector<MathParam>	m_vars;
 };
@@ -99,6 +108,8 @@ public:
 	~FEMathValue();
 	double operator()(const FEMaterialPoint& pt) override;
 
+	void evaluate(const FEMaterialPoint* const* pt, int n, double* out) override;
+
 	bool Init() override;
 
 	FEScalarValuator* copy() override;
@@ -44,6 +44,7 @@ BEGIN_FECORE_CLASS(FESolver, FECoreBase)
 		ADD_PARAMETER(m_eq_scheme, "equation_scheme", 0, "staggered\0block\0");
 		ADD_PARAMETER(m_eq_order , "equation_order", 0, "default\0reverse\0febio2\0");
 		ADD_PARAMETER(m_bwopt    , "optimize_bw");
+		ADD_PARAMETER(m_assembly_mode, "assembly_mode", 0, "atomic\0colored\0");
 	END_PARAM_GROUP();
 END_FECORE_CLASS();
 
@@ -64,6 +65,8 @@ FESolver::FESolver(FEModel* fem) : FECoreBase(fem)
 
 	m_eq_scheme = EQUATION_SCHEME::STAGGERED;
 	m_eq_order = EQUATION_ORDER::NORMAL_ORDER;
+
+	m_assembly_mode = ASSEMBLY_MODE::ATOMIC_ASSEMBLY;
 }
 
 //-----------------------------------------------------------------------------
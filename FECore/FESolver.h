@@ -52,6 +52,20 @@ enum EQUATION_ORDER
 	FEBIO2_ORDER
 };
 
+//-----------------------------------------------------------------------------
+// Strategy for the parallel assembly of element contributions
+// ATOMIC : all elements are processed concurrently and updates of the global system are atomic
+// COLORED: elements are processed one color at a time. Elements of the same color 
+//          do not share nodes, so they can be assembled without synchronization.
+//          This is used by the stiffness and force loops of the elastic solid and shell 
+//          domains, and the biphasic and multiphasic solid domains. Other domains and
+//          contact interfaces always assemble atomically.
+enum ASSEMBLY_MODE
+{
+	ATOMIC_ASSEMBLY,
+	COLORED_ASSEMBLY
+};
+
 //-----------------------------------------------------------------------------
 // Solution variable
 class FESolutionVariable
@@ -191,6 +205,7 @@ public: //TODO Move these parameters elsewhere
 	int					m_msymm;		//!< matrix symmetry flag for linear solver allocation
 	int					m_eq_scheme;	//!< equation number scheme (used in InitEquations)
 	int					m_eq_order;		//!< normal or reverse ordering
+	int					m_assembly_mode;	//!< parallel assembly strategy (see ASSEMBLY_MODE)
 	int					m_neq;			//!< number of equations
 	std::vector<int>	m_part;			//!< partitions of linear system
 	std::vector<int>	m_dofMap;		//!< array stores for each equation the corresponding dof index
@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include "FEMesh.h"
 #include "FESolidDomain.h"
 #include "FEElemElemList.h"
+#include "FENodeElemList.h"
+#include "FESurfaceBVH.h"
 #include "DumpStream.h"
 #include "matrix.h"
 #include <FECore/log.h>
@@ -42,17 +44,68 @@ FESurface::FESurface(FEModel* fem) : FEMeshPartition(FE_DOMAIN_SURFACE, fem)
 	m_bitfc = false;
 	m_alpha = 1;
 	m_bshellb = false;
+
+	m_bvh = nullptr;
+	m_NEL = nullptr;
+	m_EEL = nullptr;
+	m_bNEL = false;
+	m_bEEL = false;
 }
 
 //-----------------------------------------------------------------------------
 FESurface::~FESurface()
 {
+	delete m_bvh;
+	delete m_NEL;
+	delete m_EEL;
+}
+
+//-----------------------------------------------------------------------------
+// The search structures are not deleted, since projections may keep pointers
+// to them. Instead, they are rebuilt on the next access.
+void FESurface::InvalidateSearchData()
+{
+	if (m_bvh) m_bvh->Invalidate();
+	m_bNEL = false;
+	m_bEEL = false;
+}
 
+//-----------------------------------------------------------------------------
+FESurfaceBVH& FESurface::SpatialIndex()
+{
+	if (m_bvh == nullptr) m_bvh = new FESurfaceBVH(this);
+	return *m_bvh;
+}
+
+//-----------------------------------------------------------------------------
+FENodeElemList& FESurface::NodeElemList()
+{
+	if (m_NEL == nullptr) m_NEL = new FENodeElemList;
+	if (m_bNEL == false)
+	{
+		m_NEL->Create(*this);
+		m_bNEL = true;
+	}
+	return *m_NEL;
+}
+
+//-----------------------------------------------------------------------------
+FEElemElemList& FESurface::ElemElemList()
+{
+	if (m_EEL == nullptr) m_EEL = new FEElemElemList;
+	if (m_bEEL == false)
+	{
+		m_EEL->Create(this);
+		m_bEEL = true;
+	}
+	return *m_EEL;
 }
 
 //-----------------------------------------------------------------------------
 void FESurface::Create(int nsize, int elemType)
 {
+	InvalidateSearchData();
+
 	m_el.resize(nsize);
 	for (int i = 0; i < nsize; ++i)
 	{
@@ -213,6 +266,9 @@ void FESurface::Update(const FETimeInfo& tp)
 //-----------------------------------------------------------------------------
 void FESurface::InitSurface()
 {
+	// the local node numbering may change
+	InvalidateSearchData();
+
 	// get the mesh to which this surface belongs
 	FEMesh& mesh = *GetMesh();
 
@@ -2152,6 +2208,9 @@ bool IntersectTri7(vec3d* y, vec3d r, vec3d n, double rs[2], double& g, double e
 //-----------------------------------------------------------------------------
 void FESurface::Invert()
 {
+	// this changes the edge numbering of the elements
+	InvalidateSearchData();
+
 	ForEachSurfaceElement([](FESurfaceElement& el) {
 		int tmp;
 		switch (el.Shape())
@@ -2222,6 +2281,7 @@ void FESurface::Serialize(DumpStream &ar)
 		// reallocate integration point data on loading
 		if (ar.IsSaving() == false)
 		{
+			InvalidateSearchData();
 			for (int i = 0; i < Elements(); ++i)
 			{
 				FESurfaceElement& el = Element(i);
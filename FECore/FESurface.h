@@ -41,6 +41,9 @@ class FEMesh;
 class FENodeSet;
 class FEFacetSet;
 class FELinearSystem;
+class FESurfaceBVH;
+class FENodeElemList;
+class FEElemElemList;
 
 //-----------------------------------------------------------------------------
 class FECORE_API FESurfaceMaterialPoint : public FEMaterialPoint
@@ -121,6 +124,24 @@ public:
     //! Set alpha parameter for intermediate time
     void SetAlpha(const double alpha) { m_alpha = alpha; }
 
+public:
+	// Search structures. These are created when first needed and are shared
+	// by all the projections onto this surface. They are rebuilt on the next
+	// access after the surface topology has changed.
+
+	//! spatial index over the surface elements (call its Update before searching)
+	FESurfaceBVH& SpatialIndex();
+
+	//! node-element list of this surface
+	FENodeElemList& NodeElemList();
+
+	//! element-element list of this surface
+	FEElemElemList& ElemElemList();
+
+protected:
+	//! mark the search structures as out of date
+	void InvalidateSearchData();
+
 public:
 
 	//! return number of surface elements
@@ -316,4 +337,11 @@ protected:
     bool                        m_bitfc;    //!< interface status
     double                      m_alpha;    //!< intermediate time fraction
 	bool						m_bshellb;	//!< true if this surface is the bottom of a shell domain
+
+private:
+	FESurfaceBVH*		m_bvh;	//!< spatial index
+	FENodeElemList*		m_NEL;	//!< node-element list
+	FEElemElemList*		m_EEL;	//!< element-element list
+	bool				m_bNEL;	//!< node-element list is up to date
+	bool				m_bEEL;	//!< element-element list is up to date
 };
@@ -0,0 +1,388 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FESurfaceBVH.h"
+#include "FESurface.h"
+#include <algorithm>
+#include <limits>
+
+//-----------------------------------------------------------------------------
+// max number of facets in a leaf
+const int MAX_LEAF_FACETS = 4;
+
+// max depth of the tree (the median split keeps the depth at log2(N))
+const int MAX_STACK = 128;
+
+//-----------------------------------------------------------------------------
+// surface area of a box
+static double boxArea(const vec3d& r0, const vec3d& r1)
+{
+	double w = r1.x - r0.x, h = r1.y - r0.y, d = r1.z - r0.z;
+	return 2.0*(w*h + h*d + d*w);
+}
+
+//-----------------------------------------------------------------------------
+// grow the box (r0, r1) so that it contains the box (a, b)
+static void boxAdd(vec3d& r0, vec3d& r1, const vec3d& a, const vec3d& b)
+{
+	if (a.x < r0.x) r0.x = a.x;
+	if (a.y < r0.y) r0.y = a.y;
+	if (a.z < r0.z) r0.z = a.z;
+	if (b.x > r1.x) r1.x = b.x;
+	if (b.y > r1.y) r1.y = b.y;
+	if (b.z > r1.z) r1.z = b.z;
+}
+
+//-----------------------------------------------------------------------------
+// squared distance from a point to a box
+static double boxDistance2(const vec3d& x, const vec3d& r0, const vec3d& r1)
+{
+	double dx = (x.x < r0.x ? r0.x - x.x : (x.x > r1.x ? x.x - r1.x : 0.0));
+	double dy = (x.y < r0.y ? r0.y - x.y : (x.y > r1.y ? x.y - r1.y : 0.0));
+	double dz = (x.z < r0.z ? r0.z - x.z : (x.z > r1.z ? x.z - r1.z : 0.0));
+	return dx*dx + dy*dy + dz*dz;
+}
+
+//-----------------------------------------------------------------------------
+// see if the box, inflated by d, contains the point p
+static bool boxContains(const vec3d& r0, const vec3d& r1, const vec3d& p, double d)
+{
+	return ((r0.x - d <= p.x) && (r1.x + d >= p.x) &&
+			(r0.y - d <= p.y) && (r1.y + d >= p.y) &&
+			(r0.z - d <= p.z) && (r1.z + d >= p.z));
+}
+
+//-----------------------------------------------------------------------------
+// see if the (infinite) line through p with direction n intersects the box, inflated by d
+static bool lineIntersectsBox(const vec3d& r0, const vec3d& r1, const vec3d& p, const vec3d& n, double d)
+{
+	double tmin = -std::numeric_limits<double>::max();
+	double tmax =  std::numeric_limits<double>::max();
+	const double a[3] = { r0.x - d, r0.y - d, r0.z - d };
+	const double b[3] = { r1.x + d, r1.y + d, r1.z + d };
+	const double q[3] = { p.x, p.y, p.z };
+	const double m[3] = { n.x, n.y, n.z };
+	for (int i = 0; i < 3; ++i)
+	{
+		if (m[i] == 0.0)
+		{
+			if ((q[i] < a[i]) || (q[i] > b[i])) return false;
+		}
+		else
+		{
+			double t1 = (a[i] - q[i]) / m[i];
+			double t2 = (b[i] - q[i]) / m[i];
+			if (t1 > t2) std::swap(t1, t2);
+			if (t1 > tmin) tmin = t1;
+			if (t2 < tmax) tmax = t2;
+			if (tmin > tmax) return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::FESurfaceBVH(FESurface* ps) : m_ps(ps)
+{
+	m_nfacets = 0;
+	m_cost0 = 0.0;
+	m_maxGrowth = 2.0;
+	m_nbuilds = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Attach(FESurface* ps)
+{
+	if (ps != m_ps)
+	{
+		m_ps = ps;
+		Invalidate();
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Invalidate()
+{
+	m_node.clear();
+	m_facet.clear();
+	m_nfacets = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Update()
+{
+	assert(m_ps);
+	if (m_node.empty() || (m_nfacets != m_ps->Elements()))
+	{
+		Build();
+		return;
+	}
+
+	Refit();
+
+	// rebuild if the boxes have grown too much
+	if (Cost() > m_maxGrowth*m_cost0) Build();
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FacetBox(int i, vec3d& rmin, vec3d& rmax) const
+{
+	const FESurfaceElement& el = m_ps->Element(i);
+	rmin = rmax = m_ps->Node(el.m_lnode[0]).m_rt;
+	int ne = el.Nodes();
+	for (int j = 1; j < ne; ++j)
+	{
+		const vec3d& r = m_ps->Node(el.m_lnode[j]).m_rt;
+		boxAdd(rmin, rmax, r, r);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Build()
+{
+	assert(m_ps);
+	m_node.clear();
+	m_facet.clear();
+	m_nfacets = m_ps->Elements();
+	m_nbuilds++;
+	if (m_nfacets == 0) return;
+
+	// calculate the facet centers
+	std::vector<vec3d> c(m_nfacets);
+	for (int i = 0; i < m_nfacets; ++i)
+	{
+		vec3d r0, r1;
+		FacetBox(i, r0, r1);
+		c[i] = (r0 + r1)*0.5;
+	}
+
+	m_facet.resize(m_nfacets);
+	for (int i = 0; i < m_nfacets; ++i) m_facet[i] = i;
+	m_node.reserve(2 * (m_nfacets / MAX_LEAF_FACETS + 1));
+
+	BuildNode(0, m_nfacets, c);
+
+	// calculate the boxes
+	Refit();
+	m_cost0 = Cost();
+}
+
+//-----------------------------------------------------------------------------
+// Builds the subtree for the facets [first, first+count), splitting at the
+// median of the facet centers along the longest axis.
+int FESurfaceBVH::BuildNode(int first, int count, std::vector<vec3d>& c)
+{
+	int n = (int)m_node.size();
+	m_node.push_back(NODE());
+	m_node[n].right = -1;
+	m_node[n].first = first;
+	m_node[n].count = count;
+	if (count <= MAX_LEAF_FACETS) return n;
+
+	// find the extent of the facet centers
+	vec3d r0 = c[m_facet[first]], r1 = r0;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		const vec3d& ci = c[m_facet[i]];
+		boxAdd(r0, r1, ci, ci);
+	}
+	vec3d d = r1 - r0;
+	int axis = ((d.x >= d.y) && (d.x >= d.z) ? 0 : (d.y >= d.z ? 1 : 2));
+
+	// split at the median
+	int half = count / 2;
+	std::vector<int>::iterator it = m_facet.begin() + first;
+	std::nth_element(it, it + half, it + count, [&](int a, int b) {
+		const vec3d& ca = c[a];
+		const vec3d& cb = c[b];
+		double va = (axis == 0 ? ca.x : (axis == 1 ? ca.y : ca.z));
+		double vb = (axis == 0 ? cb.x : (axis == 1 ? cb.y : cb.z));
+		return (va < vb) || ((va == vb) && (a < b));
+	});
+
+	m_node[n].count = 0;
+	BuildNode(first, half, c);
+	int right = BuildNode(first + half, count - half, c);
+	m_node[n].right = right;
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Refit()
+{
+	// Children are always stored after their parent, so we can
+	// update the boxes bottom-up by looping backwards.
+	for (int n = (int)m_node.size() - 1; n >= 0; --n)
+	{
+		NODE& node = m_node[n];
+		if (node.right < 0)
+		{
+			FacetBox(m_facet[node.first], node.rmin, node.rmax);
+			for (int i = 1; i < node.count; ++i)
+			{
+				vec3d r0, r1;
+				FacetBox(m_facet[node.first + i], r0, r1);
+				boxAdd(node.rmin, node.rmax, r0, r1);
+			}
+		}
+		else
+		{
+			const NODE& a = m_node[n + 1];
+			const NODE& b = m_node[node.right];
+			node.rmin = a.rmin;
+			node.rmax = a.rmax;
+			boxAdd(node.rmin, node.rmax, b.rmin, b.rmax);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// The cost of the tree is the total surface area of the boxes, relative to
+// the area of the root box. It grows when the boxes start to overlap more
+// after the nodes have moved.
+double FESurfaceBVH::Cost() const
+{
+	if (m_node.empty()) return 0.0;
+	double A0 = boxArea(m_node[0].rmin, m_node[0].rmax);
+	if (A0 <= 0.0) return 0.0;
+
+	double A = 0.0;
+	for (const NODE& node : m_node) A += boxArea(node.rmin, node.rmax);
+	return A / A0;
+}
+
+//-----------------------------------------------------------------------------
+double FESurfaceBVH::Size() const
+{
+	if (m_node.empty()) return 0.0;
+	return (m_node[0].rmax - m_node[0].rmin).norm();
+}
+
+//-----------------------------------------------------------------------------
+int FESurfaceBVH::FindClosestNode(const vec3d& x, double R2, const std::function<bool(int)>& accept) const
+{
+	if (m_node.empty()) return -1;
+
+	int imin = -1;
+	double d2min = 0.0;
+
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		int k = stack[--ns];
+		const NODE& node = m_node[k];
+
+		// Skip this node if it cannot contain a closer node. Note that we don't skip
+		// nodes at the same distance, since they may contain a node with a lower index.
+		double db2 = boxDistance2(x, node.rmin, node.rmax);
+		if ((imin >= 0) && (db2 > d2min)) continue;
+		if ((R2 > 0) && (db2 > R2)) continue;
+
+		if (node.right < 0)
+		{
+			for (int i = 0; i < node.count; ++i)
+			{
+				const FESurfaceElement& el = m_ps->Element(m_facet[node.first + i]);
+				int ne = el.Nodes();
+				for (int j = 0; j < ne; ++j)
+				{
+					int m = el.m_lnode[j];
+					const vec3d& r = m_ps->Node(m).m_rt;
+					double d2 = (r - x)*(r - x);
+					if ((R2 > 0) && (d2 > R2)) continue;
+					if ((imin == -1) || (d2 < d2min) || ((d2 == d2min) && (m < imin)))
+					{
+						if (accept && (accept(m) == false)) continue;
+						imin = m;
+						d2min = d2;
+					}
+				}
+			}
+		}
+		else
+		{
+			// visit the closest child first
+			int a = k + 1;
+			int b = node.right;
+			double da = boxDistance2(x, m_node[a].rmin, m_node[a].rmax);
+			double db = boxDistance2(x, m_node[b].rmin, m_node[b].rmax);
+			assert(ns + 2 <= MAX_STACK);
+			if (da <= db) { stack[ns++] = b; stack[ns++] = a; }
+			else { stack[ns++] = a; stack[ns++] = b; }
+		}
+	}
+
+	return imin;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindRayCandidates(const vec3d& p, const vec3d& n, double srad, double tol, std::vector<int>& sel) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	// the boxes are inflated by a fraction of the surface size
+	double d = Size()*tol;
+
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		int k = stack[--ns];
+		const NODE& node = m_node[k];
+		if (boxContains(node.rmin, node.rmax, p, d + srad) && lineIntersectsBox(node.rmin, node.rmax, p, n, d))
+		{
+			if (node.right < 0)
+			{
+				for (int i = 0; i < node.count; ++i)
+				{
+					int m = m_facet[node.first + i];
+					if (node.count > 1)
+					{
+						vec3d r0, r1;
+						FacetBox(m, r0, r1);
+						if ((boxContains(r0, r1, p, d + srad) == false) || (lineIntersectsBox(r0, r1, p, n, d) == false)) continue;
+					}
+					sel.push_back(m);
+				}
+			}
+			else
+			{
+				assert(ns + 2 <= MAX_STACK);
+				stack[ns++] = node.right;
+				stack[ns++] = k + 1;
+			}
+		}
+	}
+
+	std::sort(sel.begin(), sel.end());
+}
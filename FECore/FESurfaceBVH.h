@@ -0,0 +1,109 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "vec3d.h"
+#include "fecore_api.h"
+#include <vector>
+#include <functional>
+
+class FESurface;
+
+//-----------------------------------------------------------------------------
+//! Bounding volume hierarchy over the facets of a surface.
+//! The hierarchy is built once and then refitted to the current nodal positions
+//! when Update is called. A refit only recomputes the boxes and is linear in
+//! the number of facets. The tree is rebuilt when the boxes have grown so much
+//! (relative to the root box) that the quality of the tree has degraded, or when
+//! the number of facets has changed.
+//! The same hierarchy is used for closest node searches (see FEClosestPointProjection)
+//! and for finding facets that are intersected by a ray (see FEOctree).
+class FECORE_API FESurfaceBVH
+{
+	struct NODE
+	{
+		vec3d	rmin, rmax;	//!< bounding box
+		int		right;		//!< index of right child (left child is the next node), or -1 for leaves
+		int		first;		//!< first facet in leaf
+		int		count;		//!< number of facets in leaf
+	};
+
+public:
+	FESurfaceBVH(FESurface* ps = nullptr);
+
+	//! attach to a surface
+	void Attach(FESurface* ps);
+
+	//! Make sure the hierarchy is up to date with the current nodal positions
+	void Update();
+
+	//! Build the hierarchy from scratch
+	void Build();
+
+	//! Recalculate the bounding boxes, keeping the tree structure
+	void Refit();
+
+	//! Force a rebuild on the next update (e.g. when the surface topology changed)
+	void Invalidate();
+
+	//! Find the closest surface node to x. Only nodes whose squared distance does
+	//! not exceed R2 are considered (unless R2 is zero) and for which accept
+	//! returns true (if given). Ties are resolved by taking the lowest node index.
+	//! Returns the local node index or -1 if no node was found.
+	int FindClosestNode(const vec3d& x, double R2 = 0.0, const std::function<bool(int)>& accept = nullptr) const;
+
+	//! Find all facets whose bounding box, inflated by tol, is intersected by the
+	//! line through p with direction n and which are within a distance srad of p.
+	//! The facet list is returned in ascending order.
+	void FindRayCandidates(const vec3d& p, const vec3d& n, double srad, double tol, std::vector<int>& sel) const;
+
+	//! size of the diagonal of the root box
+	double Size() const;
+
+	//! set the threshold for rebuilding the tree
+	void SetRebuildThreshold(double f) { m_maxGrowth = f; }
+
+	//! number of times the tree was built
+	int Builds() const { return m_nbuilds; }
+
+private:
+	int BuildNode(int first, int count, std::vector<vec3d>& c);
+
+	void FacetBox(int i, vec3d& rmin, vec3d& rmax) const;
+
+	double Cost() const;
+
+private:
+	FESurface*			m_ps;		//!< the surface
+	std::vector<NODE>	m_node;		//!< nodes of the tree (in depth-first order)
+	std::vector<int>	m_facet;	//!< facet indices, sorted by leaf
+	int					m_nfacets;	//!< number of facets when the tree was built
+	double				m_cost0;	//!< tree cost after the last build
+	double				m_maxGrowth;	//!< max allowed cost growth before rebuilding
+	int					m_nbuilds;	//!< number of builds
+};
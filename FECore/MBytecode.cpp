@@ -0,0 +1,298 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "MBytecode.h"
+#include "MItem.h"
+#include <math.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+MBytecode::MBytecode()
+{
+	m_nvars = 0;
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::Clear()
+{
+	m_code.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool MBytecode::Compile(const MItem* pi, int nvars)
+{
+	m_code.clear();
+	if (pi == nullptr) return false;
+
+	m_nvars = nvars;
+	int depth = compile(pi);
+	if ((depth <= 0) || (depth > MAX_STACK))
+	{
+		m_code.clear();
+		return false;
+	}
+
+	// we no longer need the excess capacity
+	std::vector<Instruction>(m_code).swap(m_code);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::emit(int op, int n, double c, FUNCPTR f1, FUNC2PTR f2)
+{
+	Instruction i;
+	i.op = op;
+	i.n = n;
+	i.c = c;
+	i.f1 = f1;
+	i.f2 = f2;
+	m_code.push_back(i);
+}
+
+//-----------------------------------------------------------------------------
+// Compiles the item and returns the stack depth required to evaluate it, or
+// -1 if the item cannot be compiled. Constant sub-expressions are evaluated
+// here, using the same operations (and order) as the run-time evaluation.
+int MBytecode::compile(const MItem* pi)
+{
+	switch (pi->Type())
+	{
+	case MCONST:
+	case MFRAC:
+	case MNAMED:
+		emit(OP_CONST, 0, mnumber(pi)->value());
+		return 1;
+	case MVAR:
+	{
+		int n = mvar(pi)->index();
+		if ((n < 0) || (n >= m_nvars)) return -1;
+		emit(OP_VAR, n);
+		return 1;
+	}
+	case MNEG:
+	{
+		size_t n0 = m_code.size();
+		int d = compile(munary(pi)->Item());
+		if (d < 0) return -1;
+		if ((m_code.size() == n0 + 1) && (m_code.back().op == OP_CONST)) m_code.back().c = -m_code.back().c;
+		else emit(OP_NEG);
+		return d;
+	}
+	case MADD:
+	case MSUB:
+	case MMUL:
+	case MDIV:
+	case MPOW:
+	{
+		int op = pi->Type();
+		size_t n0 = m_code.size();
+		int dl = compile(mbinary(pi)->LeftItem());
+		if (dl < 0) return -1;
+		bool lconst = ((m_code.size() == n0 + 1) && (m_code.back().op == OP_CONST));
+
+		size_t n1 = m_code.size();
+		int dr = compile(mbinary(pi)->RightItem());
+		if (dr < 0) return -1;
+		bool rsingle = (m_code.size() == n1 + 1);
+		Instruction r = m_code.back();
+
+		if (rsingle && (r.op == OP_CONST))
+		{
+			m_code.pop_back();
+			if (lconst)
+			{
+				// fold the constant expression
+				double a = m_code.back().c, b = r.c, v = 0.0;
+				switch (op)
+				{
+				case MADD: v = a + b; break;
+				case MSUB: v = a - b; break;
+				case MMUL: v = a * b; break;
+				case MDIV: v = a / b; break;
+				case MPOW: v = pow(a, b); break;
+				}
+				m_code.back().c = v;
+			}
+			else
+			{
+				switch (op)
+				{
+				case MADD: emit(OP_ADDK, 0, r.c); break;
+				case MSUB: emit(OP_SUBK, 0, r.c); break;
+				case MMUL: emit(OP_MULK, 0, r.c); break;
+				case MDIV: emit(OP_DIVK, 0, r.c); break;
+				case MPOW: emit(OP_POWK, 0, r.c); break;
+				}
+			}
+			return dl;
+		}
+		else if (rsingle && (r.op == OP_VAR) && (op != MPOW))
+		{
+			m_code.pop_back();
+			switch (op)
+			{
+			case MADD: emit(OP_ADDV, r.n); break;
+			case MSUB: emit(OP_SUBV, r.n); break;
+			case MMUL: emit(OP_MULV, r.n); break;
+			case MDIV: emit(OP_DIVV, r.n); break;
+			}
+			return dl;
+		}
+
+		switch (op)
+		{
+		case MADD: emit(OP_ADD); break;
+		case MSUB: emit(OP_SUB); break;
+		case MMUL: emit(OP_MUL); break;
+		case MDIV: emit(OP_DIV); break;
+		case MPOW: emit(OP_POW); break;
+		}
+		return std::max(dl, dr + 1);
+	}
+	case MF1D:
+	{
+		FUNCPTR f = mfnc1d(pi)->funcptr();
+		size_t n0 = m_code.size();
+		int d = compile(munary(pi)->Item());
+		if (d < 0) return -1;
+		if ((m_code.size() == n0 + 1) && (m_code.back().op == OP_CONST)) m_code.back().c = f(m_code.back().c);
+		else emit(OP_F1, 0, 0.0, f);
+		return d;
+	}
+	case MF2D:
+	{
+		FUNC2PTR f = mfnc2d(pi)->funcptr();
+		size_t n0 = m_code.size();
+		int dl = compile(mbinary(pi)->LeftItem());
+		if (dl < 0) return -1;
+		bool lconst = ((m_code.size() == n0 + 1) && (m_code.back().op == OP_CONST));
+
+		size_t n1 = m_code.size();
+		int dr = compile(mbinary(pi)->RightItem());
+		if (dr < 0) return -1;
+		bool rconst = ((m_code.size() == n1 + 1) && (m_code.back().op == OP_CONST));
+
+		if (lconst && rconst)
+		{
+			double b = m_code.back().c; m_code.pop_back();
+			m_code.back().c = f(m_code.back().c, b);
+			return 1;
+		}
+		emit(OP_F2, 0, 0.0, nullptr, f);
+		return std::max(dl, dr + 1);
+	}
+	case MSFNC:
+		return compile(msfncnd(pi)->Value());
+	default:
+		// not supported
+		return -1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double MBytecode::value(const double* var) const
+{
+	double s[MAX_STACK];
+	int sp = -1;
+	const Instruction* c = m_code.data();
+	const Instruction* end = c + m_code.size();
+	for (; c != end; ++c)
+	{
+		switch (c->op)
+		{
+		case OP_CONST: s[++sp] = c->c; break;
+		case OP_VAR  : s[++sp] = var[c->n]; break;
+		case OP_NEG  : s[sp] = -s[sp]; break;
+		case OP_ADD  : s[sp - 1] = s[sp - 1] + s[sp]; --sp; break;
+		case OP_SUB  : s[sp - 1] = s[sp - 1] - s[sp]; --sp; break;
+		case OP_MUL  : s[sp - 1] = s[sp - 1] * s[sp]; --sp; break;
+		case OP_DIV  : s[sp - 1] = s[sp - 1] / s[sp]; --sp; break;
+		case OP_POW  : s[sp - 1] = pow(s[sp - 1], s[sp]); --sp; break;
+		case OP_ADDK : s[sp] = s[sp] + c->c; break;
+		case OP_SUBK : s[sp] = s[sp] - c->c; break;
+		case OP_MULK : s[sp] = s[sp] * c->c; break;
+		case OP_DIVK : s[sp] = s[sp] / c->c; break;
+		case OP_POWK : s[sp] = pow(s[sp], c->c); break;
+		case OP_ADDV : s[sp] = s[sp] + var[c->n]; break;
+		case OP_SUBV : s[sp] = s[sp] - var[c->n]; break;
+		case OP_MULV : s[sp] = s[sp] * var[c->n]; break;
+		case OP_DIVV : s[sp] = s[sp] / var[c->n]; break;
+		case OP_F1   : s[sp] = (c->f1)(s[sp]); break;
+		case OP_F2   : s[sp - 1] = (c->f2)(s[sp - 1], s[sp]); --sp; break;
+		}
+	}
+	assert(sp == 0);
+	return s[0];
+}
+
+//-----------------------------------------------------------------------------
+// The batch version runs each instruction over a block of points at a time,
+// which amortizes the instruction dispatch and lets the compiler vectorize the
+// arithmetic.
+void MBytecode::value(const double* var, int stride, int n, double* out) const
+{
+	const int B = 16;
+	double s[MAX_STACK][B];
+
+	for (int i0 = 0; i0 < n; i0 += B)
+	{
+		const int nb = std::min(B, n - i0);
+		const double* v = var + (size_t)i0 * stride;
+		int sp = -1;
+		for (const Instruction& c : m_code)
+		{
+			double* a = s[sp < 0 ? 0 : sp];
+			switch (c.op)
+			{
+			case OP_CONST: a = s[++sp]; for (int k = 0; k < nb; ++k) a[k] = c.c; break;
+			case OP_VAR  : a = s[++sp]; for (int k = 0; k < nb; ++k) a[k] = v[k*stride + c.n]; break;
+			case OP_NEG  : for (int k = 0; k < nb; ++k) a[k] = -a[k]; break;
+			case OP_ADD  : { double* b = s[sp - 1]; for (int k = 0; k < nb; ++k) b[k] = b[k] + a[k]; --sp; } break;
+			case OP_SUB  : { double* b = s[sp - 1]; for (int k = 0; k < nb; ++k) b[k] = b[k] - a[k]; --sp; } break;
+			case OP_MUL  : { double* b = s[sp - 1]; for (int k = 0; k < nb; ++k) b[k] = b[k] * a[k]; --sp; } break;
+			case OP_DIV  : { double* b = s[sp - 1]; for (int k = 0; k < nb; ++k) b[k] = b[k] / a[k]; --sp; } break;
+			case OP_POW  : { double* b = s[sp - 1]; for (int k = 0; k < nb; ++k) b[k] = pow(b[k], a[k]); --sp; } break;
+			case OP_ADDK : for (int k = 0; k < nb; ++k) a[k] = a[k] + c.c; break;
+			case OP_SUBK : for (int k = 0; k < nb; ++k) a[k] = a[k] - c.c; break;
+			case OP_MULK : for (int k = 0; k < nb; ++k) a[k] = a[k] * c.c; break;
+			case OP_DIVK : for (int k = 0; k < nb; ++k) a[k] = a[k] / c.c; break;
+			case OP_POWK : for (int k = 0; k < nb; ++k) a[k] = pow(a[k], c.c); break;
+			case OP_ADDV : for (int k = 0; k < nb; ++k) a[k] = a[k] + v[k*stride + c.n]; break;
+			case OP_SUBV : for (int k = 0; k < nb; ++k) a[k] = a[k] - v[k*stride + c.n]; break;
+			case OP_MULV : for (int k = 0; k < nb; ++k) a[k] = a[k] * v[k*stride + c.n]; break;
+			case OP_DIVV : for (int k = 0; k < nb; ++k) a[k] = a[k] / v[k*stride + c.n]; break;
+			case OP_F1   : for (int k = 0; k < nb; ++k) a[k] = (c.f1)(a[k]); break;
+			case OP_F2   : { double* b = s[sp - 1]; for (int k = 0; k < nb; ++k) b[k] = (c.f2)(b[k], a[k]); --sp; } break;
+			}
+		}
+		assert(sp == 0);
+		for (int k = 0; k < nb; ++k) out[i0 + k] = s[0][k];
+	}
+}
@@ -0,0 +1,102 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "MFunctions.h"
+#include <vector>
+#include "fecore_api.h"
+
+class MItem;
+
+//-----------------------------------------------------------------------------
+// This class stores a math expression as a flat list of stack-machine
+// instructions. The expression tree is compiled once (folding all constant
+// sub-expressions), after which it can be evaluated without recursion or
+// memory allocation. Evaluation does not modify the object, so a single
+// instance can be evaluated from multiple threads simultaneously.
+class FECORE_API MBytecode
+{
+public:
+	// max depth of the evaluation stack
+	enum { MAX_STACK = 32 };
+
+	enum OpCode {
+		OP_CONST,		// push constant
+		OP_VAR,			// push variable
+		OP_NEG,			// negate top
+		OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW,			// binary operators on the two top values
+		OP_ADDK, OP_SUBK, OP_MULK, OP_DIVK, OP_POWK,	// binary operators with a constant right operand
+		OP_ADDV, OP_SUBV, OP_MULV, OP_DIVV,				// binary operators with a variable right operand
+		OP_F1,			// function of one variable
+		OP_F2			// function of two variables
+	};
+
+	struct Instruction
+	{
+		int			op;		// op code
+		int			n;		// variable index
+		double		c;		// constant value
+		FUNCPTR		f1;		// function pointers
+		FUNC2PTR	f2;
+	};
+
+public:
+	MBytecode();
+
+	// compile the expression. The expression can reference variables with an
+	// index smaller than nvars. Returns false if the expression contains items
+	// that cannot be compiled (in which case the object remains empty).
+	bool Compile(const MItem* pi, int nvars);
+
+	// clear the program
+	void Clear();
+
+	// was the expression compiled successfully?
+	bool IsValid() const { return (m_code.empty() == false); }
+
+	// does the expression evaluate to a constant?
+	bool IsConst() const { return ((m_code.size() == 1) && (m_code[0].op == OP_CONST)); }
+
+	// number of instructions
+	int Size() const { return (int)m_code.size(); }
+
+	// evaluate the expression for the variable values in var
+	double value(const double* var) const;
+
+	// Evaluate the expression for n sets of variables. The variables of set i
+	// start at var[i*stride] and the result is stored in out[i].
+	void value(const double* var, int stride, int n, double* out) const;
+
+private:
+	int compile(const MItem* pi);
+	void emit(int op, int n = 0, double c = 0.0, FUNCPTR f1 = nullptr, FUNC2PTR f2 = nullptr);
+
+private:
+	std::vector<Instruction>	m_code;
+	int		m_nvars;		// nr of variables (only used during compilation)
+};
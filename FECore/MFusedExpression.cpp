@@ -0,0 +1,327 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "MFusedExpression.h"
+#include "MItem.h"
+#include <math.h>
+#include <string.h>
+#include <map>
+#include <functional>
+
+namespace {
+
+	// node types of the expression graph (in addition to the op codes)
+	enum { NODE_VAR = -1, NODE_CONST = -2 };
+
+	// A node of the expression graph. Nodes are identified by their contents,
+	// which is what allows identical sub-expressions to be shared.
+	struct Node
+	{
+		int			op;
+		int			a, b;	// operand nodes (or variable index for NODE_VAR)
+		double		c;		// constant value
+		FUNCPTR		f1;
+		FUNC2PTR	f2;
+
+		bool operator < (const Node& x) const
+		{
+			if (op != x.op) return op < x.op;
+			if (a != x.a) return a < x.a;
+			if (b != x.b) return b < x.b;
+			if (op == NODE_CONST)
+			{
+				// compare the bits, so that e.g. -0 and 0 remain different
+				unsigned long long u, v;
+				memcpy(&u, &c, sizeof(double));
+				memcpy(&v, &x.c, sizeof(double));
+				if (u != v) return u < v;
+			}
+			if (f1 != x.f1) return std::less<FUNCPTR>()(f1, x.f1);
+			if (f2 != x.f2) return std::less<FUNC2PTR>()(f2, x.f2);
+			return false;
+		}
+	};
+
+	class MGraphBuilder
+	{
+	public:
+		MGraphBuilder(int nvars) : m_nvars(nvars) {}
+
+		int add(const MItem* pi);
+
+		std::vector<Node>	m_node;
+
+	private:
+		int node(int op, int a = -1, int b = -1, double c = 0.0, FUNCPTR f1 = nullptr, FUNC2PTR f2 = nullptr);
+		int constant(double c) { return node(NODE_CONST, -1, -1, c); }
+		bool isConst(int i) const { return m_node[i].op == NODE_CONST; }
+		bool isConst(int i, double v) const { return (isConst(i) && (m_node[i].c == v)); }
+		int binary(int op, int a, int b);
+
+	private:
+		int		m_nvars;
+		std::map<Node, int>	m_map;
+	};
+
+	int MGraphBuilder::node(int op, int a, int b, double c, FUNCPTR f1, FUNC2PTR f2)
+	{
+		Node nd = { op, a, b, c, f1, f2 };
+
+		// addition and multiplication are commutative (also in floating point),
+		// so order the operands to find more common sub-expressions
+		if (((op == MFusedExpression::OP_ADD) || (op == MFusedExpression::OP_MUL)) && (nd.a > nd.b)) std::swap(nd.a, nd.b);
+
+		std::map<Node, int>::iterator it = m_map.find(nd);
+		if (it != m_map.end()) return it->second;
+
+		int id = (int)m_node.size();
+		m_node.push_back(nd);
+		m_map[nd] = id;
+		return id;
+	}
+
+	int MGraphBuilder::binary(int op, int a, int b)
+	{
+		// evaluate constant expressions
+		if (isConst(a) && isConst(b))
+		{
+			double x = m_node[a].c, y = m_node[b].c, v = 0.0;
+			switch (op)
+			{
+			case MFusedExpression::OP_ADD: v = x + y; break;
+			case MFusedExpression::OP_SUB: v = x - y; break;
+			case MFusedExpression::OP_MUL: v = x * y; break;
+			case MFusedExpression::OP_DIV: v = x / y; break;
+			case MFusedExpression::OP_POW: v = pow(x, y); break;
+			}
+			return constant(v);
+		}
+
+		// Remove operations that don't change the value. Only operations that 
+		// return their operand exactly (including -0, inf and NaN) are removed. 
+		// Note that x + 0 is not one of them, since -0 + 0 = +0.
+		switch (op)
+		{
+		case MFusedExpression::OP_SUB:
+			// (x - (-0) is not exact either)
+			if (isConst(b, 0.0) && !signbit(m_node[b].c)) return a;
+			break;
+		case MFusedExpression::OP_MUL:
+			if (isConst(a, 1.0)) return b;
+			if (isConst(b, 1.0)) return a;
+			break;
+		case MFusedExpression::OP_DIV:
+			if (isConst(b, 1.0)) return a;
+			break;
+		}
+
+		return node(op, a, b);
+	}
+
+	// Add the item to the graph and return its node, or -1 if the item cannot be compiled.
+	int MGraphBuilder::add(const MItem* pi)
+	{
+		switch (pi->Type())
+		{
+		case MCONST:
+		case MFRAC:
+		case MNAMED:
+			return constant(mnumber(pi)->value());
+		case MVAR:
+		{
+			int n = mvar(pi)->index();
+			if ((n < 0) || (n >= m_nvars)) return -1;
+			return node(NODE_VAR, n);
+		}
+		case MNEG:
+		{
+			int a = add(munary(pi)->Item());
+			if (a < 0) return -1;
+			if (isConst(a)) return constant(-m_node[a].c);
+			return node(MFusedExpression::OP_NEG, a);
+		}
+		case MADD:
+		case MSUB:
+		case MMUL:
+		case MDIV:
+		case MPOW:
+		{
+			int a = add(mbinary(pi)->LeftItem()); if (a < 0) return -1;
+			int b = add(mbinary(pi)->RightItem()); if (b < 0) return -1;
+			switch (pi->Type())
+			{
+			case MADD: return binary(MFusedExpression::OP_ADD, a, b);
+			case MSUB: return binary(MFusedExpression::OP_SUB, a, b);
+			case MMUL: return binary(MFusedExpression::OP_MUL, a, b);
+			case MDIV: return binary(MFusedExpression::OP_DIV, a, b);
+			case MPOW: return binary(MFusedExpression::OP_POW, a, b);
+			default: break;
+			}
+			return -1;
+		}
+		case MF1D:
+		{
+			FUNCPTR f = mfnc1d(pi)->funcptr();
+			int a = add(munary(pi)->Item());
+			if (a < 0) return -1;
+			if (isConst(a)) return constant(f(m_node[a].c));
+			return node(MFusedExpression::OP_F1, a, -1, 0.0, f);
+		}
+		case MF2D:
+		{
+			FUNC2PTR f = mfnc2d(pi)->funcptr();
+			int a = add(mbinary(pi)->LeftItem()); if (a < 0) return -1;
+			int b = add(mbinary(pi)->RightItem()); if (b < 0) return -1;
+			if (isConst(a) && isConst(b)) return constant(f(m_node[a].c, m_node[b].c));
+			return node(MFusedExpression::OP_F2, a, b, 0.0, nullptr, f);
+		}
+		case MSFNC:
+			return add(msfncnd(pi)->Value());
+		default:
+			// not supported
+			return -1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+MFusedExpression::MFusedExpression()
+{
+	m_nvars = 0;
+}
+
+//-----------------------------------------------------------------------------
+void MFusedExpression::Clear()
+{
+	m_code.clear();
+	m_const.clear();
+	m_out.clear();
+	m_nvars = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool MFusedExpression::Compile(const std::vector<const MItem*>& items, int nvars)
+{
+	Clear();
+	if (items.empty()) return false;
+
+	// build the expression graph
+	MGraphBuilder graph(nvars);
+	std::vector<int> out(items.size());
+	for (size_t i = 0; i < items.size(); ++i)
+	{
+		if (items[i] == nullptr) return false;
+		out[i] = graph.add(items[i]);
+		if (out[i] < 0) return false;
+	}
+	const std::vector<Node>& node = graph.m_node;
+	const int N = (int)node.size();
+
+	// Find the nodes that are needed for the outputs. Since operands are always
+	// created before the nodes that use them, one backward sweep suffices.
+	std::vector<bool> live(N, false);
+	for (int i : out) live[i] = true;
+	for (int i = N - 1; i >= 0; --i)
+	{
+		const Node& nd = node[i];
+		if (live[i] && (nd.op >= 0))
+		{
+			if (nd.a >= 0) live[nd.a] = true;
+			if (nd.b >= 0) live[nd.b] = true;
+		}
+	}
+
+	// assign registers: variables, then constants, then instructions
+	std::vector<int> reg(N, -1);
+	int nconst = 0;
+	for (int i = 0; i < N; ++i)
+	{
+		if (live[i] == false) continue;
+		const Node& nd = node[i];
+		if (nd.op == NODE_VAR) reg[i] = nd.a;
+		else if (nd.op == NODE_CONST) { reg[i] = nvars + nconst++; m_const.push_back(nd.c); }
+	}
+
+	for (int i = 0; i < N; ++i)
+	{
+		const Node& nd = node[i];
+		if ((live[i] == false) || (nd.op < 0)) continue;
+
+		Instruction c;
+		c.op = nd.op;
+		c.a = (nd.a >= 0 ? reg[nd.a] : -1);
+		c.b = (nd.b >= 0 ? reg[nd.b] : -1);
+		c.f1 = nd.f1;
+		c.f2 = nd.f2;
+		reg[i] = nvars + nconst + (int)m_code.size();
+		m_code.push_back(c);
+	}
+
+	m_out.resize(out.size());
+	for (size_t i = 0; i < out.size(); ++i) m_out[i] = reg[out[i]];
+	m_nvars = nvars;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void MFusedExpression::value(const double* var, double* out) const
+{
+	// use a stack buffer for the registers, unless the program is very large
+	const int MAX_REG = 256;
+	const int nconst = (int)m_const.size();
+	const int nreg = m_nvars + nconst + (int)m_code.size();
+	double buf[MAX_REG];
+	std::vector<double> tmp;
+	double* r = buf;
+	if (nreg > MAX_REG) { tmp.resize(nreg); r = tmp.data(); }
+
+	for (int i = 0; i < m_nvars; ++i) r[i] = var[i];
+	for (int i = 0; i < nconst; ++i) r[m_nvars + i] = m_const[i];
+
+	double* v = r + m_nvars + nconst;
+	const Instruction* c = m_code.data();
+	const int ni = (int)m_code.size();
+	for (int i = 0; i < ni; ++i, ++c)
+	{
+		switch (c->op)
+		{
+		case OP_NEG : v[i] = -r[c->a]; break;
+		case OP_ADD : v[i] = r[c->a] + r[c->b]; break;
+		case OP_SUB : v[i] = r[c->a] - r[c->b]; break;
+		case OP_MUL : v[i] = r[c->a] * r[c->b]; break;
+		case OP_DIV : v[i] = r[c->a] / r[c->b]; break;
+		case OP_POW : v[i] = pow(r[c->a], r[c->b]); break;
+		case OP_F1  : v[i] = (c->f1)(r[c->a]); break;
+		case OP_F2  : v[i] = (c->f2)(r[c->a], r[c->b]); break;
+		}
+	}
+
+	for (size_t i = 0; i < m_out.size(); ++i) out[i] = r[m_out[i]];
+}
@@ -0,0 +1,95 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "MFunctions.h"
+#include <vector>
+#include "fecore_api.h"
+
+class MItem;
+
+//-----------------------------------------------------------------------------
+// This class compiles a set of math expressions that share the same variables
+// into a single program. Identical sub-expressions (within and across the
+// expressions) are evaluated only once, so that e.g. all the derivatives of a
+// strain energy function can be evaluated in one pass. Like MBytecode, the
+// evaluation does not modify the object and can be called from multiple threads.
+// The program gives the same results as evaluating the expressions directly: it
+// only removes operations that do not change the value in floating point 
+// arithmetic (e.g. x*1, but not x+0, which turns -0 into +0), and powers are 
+// always evaluated with pow.
+class FECORE_API MFusedExpression
+{
+public:
+	enum OpCode {
+		OP_NEG,
+		OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW,
+		OP_F1,			// function of one variable
+		OP_F2			// function of two variables
+	};
+
+	// Each instruction writes one register. Registers are ordered as the
+	// variables, followed by the constants, followed by the instruction results.
+	struct Instruction
+	{
+		int			op;		// op code
+		int			a, b;	// operand registers
+		FUNCPTR		f1;		// function pointers
+		FUNC2PTR	f2;
+	};
+
+public:
+	MFusedExpression();
+
+	// Compile the expressions. The expressions can reference variables with an
+	// index smaller than nvars. Returns false if any of the expressions contains
+	// items that cannot be compiled (in which case the object remains empty).
+	bool Compile(const std::vector<const MItem*>& items, int nvars);
+
+	// clear the program
+	void Clear();
+
+	// was the program compiled successfully?
+	bool IsValid() const { return (m_out.empty() == false); }
+
+	// number of outputs (i.e. the number of compiled expressions)
+	int Outputs() const { return (int)m_out.size(); }
+
+	// number of instructions
+	int Size() const { return (int)m_code.size(); }
+
+	// Evaluate all expressions for the variable values in var. The value of
+	// expression i is stored in out[i].
+	void value(const double* var, double* out) const;
+
+private:
+	std::vector<Instruction>	m_code;		// the instructions
+	std::vector<double>			m_const;	// constant values
+	std::vector<int>			m_out;		// output registers
+	int		m_nvars;	// nr of variables
+};
@@ -210,7 +210,52 @@ double MSimpleExpression::value(const MItem* pi, const std::vector<double>& var)
 }
 
 //-----------------------------------------------------------------------------
-MSimpleExpression::MSimpleExpression(const MSimpleExpression& mo) : MathObject(mo), m_item(mo.m_item)
+void MSimpleExpression::SetExpression(MITEM& e)
+{
+	m_item = e;
+	Compile();
+}
+
+//-----------------------------------------------------------------------------
+bool MSimpleExpression::Compile()
+{
+	if (m_item.ItemPtr() == nullptr) { m_code.Clear(); return false; }
+	return m_code.Compile(m_item.ItemPtr(), Variables());
+}
+
+//-----------------------------------------------------------------------------
+void MSimpleExpression::Clear()
+{
+	MathObject::Clear();
+	m_code.Clear();
+}
+
+//-----------------------------------------------------------------------------
+double MSimpleExpression::value_s(const double* var) const
+{
+	if (m_code.IsValid()) return m_code.value(var);
+	std::vector<double> v(var, var + m_Var.size());
+	return value(m_item.ItemPtr(), v);
+}
+
+//-----------------------------------------------------------------------------
+void MSimpleExpression::value_s(const double* var, int stride, int n, double* out) const
+{
+	if (m_code.IsValid()) m_code.value(var, stride, n, out);
+	else
+	{
+		std::vector<double> v(m_Var.size());
+		for (int i = 0; i < n; ++i)
+		{
+			const double* vi = var + (size_t)i * stride;
+			v.assign(vi, vi + m_Var.size());
+			out[i] = value(m_item.ItemPtr(), v);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+MSimpleExpression::MSimpleExpression(const MSimpleExpression& mo) : MathObject(mo), m_item(mo.m_item), m_code(mo.m_code)
 {
 	// The copy c'tor of MathObject copied the variables, but any MVarRefs still point to the mo object, not this object's var list.
 	// Calling the following function fixes this
@@ -225,6 +270,7 @@ void MSimpleExpression::operator=(const MSimpleExpression& mo)
 
 	// copy the item
 	m_item = mo.m_item;
+	m_code = mo.m_code;
 
 	// The = operator of MathObject copied the variables, but any MVarRefs still point to the mo object, not this object's var list.
 	// Calling the following function fixes this
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "MItem.h"
+#include "MBytecode.h"
 #include <vector>
 #include "fecore_api.h"
 
@@ -76,7 +77,7 @@ public:
 	MSimpleExpression(const MSimpleExpression& mo);
 	void operator = (const MSimpleExpression& mo);
 
-	void SetExpression(MITEM& e) { m_item = e; }
+	void SetExpression(MITEM& e);
 	MITEM& GetExpression() { return m_item; }
 	const MITEM& GetExpression() const { return m_item; }
 
@@ -100,9 +101,28 @@ public:
 	double value_s(const std::vector<double>& var) const
 	{ 
 		assert(var.size() == m_Var.size());
+		if (m_code.IsValid()) return m_code.value(var.data());
 		return value(m_item.ItemPtr(), var); 
 	}
 
+	// Same as above, but the variable values are passed as a plain array (of size Variables()).
+	// This does not allocate any memory when the expression is compiled.
+	double value_s(const double* var) const;
+
+	// Evaluate the expression for n sets of variables (each of size Variables()). 
+	// The variables of set i start at var[i*stride] and the result is stored in out[i].
+	void value_s(const double* var, int stride, int n, double* out) const;
+
+	// Compile the expression to bytecode. This is done automatically when the 
+	// expression is set, but must be called again if the expression is modified
+	// through GetExpression.
+	bool Compile();
+
+	// is the expression compiled?
+	bool IsCompiled() const { return m_code.IsValid(); }
+
+	void Clear() override;
+
 	int Items();
 
 protected:
@@ -113,5 +133,6 @@ protected:
 	void fixVariableRefs(MItem* pi);
 
 protected:
-	MITEM	m_item;
+	MITEM		m_item;
+	MBytecode	m_code;		// compiled expression
 };
@@ -0,0 +1,80 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "MatrixOperator.h"
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+double MatrixOperator::dot(int n, const double* a, const double* b)
+{
+	double s = 0.0;
+#pragma omp parallel for reduction(+:s) schedule(static) if (n > BLAS1_MIN_PARALLEL)
+	for (int i = 0; i < n; ++i) s += a[i] * b[i];
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+double MatrixOperator::norm(int n, const double* a)
+{
+	return sqrt(dot(n, a, a));
+}
+
+//-----------------------------------------------------------------------------
+void MatrixOperator::axpy(int n, double s, const double* x, double* y)
+{
+#pragma omp parallel for schedule(static) if (n > BLAS1_MIN_PARALLEL)
+	for (int i = 0; i < n; ++i) y[i] += s * x[i];
+}
+
+//-----------------------------------------------------------------------------
+void MatrixOperator::xpay(int n, const double* x, double s, double* y)
+{
+#pragma omp parallel for schedule(static) if (n > BLAS1_MIN_PARALLEL)
+	for (int i = 0; i < n; ++i) y[i] = x[i] + s * y[i];
+}
+
+//-----------------------------------------------------------------------------
+double MatrixOperator::axpy_sqrnorm(int n, double s, const double* x, double* y)
+{
+	double r = 0.0;
+#pragma omp parallel for reduction(+:r) schedule(static) if (n > BLAS1_MIN_PARALLEL)
+	for (int i = 0; i < n; ++i)
+	{
+		y[i] += s * x[i];
+		r += y[i] * y[i];
+	}
+	return r;
+}
+
+//-----------------------------------------------------------------------------
+void MatrixOperator::waxpy(int n, const double* x, double s, const double* y, double* z)
+{
+#pragma omp parallel for schedule(static) if (n > BLAS1_MIN_PARALLEL)
+	for (int i = 0; i < n; ++i) z[i] = x[i] + s * y[i];
+}
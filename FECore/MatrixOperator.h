@@ -29,6 +29,9 @@ SOFTWARE.*/
 #pragma once
 #include "fecore_api.h"
 
+// vectors smaller than this are processed serially by the BLAS1-type operations
+#define BLAS1_MIN_PARALLEL	10000
+
 // abstract base class for matrix operators, i.e. a class that can calculate a matrix-vector product
 class FECORE_API MatrixOperator
 {
@@ -38,4 +41,26 @@ public:
 
 	// calculate the product Ax = y
 	virtual bool mult_vector(double* x, double* y) = 0;
+
+public:
+	// Threaded BLAS-1 kernels used by the iterative solvers.
+	// Small vectors are processed serially to avoid the threading overhead.
+
+	// returns a.b
+	static double dot(int n, const double* a, const double* b);
+
+	// returns |a|
+	static double norm(int n, const double* a);
+
+	// y += s*x
+	static void axpy(int n, double s, const double* x, double* y);
+
+	// y = x + s*y
+	static void xpay(int n, const double* x, double s, double* y);
+
+	// y += s*x, returns the squared norm of the updated y
+	static double axpy_sqrnorm(int n, double s, const double* x, double* y);
+
+	// z = x + s*y
+	static void waxpy(int n, const double* x, double s, const double* y, double* z);
 };
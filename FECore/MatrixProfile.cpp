@@ -153,6 +153,50 @@ void SparseMatrixProfile::ColumnProfile::insertRow(int row)
 	}
 }
 
+// see if all rows of a are also in this column profile
+// NOTE: This assumes that adjacent row entries are merged, as done by insertRow.
+bool SparseMatrixProfile::ColumnProfile::contains(const ColumnProfile& a) const
+{
+	int N = size();
+	int n = 0;
+	for (const RowEntry& ra : a.m_data)
+	{
+		// find the first entry that does not end before ra
+		while ((n < N) && (m_data[n].end < ra.start)) ++n;
+		if (n == N) return false;
+
+		// ra must lie inside this entry
+		const RowEntry& rn = m_data[n];
+		if ((ra.start < rn.start) || (ra.end > rn.end)) return false;
+	}
+	return true;
+}
+
+// add all rows of a to this column profile
+void SparseMatrixProfile::ColumnProfile::merge(const ColumnProfile& a)
+{
+	if (a.m_data.empty()) return;
+	if (m_data.empty()) { m_data = a.m_data; return; }
+
+	// merge the two sorted lists, combining overlapping and adjacent entries
+	std::vector<RowEntry> d;
+	d.reserve(m_data.size() + a.m_data.size());
+	size_t i = 0, j = 0;
+	while ((i < m_data.size()) || (j < a.m_data.size()))
+	{
+		RowEntry r;
+		if ((j == a.m_data.size()) || ((i < m_data.size()) && (m_data[i].start <= a.m_data[j].start))) r = m_data[i++];
+		else r = a.m_data[j++];
+
+		if (d.empty() == false && (r.start <= d.back().end + 1))
+		{
+			if (r.end > d.back().end) d.back().end = r.end;
+		}
+		else d.push_back(r);
+	}
+	m_data.swap(d);
+}
+
 //-----------------------------------------------------------------------------
 //! MatrixProfile constructor. Takes the nr of equations as input argument.
 //! If n is larger than zero a default profile is constructor for a diagonal
@@ -319,6 +363,33 @@ void SparseMatrixProfile::Insert(int i, int j)
 	a.insertRow(i);
 }
 
+//-----------------------------------------------------------------------------
+//! see if all entries of mp are also in this profile
+bool SparseMatrixProfile::Contains(const SparseMatrixProfile& mp) const
+{
+	if ((mp.m_nrow != m_nrow) || (mp.m_ncol != m_ncol)) return false;
+	if (mp.m_prof.size() != m_prof.size()) return false;
+
+	int nc = (int)m_prof.size();
+	for (int i = 0; i < nc; ++i)
+	{
+		if (m_prof[i].contains(mp.m_prof[i]) == false) return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! add all entries of mp to this profile
+void SparseMatrixProfile::Merge(const SparseMatrixProfile& mp)
+{
+	assert((mp.m_nrow == m_nrow) && (mp.m_ncol == m_ncol));
+	int nc = (int)m_prof.size();
+	if ((int)mp.m_prof.size() != nc) return;
+
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < nc; ++i) m_prof[i].merge(mp.m_prof[i]);
+}
+
 //-----------------------------------------------------------------------------
 // extract the matrix profile of a block
 SparseMatrixProfile SparseMatrixProfile::GetBlockProfile(int nrow0, int ncol0, int nrow1, int ncol1) const
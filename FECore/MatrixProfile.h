@@ -85,6 +85,12 @@ public:
 		// add row index to column profile
 		void insertRow(int row);
 
+		// see if all rows of a are also in this column profile
+		bool contains(const ColumnProfile& a) const;
+
+		// add all rows of a to this column profile
+		void merge(const ColumnProfile& a);
+
 	private:
 		std::vector<RowEntry>	m_data;	// the column profile data
 	};
@@ -114,6 +120,12 @@ public:
 	//! inserts an entry into the profile (This is an expensive operation!)
 	void Insert(int i, int j);
 
+	//! see if all entries of mp are also in this profile
+	bool Contains(const SparseMatrixProfile& mp) const;
+
+	//! add all entries of mp to this profile (the profiles must have the same size)
+	void Merge(const SparseMatrixProfile& mp);
+
 	//! returns the number of rows
 	int Rows() const { return m_nrow; }
 
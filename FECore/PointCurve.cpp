@@ -28,6 +28,7 @@ SOFTWARE.*/
 #include "BSpline.h"
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
 
 #ifndef min
 #define min(a,b) ((a)<(b)?(a):(b))
@@ -35,19 +36,105 @@ SOFTWARE.*/
 
 class PointCurve::Imp
 {
+public:
+	// curves with at least this many points get a lookup table
+	enum { MIN_TABLE_POINTS = 256 };
+
 public:
 	int		fnc;	//!< interpolation function
 	int		ext;	//!< extend mode
 	std::vector<vec2d>	points;
 	BSpline* spline;    //!< B-spline
+
+	// Lookup table for long curves. The domain is divided in uniform bins and
+	// for each bin we store the first point that lies beyond its left edge.
+	std::vector<int>	table;
+	double	tableMin, tableScale;
+
+	// the last interval that was found
+	mutable std::atomic<int>	hint;
+
+public:
+	Imp() : spline(nullptr), tableMin(0.0), tableScale(0.0), hint(1) {}
+
+	// call when the points have changed
+	void Invalidate() { table.clear(); }
+
+	void BuildTable();
+
+	int FindInterval(double x) const;
 };
 
+//-----------------------------------------------------------------------------
+void PointCurve::Imp::BuildTable()
+{
+	table.clear();
+	const int N = (int)points.size();
+	if (N < MIN_TABLE_POINTS) return;
+
+	double xmin = points[0].x();
+	double xmax = points[N - 1].x();
+	if (xmax <= xmin) return;
+
+	const int M = N;
+	tableMin = xmin;
+	tableScale = M / (xmax - xmin);
+	table.resize(M);
+	int n = 1;
+	for (int i = 0; i < M; ++i)
+	{
+		double xi = xmin + i / tableScale;
+		while ((n < N - 1) && (points[n].x() <= xi)) ++n;
+		table[i] = n;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Returns the index n of the first point with points[n].x() > x, i.e. x lies
+// in the interval [points[n-1].x(), points[n].x()). This assumes that x lies 
+// strictly inside the domain of the curve.
+int PointCurve::Imp::FindInterval(double x) const
+{
+	const int N = (int)points.size();
+	const vec2d* p = points.data();
+
+	// curves are usually evaluated at increasing values, so first try the 
+	// interval we found last time, or the next one.
+	int n = hint.load(std::memory_order_relaxed);
+	if ((n >= 1) && (n < N) && (p[n - 1].x() <= x))
+	{
+		if (x < p[n].x()) return n;
+		if ((n + 1 < N) && (x < p[n + 1].x())) { hint.store(n + 1, std::memory_order_relaxed); return n + 1; }
+	}
+
+	if (table.empty() == false)
+	{
+		// The table gives us a point close to the interval. We still scan to 
+		// the exact interval, which also guards against round-off in the bin index.
+		int i = (int)((x - tableMin) * tableScale);
+		if (i < 0) i = 0;
+		if (i >= (int)table.size()) i = (int)table.size() - 1;
+		n = table[i];
+		while ((n > 1) && (p[n - 1].x() > x)) --n;
+		while ((n < N - 1) && (p[n].x() <= x)) ++n;
+	}
+	else
+	{
+		// binary search
+		n = (int)(std::upper_bound(p, p + N, x, [](double a, const vec2d& b) { return a < b.x(); }) - p);
+		if (n < 1) n = 1;
+		if (n > N - 1) n = N - 1;
+	}
+
+	hint.store(n, std::memory_order_relaxed);
+	return n;
+}
+
 //-----------------------------------------------------------------------------
 PointCurve::PointCurve() : im(new PointCurve::Imp)
 {
 	im->fnc = LINEAR;
 	im->ext = CONSTANT;
-	im->spline = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -87,6 +174,7 @@ int PointCurve::Add(double x, double y)
 
 	// insert loadpoint
 	im->points.insert(im->points.begin() + n, vec2d(x, y));
+	im->Invalidate();
 
 	return n;
 }
@@ -102,6 +190,7 @@ int PointCurve::Add(const vec2d& p)
 void PointCurve::Clear()
 {
 	im->points.clear();
+	im->Invalidate();
 	if (im->spline) delete im->spline;
 	im->spline = nullptr;
 }
@@ -122,18 +211,21 @@ void PointCurve::SetPoint(int i, double x, double y)
 	vec2d& pt = im->points[i];
 	pt.x() = x;
 	pt.y() = y;
+	im->Invalidate();
 }
 
 //-----------------------------------------------------------------------------
 void PointCurve::SetPoint(int i, const vec2d& p)
 {
 	im->points[i] = p;
+	im->Invalidate();
 }
 
 //-----------------------------------------------------------------------------
 void PointCurve::SetPoints(const std::vector<vec2d>& points)
 {
 	im->points = points;
+	im->Invalidate();
 }
 
 //-----------------------------------------------------------------------------
@@ -184,6 +276,7 @@ void PointCurve::Delete(int n)
 	if ((n >= 0) && (n < Points()) && (Points() > 2))
 	{
 		im->points.erase(im->points.begin() + n);
+		im->Invalidate();
 	}
 }
 
@@ -206,6 +299,7 @@ void PointCurve::Delete(const std::vector<int>& indexList)
 		im->points.erase(im->points.begin() + n);
 		for (int j = i + 1; j < N; ++j) tmp[j]--;
 	}
+	im->Invalidate();
 }
 
 //-----------------------------------------------------------------------------
@@ -271,8 +365,7 @@ double PointCurve::value(double time) const
 
 	if (im->fnc == LINEAR)
 	{
-		int n = 0;
-		while (points[n].x() <= time) ++n;
+		int n = im->FindInterval(time);
 
 		double t0 = points[n - 1].x();
 		double t1 = points[n].x();
@@ -284,15 +377,13 @@ double PointCurve::value(double time) const
 	}
 	else if (im->fnc == STEP)
 	{
-		int n = 0;
-		while (points[n].x() <= time) ++n;
+		int n = im->FindInterval(time);
 
 		return points[n].y();
 	}
 	else if (im->fnc == SMOOTH_STEP)
 	{
-		int n = 0;
-		while (points[n].x() <= time) ++n;
+		int n = im->FindInterval(time);
 
 		double t0 = points[n - 1].x();
 		double t1 = points[n].x();
@@ -332,8 +423,7 @@ double PointCurve::value(double time) const
 		}
 		else
 		{
-			int n = 0;
-			while (points[n].x() <= time) ++n;
+			int n = im->FindInterval(time);
 
 			if (n == 1)
 			{
@@ -678,6 +768,9 @@ bool PointCurve::Update()
 {
 	bool bvalid = true;
 
+	// build the lookup table for long curves
+	im->BuildTable();
+
 	if ((im->fnc > SMOOTH) && (im->fnc < SMOOTH_STEP))
 	{
 		const int N = Points();
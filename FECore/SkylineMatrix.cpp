@@ -125,8 +125,12 @@ void SkylineMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 				// only add values to upper-diagonal part of stiffness matrix
 				if (J>=I)
 				{
-					#pragma omp atomic
-					pv[ pi[J] + J - I] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pv[ pi[J] + J - I] += ke[i][j];
+					}
+					else pv[ pi[J] + J - I] += ke[i][j];
 				}
 			}
 		}
@@ -158,8 +162,12 @@ void SkylineMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const vec
 				// only add values to upper-diagonal part of stiffness matrix
 				if (J>=I)
 				{
-					#pragma omp atomic
-					pv[ pi[J] + J - I] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pv[ pi[J] + J - I] += ke[i][j];
+					}
+					else pv[ pi[J] + J - I] += ke[i][j];
 				}
 			}
 		}
@@ -177,8 +185,12 @@ void SkylineMatrix::add(int i, int j, double v)
 	// only add to the upper triangular part
 	if (j >= i)
 	{
-		#pragma omp atomic
-		m_pd[m_ppointers[j] + j - i] += v;
+		if (m_batomic)
+		{
+			#pragma omp atomic
+			m_pd[m_ppointers[j] + j - i] += v;
+		}
+		else m_pd[m_ppointers[j] + j - i] += v;
 	}
 }
 
@@ -36,6 +36,7 @@ SparseMatrix::SparseMatrix()
 {
 	m_nrow = m_ncol = 0;
 	m_nsize = 0;
+	m_batomic = true;
 }
 
 SparseMatrix::~SparseMatrix()
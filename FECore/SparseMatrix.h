@@ -60,6 +60,14 @@ public:
 	//! return number of nonzeros
 	int NonZeroes() const { return m_nsize; }
 
+	//! Set whether Assemble and add must protect concurrent updates of the same entry.
+	//! This can only be turned off when the caller guarantees that threads never
+	//! assemble into the same matrix entries (e.g. colored element assembly).
+	void SetAtomicAssembly(bool b) { m_batomic = b; }
+
+	//! see if atomic assembly is used
+	bool AtomicAssembly() const { return m_batomic; }
+
 public: // functions to be overwritten in derived classes
 
 	//! set all matrix elements to zero
@@ -111,4 +119,5 @@ protected:
 	// NOTE: These values are set by derived classes
 	int	m_nrow, m_ncol;		//!< dimension of matrix
 	int	m_nsize;			//!< number of nonzeroes (i.e. matrix elements actually allocated)
+	bool	m_batomic;		//!< use atomic updates during assembly
 };
@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include "mortar.h"
 #include <math.h>
 #include "FEMesh.h"
+#include "sys.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // subtract operator for POINT2D
@@ -541,29 +543,234 @@ bool CalculateMortarIntersection(FESurface& ss, FESurface& ms, int k, int l, Pat
 	return (patch.Empty() == false);
 }
 
-void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& mortar)
+//-----------------------------------------------------------------------------
+// Uniform grid over the axis-aligned bounding boxes of the secondary facets.
+// It is used as the broad phase of the mortar surface calculation so that the
+// polygon clipping is only done for facet pairs whose boxes overlap.
+namespace {
+
+struct FACET_BOX
+{
+	vec3d	r0, r1;
+
+	void add(const vec3d& r)
+	{
+		if (r.x < r0.x) r0.x = r.x;
+		if (r.y < r0.y) r0.y = r.y;
+		if (r.z < r0.z) r0.z = r.z;
+		if (r.x > r1.x) r1.x = r.x;
+		if (r.y > r1.y) r1.y = r.y;
+		if (r.z > r1.z) r1.z = r.z;
+	}
+
+	void inflate(double d)
+	{
+		r0.x -= d; r0.y -= d; r0.z -= d;
+		r1.x += d; r1.y += d; r1.z += d;
+	}
+
+	// largest box dimension
+	double size() const
+	{
+		return std::max(r1.x - r0.x, std::max(r1.y - r0.y, r1.z - r0.z));
+	}
+};
+
+class MortarFacetGrid
+{
+public:
+	void Build(const std::vector<FACET_BOX>& box)
+	{
+		int NMF = (int)box.size();
+		m_cell.clear();
+		m_index.clear();
+		if (NMF == 0) return;
+
+		// find the extents of the grid and the average facet size
+		FACET_BOX ext = box[0];
+		double h = 0.0;
+		for (int j = 0; j < NMF; ++j)
+		{
+			ext.add(box[j].r0);
+			ext.add(box[j].r1);
+			h += box[j].size();
+		}
+		h /= NMF;
+
+		// choose the cell size so that a facet overlaps only a few cells,
+		// but don't allow more than a few cells per facet
+		double W = ext.r1.x - ext.r0.x, H = ext.r1.y - ext.r0.y, D = ext.r1.z - ext.r0.z;
+		const double hmin = 1e-12*(ext.size() + 1.0);
+		if (h < hmin) h = hmin;
+		double ncells = (W / h + 1)*(H / h + 1)*(D / h + 1);
+		double nmax = 4.0*NMF + 64.0;
+		if (ncells > nmax) h *= pow(ncells / nmax, 1.0 / 3.0);
+
+		m_r0 = ext.r0;
+		m_h = h;
+		m_nx = (int)(W / h) + 1;
+		m_ny = (int)(H / h) + 1;
+		m_nz = (int)(D / h) + 1;
+
+		// count the facets per cell
+		m_cell.assign(m_nx*m_ny*m_nz + 1, 0);
+		for (int j = 0; j < NMF; ++j)
+		{
+			int i0[3], i1[3];
+			CellRange(box[j], i0, i1);
+			for (int k = i0[2]; k <= i1[2]; ++k)
+				for (int l = i0[1]; l <= i1[1]; ++l)
+					for (int m = i0[0]; m <= i1[0]; ++m) m_cell[Cell(m, l, k) + 1]++;
+		}
+		for (size_t n = 1; n < m_cell.size(); ++n) m_cell[n] += m_cell[n - 1];
+
+		// fill the cells
+		m_index.resize(m_cell.back());
+		std::vector<int> pos(m_cell.begin(), m_cell.end() - 1);
+		for (int j = 0; j < NMF; ++j)
+		{
+			int i0[3], i1[3];
+			CellRange(box[j], i0, i1);
+			for (int k = i0[2]; k <= i1[2]; ++k)
+				for (int l = i0[1]; l <= i1[1]; ++l)
+					for (int m = i0[0]; m <= i1[0]; ++m) m_index[pos[Cell(m, l, k)]++] = j;
+		}
+	}
+
+	// Find all the facets whose boxes overlap with the box b. The tag array
+	// is used to avoid duplicates and must be initialized to -1. The returned
+	// list is sorted.
+	void FindCandidates(const FACET_BOX& b, int tag, std::vector<int>& tags, std::vector<int>& list, const std::vector<FACET_BOX>& box) const
+	{
+		list.clear();
+		if (m_index.empty()) return;
+
+		int i0[3], i1[3];
+		CellRange(b, i0, i1);
+		for (int k = i0[2]; k <= i1[2]; ++k)
+			for (int l = i0[1]; l <= i1[1]; ++l)
+				for (int m = i0[0]; m <= i1[0]; ++m)
+				{
+					int c = Cell(m, l, k);
+					for (int n = m_cell[c]; n < m_cell[c + 1]; ++n)
+					{
+						int j = m_index[n];
+						if ((tags[j] != tag) && Overlap(b, box[j]))
+						{
+							tags[j] = tag;
+							list.push_back(j);
+						}
+					}
+				}
+		std::sort(list.begin(), list.end());
+	}
+
+private:
+	static bool Overlap(const FACET_BOX& a, const FACET_BOX& b)
+	{
+		return ((a.r0.x <= b.r1.x) && (b.r0.x <= a.r1.x) &&
+			    (a.r0.y <= b.r1.y) && (b.r0.y <= a.r1.y) &&
+			    (a.r0.z <= b.r1.z) && (b.r0.z <= a.r1.z));
+	}
+
+	int Clamp(double x, int n) const
+	{
+		int i = (int)floor(x / m_h);
+		return (i < 0 ? 0 : (i >= n ? n - 1 : i));
+	}
+
+	void CellRange(const FACET_BOX& b, int i0[3], int i1[3]) const
+	{
+		i0[0] = Clamp(b.r0.x - m_r0.x, m_nx); i1[0] = Clamp(b.r1.x - m_r0.x, m_nx);
+		i0[1] = Clamp(b.r0.y - m_r0.y, m_ny); i1[1] = Clamp(b.r1.y - m_r0.y, m_ny);
+		i0[2] = Clamp(b.r0.z - m_r0.z, m_nz); i1[2] = Clamp(b.r1.z - m_r0.z, m_nz);
+	}
+
+	int Cell(int i, int j, int k) const { return (k*m_ny + j)*m_nx + i; }
+
+private:
+	vec3d	m_r0;			// lower corner of grid
+	double	m_h = 1.0;		// cell size
+	int		m_nx = 0, m_ny = 0, m_nz = 0;
+	std::vector<int>	m_cell;		// offsets into m_index for each cell
+	std::vector<int>	m_index;	// facet indices per cell
+};
+
+// calculate the bounding box of a surface facet
+FACET_BOX FacetBox(FESurface& s, FESurfaceElement& el)
+{
+	FACET_BOX b;
+	b.r0 = b.r1 = s.Node(el.m_lnode[0]).m_rt;
+	for (int i = 1; i < el.Nodes(); ++i) b.add(s.Node(el.m_lnode[i]).m_rt);
+	return b;
+}
+
+}
+
+//-----------------------------------------------------------------------------
+// Calculates the mortar surface. A facet pair is only considered when the
+// bounding box of the non-mortar facet, inflated by the search radius,
+// overlaps the bounding box of the mortar facet. If the search radius is zero,
+// the largest facet dimension of both surfaces is used.
+void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& mortar, double searchRadius)
 {
-	// loop over all non-mortar facets
 	int NSF = ss.Elements();
 	int NMF = ms.Elements();
-	for (int i=0; i<NSF; ++i)
+	if ((NSF == 0) || (NMF == 0)) return;
+
+	// calculate the facet boxes
+	std::vector<FACET_BOX> sbox(NSF), mbox(NMF);
+	double hmax = 0.0;
+	for (int i = 0; i < NSF; ++i)
+	{
+		sbox[i] = FacetBox(ss, ss.Element(i));
+		hmax = std::max(hmax, sbox[i].size());
+	}
+	for (int j = 0; j < NMF; ++j)
+	{
+		mbox[j] = FacetBox(ms, ms.Element(j));
+		hmax = std::max(hmax, mbox[j].size());
+	}
+
+	// inflate the non-mortar boxes by the search radius
+	double R = (searchRadius > 0.0 ? searchRadius : hmax);
+	for (int i = 0; i < NSF; ++i) sbox[i].inflate(R);
+
+	// setup the broad phase
+	MortarFacetGrid grid;
+	grid.Build(mbox);
+
+	// Clip the candidate pairs in parallel. Each thread processes a contiguous
+	// range of non-mortar facets, so appending the thread lists in order
+	// gives the same patch order as a serial loop.
+	int nt = omp_get_max_threads();
+	if (nt < 1) nt = 1;
+	std::vector< std::vector<Patch> > patches(nt);
+#pragma omp parallel num_threads(nt)
 	{
-		// get the non-mortar surface element
-		FESurfaceElement& se = ss.Element(i);
+		int n = omp_get_thread_num();
+		std::vector<Patch>& local = patches[n];
+		std::vector<int> tags(NMF, -1);
+		std::vector<int> candidates;
 
-		// loop over all the mortar surface elements
-		for (int j=0; j<NMF; ++j)
+#pragma omp for schedule(static)
+		for (int i = 0; i < NSF; ++i)
 		{
-			// get the next surface element
-			FESurfaceElement& me = ms.Element(j);
-
-			// calculate the patch of triangles, representing the intersection
-			// of the non-mortar facet with the mortar facet
-			Patch patch(i,j);
-			CalculateMortarIntersection(ss, ms, i, j, patch);
-			mortar.AddPatch(patch);
+			grid.FindCandidates(sbox[i], i, tags, candidates, mbox);
+			for (int j : candidates)
+			{
+				// calculate the patch of triangles, representing the intersection
+				// of the non-mortar facet with the mortar facet
+				Patch patch(i, j);
+				if (CalculateMortarIntersection(ss, ms, i, j, patch)) local.push_back(patch);
+			}
 		}
 	}
+
+	for (int n = 0; n < nt; ++n)
+	{
+		for (Patch& p : patches[n]) mortar.AddPatch(p);
+	}
 }
 
 bool ExportMortar(MortarSurface& mortar, const char* szfile)
@@ -131,8 +131,9 @@ private:
 FECORE_API bool CalculateMortarIntersection(FESurface& ss, FESurface& ms, int k, int l, Patch& patch);
 
 //-----------------------------------------------------------------------------
-// Calculates the mortar intersection between two surfaces
-FECORE_API void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& s);
+// Calculates the mortar intersection between two surfaces. Only facet pairs
+// that are within the search radius are intersected (zero = automatic).
+FECORE_API void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& s, double searchRadius = 0.0);
 
 //-----------------------------------------------------------------------------
 // Stores the mortar surface in STL format
@@ -31,12 +31,15 @@ SOFTWARE.*/
 #include "vector.h"
 #include "FEMesh.h"
 #include "FEDofList.h"
+#include "MatrixOperator.h"
 #include <algorithm>
 
 double operator*(const vector<double>& a, const vector<double>& b)
 {
 	double sum_p = 0, sum_n = 0;
-	for (size_t i = 0; i < a.size(); i++)
+	int n = (int)a.size();
+#pragma omp parallel for reduction(+:sum_p,sum_n) schedule(static) if (n > BLAS1_MIN_PARALLEL)
+	for (int i = 0; i < n; i++)
 	{
 		double ab = a[i] * b[i];
 		if (ab >= 0.0) sum_p += ab; else sum_n += ab;
@@ -72,19 +75,21 @@ void operator *= (vector<double>& a, double b)
 void vcopys(vector<double>& a, const vector<double>& b, double s)
 {
 	assert(a.size() == b.size());
-	for (size_t i=0; i<a.size(); ++i) a[i] = b[i]*s;
+	int n = (int)a.size();
+#pragma omp parallel for schedule(static) if (n > BLAS1_MIN_PARALLEL)
+	for (int i=0; i<n; ++i) a[i] = b[i]*s;
 }
 
 void vadds(vector<double>& a, const vector<double>& b, double s)
 {
 	assert(a.size() == b.size());
-	for (size_t i = 0; i<a.size(); ++i) a[i] += b[i] * s;
+	MatrixOperator::axpy((int)a.size(), s, b.data(), a.data());
 }
 
 void vsubs(vector<double>& a, const vector<double>& b, double s)
 {
 	assert(a.size() == b.size());
-	for (size_t i = 0; i<a.size(); ++i) a[i] -= b[i] * s;
+	MatrixOperator::axpy((int)a.size(), -s, b.data(), a.data());
 }
 
 void vscale(vector<double>& a, const vector<double>& s)
@@ -186,21 +191,15 @@ void scatter(vector<double>& v, FEMesh& mesh, const FEDofList& dofs)
 
 double l2_norm(const vector<double>& v)
 {
-	double s = 0.0;
-	for (auto vi : v) s += vi*vi;
-	return sqrt(s);
+	return MatrixOperator::norm((int)v.size(), v.data());
 }
 
 double l2_sqrnorm(const vector<double>& v)
 {
-	double s = 0.0;
-	for (auto vi : v) s += vi*vi;
-	return s;
+	return MatrixOperator::dot((int)v.size(), v.data(), v.data());
 }
 
 double l2_norm(double* x, int n)
 {
-	double s = 0.0;
-	for (int i = 0; i < n; ++i) s += x[i]*x[i];
-	return sqrt(s);
+	return MatrixOperator::norm(n, x);
 }
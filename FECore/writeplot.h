@@ -35,22 +35,42 @@ SOFTWARE.*/
 #include "fecore_api.h"
 #include <functional>
 
+// NOTE: Most of the functions below only evaluate the data in parallel when the data stream
+//       allows it (see FEDataStream::isParallel). This is off by default and is only
+//       turned on for plot variables that are marked thread-safe (see FEPlotData::IsThreadSafe).
+//       The writeElementValue and writeAverageElementValue functions that take a material
+//       point function always run in parallel, as they did before the flag was introduced.
+//       The output is allocated up front and each thread writes its values directly 
+//       to its own part of the stream.
+
 //=================================================================================================
 template <class T> void writeNodalValues(FEMesh& mesh, FEDataStream& ar, std::function<T(const FENode& node)> f)
 {
-	for (int i = 0; i<mesh.Nodes(); ++i) ar << f(mesh.Node(i));
+	int NN = mesh.Nodes();
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NN);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NN; ++i) ar.write(n0 + (size_t)i*nc, f(mesh.Node(i)));
 }
 
 //=================================================================================================
 template <class T> void writeNodalValues(FEMeshPartition& dom, FEDataStream& ar, std::function<T(int)> f)
 {
-	for (int i = 0; i<dom.Nodes(); ++i) ar << f(i);
+	int NN = dom.Nodes();
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NN);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NN; ++i) ar.write(n0 + (size_t)i*nc, f(i));
 }
 
 //=================================================================================================
 template <class T> void writeElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<T(int nface)> f)
 {
-	for (int i = 0; i<dom.Elements(); ++i) ar << f(i);
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NE);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NE; ++i) ar.write(n0 + (size_t)i*nc, f(i));
 }
 
 //=================================================================================================
@@ -85,71 +105,83 @@ template <class T> void writeIntegratedElementValue(FESurface& surf, FEDataStrea
 template <class T> void writeElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint& mp)> fnc)
 {
 	int NE = dom.Elements();
-	std::vector<T> v(NE);
-#pragma omp parallel for shared(v)
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NE);
+#pragma omp parallel for
 	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
-		v[i] = fnc(*el.GetMaterialPoint(0));
+		ar.write(n0 + (size_t)i*nc, fnc(*el.GetMaterialPoint(0)));
 	}
-
-	for (int i = 0; i < NE; ++i)
-		ar << v[i];
 }
 
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint& mp)> fnc)
 {
 	int NE = dom.Elements();
-	std::vector<T> v(NE);
-#pragma omp parallel for shared(v)
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NE);
+#pragma omp parallel for
 	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		T s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(*el.GetMaterialPoint(j));
-		v[i] = s / (double)el.GaussPoints();
+		ar.write(n0 + (size_t)i*nc, s / (double)el.GaussPoints());
 	}
-
-	for (int i=0; i<NE; ++i)
-		ar << v[i];
 }
 
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<T(FEElement& el, int ip)> fnc)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NE);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		T s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(el, j);
-		ar << s / (double) el.GaussPoints();
+		ar.write(n0 + (size_t)i*nc, s / (double) el.GaussPoints());
 	}
 }
 
 //=================================================================================================
 template <class Tin, class Tout> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<Tin(const FEMaterialPoint&)> fnc, std::function<Tout(const Tin& m)> flt)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<Tout>();
+	size_t n0 = ar.allocate<Tout>(NE);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		Tin s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(*el.GetMaterialPoint(j));
-		ar << flt(s / (double) el.GaussPoints());
+		ar.write(n0 + (size_t)i*nc, flt(s / (double) el.GaussPoints()));
 	}
 }
 
 //=================================================================================================
 template <class Tin, class Tout> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<Tin(FEElement& el, int ip)> fnc, std::function<Tout(const Tin& m)> flt)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<Tout>();
+	size_t n0 = ar.allocate<Tout>(NE);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		Tin s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(el, j);
-		ar << flt(s / (double)el.GaussPoints());
+		ar.write(n0 + (size_t)i*nc, flt(s / (double)el.GaussPoints()));
 	}
 }
 
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, FEDomainParameter* var)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NE);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		T s(0.0);
 		for (int j = 0; j < el.GaussPoints(); ++j)
@@ -157,14 +189,18 @@ template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStr
 			FEParamValue v = var->value(*el.GetMaterialPoint(j));
 			s += v.value<T>();
 		}
-		ar << s / (double)el.GaussPoints();
+		ar.write(n0 + (size_t)i*nc, s / (double)el.GaussPoints());
 	}
 }
 
 //=================================================================================================
 template <class T> void writeIntegratedElementValue(FESolidDomain& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint& mp)> fnc)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<T>();
+	size_t n0 = ar.allocate<T>(NE);
+#pragma omp parallel for if (ar.isParallel())
+	for (int i = 0; i<NE; ++i) {
 		FESolidElement& el = dom.Element(i);
 		double* gw = el.GaussWeights();
 
@@ -174,21 +210,28 @@ template <class T> void writeIntegratedElementValue(FESolidDomain& dom, FEDataSt
 			FEMaterialPoint& mp = *el.GetMaterialPoint(j);
 			ew += fnc(mp)*dom.detJ0(el, j)*gw[j];
 		}
-		ar << ew;
+		ar.write(n0 + (size_t)i*nc, ew);
 	}
 }
 
 //=================================================================================================
 template <class T> void writeNodalProjectedElementValues(FEMeshPartition& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint&)> var)
 {
-	// temp storage 
-	T si[FEElement::MAX_INTPOINTS];
-	T sn[FEElement::MAX_NODES];
+	// the number of nodes can differ between elements, so figure out where each element's data goes
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<T>();
+	vector<size_t> off(NE + 1, 0);
+	for (int i = 0; i<NE; ++i) off[i + 1] = off[i] + dom.ElementRef(i).Nodes();
+	size_t n0 = ar.allocate<T>(off[NE]);
 
 	// loop over all elements
-	int NE = dom.Elements();
+#pragma omp parallel for if (ar.isParallel())
 	for (int i = 0; i<NE; ++i)
 	{
+		// temp storage 
+		T si[FEElement::MAX_INTPOINTS];
+		T sn[FEElement::MAX_NODES];
+
 		FEElement& e = dom.ElementRef(i);
 		int ne = e.Nodes();
 		int ni = e.GaussPoints();
@@ -205,20 +248,27 @@ template <class T> void writeNodalProjectedElementValues(FEMeshPartition& dom, F
 		e.project_to_nodes(si, sn);
 
 		// push data to archive
-		for (int j = 0; j<ne; ++j) ar << sn[j];
+		for (int j = 0; j<ne; ++j) ar.write(n0 + (off[i] + j)*nc, sn[j]);
 	}
 }
 
 //=================================================================================================
 template <class T> void writeNodalProjectedElementValues(FESurface& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint&)> var)
 {
-	T gi[FEElement::MAX_INTPOINTS];
-	T gn[FEElement::MAX_NODES];
+	// the number of nodes can differ between facets, so figure out where each facet's data goes
+	int NE = dom.Elements();
+	const int nc = FEDataStream::components<T>();
+	vector<size_t> off(NE + 1, 0);
+	for (int i = 0; i<NE; ++i) off[i + 1] = off[i] + dom.Element(i).Nodes();
+	size_t n0 = ar.allocate<T>(off[NE]);
 
 	// loop over all the elements in the domain
-	int NE = dom.Elements();
+#pragma omp parallel for if (ar.isParallel())
 	for (int i = 0; i < NE; ++i)
 	{
+		T gi[FEElement::MAX_INTPOINTS];
+		T gn[FEElement::MAX_NODES];
+
 		// get the element and loop over its integration points
 		// we only calculate the element's average
 		// but since most material parameters can only defined 
@@ -237,7 +287,7 @@ template <class T> void writeNodalProjectedElementValues(FESurface& dom, FEDataS
 		e.FEElement::project_to_nodes(gi, gn);
 
 		// store the result
-		for (int j = 0; j < neln; ++j) ar << gn[j];
+		for (int j = 0; j < neln; ++j) ar.write(n0 + (off[i] + j)*nc, gn[j]);
 	}
 }
 
@@ -26,6 +26,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "BiCGStabSolver.h"
 #include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BSRMatrix.h>
 #include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
@@ -34,6 +35,7 @@ BEGIN_FECORE_CLASS(BiCGStabSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iter, "fail_max_iters");
+	ADD_PARAMETER(m_blockMatrix, "block_matrix");
 	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
 END_FECORE_CLASS();
 
@@ -45,6 +47,7 @@ BiCGStabSolver::BiCGStabSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(
 	m_abstol = 0.0;
 	m_print_level = 0;
 	m_fail_max_iter = true;
+	m_blockMatrix = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -57,10 +60,15 @@ SparseMatrix* BiCGStabSolver::CreateSparseMatrix(Matrix_Type ntype)
 		m_P->SetPartitions(m_part);
 		m_pA = m_P->CreateSparseMatrix(ntype);
 	}
-	else
+
+	// if the preconditioner does not need a particular format, we pick one
+	if (m_pA == nullptr)
 	{
-		if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
+		if (m_blockMatrix) m_pA = new BSRMatrix(GetFEModel(), ntype == REAL_SYMMETRIC);
+		else if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
 		else m_pA = new CRSSparseMatrix(1);
+
+		if (m_P) m_P->SetSparseMatrix(m_pA);
 	}
 	return m_pA;
 }
@@ -121,13 +129,8 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 
 	// calculate initial norm
 	// r0 = b - A*x0
-	vector<double> r_i(neq); double norm0 = 0.0, normi = 0.0;
-	for (int j = 0; j < neq; ++j)
-	{
-		r_i[j] = b[j];
-		norm0 += r_i[j] * r_i[j];
-	}
-	norm0 = sqrt(norm0);
+	vector<double> r_i(b, b + neq); double normi = 0.0;
+	double norm0 = MatrixOperator::norm(neq, &r_i[0]);
 
 	// if the norm is zero, there is nothing to do
 	if (norm0 == 0.0) return true;
@@ -145,11 +148,13 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 	bool converged = false;
 	do
 	{
-		double rho_i = rt*r_i;
+		double rho_i = MatrixOperator::dot(neq, &rt[0], &r_i[0]);
 
 		double beta = (rho_i / rho_p)*(alpha / w_p);
 
-		for (int j = 0; j < neq; ++j) p_i[j] = r_i[j] + beta*(p_p[j] - w_p*v_p[j]);
+		// p_i = r_i + beta*(p_p - w_p*v_p)
+		MatrixOperator::waxpy(neq, &p_p[0], -w_p, &v_p[0], &p_i[0]);
+		MatrixOperator::xpay(neq, &r_i[0], beta, &p_i[0]);
 
 		// apply preconditioner
 		if (m_P)
@@ -160,11 +165,11 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 
 		A.mult_vector(&y[0], &v_p[0]);
 
-		alpha = rho_i / (rt*v_p);
+		alpha = rho_i / MatrixOperator::dot(neq, &rt[0], &v_p[0]);
 
-		for (int j = 0; j < neq; ++j) h[j] = x[j] + alpha*y[j];
+		MatrixOperator::waxpy(neq, x, alpha, &y[0], &h[0]);
 
-		for (int j = 0; j < neq; ++j) s[j] = r_i[j] - alpha*v_p[j];
+		MatrixOperator::waxpy(neq, &r_i[0], -alpha, &v_p[0], &s[0]);
 //		If h is accurate enough then xi = h and quit
 
 		if (m_P)
@@ -181,17 +186,12 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 		}
 		else q = t;
 
-		w_p = (q*z) / (q*q);
+		w_p = MatrixOperator::dot(neq, &q[0], &z[0]) / MatrixOperator::dot(neq, &q[0], &q[0]);
 
-		for (int j = 0; j < neq; ++j) x[j] = h[j] + w_p*z[j];
-		
-		normi = 0.0;
-		for (int j = 0; j < neq; ++j)
-		{
-			r_i[j] = s[j] - w_p*t[j];
-			normi += r_i[j] * r_i[j];
-		}
-		normi = sqrt(normi);
+		MatrixOperator::waxpy(neq, &h[0], w_p, &z[0], x);
+
+		r_i = s;
+		normi = sqrt(MatrixOperator::axpy_sqrnorm(neq, -w_p, &t[0], &r_i[0]));
 
 		// see if we have converged
 		double tol = norm0*m_tol + m_abstol;
@@ -59,6 +59,7 @@ protected:
 	double	m_abstol;		// absolute residual tolerance
 	int		m_print_level;	// output level
 	double	m_fail_max_iter;
+	bool	m_blockMatrix;	// use 3x3 block sparse (BSR) storage
 
 	DECLARE_FECORE_CLASS();
 };
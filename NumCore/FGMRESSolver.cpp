@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FGMRESSolver.h"
 #include <FECore/CompactSymmMatrix.h>
 #include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BSRMatrix.h>
 #include <FECore/log.h>
 #include "MatrixTools.h"
 
@@ -52,6 +53,7 @@ BEGIN_FECORE_CLASS(FGMRESSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_reltol        , "tol");
 	ADD_PARAMETER(m_abstol        , "abs_tol");
 	ADD_PARAMETER(m_maxIterFail   , "fail_max_iters");
+	ADD_PARAMETER(m_blockMatrix   , "block_matrix");
 
 	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
 	ADD_PROPERTY(m_R, "pc_right")->SetFlags(FEProperty::Optional);
@@ -75,6 +77,7 @@ FGMRESSolver::FGMRESSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0)
 	m_R = 0;	// no right preconditioner
 
 	m_maxIterFail = true;
+	m_blockMatrix = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -211,7 +214,11 @@ SparseMatrix* FGMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
 	}
 
 	// if the matrix is still zero, let's just allocate one
-	if (m_pA == nullptr)
+	if ((m_pA == nullptr) && m_blockMatrix)
+	{
+		m_pA = new BSRMatrix(GetFEModel(), ntype == REAL_SYMMETRIC);
+	}
+	else if (m_pA == nullptr)
 	{
 		// allocate new matrix
 		switch (ntype)
@@ -116,6 +116,7 @@ private:
 	bool	m_maxIterFail;
 	bool	m_print_cn;			// Calculate and print the condition number
 	bool	m_do_jacobi;
+	bool	m_blockMatrix;		// use 3x3 block sparse (BSR) storage
 
 private:
 	SparseMatrix*	m_pA;		//!< the sparse matrix format
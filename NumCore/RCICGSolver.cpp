@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "RCICGSolver.h"
 #include "IncompleteCholesky.h"
+#include <FECore/BSRMatrix.h>
+#include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
@@ -47,6 +49,7 @@ BEGIN_FECORE_CLASS(RCICGSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_blockMatrix, "block_matrix");
 	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
 END_FECORE_CLASS();
 
@@ -57,6 +60,7 @@ RCICGSolver::RCICGSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0), m_
 	m_tol = 1e-5;
 	m_print_level = 0;
 	m_fail_max_iters = true;
+	m_blockMatrix = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -64,11 +68,22 @@ SparseMatrix* RCICGSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
 #ifdef MKL_ISS
 	if (ntype != REAL_SYMMETRIC) return 0;
-	m_pA = new CompactSymmMatrix(1);
+	// the MKL preconditioners expect the compact format, so the block format is only used without one
+	if (m_blockMatrix && (m_P == nullptr)) m_pA = new BSRMatrix(GetFEModel(), true);
+	else m_pA = new CompactSymmMatrix(1);
 	if (m_P) m_P->SetSparseMatrix(m_pA);
 	return m_pA;
 #else
-	return 0;
+	// use the native CG implementation
+	if (ntype != REAL_SYMMETRIC) return 0;
+	m_pA = (m_P ? m_P->CreateSparseMatrix(ntype) : nullptr);
+	if (m_pA == nullptr)
+	{
+		if (m_blockMatrix) m_pA = new BSRMatrix(GetFEModel(), true);
+		else m_pA = new CompactSymmMatrix(1);
+		if (m_P) m_P->SetSparseMatrix(m_pA);
+	}
+	return m_pA;
 #endif
 }
 
@@ -209,7 +224,50 @@ bool RCICGSolver::BackSolve(double* x, double* b)
 
 	return (m_fail_max_iters ? bsuccess : true);
 #else
-	return false;
+	// native preconditioned conjugate gradient
+	if (m_pA == 0) return false;
+	int n = m_pA->Rows();
+
+	vector<double> r(b, b + n), z(n), p(n), q(n);
+	for (int i = 0; i < n; ++i) x[i] = 0.0;
+
+	double norm0 = MatrixOperator::norm(n, &r[0]);
+	if (norm0 == 0.0) return true;
+
+	if (m_P) m_P->BackSolve(&z[0], &r[0]); else z = r;
+	p = z;
+	double rz = MatrixOperator::dot(n, &r[0], &z[0]);
+
+	int max_iter = (m_maxiter > 0 ? m_maxiter : n);
+	int iter = 0;
+	bool converged = false;
+	double normi = norm0;
+	while (iter < max_iter)
+	{
+		m_pA->mult_vector(&p[0], &q[0]);
+		double pq = MatrixOperator::dot(n, &p[0], &q[0]);
+		if (pq == 0.0) break;
+		double alpha = rz / pq;
+
+		MatrixOperator::axpy(n, alpha, &p[0], x);
+		normi = sqrt(MatrixOperator::axpy_sqrnorm(n, -alpha, &q[0], &r[0]));
+		iter++;
+
+		if (m_print_level > 1) feLog("%d: %lg, %lg\n", iter, normi, norm0*m_tol);
+		if (normi <= norm0*m_tol) { converged = true; break; }
+
+		if (m_P) m_P->BackSolve(&z[0], &r[0]); else z = r;
+		double rz_new = MatrixOperator::dot(n, &r[0], &z[0]);
+		double beta = rz_new / rz;
+		rz = rz_new;
+		MatrixOperator::xpay(n, &z[0], beta, &p[0]);
+	}
+
+	if (m_print_level == 1) feLog("%d: %lg, %lg\n", iter, normi, norm0);
+
+	UpdateStats(iter);
+
+	return (m_fail_max_iters ? converged : true);
 #endif // MKL_ISS
 }
 
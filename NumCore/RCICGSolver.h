@@ -59,6 +59,7 @@ protected:
 	double	m_tol;			// residual relative tolerance
 	int		m_print_level;	// output level
 	bool	m_fail_max_iters;
+	bool	m_blockMatrix;	// use 3x3 block sparse (BSR) storage
 
 	DECLARE_FECORE_CLASS();
 };
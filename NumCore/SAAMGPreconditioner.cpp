@@ -0,0 +1,933 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SAAMGPreconditioner.h"
+#include <FECore/CompactMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/BSRMatrix.h>
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/log.h>
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(SAAMGPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_maxLevels , "max_levels");
+	ADD_PARAMETER(m_coarseSize, "coarse_size");
+	ADD_PARAMETER(m_theta     , "strength_threshold");
+	ADD_PARAMETER(m_degree    , "smoother_degree");
+	ADD_PARAMETER(m_omega     , "prolongator_damping");
+	ADD_PARAMETER(m_printLevel, "print_level");
+END_FECORE_CLASS();
+
+//=============================================================================
+// Simple compressed row storage matrix used for the multigrid hierarchy
+struct CSRMat
+{
+	int	nr = 0, nc = 0;
+	vector<int>		p;	// row pointers
+	vector<int>		c;	// column indices
+	vector<double>	v;	// values
+
+	int nnz() const { return (int)c.size(); }
+
+	// y = A*x
+	void mult(const double* x, double* y) const
+	{
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < nr; ++i)
+		{
+			double s = 0.0;
+			for (int k = p[i]; k < p[i + 1]; ++k) s += v[k] * x[c[k]];
+			y[i] = s;
+		}
+	}
+
+};
+
+//=============================================================================
+// Row access to the matrix of a level. The coarse levels point to their own 
+// CSR matrix, but the fine level can point directly to the global matrix, so 
+// that it does not have to be copied. For symmetric matrices only the upper 
+// triangular part of the rows is stored (i.e. the columns of the lower 
+// triangular storage), and the rest of each row is found through the row index
+// of the strictly lower-triangular entries.
+struct RowMat
+{
+	int	nr = 0, nc = 0;
+	int	off = 0;					// index offset of p and c
+	const int*		p = nullptr;	// row pointers
+	const int*		c = nullptr;	// column indices
+	const double*	v = nullptr;	// values
+	const int*		lp = nullptr;	// row pointers of lower triangular part (symmetric only)
+	const int*		lc = nullptr;	// columns of the lower triangular part
+	const int*		lv = nullptr;	// positions of the lower triangular values in v
+
+	int nnz() const { return (p[nr] - p[0]) + (lp ? lp[nr] : 0); }
+
+	// call f(j, aij) for all entries of row i
+	template <class F> void forEachInRow(int i, F f) const
+	{
+		for (int k = p[i] - off; k < p[i + 1] - off; ++k) f(c[k] - off, v[k]);
+		if (lp) for (int k = lp[i]; k < lp[i + 1]; ++k) f(lc[k], v[lv[k]]);
+	}
+
+	// r = b - A*x
+	void residual(const double* b, const double* x, double* r) const
+	{
+#pragma omp parallel for schedule(dynamic, 256)
+		for (int i = 0; i < nr; ++i)
+		{
+			double s = b[i];
+			forEachInRow(i, [&](int j, double aij) { s -= aij * x[j]; });
+			r[i] = s;
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+static RowMat RowView(const CSRMat& A)
+{
+	RowMat R;
+	R.nr = A.nr;
+	R.nc = A.nc;
+	R.p = A.p.data();
+	R.c = A.c.data();
+	R.v = A.v.data();
+	return R;
+}
+
+//-----------------------------------------------------------------------------
+// Access the global matrix without copying it. This is possible for row-based
+// storage and for the symmetric (lower-triangular, column-based) storage.
+static bool GlobalMatrixView(SparseMatrix* K, RowMat& A)
+{
+	CompactMatrix* C = dynamic_cast<CompactMatrix*>(K);
+	if (C == nullptr) return false;
+
+	CompactSymmMatrix* S = dynamic_cast<CompactSymmMatrix*>(K);
+	if ((S == nullptr) && ((C->isRowBased() == false) || C->isSymmetric())) return false;
+
+	A.nr = C->Rows();
+	A.nc = C->Columns();
+	A.off = C->Offset();
+	A.p = C->Pointers();
+	A.c = C->Indices();
+	A.v = C->Values();
+	if (S) S->GetRowIndex(A.lp, A.lc, A.lv);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Build a CSR matrix from an entry generator. The generator is called twice:
+// once for counting and once for filling in the entries.
+template <class F> static void BuildCSR(CSRMat& A, int nr, int nc, F forEachEntry)
+{
+	A.nr = nr;
+	A.nc = nc;
+	A.p.assign(nr + 1, 0);
+	forEachEntry([&](int i, int j, double v) { A.p[i + 1]++; });
+	for (int i = 0; i < nr; ++i) A.p[i + 1] += A.p[i];
+
+	A.c.resize(A.p[nr]);
+	A.v.resize(A.p[nr]);
+	vector<int> pos(A.p.begin(), A.p.end() - 1);
+	forEachEntry([&](int i, int j, double v) {
+		int k = pos[i]++;
+		A.c[k] = j;
+		A.v[k] = v;
+	});
+}
+
+//-----------------------------------------------------------------------------
+// Copy the global matrix to CSR format
+static bool ConvertMatrix(SparseMatrix* K, CSRMat& A)
+{
+	int n = K->Rows();
+
+	CompactMatrix* C = dynamic_cast<CompactMatrix*>(K);
+	if (C)
+	{
+		const int off = C->Offset();
+		const int* pp = C->Pointers();
+		const int* pi = C->Indices();
+		const double* pv = C->Values();
+		const bool brow = C->isRowBased();
+		const bool bsym = C->isSymmetric();
+		BuildCSR(A, n, n, [=](auto f) {
+			for (int k = 0; k < n; ++k)
+			{
+				for (int l = pp[k] - off; l < pp[k + 1] - off; ++l)
+				{
+					int m = pi[l] - off;
+					if (brow) f(k, m, pv[l]);
+					else
+					{
+						f(m, k, pv[l]);
+						if (bsym && (m != k)) f(k, m, pv[l]);
+					}
+				}
+			}
+		});
+		return true;
+	}
+
+	BSRMatrix* B = dynamic_cast<BSRMatrix*>(K);
+	if (B)
+	{
+		const int nbr = B->BlockRows();
+		const int* pp = B->BlockPointers();
+		const int* pc = B->BlockIndices();
+		const int* eq = B->BlockEquations();
+		const bool bsym = B->IsSymmetric();
+		BuildCSR(A, n, n, [=](auto f) {
+			for (int I = 0; I < nbr; ++I)
+				for (int k = pp[I]; k < pp[I + 1]; ++k)
+				{
+					int J = pc[k];
+					const double* a = B->Block(k);
+					for (int p = 0; p < 3; ++p)
+						for (int q = 0; q < 3; ++q)
+						{
+							int i = eq[3 * I + p], j = eq[3 * J + q];
+							if ((i >= 0) && (j >= 0) && (a[3 * p + q] != 0.0))
+							{
+								f(i, j, a[3 * p + q]);
+								// only the upper blocks of symmetric matrices are stored
+								if (bsym && (I != J)) f(j, i, a[3 * p + q]);
+							}
+						}
+				}
+		});
+		return true;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+static void Transpose(const CSRMat& A, CSRMat& T)
+{
+	BuildCSR(T, A.nc, A.nr, [&](auto f) {
+		for (int i = 0; i < A.nr; ++i)
+			for (int k = A.p[i]; k < A.p[i + 1]; ++k) f(A.c[k], i, A.v[k]);
+	});
+}
+
+//-----------------------------------------------------------------------------
+// C = A*B (row-by-row Gustavson algorithm)
+static void Multiply(const CSRMat& A, const RowMat& B, CSRMat& C)
+{
+	const int nr = A.nr;
+	const int nc = B.nc;
+	C.nr = nr;
+	C.nc = nc;
+	C.p.assign(nr + 1, 0);
+
+	// count the nonzeroes of each row
+#pragma omp parallel
+	{
+		vector<int> mark(nc, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < nr; ++i)
+		{
+			int cnt = 0;
+			for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+			{
+				B.forEachInRow(A.c[k], [&](int m, double bjm) {
+					if (mark[m] != i) { mark[m] = i; cnt++; }
+				});
+			}
+			C.p[i + 1] = cnt;
+		}
+	}
+	for (int i = 0; i < nr; ++i) C.p[i + 1] += C.p[i];
+	C.c.resize(C.p[nr]);
+	C.v.resize(C.p[nr]);
+
+	// fill in the values
+#pragma omp parallel
+	{
+		vector<int> pos(nc, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < nr; ++i)
+		{
+			int n0 = C.p[i], n = n0;
+			for (int k = A.p[i]; k < A.p[i + 1]; ++k)
+			{
+				double aij = A.v[k];
+				B.forEachInRow(A.c[k], [&](int m, double bjm) {
+					if ((pos[m] < n0) || (pos[m] >= n) || (C.c[pos[m]] != m))
+					{
+						pos[m] = n;
+						C.c[n] = m;
+						C.v[n] = aij * bjm;
+						n++;
+					}
+					else C.v[pos[m]] += aij * bjm;
+				});
+			}
+			assert(n == C.p[i + 1]);
+		}
+	}
+}
+
+//=============================================================================
+// One level of the multigrid hierarchy
+struct AMGLevel
+{
+	RowMat	A;			// level matrix
+	CSRMat	Ac;			// storage of the level matrix (not used when the fine level accesses the global matrix)
+	CSRMat	P, R;		// prolongation and restriction to the next level
+	vector<double>	Dinv;	// inverse of diagonal
+	double	lmax;		// estimate of the largest eigenvalue of Dinv*A
+
+	vector<double>	x, b, r, d;	// work vectors
+};
+
+class SAAMGPreconditioner::Impl
+{
+public:
+	vector<AMGLevel>	levels;
+
+	// dense LU factorization of the coarsest level
+	vector<double>	LU;
+	vector<int>		piv;
+	bool			bdirect = false;
+
+	int		degree = 2;
+
+public:
+	void Clear() { levels.clear(); LU.clear(); piv.clear(); bdirect = false; }
+
+	void Smooth(AMGLevel& L, bool zeroGuess);
+	void VCycle(int l);
+	bool FactorCoarse(const RowMat& A);
+	void SolveCoarse(double* x, const double* b);
+};
+
+//-----------------------------------------------------------------------------
+// calculate the inverse diagonal and estimate the spectral radius of Dinv*A
+static void SetupLevel(AMGLevel& L)
+{
+	const RowMat& A = L.A;
+	int n = A.nr;
+	L.Dinv.assign(n, 1.0);
+#pragma omp parallel for
+	for (int i = 0; i < n; ++i)
+	{
+		A.forEachInRow(i, [&](int j, double aij) {
+			double d = fabs(aij);
+			if ((j == i) && (d > 0.0)) L.Dinv[i] = 1.0 / d;
+		});
+	}
+
+	// Gershgorin bound on the spectral radius. Unlike a power iteration estimate, this
+	// never underestimates the largest eigenvalue, which would make the smoother unstable.
+	// (the max is combined by hand, since max reductions need OpenMP 3.1)
+	double lmax = 0.0;
+#pragma omp parallel shared(lmax)
+	{
+		double lmax_t = 0.0;
+#pragma omp for
+		for (int i = 0; i < n; ++i)
+		{
+			double s = 0.0;
+			A.forEachInRow(i, [&](int j, double aij) { s += fabs(aij); });
+			s *= L.Dinv[i];
+			if (s > lmax_t) lmax_t = s;
+		}
+
+#pragma omp critical
+		{
+			if (lmax_t > lmax) lmax = lmax_t;
+		}
+	}
+	L.lmax = (lmax > 0.0 ? lmax : 1.0);
+
+	L.x.resize(n);
+	L.b.resize(n);
+	L.r.resize(n);
+	L.d.resize(n);
+}
+
+//-----------------------------------------------------------------------------
+// Chebyshev smoother for Dinv*A on the interval [lmax/30, lmax]
+void SAAMGPreconditioner::Impl::Smooth(AMGLevel& L, bool zeroGuess)
+{
+	const int n = L.A.nr;
+	double* x = &L.x[0];
+	double* b = &L.b[0];
+	double* r = &L.r[0];
+	double* d = &L.d[0];
+	const double* Di = &L.Dinv[0];
+
+	const double lmax = L.lmax;
+	const double lmin = lmax / 30.0;
+	const double theta = 0.5*(lmax + lmin);
+	const double delta = 0.5*(lmax - lmin);
+	const double sigma = theta / delta;
+	double rho = 1.0 / sigma;
+
+	if (zeroGuess)
+	{
+#pragma omp parallel for
+		for (int i = 0; i < n; ++i) { d[i] = Di[i] * b[i] / theta; x[i] = d[i]; }
+	}
+	else
+	{
+		L.A.residual(b, x, r);
+#pragma omp parallel for
+		for (int i = 0; i < n; ++i) { d[i] = Di[i] * r[i] / theta; x[i] += d[i]; }
+	}
+
+	for (int k = 1; k < degree; ++k)
+	{
+		L.A.residual(b, x, r);
+		double rho_new = 1.0 / (2.0*sigma - rho);
+		double a = rho_new*rho;
+		double c = 2.0*rho_new / delta;
+#pragma omp parallel for
+		for (int i = 0; i < n; ++i)
+		{
+			d[i] = a*d[i] + c*Di[i] * r[i];
+			x[i] += d[i];
+		}
+		rho = rho_new;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// V-cycle on level l. The right-hand side is in levels[l].b, the result
+// is returned in levels[l].x.
+void SAAMGPreconditioner::Impl::VCycle(int l)
+{
+	AMGLevel& L = levels[l];
+	int n = L.A.nr;
+
+	// coarsest level
+	if (l == (int)levels.size() - 1)
+	{
+		if (bdirect) SolveCoarse(&L.x[0], &L.b[0]);
+		else
+		{
+			Smooth(L, true);
+			for (int k = 0; k < 4; ++k) Smooth(L, false);
+		}
+		return;
+	}
+
+	// pre-smoothing
+	Smooth(L, true);
+
+	// restrict the residual
+	AMGLevel& C = levels[l + 1];
+	L.A.residual(&L.b[0], &L.x[0], &L.r[0]);
+	L.R.mult(&L.r[0], &C.b[0]);
+
+	// coarse grid correction
+	VCycle(l + 1);
+	L.P.mult(&C.x[0], &L.d[0]);
+#pragma omp parallel for
+	for (int i = 0; i < n; ++i) L.x[i] += L.d[i];
+
+	// post-smoothing
+	Smooth(L, false);
+}
+
+//-----------------------------------------------------------------------------
+bool SAAMGPreconditioner::Impl::FactorCoarse(const RowMat& A)
+{
+	int n = A.nr;
+	LU.assign((size_t)n*n, 0.0);
+	piv.resize(n);
+	for (int i = 0; i < n; ++i)
+		A.forEachInRow(i, [&](int j, double aij) { LU[(size_t)i*n + j] += aij; });
+
+	// LU with partial pivoting
+	for (int k = 0; k < n; ++k)
+	{
+		int p = k;
+		double vmax = fabs(LU[(size_t)k*n + k]);
+		for (int i = k + 1; i < n; ++i)
+		{
+			double v = fabs(LU[(size_t)i*n + k]);
+			if (v > vmax) { vmax = v; p = i; }
+		}
+		piv[k] = p;
+		if (p != k)
+			for (int j = 0; j < n; ++j) swap(LU[(size_t)k*n + j], LU[(size_t)p*n + j]);
+
+		double akk = LU[(size_t)k*n + k];
+		if (akk == 0.0) return false;
+
+#pragma omp parallel for
+		for (int i = k + 1; i < n; ++i)
+		{
+			double* ai = &LU[(size_t)i*n];
+			const double* ak = &LU[(size_t)k*n];
+			double f = ai[k] / akk;
+			ai[k] = f;
+			if (f != 0.0)
+				for (int j = k + 1; j < n; ++j) ai[j] -= f*ak[j];
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SAAMGPreconditioner::Impl::SolveCoarse(double* x, const double* b)
+{
+	int n = (int)piv.size();
+	for (int i = 0; i < n; ++i) x[i] = b[i];
+	for (int k = 0; k < n; ++k) if (piv[k] != k) swap(x[k], x[piv[k]]);
+	for (int i = 0; i < n; ++i)
+	{
+		const double* ai = &LU[(size_t)i*n];
+		double s = x[i];
+		for (int j = 0; j < i; ++j) s -= ai[j] * x[j];
+		x[i] = s;
+	}
+	for (int i = n - 1; i >= 0; --i)
+	{
+		const double* ai = &LU[(size_t)i*n];
+		double s = x[i];
+		for (int j = i + 1; j < n; ++j) s -= ai[j] * x[j];
+		x[i] = s / ai[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Aggregate the groups of equations. Groups are the sets of equations that are
+// always kept together (e.g. the displacement equations of a node). The
+// aggregation uses the usual three phases of Vanek et al.
+static int Aggregate(const RowMat& A, const vector<int>& gptr, const vector<int>& geq, double theta, vector<int>& agg)
+{
+	const int ng = (int)gptr.size() - 1;
+	const int n = A.nr;
+
+	// group of each equation
+	vector<int> grp(n, -1);
+	for (int g = 0; g < ng; ++g)
+		for (int k = gptr[g]; k < gptr[g + 1]; ++k) grp[geq[k]] = g;
+
+	// Frobenius norm of the diagonal blocks
+	vector<double> dn(ng, 0.0);
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int g = 0; g < ng; ++g)
+	{
+		double s = 0.0;
+		for (int k = gptr[g]; k < gptr[g + 1]; ++k)
+		{
+			A.forEachInRow(geq[k], [&](int j, double aij) {
+				if (grp[j] == g) s += aij * aij;
+			});
+		}
+		dn[g] = sqrt(s);
+	}
+
+	// strong connections between groups (sorted by decreasing strength)
+	vector< vector< pair<double, int> > > S(ng);
+	const double th2 = theta*theta;
+#pragma omp parallel
+	{
+		vector<double> acc(ng, 0.0);
+		vector<int> mark(ng, -1);
+		vector<int> touched;
+#pragma omp for schedule(dynamic, 256)
+		for (int g = 0; g < ng; ++g)
+		{
+			touched.clear();
+			for (int k = gptr[g]; k < gptr[g + 1]; ++k)
+			{
+				A.forEachInRow(geq[k], [&](int j, double aij) {
+					int h = grp[j];
+					if (h == g) return;
+					if (mark[h] != g) { mark[h] = g; acc[h] = 0.0; touched.push_back(h); }
+					acc[h] += aij * aij;
+				});
+			}
+
+			vector< pair<double, int> >& Sg = S[g];
+			for (int h : touched)
+			{
+				double ah = acc[h];
+				if ((ah > 0.0) && (ah > th2*dn[g] * dn[h])) Sg.push_back(pair<double, int>(-ah, h));
+			}
+			std::sort(Sg.begin(), Sg.end());
+		}
+	}
+
+	// phase 1: groups whose strong neighbors are all free form a new aggregate
+	agg.assign(ng, -1);
+	int na = 0;
+	for (int g = 0; g < ng; ++g)
+	{
+		if (agg[g] != -1) continue;
+		if (S[g].empty()) continue;
+		bool bfree = true;
+		for (auto& s : S[g]) if (agg[s.second] != -1) { bfree = false; break; }
+		if (bfree)
+		{
+			agg[g] = na;
+			for (auto& s : S[g]) agg[s.second] = na;
+			na++;
+		}
+	}
+
+	// phase 2: attach the remaining groups to the strongest neighboring aggregate
+	vector<int> agg1(agg);
+	for (int g = 0; g < ng; ++g)
+	{
+		if (agg[g] != -1) continue;
+		for (auto& s : S[g])
+			if (agg1[s.second] != -1) { agg[g] = agg1[s.second]; break; }
+	}
+
+	// phase 3: aggregate whatever is left
+	for (int g = 0; g < ng; ++g)
+	{
+		if (agg[g] != -1) continue;
+		agg[g] = na;
+		for (auto& s : S[g]) if (agg[s.second] == -1) agg[s.second] = na;
+		na++;
+	}
+
+	return na;
+}
+
+//-----------------------------------------------------------------------------
+// Build the tentative prolongator by orthonormalizing the near-null space over each
+// aggregate. On return, B holds the coarse near-null space and the groups are
+// replaced by the coarse groups (i.e. the coarse equations of each aggregate).
+static void TentativeProlongator(int n, int na, const vector<int>& agg, vector<int>& gptr, vector<int>& geq, vector<double>& B, int nb, CSRMat& T)
+{
+	const int ng = (int)gptr.size() - 1;
+
+	// collect the equations of each aggregate
+	vector<int> aptr(na + 1, 0);
+	for (int g = 0; g < ng; ++g) aptr[agg[g] + 1] += gptr[g + 1] - gptr[g];
+	for (int a = 0; a < na; ++a) aptr[a + 1] += aptr[a];
+	vector<int> aeq(aptr[na]);
+	vector<int> pos(aptr.begin(), aptr.end() - 1);
+	for (int g = 0; g < ng; ++g)
+		for (int k = gptr[g]; k < gptr[g + 1]; ++k) aeq[pos[agg[g]]++] = geq[k];
+
+	// orthonormalize the near-null space over each aggregate (modified Gram-Schmidt)
+	vector< vector<double> > Q(na), R(na);
+	vector<int> ncol(na, 0);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int a = 0; a < na; ++a)
+	{
+		int m = aptr[a + 1] - aptr[a];
+		const int* eq = &aeq[aptr[a]];
+
+		vector<double>& q = Q[a];
+		vector<double>& r = R[a];
+		q.resize((size_t)m*nb);
+		r.assign((size_t)nb*nb, 0.0);
+		for (int i = 0; i < m; ++i)
+			for (int j = 0; j < nb; ++j) q[(size_t)j*m + i] = B[(size_t)eq[i] * nb + j];
+
+		int nc = 0;
+		for (int j = 0; j < nb; ++j)
+		{
+			double* qj = &q[(size_t)nc*m];
+			if (nc != j) for (int i = 0; i < m; ++i) qj[i] = q[(size_t)j*m + i];
+
+			double n0 = 0.0;
+			for (int i = 0; i < m; ++i) n0 += qj[i] * qj[i];
+			n0 = sqrt(n0);
+
+			// orthogonalize twice for stability
+			for (int pass = 0; pass < 2; ++pass)
+				for (int l = 0; l < nc; ++l)
+				{
+					const double* ql = &q[(size_t)l*m];
+					double s = 0.0;
+					for (int i = 0; i < m; ++i) s += ql[i] * qj[i];
+					for (int i = 0; i < m; ++i) qj[i] -= s*ql[i];
+					r[(size_t)l*nb + j] += s;
+				}
+
+			double nj = 0.0;
+			for (int i = 0; i < m; ++i) nj += qj[i] * qj[i];
+			nj = sqrt(nj);
+
+			// drop linearly dependent columns
+			if ((nj == 0.0) || (nj <= 1e-10*n0)) continue;
+
+			for (int i = 0; i < m; ++i) qj[i] /= nj;
+			r[(size_t)nc*nb + j] = nj;
+			nc++;
+		}
+		ncol[a] = nc;
+	}
+
+	// coarse equation numbering
+	vector<int> cptr(na + 1, 0);
+	for (int a = 0; a < na; ++a) cptr[a + 1] = cptr[a] + ncol[a];
+	int nc = cptr[na];
+
+	// assemble the tentative prolongator
+	T.nr = n;
+	T.nc = nc;
+	T.p.assign(n + 1, 0);
+	for (int a = 0; a < na; ++a)
+		for (int k = aptr[a]; k < aptr[a + 1]; ++k) T.p[aeq[k] + 1] = ncol[a];
+	for (int i = 0; i < n; ++i) T.p[i + 1] += T.p[i];
+	T.c.resize(T.p[n]);
+	T.v.resize(T.p[n]);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int a = 0; a < na; ++a)
+	{
+		int m = aptr[a + 1] - aptr[a];
+		for (int k = 0; k < m; ++k)
+		{
+			int i = aeq[aptr[a] + k];
+			int l0 = T.p[i];
+			for (int j = 0; j < ncol[a]; ++j)
+			{
+				T.c[l0 + j] = cptr[a] + j;
+				T.v[l0 + j] = Q[a][(size_t)j*m + k];
+			}
+		}
+	}
+
+	// coarse near-null space and coarse groups
+	vector<double> Bc((size_t)nc*nb, 0.0);
+	for (int a = 0; a < na; ++a)
+		for (int j = 0; j < ncol[a]; ++j)
+			for (int l = 0; l < nb; ++l) Bc[(size_t)(cptr[a] + j)*nb + l] = R[a][(size_t)j*nb + l];
+	B.swap(Bc);
+
+	gptr = cptr;
+	geq.resize(nc);
+	for (int i = 0; i < nc; ++i) geq[i] = i;
+}
+
+//=============================================================================
+SAAMGPreconditioner::SAAMGPreconditioner(FEModel* fem) : Preconditioner(fem), m(new Impl)
+{
+	m_maxLevels = 10;
+	m_coarseSize = 500;
+	m_theta = 0.0;
+	m_degree = 2;
+	m_omega = 4.0 / 3.0;
+	m_printLevel = 0;
+}
+
+//-----------------------------------------------------------------------------
+SAAMGPreconditioner::~SAAMGPreconditioner()
+{
+	delete m;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SAAMGPreconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// symmetric matrices only store the lower triangular part
+	SparseMatrix* K = nullptr;
+	if (ntype == REAL_SYMMETRIC) K = new CompactSymmMatrix(1);
+	else K = new CRSSparseMatrix(0);
+	SetSparseMatrix(K);
+	return K;
+}
+
+//-----------------------------------------------------------------------------
+void SAAMGPreconditioner::Destroy()
+{
+	m->Clear();
+}
+
+//-----------------------------------------------------------------------------
+bool SAAMGPreconditioner::Factor()
+{
+	SparseMatrix* K = GetSparseMatrix();
+	if ((K == nullptr) || (K->IsSquare() == false)) return false;
+
+	m->Clear();
+	m->degree = (m_degree < 1 ? 1 : m_degree);
+
+	// The fine level accesses the global matrix directly if the format allows it,
+	// otherwise it is copied. (The levels are reserved up front, since the level 
+	// matrices point to the storage of the levels.)
+	m->levels.reserve(m_maxLevels > 1 ? m_maxLevels : 1);
+	m->levels.push_back(AMGLevel());
+	AMGLevel& L0 = m->levels[0];
+	if (GlobalMatrixView(K, L0.A) == false)
+	{
+		if (ConvertMatrix(K, L0.Ac) == false)
+		{
+			feLogError("sa_amg preconditioner does not support this matrix format.");
+			return false;
+		}
+		L0.A = RowView(L0.Ac);
+	}
+	const int n = L0.A.nr;
+
+	// Setup the near-null space. For the displacement equations these are the rigid
+	// body modes, and equations of the same node are grouped. All other equations
+	// are kept as separate groups and only use the constant mode.
+	const int nb = 6;
+	vector<double> B((size_t)n*nb, 0.0);
+	vector<int> gptr(1, 0), geq;
+	vector<int> eqNode(n, -1);
+
+	FEModel* fem = GetFEModel();
+	int dofs[3] = { -1, -1, -1 };
+	if (fem)
+	{
+		dofs[0] = fem->GetDOFIndex("x");
+		dofs[1] = fem->GetDOFIndex("y");
+		dofs[2] = fem->GetDOFIndex("z");
+	}
+	if (fem && (dofs[0] >= 0) && (dofs[1] >= 0) && (dofs[2] >= 0))
+	{
+		FEMesh& mesh = fem->GetMesh();
+		int NN = mesh.Nodes();
+
+		// use the centroid as the origin for the rotational modes
+		vec3d c(0, 0, 0);
+		for (int i = 0; i < NN; ++i) c += mesh.Node(i).m_r0;
+		if (NN > 0) c /= (double)NN;
+
+		for (int i = 0; i < NN; ++i)
+		{
+			FENode& node = mesh.Node(i);
+			vec3d r = node.m_r0 - c;
+			int ng = 0;
+			for (int k = 0; k < 3; ++k)
+			{
+				int eq = node.m_ID[dofs[k]];
+				if ((eq < 0) || (eq >= n) || (eqNode[eq] != -1)) continue;
+				eqNode[eq] = i;
+				geq.push_back(eq);
+				ng++;
+
+				double* b = &B[(size_t)eq*nb];
+				b[k] = 1.0;
+				switch (k)
+				{
+				case 0: b[4] =  r.z; b[5] = -r.y; break;
+				case 1: b[3] = -r.z; b[5] =  r.x; break;
+				case 2: b[3] =  r.y; b[4] = -r.x; break;
+				}
+			}
+			if (ng > 0) gptr.push_back((int)geq.size());
+		}
+	}
+	for (int i = 0; i < n; ++i)
+	{
+		if (eqNode[i] == -1)
+		{
+			B[(size_t)i*nb] = 1.0;
+			geq.push_back(i);
+			gptr.push_back((int)geq.size());
+		}
+	}
+
+	// build the hierarchy
+	for (int l = 0; ; ++l)
+	{
+		AMGLevel& L = m->levels[l];
+		SetupLevel(L);
+
+		int nl = L.A.nr;
+		if ((nl <= m_coarseSize) || (l >= m_maxLevels - 1)) break;
+
+		// aggregation and tentative prolongator
+		vector<int> agg;
+		int na = Aggregate(L.A, gptr, geq, m_theta, agg);
+		CSRMat T;
+		TentativeProlongator(nl, na, agg, gptr, geq, B, nb, T);
+		if ((T.nc == 0) || (T.nc >= 0.9*nl)) break;
+
+		// smooth the prolongator: P = (I - w*Dinv*A)*T
+		double w = m_omega / L.lmax;
+		CSRMat S;
+		BuildCSR(S, nl, nl, [&](auto f) {
+			for (int i = 0; i < nl; ++i)
+			{
+				bool bdiag = false;
+				L.A.forEachInRow(i, [&](int j, double aij) {
+					double sij = -w*L.Dinv[i] * aij;
+					if (j == i) { sij += 1.0; bdiag = true; }
+					f(i, j, sij);
+				});
+				if (bdiag == false) f(i, i, 1.0);
+			}
+		});
+		CSRMat& P = L.P;
+		Multiply(S, RowView(T), P);
+		Transpose(P, L.R);
+
+		// Galerkin coarse operator
+		CSRMat RA;
+		m->levels.push_back(AMGLevel());
+		AMGLevel& Ll = m->levels[l];
+		AMGLevel& Lc = m->levels[l + 1];
+		Multiply(Ll.R, Ll.A, RA);
+		Multiply(RA, RowView(Ll.P), Lc.Ac);
+		Lc.A = RowView(Lc.Ac);
+	}
+
+	// factor the coarsest level
+	AMGLevel& Lc = m->levels.back();
+	if (Lc.A.nr <= 4*m_coarseSize) m->bdirect = m->FactorCoarse(Lc.A);
+
+	if (m_printLevel > 0)
+	{
+		feLog("sa_amg hierarchy:\n");
+		for (size_t l = 0; l < m->levels.size(); ++l)
+		{
+			const RowMat& A = m->levels[l].A;
+			feLog("  level %d: %d rows, %d nonzeroes\n", (int)l, A.nr, A.nnz());
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SAAMGPreconditioner::BackSolve(double* x, double* y)
+{
+	if (m->levels.empty()) return false;
+
+	AMGLevel& L = m->levels[0];
+	int n = L.A.nr;
+	for (int i = 0; i < n; ++i) L.b[i] = y[i];
+	m->VCycle(0);
+	for (int i = 0; i < n; ++i) x[i] = L.x[i];
+
+	return true;
+}
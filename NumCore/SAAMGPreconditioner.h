@@ -0,0 +1,72 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+
+//-----------------------------------------------------------------------------
+//! Smoothed aggregation algebraic multigrid (SA-AMG) preconditioner.
+//! The near-null space of the fine level is made up of the rigid body modes,
+//! which are constructed from the initial nodal coordinates and the nodal
+//! displacement equations. The multigrid hierarchy is rebuilt in each call to
+//! Factor, and the preconditioner applies one symmetric V-cycle with Chebyshev
+//! smoothing in BackSolve, so it can be used with CG as well as BiCGStab.
+class SAAMGPreconditioner : public Preconditioner
+{
+	class Impl;
+
+public:
+	SAAMGPreconditioner(FEModel* fem);
+	~SAAMGPreconditioner();
+
+	// create a preconditioner for a sparse matrix
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+	// create sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	void Destroy() override;
+
+	void SetPrintLevel(int n) override { m_printLevel = n; }
+
+private:
+	int		m_maxLevels;	//!< max number of levels
+	int		m_coarseSize;	//!< levels below this size are solved directly
+	double	m_theta;		//!< strength of connection threshold
+	int		m_degree;		//!< degree of Chebyshev smoother
+	double	m_omega;		//!< prolongator smoothing damping factor
+	int		m_printLevel;	//!< output level
+
+private:
+	Impl*	m;
+
+	DECLARE_FECORE_CLASS();
+};
@@ -0,0 +1,1096 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SupernodalSolver.h"
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+using namespace std;
+
+// subgraphs with fewer vertices than this are not dissected any further
+#define ND_LEAF_SIZE	64
+
+// max nr of columns in a supernode
+#define MAX_SUPERNODE_SIZE	64
+
+// fronts with more columns than this are updated in parallel
+#define MIN_PARALLEL_FRONT	128
+
+//-----------------------------------------------------------------------------
+class SupernodalSolver::Impl
+{
+public:
+	// solver parameters
+	int		ordering = MINIMUM_DEGREE;
+	int		printLevel = 0;
+
+	// copy of the sparsity pattern that was used for the analysis
+	int			neq = 0;
+	int			offset = 0;
+	vector<int>	colptr;
+	vector<int>	rowind;
+
+	// fill-reducing permutation (perm[new] = old, iperm[old] = new)
+	vector<int>	perm, iperm;
+
+	// lower triangular pattern of the permuted matrix (column-wise).
+	// Amap stores for each entry the location in the original values array.
+	vector<int>	Ap, Ai, Amap;
+
+	// supernodes
+	int				nsuper = 0;
+	vector<int>		super;		// first column of each supernode
+	vector<int>		sparent;	// parent supernode in assembly tree
+	vector<int>		childp;		// children of supernodes
+	vector<int>		child;
+	vector<int>		Lrp;		// start of row structure of each supernode
+	vector<int>		Lrow;		// row indices of supernodes
+	vector<size_t>	Lvp;		// start of values of each supernode
+	vector< vector<int> >	levels;	// supernodes grouped by tree height
+
+	// numerical factorization
+	vector<double>	Lx;
+	vector<double>	D;
+	vector< vector<double> >	upd;	// frontal update matrices
+
+	bool	analyzed = false;
+	bool	factored = false;
+	int		nthreads = 1;
+
+public:
+	bool SamePattern(CompactSymmMatrix& A);
+	void Analyze(CompactSymmMatrix& A);
+	bool Factor(CompactSymmMatrix& A);
+	void Solve(double* x, const double* b);
+	void ClearFactor();
+
+private:
+	void BuildPermutedPattern(CompactSymmMatrix& A);
+	void RowPattern(vector<int>& Up, vector<int>& Uj);
+	void EliminationTree(vector<int>& parent);
+	bool FactorSupernode(int s, const double* Av, bool bparallel);
+};
+
+//-----------------------------------------------------------------------------
+// Builds the adjacency graph (without diagonal) from the lower triangular pattern
+static void BuildGraph(int n, const int* colptr, const int* rowind, int offset, vector<int>& xadj, vector<int>& adj)
+{
+	xadj.assign(n + 1, 0);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int p = colptr[j] - offset; p < colptr[j + 1] - offset; ++p)
+		{
+			int i = rowind[p] - offset;
+			if (i != j) { xadj[i + 1]++; xadj[j + 1]++; }
+		}
+	}
+	for (int i = 0; i < n; ++i) xadj[i + 1] += xadj[i];
+
+	adj.resize(xadj[n]);
+	vector<int> pos(xadj.begin(), xadj.end() - 1);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int p = colptr[j] - offset; p < colptr[j + 1] - offset; ++p)
+		{
+			int i = rowind[p] - offset;
+			if (i != j)
+			{
+				adj[pos[i]++] = j;
+				adj[pos[j]++] = i;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Calculates an approximate minimum degree ordering of a graph. 
+// The elimination is simulated on the quotient graph, where eliminated vertices 
+// are represented by elements. The degrees are approximated by the bound of
+// Amestoy, Davis and Duff. Indistinguishable vertices are merged into 
+// supervariables and vertices that only connect to the pivot are eliminated with it.
+// On return, perm[new] = old.
+static void MinimumDegree(int n, const vector<int>& xadj, const vector<int>& adj, vector<int>& perm)
+{
+	perm.clear();
+	if (n == 0) return;
+
+	vector< vector<int> > A(n);	// adjacent variables
+	vector< vector<int> > E(n);	// adjacent elements
+	vector< vector<int> > L(n);	// variables of each element
+	vector<int> nv(n, 1);		// size of supervariables (0 if absorbed)
+	vector<int> deg(n, 0);		// approximate external degrees
+	vector<int> esize(n, 0);	// (upper bound of) element sizes
+	vector<int> parent(n, -1);	// variables absorbed into other variables
+	vector<char> isElem(n, 0), isDead(n, 0);
+
+	// vertices with a very high degree are ordered last
+	int dense = (int)(10.0*sqrt((double)n));
+	if (dense < 16) dense = 16;
+	vector<int> denseList;
+
+	// degree lists
+	vector<int> head(n, -1), next(n, -1), prev(n, -1);
+	auto addToList = [&](int i, int d) {
+		next[i] = head[d]; prev[i] = -1;
+		if (head[d] != -1) prev[head[d]] = i;
+		head[d] = i;
+	};
+	auto removeFromList = [&](int i) {
+		if (prev[i] != -1) next[prev[i]] = next[i]; else head[deg[i]] = next[i];
+		if (next[i] != -1) prev[next[i]] = prev[i];
+	};
+
+	for (int i = 0; i < n; ++i)
+	{
+		int d = xadj[i + 1] - xadj[i];
+		if (d > dense) { nv[i] = 0; isDead[i] = 1; denseList.push_back(i); }
+	}
+	for (int i = 0; i < n; ++i)
+	{
+		if (nv[i] == 0) continue;
+		A[i].reserve(xadj[i + 1] - xadj[i]);
+		for (int p = xadj[i]; p < xadj[i + 1]; ++p) if (nv[adj[p]] > 0) A[i].push_back(adj[p]);
+		deg[i] = (int)A[i].size();
+		addToList(i, deg[i]);
+	}
+
+	vector<int> pivots; pivots.reserve(n);
+	vector<int> w(n, 0), wtag(n, -1), mark(n, -1), smark(n, -1);
+	vector<int> Lp;
+	vector< pair<int, int> > hashList;
+	int nel = (int)denseList.size();
+	int mindeg = 0;
+	int tag = 0, stag = 0;
+	while (nel < n)
+	{
+		// select the pivot of minimum degree
+		while (head[mindeg] == -1) ++mindeg;
+		int p = head[mindeg];
+		removeFromList(p);
+		pivots.push_back(p);
+		nel += nv[p];
+		++tag;
+
+		// form the new element from the variables adjacent to the pivot
+		Lp.clear();
+		mark[p] = tag;
+		for (size_t k = 0; k < A[p].size(); ++k)
+		{
+			int i = A[p][k];
+			if ((nv[i] > 0) && (isElem[i] == 0) && (mark[i] != tag)) { mark[i] = tag; Lp.push_back(i); }
+		}
+		for (size_t k = 0; k < E[p].size(); ++k)
+		{
+			int e = E[p][k];
+			if (isDead[e]) continue;
+			for (size_t m = 0; m < L[e].size(); ++m)
+			{
+				int i = L[e][m];
+				if ((nv[i] > 0) && (mark[i] != tag)) { mark[i] = tag; Lp.push_back(i); }
+			}
+			// element e is absorbed into the new element
+			isDead[e] = 1;
+			vector<int>().swap(L[e]);
+		}
+		vector<int>().swap(A[p]);
+		vector<int>().swap(E[p]);
+		isElem[p] = 1;
+
+		int lpsize = 0;
+		for (size_t k = 0; k < Lp.size(); ++k)
+		{
+			int i = Lp[k];
+			lpsize += nv[i];
+			removeFromList(i);
+		}
+
+		// calculate |Le \ Lp| for all elements adjacent to the variables in Lp
+		for (size_t k = 0; k < Lp.size(); ++k)
+		{
+			int i = Lp[k];
+			for (size_t m = 0; m < E[i].size(); ++m)
+			{
+				int e = E[i][m];
+				if (isDead[e]) continue;
+				if (wtag[e] != tag) { wtag[e] = tag; w[e] = esize[e]; }
+				w[e] -= nv[i];
+			}
+		}
+
+		// update the variables in Lp
+		hashList.clear();
+		for (size_t k = 0; k < Lp.size(); ++k)
+		{
+			int i = Lp[k];
+			int d = 0;
+			size_t h = 0;
+
+			// prune the element list
+			vector<int>& Ei = E[i];
+			int ne = 0;
+			for (size_t m = 0; m < Ei.size(); ++m)
+			{
+				int e = Ei[m];
+				if (isDead[e]) continue;
+				if (w[e] > 0) { d += w[e]; Ei[ne++] = e; h += e; }
+				else isDead[e] = 1;	// aggressive absorption
+			}
+			Ei.resize(ne);
+
+			// prune the variable list
+			vector<int>& Ai = A[i];
+			int na = 0;
+			for (size_t m = 0; m < Ai.size(); ++m)
+			{
+				int j = Ai[m];
+				if ((nv[j] > 0) && (isElem[j] == 0) && (mark[j] != tag)) { d += nv[j]; Ai[na++] = j; h += j; }
+			}
+			Ai.resize(na);
+
+			if (d == 0)
+			{
+				// mass elimination: i only connects to the pivot
+				parent[i] = p;
+				nel += nv[i];
+				lpsize -= nv[i];
+				nv[i] = 0;
+				vector<int>().swap(Ai);
+				vector<int>().swap(Ei);
+			}
+			else
+			{
+				Ei.push_back(p);
+				deg[i] = min(deg[i], d);
+				hashList.push_back(pair<int, int>((int)(h % n), i));
+			}
+		}
+
+		// find indistinguishable variables and merge them into supervariables
+		sort(hashList.begin(), hashList.end());
+		for (size_t k0 = 0; k0 < hashList.size(); )
+		{
+			size_t k1 = k0 + 1;
+			while ((k1 < hashList.size()) && (hashList[k1].first == hashList[k0].first)) ++k1;
+			for (size_t a = k0; a + 1 < k1; ++a)
+			{
+				int i = hashList[a].second;
+				if (nv[i] == 0) continue;
+				++stag;
+				for (size_t m = 0; m < A[i].size(); ++m) smark[A[i][m]] = stag;
+				for (size_t m = 0; m < E[i].size(); ++m) smark[E[i][m]] = stag;
+				for (size_t b = a + 1; b < k1; ++b)
+				{
+					int j = hashList[b].second;
+					if ((nv[j] == 0) || (A[j].size() != A[i].size()) || (E[j].size() != E[i].size())) continue;
+					bool same = true;
+					for (size_t m = 0; same && (m < A[j].size()); ++m) if (smark[A[j][m]] != stag) same = false;
+					for (size_t m = 0; same && (m < E[j].size()); ++m) if (smark[E[j][m]] != stag) same = false;
+					if (same)
+					{
+						parent[j] = i;
+						nv[i] += nv[j];
+						nv[j] = 0;
+						vector<int>().swap(A[j]);
+						vector<int>().swap(E[j]);
+					}
+				}
+			}
+			k0 = k1;
+		}
+
+		// finalize the new element and the degrees of its variables
+		L[p].clear();
+		for (size_t k = 0; k < Lp.size(); ++k)
+		{
+			int i = Lp[k];
+			if (nv[i] == 0) continue;
+			L[p].push_back(i);
+			int d = deg[i] + lpsize - nv[i];
+			int dmax = n - nel - nv[i];
+			if (d > dmax) d = dmax;
+			if (d < 0) d = 0;
+			deg[i] = d;
+			addToList(i, d);
+			if (d < mindeg) mindeg = d;
+		}
+		esize[p] = lpsize;
+		if (L[p].empty()) isDead[p] = 1;
+	}
+
+	// Generate the permutation. Variables that were absorbed into other variables
+	// are numbered right after them.
+	vector<int> chead(n, -1), cnext(n, -1);
+	for (int i = n - 1; i >= 0; --i)
+	{
+		if (parent[i] != -1) { cnext[i] = chead[parent[i]]; chead[parent[i]] = i; }
+	}
+	perm.reserve(n);
+	vector<int> stack;
+	for (size_t k = 0; k < pivots.size(); ++k)
+	{
+		stack.push_back(pivots[k]);
+		while (stack.empty() == false)
+		{
+			int i = stack.back(); stack.pop_back();
+			perm.push_back(i);
+			for (int c = chead[i]; c != -1; c = cnext[c]) stack.push_back(c);
+		}
+	}
+	for (size_t k = 0; k < denseList.size(); ++k) perm.push_back(denseList[k]);
+	assert((int)perm.size() == n);
+}
+
+//-----------------------------------------------------------------------------
+// Calculates a nested dissection ordering of a graph. The graph is recursively
+// bisected with level-structure separators. The separator vertices are numbered 
+// last, so that they are eliminated after the two halves. 
+// On return, perm[new] = old.
+static void NestedDissection(int n, const vector<int>& xadj, const vector<int>& adj, vector<int>& perm)
+{
+	perm.assign(n, -1);
+	if (n == 0) return;
+
+	vector<int> mark(n, -1), visit(n, -1), level(n, 0);
+	vector<int> queue; queue.reserve(n);
+	int sid = 0, bid = 0;
+
+	// breadth-first search, restricted to the current subgraph
+	auto bfs = [&](int root) -> int {
+		++bid;
+		queue.clear();
+		queue.push_back(root);
+		visit[root] = bid;
+		level[root] = 0;
+		for (size_t k = 0; k < queue.size(); ++k)
+		{
+			int v = queue[k];
+			for (int p = xadj[v]; p < xadj[v + 1]; ++p)
+			{
+				int w = adj[p];
+				if ((mark[w] == sid) && (visit[w] != bid))
+				{
+					visit[w] = bid;
+					level[w] = level[v] + 1;
+					queue.push_back(w);
+				}
+			}
+		}
+		return level[queue.back()] + 1;
+	};
+
+	// labels are assigned from the top down
+	int label = n;
+
+	vector< vector<int> > stack(1);
+	stack[0].resize(n);
+	for (int i = 0; i < n; ++i) stack[0][i] = i;
+	while (stack.empty() == false)
+	{
+		vector<int> S;
+		S.swap(stack.back());
+		stack.pop_back();
+		int ns = (int)S.size();
+		if (ns == 0) continue;
+
+		// small subgraphs are numbered as is
+		if (ns <= ND_LEAF_SIZE)
+		{
+			for (int i = ns - 1; i >= 0; --i) perm[--label] = S[i];
+			continue;
+		}
+
+		++sid;
+		for (int i = 0; i < ns; ++i) mark[S[i]] = sid;
+
+		// find a pseudo-peripheral vertex
+		int root = S[0];
+		int nl = bfs(root);
+		for (int k = 0; k < 8; ++k)
+		{
+			int cand = queue.back();
+			int nlk = bfs(cand);
+			if (nlk <= nl) { nl = bfs(root); break; }
+			root = cand;
+			nl = nlk;
+		}
+
+		// if the subgraph is not connected, process the components separately
+		if ((int)queue.size() < ns)
+		{
+			vector<int> rest; rest.reserve(ns - queue.size());
+			for (int i = 0; i < ns; ++i) if (visit[S[i]] != bid) rest.push_back(S[i]);
+			stack.push_back(rest);
+			stack.push_back(queue);
+			continue;
+		}
+
+		// there is no separator that splits the graph
+		if (nl < 3)
+		{
+			for (int i = ns - 1; i >= 0; --i) perm[--label] = S[i];
+			continue;
+		}
+
+		// find the middle level
+		vector<int> cnt(nl, 0);
+		for (int i = 0; i < ns; ++i) cnt[level[S[i]]]++;
+		int m = 0, sum = cnt[0];
+		while (2 * sum < ns) sum += cnt[++m];
+		if (m < 1) m = 1;
+		if (m > nl - 2) m = nl - 2;
+
+		// only vertices of the middle level that connect to the next level go in the separator
+		vector<int> A, B;
+		A.reserve(ns); B.reserve(ns);
+		for (int i = ns - 1; i >= 0; --i)
+		{
+			int v = S[i];
+			int lv = level[v];
+			if (lv < m) A.push_back(v);
+			else if (lv > m) B.push_back(v);
+			else
+			{
+				bool bsep = false;
+				for (int p = xadj[v]; p < xadj[v + 1]; ++p)
+				{
+					int w = adj[p];
+					if ((mark[w] == sid) && (level[w] == m + 1)) { bsep = true; break; }
+				}
+				if (bsep) perm[--label] = v; else A.push_back(v);
+			}
+		}
+		reverse(A.begin(), A.end());
+		reverse(B.begin(), B.end());
+
+		stack.push_back(A);
+		stack.push_back(B);
+	}
+	assert(label == 0);
+}
+
+//-----------------------------------------------------------------------------
+// see if the matrix has the same sparsity pattern as the one that was analyzed
+bool SupernodalSolver::Impl::SamePattern(CompactSymmMatrix& A)
+{
+	if (analyzed == false) return false;
+	int n = A.Rows();
+	if ((n != neq) || (A.Offset() != offset)) return false;
+	if (A.NonZeroes() != (int)rowind.size()) return false;
+	if (memcmp(A.Pointers(), &colptr[0], sizeof(int)*(n + 1)) != 0) return false;
+	if ((rowind.empty() == false) && (memcmp(A.Indices(), &rowind[0], sizeof(int)*rowind.size()) != 0)) return false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// build the lower triangular pattern of the permuted matrix P*A*P^T
+void SupernodalSolver::Impl::BuildPermutedPattern(CompactSymmMatrix& A)
+{
+	int n = neq;
+	iperm.resize(n);
+	for (int i = 0; i < n; ++i) iperm[perm[i]] = i;
+
+	Ap.assign(n + 1, 0);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int p = colptr[j] - offset; p < colptr[j + 1] - offset; ++p)
+		{
+			int i = rowind[p] - offset;
+			int c = min(iperm[i], iperm[j]);
+			Ap[c + 1]++;
+		}
+	}
+	for (int i = 0; i < n; ++i) Ap[i + 1] += Ap[i];
+
+	Ai.resize(Ap[n]);
+	Amap.resize(Ap[n]);
+	vector<int> pos(Ap.begin(), Ap.end() - 1);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int p = colptr[j] - offset; p < colptr[j + 1] - offset; ++p)
+		{
+			int i = rowind[p] - offset;
+			int r = max(iperm[i], iperm[j]);
+			int c = min(iperm[i], iperm[j]);
+			int k = pos[c]++;
+			Ai[k] = r;
+			Amap[k] = p;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// get the lower triangular pattern of the permuted matrix row-wise
+void SupernodalSolver::Impl::RowPattern(vector<int>& Up, vector<int>& Uj)
+{
+	int n = neq;
+	Up.assign(n + 1, 0);
+	Uj.resize(Ap[n]);
+	for (int k = 0; k < Ap[n]; ++k) Up[Ai[k] + 1]++;
+	for (int i = 0; i < n; ++i) Up[i + 1] += Up[i];
+	vector<int> pos(Up.begin(), Up.end() - 1);
+	for (int j = 0; j < n; ++j)
+		for (int k = Ap[j]; k < Ap[j + 1]; ++k) Uj[pos[Ai[k]]++] = j;
+}
+
+//-----------------------------------------------------------------------------
+// calculate the elimination tree of the permuted matrix
+void SupernodalSolver::Impl::EliminationTree(vector<int>& parent)
+{
+	int n = neq;
+
+	// we need the matrix row-wise
+	vector<int> Up, Uj;
+	RowPattern(Up, Uj);
+
+	parent.assign(n, -1);
+	vector<int> ancestor(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		for (int p = Up[k]; p < Up[k + 1]; ++p)
+		{
+			int i = Uj[p];
+			while ((i != -1) && (i < k))
+			{
+				int inext = ancestor[i];
+				ancestor[i] = k;
+				if (inext == -1) parent[i] = k;
+				i = inext;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::Analyze(CompactSymmMatrix& A)
+{
+	int n = A.Rows();
+	neq = n;
+	offset = A.Offset();
+	colptr.assign(A.Pointers(), A.Pointers() + n + 1);
+	rowind.assign(A.Indices(), A.Indices() + A.NonZeroes());
+
+	// fill-reducing ordering
+	if (ordering != NATURAL_ORDERING)
+	{
+		vector<int> xadj, adj;
+		BuildGraph(n, &colptr[0], (rowind.empty() ? nullptr : &rowind[0]), offset, xadj, adj);
+		if (ordering == NESTED_DISSECTION)
+			NestedDissection(n, xadj, adj, perm);
+		else
+			MinimumDegree(n, xadj, adj, perm);
+	}
+	else
+	{
+		perm.resize(n);
+		for (int i = 0; i < n; ++i) perm[i] = i;
+	}
+	BuildPermutedPattern(A);
+
+	// postorder the elimination tree so that supernodes have consecutive columns
+	vector<int> parent;
+	EliminationTree(parent);
+	{
+		vector<int> head(n, -1), next(n, -1);
+		for (int j = n - 1; j >= 0; --j)
+		{
+			if (parent[j] != -1) { next[j] = head[parent[j]]; head[parent[j]] = j; }
+		}
+		vector<int> post(n), stack; stack.reserve(n);
+		int k = 0;
+		for (int j = 0; j < n; ++j)
+		{
+			if (parent[j] != -1) continue;
+			stack.push_back(j);
+			while (stack.empty() == false)
+			{
+				int p = stack.back();
+				int c = head[p];
+				if (c == -1) { stack.pop_back(); post[k++] = p; }
+				else { head[p] = next[c]; stack.push_back(c); }
+			}
+		}
+		vector<int> newperm(n);
+		for (int i = 0; i < n; ++i) newperm[i] = perm[post[i]];
+		perm = newperm;
+	}
+	BuildPermutedPattern(A);
+	EliminationTree(parent);
+
+	// column counts of L
+	vector<int> cc(n, 1), mark(n, -1);
+	{
+		// traverse the row subtrees, which needs the pattern row-wise
+		vector<int> Up, Uj;
+		RowPattern(Up, Uj);
+
+		for (int k = 0; k < n; ++k)
+		{
+			mark[k] = k;
+			for (int p = Up[k]; p < Up[k + 1]; ++p)
+			{
+				int i = Uj[p];
+				while (mark[i] != k)
+				{
+					mark[i] = k;
+					cc[i]++;
+					i = parent[i];
+				}
+			}
+		}
+	}
+
+	// find the (fundamental) supernodes
+	vector<int> nchild(n, 0);
+	for (int j = 0; j < n; ++j) if (parent[j] != -1) nchild[parent[j]]++;
+	super.clear();
+	if (n > 0) super.push_back(0);
+	for (int j = 1; j < n; ++j)
+	{
+		bool bmerge = (parent[j - 1] == j) && (cc[j - 1] == cc[j] + 1) && (nchild[j] == 1) && (j - super.back() < MAX_SUPERNODE_SIZE);
+		if (bmerge == false) super.push_back(j);
+	}
+	nsuper = (int)super.size();
+	super.push_back(n);
+
+	vector<int> snode(n);
+	for (int s = 0; s < nsuper; ++s)
+		for (int j = super[s]; j < super[s + 1]; ++j) snode[j] = s;
+
+	// assembly tree
+	sparent.assign(nsuper, -1);
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int l = super[s + 1] - 1;
+		if (parent[l] != -1) sparent[s] = snode[parent[l]];
+	}
+	childp.assign(nsuper + 1, 0);
+	for (int s = 0; s < nsuper; ++s) if (sparent[s] != -1) childp[sparent[s] + 1]++;
+	for (int s = 0; s < nsuper; ++s) childp[s + 1] += childp[s];
+	child.resize(childp[nsuper]);
+	{
+		vector<int> pos(childp.begin(), childp.end() - 1);
+		for (int s = 0; s < nsuper; ++s) if (sparent[s] != -1) child[pos[sparent[s]]++] = s;
+	}
+
+	// row structure of supernodes
+	Lrp.assign(nsuper + 1, 0);
+	Lvp.assign(nsuper + 1, 0);
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int nr = cc[super[s]];
+		int nc = super[s + 1] - super[s];
+		Lrp[s + 1] = Lrp[s] + nr;
+		Lvp[s + 1] = Lvp[s] + (size_t)nr * (size_t)nc;
+	}
+	Lrow.resize(Lrp[nsuper]);
+	mark.assign(n, -1);
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int f = super[s];
+		int l = super[s + 1] - 1;
+		int* rows = &Lrow[Lrp[s]];
+		int nr = 0;
+		for (int j = f; j <= l; ++j) rows[nr++] = j;
+		for (int j = f; j <= l; ++j)
+		{
+			for (int k = Ap[j]; k < Ap[j + 1]; ++k)
+			{
+				int r = Ai[k];
+				if ((r > l) && (mark[r] != s)) { mark[r] = s; rows[nr++] = r; }
+			}
+		}
+		for (int k = childp[s]; k < childp[s + 1]; ++k)
+		{
+			int c = child[k];
+			for (int p = Lrp[c]; p < Lrp[c + 1]; ++p)
+			{
+				int r = Lrow[p];
+				if ((r > l) && (mark[r] != s)) { mark[r] = s; rows[nr++] = r; }
+			}
+		}
+		assert(nr == Lrp[s + 1] - Lrp[s]);
+		sort(rows + (l - f + 1), rows + nr);
+	}
+
+	// group the supernodes by their height in the assembly tree.
+	// Supernodes on the same level can be factored independently.
+	vector<int> height(nsuper, 0);
+	int maxh = 0;
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int p = sparent[s];
+		if ((p != -1) && (height[p] < height[s] + 1)) height[p] = height[s] + 1;
+		if (height[s] > maxh) maxh = height[s];
+	}
+	levels.assign(nsuper > 0 ? maxh + 1 : 0, vector<int>());
+	for (int s = 0; s < nsuper; ++s) levels[height[s]].push_back(s);
+
+	// figure out how many threads we have
+	nthreads = 1;
+#pragma omp parallel
+	{
+#pragma omp master
+		nthreads = omp_get_num_threads();
+	}
+
+	analyzed = true;
+}
+
+//-----------------------------------------------------------------------------
+// Assemble the frontal matrix of supernode s, factor its pivot columns and 
+// calculate the update matrix for the parent.
+bool SupernodalSolver::Impl::FactorSupernode(int s, const double* Av, bool bparallel)
+{
+	int f = super[s];
+	int l = super[s + 1] - 1;
+	int nc = l - f + 1;
+	const int* rows = &Lrow[Lrp[s]];
+	int nr = Lrp[s + 1] - Lrp[s];
+	int m = nr - nc;
+	double* L = &Lx[Lvp[s]];
+
+	// assemble the original matrix entries
+	for (size_t k = 0; k < (size_t)nr*nc; ++k) L[k] = 0.0;
+	for (int j = f; j <= l; ++j)
+	{
+		double* Lj = L + (size_t)(j - f)*nr;
+		for (int k = Ap[j]; k < Ap[j + 1]; ++k)
+		{
+			int r = Ai[k];
+			int lr = (r <= l ? r - f : (int)(lower_bound(rows + nc, rows + nr, r) - rows));
+			Lj[lr] += Av[Amap[k]];
+		}
+	}
+
+	// extend-add the update matrices of the children
+	vector<double>& U = upd[s];
+	U.assign((size_t)m*m, 0.0);
+	vector<int> rel;
+	for (int k = childp[s]; k < childp[s + 1]; ++k)
+	{
+		int c = child[k];
+		int ncc = super[c + 1] - super[c];
+		int mc = Lrp[c + 1] - Lrp[c] - ncc;
+		const int* crows = &Lrow[Lrp[c] + ncc];
+		vector<double>& Uc = upd[c];
+
+		// find the relative indices (both lists are sorted)
+		rel.resize(mc);
+		int p = 0;
+		for (int i = 0; i < mc; ++i)
+		{
+			while (rows[p] != crows[i]) ++p;
+			rel[i] = p;
+		}
+
+		for (int jj = 0; jj < mc; ++jj)
+		{
+			int cj = rel[jj];
+			const double* uj = &Uc[0] + (size_t)jj*mc;
+			if (cj < nc)
+			{
+				double* Lj = L + (size_t)cj*nr;
+				for (int ii = jj; ii < mc; ++ii) Lj[rel[ii]] += uj[ii];
+			}
+			else
+			{
+				double* Uj = &U[0] + (size_t)(cj - nc)*m - nc;
+				for (int ii = jj; ii < mc; ++ii) Uj[rel[ii]] += uj[ii];
+			}
+		}
+
+		// we no longer need the child's update matrix
+		vector<double>().swap(Uc);
+	}
+
+	// factor the pivot columns
+	double* d = &D[f];
+	for (int j = 0; j < nc; ++j)
+	{
+		double* Lj = L + (size_t)j*nr;
+		for (int k = 0; k < j; ++k)
+		{
+			const double* Lk = L + (size_t)k*nr;
+			double t = Lk[j] * d[k];
+			if (t == 0.0) continue;
+			for (int i = j; i < nr; ++i) Lj[i] -= Lk[i] * t;
+		}
+
+		double djj = Lj[j];
+		if (djj == 0.0) return false;
+		d[j] = djj;
+
+		double dinv = 1.0 / djj;
+		Lj[j] = 1.0;
+		for (int i = j + 1; i < nr; ++i) Lj[i] *= dinv;
+	}
+
+	// calculate the update matrix U -= L21*D*L21^T
+	if (m > 0)
+	{
+		const double* L21 = L + nc;
+#pragma omp parallel for schedule(dynamic, 16) if (bparallel)
+		for (int jj = 0; jj < m; ++jj)
+		{
+			double* Uj = &U[0] + (size_t)jj*m;
+
+			// process four columns at a time to reduce the memory traffic on U
+			int k = 0;
+			for (; k + 3 < nc; k += 4)
+			{
+				const double* L0 = L21 + (size_t)k*nr;
+				const double* L1 = L0 + nr;
+				const double* L2 = L1 + nr;
+				const double* L3 = L2 + nr;
+				double t0 = L0[jj] * d[k];
+				double t1 = L1[jj] * d[k + 1];
+				double t2 = L2[jj] * d[k + 2];
+				double t3 = L3[jj] * d[k + 3];
+				for (int ii = jj; ii < m; ++ii) Uj[ii] -= L0[ii] * t0 + L1[ii] * t1 + L2[ii] * t2 + L3[ii] * t3;
+			}
+			for (; k < nc; ++k)
+			{
+				const double* Lk = L21 + (size_t)k*nr;
+				double t = Lk[jj] * d[k];
+				if (t == 0.0) continue;
+				for (int ii = jj; ii < m; ++ii) Uj[ii] -= Lk[ii] * t;
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Impl::Factor(CompactSymmMatrix& A)
+{
+	assert(analyzed);
+	Lx.resize(Lvp[nsuper]);
+	D.resize(neq);
+	upd.assign(nsuper, vector<double>());
+
+	const double* Av = A.Values();
+
+	bool bok = true;
+	for (size_t h = 0; (h < levels.size()) && bok; ++h)
+	{
+		vector<int>& lev = levels[h];
+		int nl = (int)lev.size();
+
+		// Process the supernodes of a level in parallel if there are enough of them.
+		// Otherwise, the work inside each supernode is parallelized.
+		if ((nl > 1) && (nl >= nthreads))
+		{
+#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < nl; ++i)
+			{
+				if (FactorSupernode(lev[i], Av, false) == false)
+				{
+#pragma omp critical
+					bok = false;
+				}
+			}
+		}
+		else
+		{
+			for (int i = 0; i < nl; ++i)
+			{
+				int s = lev[i];
+				int m = Lrp[s + 1] - Lrp[s] - (super[s + 1] - super[s]);
+				if (FactorSupernode(s, Av, (m >= MIN_PARALLEL_FRONT)) == false) bok = false;
+			}
+		}
+	}
+
+	upd.clear();
+	factored = bok;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::Solve(double* x, const double* b)
+{
+	int n = neq;
+	vector<double> y(n);
+	for (int i = 0; i < n; ++i) y[i] = b[perm[i]];
+
+	// forward substitution L*z = y
+	for (int s = 0; s < nsuper; ++s)
+	{
+		int f = super[s];
+		int nc = super[s + 1] - f;
+		int nr = Lrp[s + 1] - Lrp[s];
+		const int* rows = &Lrow[Lrp[s]];
+		const double* L = &Lx[Lvp[s]];
+		for (int j = 0; j < nc; ++j)
+		{
+			const double* Lj = L + (size_t)j*nr;
+			double yj = y[f + j];
+			if (yj == 0.0) continue;
+			for (int i = j + 1; i < nr; ++i) y[rows[i]] -= Lj[i] * yj;
+		}
+	}
+
+	// diagonal scaling
+	for (int i = 0; i < n; ++i) y[i] /= D[i];
+
+	// backward substitution L^T*x = z
+	for (int s = nsuper - 1; s >= 0; --s)
+	{
+		int f = super[s];
+		int nc = super[s + 1] - f;
+		int nr = Lrp[s + 1] - Lrp[s];
+		const int* rows = &Lrow[Lrp[s]];
+		const double* L = &Lx[Lvp[s]];
+		for (int j = nc - 1; j >= 0; --j)
+		{
+			const double* Lj = L + (size_t)j*nr;
+			double yj = y[f + j];
+			for (int i = j + 1; i < nr; ++i) yj -= Lj[i] * y[rows[i]];
+			y[f + j] = yj;
+		}
+	}
+
+	for (int i = 0; i < n; ++i) x[perm[i]] = y[i];
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::ClearFactor()
+{
+	vector<double>().swap(Lx);
+	vector<double>().swap(D);
+	upd.clear();
+	factored = false;
+}
+
+//=============================================================================
+BEGIN_FECORE_CLASS(SupernodalSolver, LinearSolver)
+	ADD_PARAMETER(m->printLevel, "print_level");
+	ADD_PARAMETER(m->ordering, "ordering", 0, "natural\0amd\0nested dissection\0");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::SupernodalSolver(FEModel* fem) : LinearSolver(fem), m_pA(nullptr)
+{
+	m = new SupernodalSolver::Impl;
+}
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::~SupernodalSolver()
+{
+	Destroy();
+	delete m;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::SetPrintLevel(int n)
+{
+	m->printLevel = n;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SupernodalSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// this solver only works with symmetric matrices
+	m_pA = (ntype == REAL_SYMMETRIC ? new CompactSymmMatrix(0) : nullptr);
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	m_pA = dynamic_cast<CompactSymmMatrix*>(pA);
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::PreProcess()
+{
+	if (m_pA == nullptr) return false;
+
+	// The symbolic analysis only needs to be redone when the sparsity pattern changed.
+	if (m->SamePattern(*m_pA) == false)
+	{
+		m->Analyze(*m_pA);
+
+		if (m->printLevel > 0)
+		{
+			feLog("\tNr of supernodes .......................... : %d\n", m->nsuper);
+			feLog("\tNr of nonzeroes in factor ................. : %.0lf\n", (double)m->Lvp[m->nsuper]);
+		}
+	}
+	else if (m->printLevel > 0) feLog("\tReusing symbolic factorization\n");
+
+	return LinearSolver::PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+
+	// make sure we have work to do
+	if (m_pA->Rows() == 0) return true;
+
+	// in case PreProcess was not called
+	if (m->analyzed == false) m->Analyze(*m_pA);
+
+	if (m->Factor(*m_pA) == false)
+	{
+		feLogError("Zero pivot encountered in supernodal factorization.");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::BackSolve(double* x, double* b)
+{
+	// make sure we have work to do
+	if (m_pA->Rows() == 0) return true;
+	if (m->factored == false) return false;
+
+	m->Solve(x, b);
+
+	// update stats
+	UpdateStats(1);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Destroy()
+{
+	// Only the numerical factorization is cleared. The symbolic analysis is 
+	// kept so it can be reused when the matrix is recreated with the same profile.
+	m->ClearFactor();
+}
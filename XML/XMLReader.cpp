@@ -28,8 +28,144 @@ SOFTWARE.*/
 #include <stdarg.h>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
 using namespace std;
 
+//=============================================================================
+// Numeric conversion
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// exact powers of ten (all of these are exactly representable as doubles)
+static const double xml_pow10[] = {
+	1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//-----------------------------------------------------------------------------
+//! Converts the number at sz to a double and returns a pointer to the first
+//! character after the number. This behaves like strtod, but numbers that have
+//! at most 15 significant digits and a small exponent (i.e. virtually all numbers
+//! in a model file) are converted directly. For those numbers both the mantissa
+//! and the power of ten are exact doubles, so a single multiplication or division
+//! gives the correctly rounded result. Anything else is passed on to strtod.
+static const char* xml_strtod(const char* sz, double& v)
+{
+	const char* s = sz;
+	while (isspace((unsigned char)*s)) ++s;
+
+	bool neg = false;
+	if ((*s == '-') || (*s == '+')) { neg = (*s == '-'); ++s; }
+
+	unsigned long long m = 0;
+	int nd = 0;			// significant digits stored in m
+	int e10 = 0;		// decimal exponent
+	bool digits = false;
+
+	// integer part
+	while (*s == '0') { ++s; digits = true; }
+	while ((*s >= '0') && (*s <= '9'))
+	{
+		m = 10*m + (*s - '0');
+		++nd; ++s;
+		digits = true;
+	}
+
+	// fraction
+	if (*s == '.')
+	{
+		++s;
+		if (m == 0) while (*s == '0') { --e10; ++s; digits = true; }
+		while ((*s >= '0') && (*s <= '9'))
+		{
+			m = 10*m + (*s - '0');
+			++nd; --e10; ++s;
+			digits = true;
+		}
+	}
+
+	// exponent
+	if (digits && ((*s == 'e') || (*s == 'E')))
+	{
+		const char* se = s + 1;
+		bool eneg = false;
+		if ((*se == '-') || (*se == '+')) { eneg = (*se == '-'); ++se; }
+		if ((*se >= '0') && (*se <= '9'))
+		{
+			int ne = 0;
+			while ((*se >= '0') && (*se <= '9'))
+			{
+				if (ne < 10000) ne = 10*ne + (*se - '0');
+				++se;
+			}
+			e10 += (eneg ? -ne : ne);
+			s = se;
+		}
+		else digits = false;	// let strtod decide
+	}
+
+	// hexadecimal numbers, inf, nan, etc.
+	if ((digits == false) || (*s == 'x') || (*s == 'X')) nd = 100;
+
+	if ((nd <= 15) && (e10 >= -22) && (e10 <= 22))
+	{
+		double d = (double)m;
+		if (e10 < 0) d /= xml_pow10[-e10];
+		else if (e10 > 0) d *= xml_pow10[e10];
+		v = (neg ? -d : d);
+		return s;
+	}
+
+	char* end = nullptr;
+	v = strtod(sz, &end);
+	return end;
+}
+
+//-----------------------------------------------------------------------------
+//! Converts the integer at sz and returns a pointer to the first character
+//! after it (or sz if no integer was found, in which case v is set to zero).
+static const char* xml_strtoi(const char* sz, int& v)
+{
+	const char* s = sz;
+	while (isspace((unsigned char)*s)) ++s;
+
+	bool neg = false;
+	if ((*s == '-') || (*s == '+')) { neg = (*s == '-'); ++s; }
+
+	if ((*s < '0') || (*s > '9')) { v = 0; return sz; }
+
+	long long n = 0;
+	while ((*s >= '0') && (*s <= '9'))
+	{
+		if (n <= 2147483648LL) n = 10*n + (*s - '0');
+		++s;
+	}
+	if (neg) n = -n;
+	if (n > 2147483647LL) n = 2147483647LL;
+	if (n < -2147483647LL - 1) n = -2147483647LL - 1;
+	v = (int)n;
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+//! Reads an integer range of the form n0[:n1[:nn]]. Returns the number of 
+//! integers that were read (like sscanf(sz, "%d:%d:%d", ...) would).
+static int xml_read_range(const char* sz, int& n0, int& n1, int& nn)
+{
+	const char* s = xml_strtoi(sz, n0);
+	if (s == sz) return 0;
+	if (*s != ':') return 1;
+
+	const char* s1 = xml_strtoi(s + 1, n1);
+	if (s1 == s + 1) return 1;
+	if (*s1 != ':') return 2;
+
+	const char* s2 = xml_strtoi(s1 + 1, nn);
+	if (s2 == s1 + 1) return 2;
+	return 3;
+}
+
 //=============================================================================
 // XMLAtt
 //=============================================================================
@@ -62,7 +198,7 @@ int XMLAtt::value(double* pf, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pf[i] = atof(sz);
+		xml_strtod(sz, pf[i]);
 		nr++;
 
 		if (sze) sz = sze + 1;
@@ -141,7 +277,7 @@ int XMLTag::value(double* pf, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pf[i] = atof(sz);
+		xml_strtod(sz, pf[i]);
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -162,7 +298,8 @@ int XMLTag::value(float* pf, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pf[i] = (float) atof(sz);
+		double d; xml_strtod(sz, d);
+		pf[i] = (float) d;
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -183,7 +320,7 @@ int XMLTag::value(int* pi, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pi[i] = atoi(sz);
+		xml_strtoi(sz, pi[i]);
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -270,16 +407,14 @@ void XMLTag::value(std::string& val)
 //-----------------------------------------------------------------------------
 void XMLTag::value(vector<int>& l)
 {
-	int i, n = 0, n0, n1, nn;
-	char* szval = strdup(m_szval.c_str());
-	char* ch;
-	char* sz = szval;
-	int nread;
+	std::vector<int> tmp;
+	const char* sz = m_szval.c_str();
+	const char* ch;
+	int n0, n1, nn;
 	do
 	{
 		ch = strchr(sz, ',');
-		if (ch) *ch = 0;
-		nread = sscanf(sz, "%d:%d:%d", &n0, &n1, &nn);
+		int nread = xml_read_range(sz, n0, n1, nn);
 		switch (nread)
 		{
 		case 1:
@@ -297,51 +432,19 @@ void XMLTag::value(vector<int>& l)
 			nn = 1;
 		}
 
-		for (i=n0; i<=n1; i += nn) ++n;
-
-		if (ch) *ch = ',';
-		sz = ch+1;
-	}
-	while (ch != 0);
-
-	if (n != 0)
-	{
-		l.resize(n);
-
-		sz = szval;
-		n = 0;
-		do
+		if ((nread == 1) && (tmp.size() == tmp.capacity()))
 		{
-			ch = strchr(sz, ',');
-			if (ch) *ch = 0;
-			nread = sscanf(sz, "%d:%d:%d", &n0, &n1, &nn);
-			switch (nread)
-			{
-			case 1:
-				n1 = n0;
-				nn = 1;
-				break;
-			case 2:
-				nn = 1;
-				break;
-			case 3:
-				break;
-			default:
-				n0 = 0;
-				n1 = -1;
-				nn = 1;
-			}
+			// plain lists are the common case, so estimate their length from the commas
+			tmp.reserve(tmp.size() + 1 + std::count(sz, sz + strlen(sz), ','));
+		}
 
-			for (i=n0; i<=n1; i += nn) l[n++] = i;
-			assert(n <= (int) l.size());
+		for (int i=n0; i<=n1; i += nn) tmp.push_back(i);
 
-			if (ch) *ch = ',';
-			sz = ch+1;
-		}
-		while (ch != 0);
+		if (ch) sz = ch+1;
 	}
+	while (ch != 0);
 
-	free(szval);
+	if (tmp.empty() == false) l.swap(tmp);
 }
 
 //-----------------------------------------------------------------------------
@@ -357,7 +460,8 @@ void XMLTag::value(vector<double>& l)
 		// read the value
 		if (sz && *sz)
 		{
-			double v = atof(sz);
+			double v = 0.0;
+			xml_strtod(sz, v);
 			l.push_back(v);
 
 			// find next space or comma
@@ -379,7 +483,8 @@ void XMLTag::value2(std::vector<int>& l)
 		// read the value
 		if (sz && *sz)
 		{
-			int v = (int)atoi(sz);
+			int v = 0;
+			xml_strtoi(sz, v);
 			l.push_back(v);
 
 			// find next space or comma
@@ -471,7 +576,7 @@ bool XMLTag::AttributeValue(const char* szat, double& d, bool bopt)
 	const char* szv = AttributeValue(szat, bopt);
 	if (szv == 0) return false;
 
-	d = atof(szv);
+	xml_strtod(szv, d);
 
 	return true;
 }
@@ -482,7 +587,7 @@ bool XMLTag::AttributeValue(const char* szat, int& n, bool bopt)
 	const char* szv = AttributeValue(szat, bopt);
 	if (szv == 0) return false;
 
-	n = atoi(szv);
+	xml_strtoi(szv, n);
 
 	return true;
 }
@@ -558,14 +663,16 @@ XMLReader::XMLReader()
 	m_bufSize = 0;
 	m_eof = false;
 	m_currentPos = 0;
-	m_buf = new char[BUF_SIZE];
+	m_block = new char[BUF_SIZE];
+	m_buf = m_block;
+	m_inMemory = false;
 }
 
 //-----------------------------------------------------------------------------
 XMLReader::~XMLReader()
 {
 	Close();
-	delete[] m_buf;
+	delete[] m_block;
 }
 
 //-----------------------------------------------------------------------------
@@ -583,6 +690,11 @@ void XMLReader::Close()
         m_stream = nullptr;
     }
 
+	// release the in-memory copy of the file
+	std::vector<char>().swap(m_data);
+	m_inMemory = false;
+	m_buf = m_block;
+
 	m_nline = 0;
 	m_bufIndex = 0;
 	m_bufSize = 0;
@@ -617,6 +729,11 @@ bool XMLReader::Open(const char* szfile, bool checkForXMLTag)
 		}
 	}
 
+	// Read the whole file in one go. Tags and values are then scanned straight
+	// from memory, which avoids the per-block refills and the seeks that are
+	// needed each time the parser jumps back to a previously visited tag.
+	ReadIntoMemory();
+
 	m_currentPos = 0;
 
 	// This file is ready to be processed
@@ -647,12 +764,74 @@ bool XMLReader::OpenString(std::string& xml, bool checkForXMLTag)
 		}
 	}
 
+	ReadIntoMemory();
+
 	m_currentPos = 0;
 
 	// This file is ready to be processed
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! Reads the entire stream into memory. The current stream position is
+//! preserved, i.e. the next character returned is the same as before. If the
+//! stream size cannot be determined the reader keeps reading in blocks.
+bool XMLReader::ReadIntoMemory()
+{
+	m_stream->clear();
+	std::streamoff pos = m_stream->tellg();
+	if (pos < 0) return false;
+
+	m_stream->seekg(0, ios_base::end);
+	std::streamoff size = m_stream->tellg();
+	m_stream->seekg(pos, ios_base::beg);
+	if ((size < 0) || (pos > size)) { m_stream->clear(); return false; }
+
+	try {
+		m_data.resize((size_t)size);
+	}
+	catch (std::bad_alloc&)
+	{
+		std::vector<char>().swap(m_data);
+		return false;
+	}
+
+	m_stream->seekg(0, ios_base::beg);
+	if (size > 0) m_stream->read(m_data.data(), size);
+	std::streamsize nread = m_stream->gcount();
+	m_stream->clear();
+	m_stream->seekg(pos, ios_base::beg);
+	if ((size > 0) && (nread != size))
+	{
+		std::vector<char>().swap(m_data);
+		return false;
+	}
+
+	m_inMemory = true;
+	m_buf = m_data.data();
+	m_bufSize = (int64_t)size;
+	m_bufIndex = (int64_t)pos;
+	m_eof = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Move the file pointer to an absolute position
+void XMLReader::seek(int64_t pos)
+{
+	if (m_inMemory)
+	{
+		m_bufIndex = pos;
+	}
+	else
+	{
+		m_stream->seekg(pos, ios_base::beg);
+		m_bufSize = m_bufIndex = 0;
+		m_eof = false;
+	}
+	m_currentPos = pos;
+}
+
 //-----------------------------------------------------------------------------
 
 class XMLPath
@@ -767,10 +946,7 @@ private:
 bool XMLReader::FindTag(const char* xpath, XMLTag& tag)
 {
 	// go to the beginning of the file
-    m_stream->seekg(0, ios_base::beg);
-	m_bufIndex = m_bufSize = 0;
-	m_currentPos = 0;
-	m_eof = false;
+	seek(0);
 
 	// set the first tag
 	tag.m_preader = this;
@@ -821,13 +997,7 @@ void XMLReader::NextTag(XMLTag& tag)
 	m_nline = tag.m_ncurrent_line;
 
 	// set the current file position
-	if (m_currentPos != tag.m_fpos)
-	{
-        m_stream->seekg(tag.m_fpos, ios_base::beg);
-		m_currentPos = tag.m_fpos;
-		m_bufSize = m_bufIndex = 0;
-		m_eof = false;
-	}
+	if (m_currentPos != tag.m_fpos) seek(tag.m_fpos);
 
 	// update the path
 	if (!tag.isend() && !tag.isempty() && !tag.isleaf())
@@ -879,9 +1049,107 @@ inline bool isvalid(char c)
 	return (isalnum(c) || (c=='_') || (c=='.') || (c=='-') || (c==':'));
 }
 
+//-----------------------------------------------------------------------------
+inline const char* skipSpace(const char* p, const char* end, int& nline)
+{
+	while ((p < end) && isspace(*p)) { if (*p == '\n') nline++; p++; }
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+// When the file is in memory, the tag is scanned directly in the buffer. 
+// Nothing is consumed unless the whole tag could be read this way. Comments, 
+// headers, entity references and syntax errors are left to the general reader.
+bool XMLReader::ReadTagFromMemory(XMLTag& tag)
+{
+	if (!m_inMemory || (m_bufIndex < 0) || (m_bufIndex >= m_bufSize)) return false;
+
+	const char* start = m_buf + m_bufIndex;
+	const char* end = m_buf + m_bufSize;
+	int nline = m_nline;
+
+	// find the start token
+	const char* p = skipSpace(start, end, nline);
+	if ((p + 1 >= end) || (*p != '<')) return false;
+	p++;
+	if ((*p == '!') || (*p == '?')) return false;
+
+	int startLine = nline;
+
+	bool bend = false;
+	if (*p == '/') { bend = true; p++; }
+
+	// read the tag name
+	p = skipSpace(p, end, nline);
+	const char* tagStart = p;
+	while ((p < end) && isvalid(*p)) p++;
+	if ((p == tagStart) || (p >= end)) return false;
+	const char* tagEnd = p;
+
+	// read attributes
+	tag.m_att.clear();
+	bool bempty = false;
+	while (true)
+	{
+		p = skipSpace(p, end, nline);
+		if (p >= end) return false;
+		if (*p == '/')
+		{
+			if ((p + 1 >= end) || (p[1] != '>')) return false;
+			bempty = true;
+			p += 2;
+			break;
+		}
+		else if (*p == '>') { p++; break; }
+
+		// read the attribute's name
+		XMLAtt att;
+		const char* s = p;
+		while ((p < end) && isvalid(*p)) p++;
+		if (p == s) return false;
+		att.m_name.assign(s, p);
+
+		p = skipSpace(p, end, nline);
+		if ((p >= end) || (*p != '=')) return false;
+		p = skipSpace(p + 1, end, nline);
+
+		// read the value
+		if ((p >= end) || ((*p != '"') && (*p != '\''))) return false;
+		char quot = *p++;
+		const char* q = (const char*)memchr(p, quot, end - p);
+		if ((q == nullptr) || memchr(p, '&', q - p)) return false;
+		nline += (int)std::count(p, q, '\n');
+		att.m_val.assign(p, q);
+		p = q + 1;
+
+		// mark tag as unvisited
+		att.m_bvisited = false;
+
+		tag.m_att.push_back(att);
+	}
+
+	// the tag was read successfully, so consume it
+	tag.m_nstart_line = startLine;
+	if (bend)
+	{
+		tag.m_bend = true;
+		m_comment.clear();
+	}
+	if (bempty) tag.m_bempty = true;
+	tag.m_sztag.assign(tagStart, tagEnd);
+
+	int64_t n = (int64_t)(p - start);
+	m_bufIndex += n;
+	m_currentPos += n;
+	m_nline = nline;
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void XMLReader::ReadTag(XMLTag& tag)
 {
+	if (ReadTagFromMemory(tag)) return;
+
 	// find the start token
 	char ch;
 	while (true)
@@ -1019,6 +1287,26 @@ void XMLReader::ReadTag(XMLTag& tag)
 //-----------------------------------------------------------------------------
 void XMLReader::ReadValue(XMLTag& tag)
 {
+	// When the file is in memory, the value is located with memchr and copied
+	// in one go, unless it contains entity references that need translating.
+	if (m_inMemory && (m_bufIndex >= 0) && (m_bufIndex < m_bufSize))
+	{
+		const char* sz = m_buf + m_bufIndex;
+		const char* end = m_buf + m_bufSize;
+		const char* lt = (const char*)memchr(sz, '<', end - sz);
+		if (lt && (memchr(sz, '&', lt - sz) == nullptr))
+		{
+			m_nline += (int)std::count(sz, lt, '\n');
+			if (!tag.isend()) tag.m_szval.assign(sz, lt);
+
+			// consume the value and the '<' of the next tag
+			int64_t n = (int64_t)(lt - sz) + 1;
+			m_bufIndex += n;
+			m_currentPos += n;
+			return;
+		}
+	}
+
 	char ch;
 	if (!tag.isend())
 	{
@@ -1121,7 +1409,7 @@ void XMLReader::rewind(int64_t nstep)
 	m_bufIndex -= nstep;
 	m_currentPos -= nstep;
 
-	if (m_bufIndex < 0)
+	if ((m_bufIndex < 0) && !m_inMemory)
 	{
         m_stream->seekg(m_bufIndex - m_bufSize, ios_base::cur);
 		m_bufIndex = m_bufSize = 0;
@@ -1160,6 +1448,72 @@ char XMLReader::GetChar()
 	return ch;
 }
 
+//-----------------------------------------------------------------------------
+//! Finds the '<' of the end tag that closes tag, starting from the tag's current
+//! file position, which must be right after the start tag. Nested elements with
+//! the same name and comments are accounted for. Returns -1 if the end tag is
+//! not found or if the input is not held in memory.
+int64_t XMLReader::FindEndTag(XMLTag& tag)
+{
+	if ((m_inMemory == false) || (m_currentPos != m_bufIndex)) return -1;
+	if ((tag.m_fpos < 0) || (tag.m_fpos > m_bufSize)) return -1;
+
+	const char* name = tag.m_sztag.c_str();
+	size_t l = tag.m_sztag.size();
+	const char* end = m_buf + m_bufSize;
+	const char* sz = m_buf + tag.m_fpos;
+	int depth = 0;
+	while (sz < end)
+	{
+		const char* lt = (const char*)memchr(sz, '<', end - sz);
+		if (lt == nullptr) return -1;
+		const char* ch = lt + 1;
+		if ((end - ch >= 3) && (strncmp(ch, "!--", 3) == 0))
+		{
+			// skip the comment
+			sz = ch + 3;
+			while ((sz + 2 < end) && ((sz[0] != '-') || (sz[1] != '-') || (sz[2] != '>'))) sz++;
+			sz += 3;
+			continue;
+		}
+
+		bool bend = (*ch == '/');
+		if (bend) ch++;
+		if (((size_t)(end - ch) > l) && (strncmp(ch, name, l) == 0) && !isvalid(ch[l]))
+		{
+			if (bend)
+			{
+				if (depth == 0) return (int64_t)(lt - m_buf);
+				depth--;
+			}
+			else
+			{
+				// don't count empty elements
+				const char* gt = (const char*)memchr(ch, '>', end - ch);
+				if (gt == nullptr) return -1;
+				if (gt[-1] != '/') depth++;
+				sz = gt + 1;
+				continue;
+			}
+		}
+		sz = ch;
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+bool XMLReader::GetTagContent(XMLTag& tag, const char*& sz, size_t& len)
+{
+	if (tag.isleaf() || tag.isend() || tag.isempty()) return false;
+
+	int64_t pos = FindEndTag(tag);
+	if (pos < 0) return false;
+
+	sz = m_buf + tag.m_fpos;
+	len = (size_t)(pos - tag.m_fpos);
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! Skip a tag
 void XMLReader::SkipTag(XMLTag& tag)
@@ -1167,6 +1521,32 @@ void XMLReader::SkipTag(XMLTag& tag)
 	// if this tag is a leaf we just return
 	if (tag.isleaf()) { return; }
 
+	// When the input is in memory, we jump straight to the end tag instead of
+	// parsing all the child elements. The tag is left in the same state as 
+	// it would be after reading the end tag with NextTag.
+	int64_t pos = FindEndTag(tag);
+	if (pos >= 0)
+	{
+		const char* sz = m_buf + pos + 2 + tag.m_sztag.size();
+		const char* end = m_buf + m_bufSize;
+		while ((sz < end) && isspace(*sz)) sz++;
+		if ((sz < end) && (*sz == '>'))
+		{
+			m_nline = tag.m_ncurrent_line + (int)std::count((const char*)m_buf + tag.m_fpos, sz, '\n');
+
+			tag.m_path.push_back(tag.m_sztag);
+			std::string name = tag.m_sztag;
+			tag.clear();
+			tag.m_sztag = name;
+			tag.m_bend = true;
+			tag.m_nstart_line = m_nline;
+			tag.m_ncurrent_line = m_nline;
+			seek((int64_t)(sz + 1 - m_buf));
+			tag.m_fpos = currentPos();
+			return;
+		}
+	}
+
 	// if it is not a leaf we have to loop over all 
 	// the children, skipping each child in turn
 	++tag;
@@ -294,6 +294,10 @@ public:
 
 	const std::string& GetLastComment();
 
+	//! Get the raw text between the start and end tag of a (non-leaf) tag.
+	//! This is only available when the input is held in memory.
+	bool GetTagContent(XMLTag& tag, const char*& sz, size_t& len);
+
 protected: // helper functions
 
 	//! Get the next character in the file
@@ -302,6 +306,9 @@ protected: // helper functions
 	//! Read a tag
 	void ReadTag(XMLTag& tag);
 
+	//! Read a tag directly from the in-memory buffer (returns false if the general reader is needed)
+	bool ReadTagFromMemory(XMLTag& tag);
+
 	//! Read the value of a tag
 	void ReadValue(XMLTag& tag);
 
@@ -317,6 +324,15 @@ protected: // helper functions
 	//! move the file pointer
     void rewind(int64_t nstep);
 
+	//! move the file pointer to an absolute position
+	void seek(int64_t pos);
+
+	//! read the entire stream into memory
+	bool ReadIntoMemory();
+
+	//! find the position of the end tag that matches tag (in memory only)
+	int64_t FindEndTag(XMLTag& tag);
+
 	// only used for processing comments
 	char GetNextChar();
 	
@@ -328,9 +344,13 @@ protected:
 
 	std::string	m_comment;	//!< last comment that was read
 
-	char*		m_buf;
+	char*		m_buf;			//!< current buffer (either m_block or the in-memory file)
+	char*		m_block;		//!< buffer for block-wise reading of the stream
     int64_t    m_bufIndex, m_bufSize;
 	bool		m_eof;
+
+	std::vector<char>	m_data;		//!< file contents (when read into memory)
+	bool				m_inMemory;	//!< the entire input is held in m_data
 };
 
 //-----------------------------------------------------------------------------